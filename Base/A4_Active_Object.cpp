@@ -46,6 +46,11 @@ Active_Object::Active_Object(void)
   this->next_check_thread_time = 0;
   this->message_queue_wait = 0;
   this->num_active_threads = 0;
+  this->num_thread_restarts = 0;
+  this->last_statistics_time = 0;
+  this->last_statistics_count = 0;
+  this->statistics_log_interval = 0;
+  this->next_statistics_log_time = 0;
 } // constructor
 
 /**
@@ -70,17 +75,17 @@ Active_Object::~Active_Object(void)
 */
 Error_Code  Active_Object::Increment_Thread_Count(bool   &the_count_was_incremented)
 { // begin
-  Method_State_Block_Begin(2)
-    State(1)
+  Fast_State_Block_Begin(2)
+    Fast_State(1)
       the_count_was_incremented = false;
 
       the_method_error = this->Set_Active (true);
-    End_State
+    End_Fast_State
 
-    State(2)
+    Fast_State(2)
       the_count_was_incremented = true;
-    End_State
-  End_Method_State_Block
+    End_Fast_State
+  End_Fast_State_Block
 
   return the_method_error.Get_Error_Code();  
 } // Increment_Thread_Count
@@ -90,11 +95,11 @@ Error_Code  Active_Object::Increment_Thread_Count(bool   &the_count_was_incremen
 */
 Error_Code  Active_Object::Decrement_Thread_Count(void)
 { // begin
-  Method_State_Block_Begin(1)
-    State(1)
+  Fast_State_Block_Begin(1)
+    Fast_State(1)
       the_method_error = this->Set_Active (false);
-    End_State
-  End_Method_State_Block
+    End_Fast_State
+  End_Fast_State_Block
 
   return the_method_error.Get_Error_Code();  
 } // Decrement_Thread_Count
@@ -144,18 +149,21 @@ Error_Code  Active_Object::Set_Active(bool  the_active_state)
  * @brief Enqueue a \b Message_Block
  * @param the_message_block - IN
  * @param is_high_prio_prepend - IN - if \b true, then the message block will be placed in the front of the queue.
- * @return 
+ * @return No_Error, EM_Not_Started, a Message_Queue error or an Executor::Schedule error - the message is queued all the same
  */
 Error_Code  Active_Object::Enqueue_Message(A4_Lib::Message_Block::Pointer   &the_message_block,
                                          bool                             is_high_prio_prepend)
 { // begin
-  Method_State_Block_Begin(1)
-    State(1)  
+  Fast_State_Block_Begin(1) // neither call throws - the queue and Executor::Schedule catch their own exceptions
+    Fast_State(1)  
       if (this->Is_Started() != true)
         the_method_error = A4_Error (A4_Active_Object_Module_ID, EM_Not_Started, "The instance is not started - no new messages may be Enqueued.");
       else the_method_error = this->message_queue.Enqueue(the_message_block, this->message_queue_wait, is_high_prio_prepend);
-    End_State
-  End_Method_State_Block
+
+      if ((the_method_error == No_Error) && (this->executor != nullptr))
+        the_method_error = this->executor->Schedule(this);
+    End_Fast_State
+  End_Fast_State_Block
     
   return the_method_error.Get_Error_Code();   
 } // Enqueue_Message
@@ -170,7 +178,7 @@ Error_Code  Active_Object::Initialize(std::size_t    the_number_of_worker_thread
                                       std::uint64_t  the_message_queue_wait,
                                       std::size_t    the_maximum_queued_items)
 { // begin
-  Method_State_Block_Begin(5)
+  Method_State_Block_Begin(6)
     State(1)
       if (this->Is_Initialized() == true)
         the_method_error = A4_Error (A4_Active_Object_Module_ID, I_Already_Initialized, "Instance is already initialized.");
@@ -193,8 +201,14 @@ Error_Code  Active_Object::Initialize(std::size_t    the_number_of_worker_thread
     End_State
       
     State(5)
+      if (this->request_pool == nullptr)
+        the_method_error = A4_Lib::Request_Pool::Allocate(this->request_pool);
+    End_State
+
+    State(6)
       this->min_num_worker_threads = the_number_of_worker_threads;
       this->message_queue_wait = the_message_queue_wait;
+      this->last_statistics_time = A4_Lib::Monotonic_Nano_Seconds();
       
       this->is_initialized = true;
     End_State
@@ -203,6 +217,63 @@ Error_Code  Active_Object::Initialize(std::size_t    the_number_of_worker_thread
   return the_method_error.Get_Error_Code();   
 } // Initialize
 
+/**
+ * @brief Place a method request in the request lane of the message queue and wake the executor, if there is one.
+ * @param the_request - IN - the queue becomes owner - OUT - nullptr on success
+ * @param is_high_prio_prepend - IN - if \b true, the request is placed in the front of the request lane.
+ * @return No_Error, ER_Not_Started, a Message_Queue error or an Executor::Schedule error - the request is queued all the same
+ */
+Error_Code  Active_Object::Enqueue_Request (A4_Lib::Method_Request::Pointer   &the_request,
+                                            bool                              is_high_prio_prepend)
+{ // begin
+  Fast_State_Block_Begin(1) // neither call throws - the queue and Executor::Schedule catch their own exceptions
+    Fast_State(1)  
+      if (this->Is_Started() != true)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, ER_Not_Started, "The instance is not started - no new method requests may be enqueued.");
+      else the_method_error = this->message_queue.Enqueue_Request(std::move(the_request), static_cast<std::int64_t>(this->message_queue_wait), is_high_prio_prepend);
+
+      if ((the_method_error == No_Error) && (this->executor != nullptr))
+        the_method_error = this->executor->Schedule(this);
+    End_Fast_State
+  End_Fast_State_Block
+    
+  return the_method_error.Get_Error_Code();   
+} // Enqueue_Request
+
+/**
+ * @brief Run this instance on a shared Executor rather than on dedicated worker threads.
+ * @param the_executor - IN - the pool - it is held until this instance is destroyed
+ * @param the_max_concurrency - IN - the number of pool threads that may process messages of this instance at once. 
+ *        1 keeps the serial Process_Message semantics, larger values behave like additional worker threads.
+ * @note  Must be called after Initialize and before Start. Handle_Timeout is still called every message_queue_wait milli-seconds when idle.
+ */
+Error_Code  Active_Object::Attach_Executor (A4_Lib::Executor::Pointer  the_executor,
+                                            std::size_t                the_max_concurrency)
+{ // begin
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->Is_Initialized() != true)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, AE_Not_Initialized, "The instance is not initialized.");
+      else if (this->Is_Started() == true)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, AE_Already_Started, "The instance is already started - an executor must be attached before Start.");
+    End_State
+
+    State(2)
+      if (the_executor == nullptr)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, AE_Invalid_Address, "Invalid parameter address - the_executor is nullptr.");
+      else if (the_max_concurrency < 1)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, AE_Invalid_Concurrency, "Invalid parameter value - the_max_concurrency must be non-zero.");
+    End_State
+
+    State(3)
+      this->executor = the_executor;
+      this->executor_attachment.max_concurrency = the_max_concurrency;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Attach_Executor
+
 /**
 * @brief   Retrieve the current initialization status.
 * @return \b true if the instance is initialized.
@@ -230,6 +301,139 @@ bool Active_Object::Message_Queue_Is_Empty(void)
   return this->message_queue.Is_Empty();
 } // Message_Queue_Is_Empty
 
+/**  
+ * @brief Retrieves the number of message blocks waiting in the internal message queue.
+ */
+std::size_t   Active_Object::Message_Queue_Size(void)
+{ // begin
+  return this->message_queue.Size();
+} // Message_Queue_Size
+
+/**  
+ * @brief Retrieves the message block limit of the internal message queue.
+ */
+std::size_t   Active_Object::Message_Queue_Max_Size(void) const
+{ // begin
+  return this->message_queue.Max_Size();
+} // Message_Queue_Max_Size
+
+/**  
+ * @brief Block the caller until the internal message queue has room - used by producers that prefer waiting to a failed Enqueue_Message.
+ * @param the_max_milli_seconds_to_wait - IN
+ * @return \b true if there is room, \b false on a timeout or when the queue is not activated.
+ */
+bool  Active_Object::Wait_For_Message_Queue_Space(std::int64_t   the_max_milli_seconds_to_wait)
+{ // begin
+  return this->message_queue.Wait_For_Space(the_max_milli_seconds_to_wait);
+} // Wait_For_Message_Queue_Space
+
+/**
+ * @brief Retrieve a snapshot of the counters and latency histograms of every worker.
+ * @param the_statistics - OUT - messages_per_second covers the time since the previous call (or Initialize)
+ * @note  Only this call and the start & exit of a worker take the statistics mutex - the workers themselves never wait on a reader.
+ */
+Error_Code  Active_Object::Get_Statistics (A4_Lib::Active_Object_Statistics  &the_statistics)
+{ // begin
+  std::int64_t    the_current_time = 0;
+  std::uint64_t   the_count = 0;
+
+  bool            the_mutex_is_acquired = false;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      the_statistics = A4_Lib::Active_Object_Statistics();
+
+      the_method_error = this->statistics_mutex.Lock(the_mutex_is_acquired);
+    End_State
+
+    State(2)
+      for (const std::unique_ptr<A4_Lib::Worker_Statistics> &the_slot : this->statistics_slots)
+      { // merge the slot
+        the_statistics.num_messages += the_slot->num_messages.Get();
+        the_statistics.num_requests += the_slot->num_requests.Get();
+        the_statistics.num_timeouts += the_slot->num_timeouts.Get();
+        the_statistics.num_errors += the_slot->num_errors.Get();
+
+        the_slot->queue_wait.Add_To(the_statistics.queue_wait);
+        the_slot->process_time.Add_To(the_statistics.process_time);
+      } // for
+
+      the_statistics.num_workers = this->statistics_slots.size() - this->free_statistics_slots.size();
+      the_statistics.num_thread_restarts = this->num_thread_restarts.load(std::memory_order_relaxed);
+      the_statistics.queue_size = this->message_queue.Size();
+
+      the_current_time = A4_Lib::Monotonic_Nano_Seconds();
+      the_count = the_statistics.num_messages + the_statistics.num_requests;
+
+      the_statistics.interval_seconds = static_cast<double>(the_current_time - this->last_statistics_time) / 1.0e9;
+
+      if (the_statistics.interval_seconds > 0.0)
+        the_statistics.messages_per_second = static_cast<double>(the_count - this->last_statistics_count) / the_statistics.interval_seconds;
+
+      this->last_statistics_time = the_current_time;
+      this->last_statistics_count = the_count;
+
+      the_method_error = this->statistics_mutex.Unlock(the_mutex_is_acquired);
+    End_State
+  End_Method_State_Block
+
+  if (the_mutex_is_acquired == true)
+    (void) this->statistics_mutex.Unlock(the_mutex_is_acquired);
+
+  return the_method_error.Get_Error_Code();
+} // Get_Statistics
+
+/**
+ * @brief Write a Get_Statistics snapshot to the application log as a single line.
+ * @param the_detail_level - IN
+ */
+Error_Code  Active_Object::Log_Statistics (A4_Lib::Logging::Detail   the_detail_level)
+{ // begin
+  A4_Lib::Active_Object_Statistics  the_statistics;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      the_method_error = this->Get_Statistics(the_statistics);
+    End_State
+
+    State(2)
+      (void) App_Log->Write (the_detail_level, "Active_Object %p: %.1f msg/s over %.1fs, %llu messages, %llu requests, queue %zu/%zu, "
+                             "wait p50 %llu p99 %llu max %llu ns, process p50 %llu p99 %llu max %llu ns, %llu timeouts, %llu errors, %llu thread restarts",
+                             static_cast<void *>(this), the_statistics.messages_per_second, the_statistics.interval_seconds,
+                             static_cast<unsigned long long>(the_statistics.num_messages), static_cast<unsigned long long>(the_statistics.num_requests),
+                             the_statistics.queue_size, this->message_queue.Max_Size(),
+                             static_cast<unsigned long long>(the_statistics.queue_wait.Percentile(50.0)), static_cast<unsigned long long>(the_statistics.queue_wait.Percentile(99.0)),
+                             static_cast<unsigned long long>(the_statistics.queue_wait.Max()),
+                             static_cast<unsigned long long>(the_statistics.process_time.Percentile(50.0)), static_cast<unsigned long long>(the_statistics.process_time.Percentile(99.0)),
+                             static_cast<unsigned long long>(the_statistics.process_time.Max()),
+                             static_cast<unsigned long long>(the_statistics.num_timeouts), static_cast<unsigned long long>(the_statistics.num_errors),
+                             static_cast<unsigned long long>(the_statistics.num_thread_restarts));
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Log_Statistics
+
+/**
+ * @brief Have a worker call Log_Statistics every the_seconds.
+ * @param the_seconds - IN - zero disables the periodic log
+ */
+Error_Code  Active_Object::Set_Statistics_Log_Interval (std::time_t   the_seconds)
+{ // begin
+  Fast_State_Block_Begin(1)
+    Fast_State(1)
+      if (the_seconds < 0)
+        the_method_error = A4_Error (A4_Active_Object_Module_ID, SSLI_Invalid_Interval, "Invalid parameter value - the_seconds must not be negative.");
+      else { // begin
+        this->next_statistics_log_time = A4_Lib::Now() + the_seconds;
+        this->statistics_log_interval = the_seconds;
+      } // if else
+    End_Fast_State
+  End_Fast_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Statistics_Log_Interval
+
 /**
 *  @brief Start the worker thread(s) of the instance. Must be initialized.
 */
@@ -257,9 +461,17 @@ Error_Code  Active_Object::Start(void)
     State(4)
       this->is_started = true; 
     
-      the_method_error = this->Check_Threads();
+      if (this->executor != nullptr)
+      { // no threads of its own
+        this->pool_thread_slots.assign(this->executor->num_worker_threads, nullptr); // will throw on failure
+
+        the_method_error = this->executor->Attach(this);
+      } // if then
+      else { // begin
+        the_method_error = this->Check_Threads();
       
-      A4_Lib::Sleep_MS(5); // wait for the thread(s) to start
+        A4_Lib::Sleep_MS(5); // wait for the thread(s) to start
+      } // if else
       
       if (the_method_error != No_Error)
         this->is_started = false;
@@ -269,7 +481,7 @@ Error_Code  Active_Object::Start(void)
     State(5)
       num_threads_started = this->Num_Threads();
     
-      if (this->min_num_worker_threads != num_threads_started)
+      if ((this->executor == nullptr) && (this->min_num_worker_threads != num_threads_started))
       { // oops - something is wrong...
         the_method_error = A4_Error (A4_Active_Object_Module_ID, S_Bad_Thread_Count, A4_Lib::Logging::Error, 
                                      "Failed to start the required %lld threads, instead %lld were created.", this->min_num_worker_threads, num_threads_started);
@@ -304,10 +516,18 @@ Error_Code  Active_Object::Stop(void)
       else { // set status
         this->is_started = false; // this should stop the thread(s)
         
-        while (this->Num_Threads() > 0)
-          A4_Lib::Sleep_MS(10);
+        if (this->executor != nullptr)
+        { // begin
+          the_method_error = this->executor->Detach(this); // waits for running slices
+
+          if (the_method_error == No_Error)
+            this->Release_Pool_Thread_Slots();
+        } // if then
+        else while (this->Num_Threads() > 0)
+               A4_Lib::Sleep_MS(10);
         
-        the_method_error = this->start_stop_mutex.Unlock(the_mutex_is_acquired);
+        if (the_method_error == No_Error)
+          the_method_error = this->start_stop_mutex.Unlock(the_mutex_is_acquired);
       } // if else
     End_State
   End_Method_State_Block
@@ -363,8 +583,8 @@ Error_Code  Active_Object::Check_Threads (void)
   
   Method_State_Block_Begin(5)
     State(1) 
-      if ((this->Is_Started() != true) || (this->next_check_thread_time > the_current_time))
-         Terminate_The_Method_Block; // some other thread is busy, or it's not quite time
+      if ((this->Is_Started() != true) || (this->next_check_thread_time > the_current_time) || (this->executor != nullptr))
+         Terminate_The_Method_Block; // some other thread is busy, or it's not quite time - or the threads belong to an executor
       else the_method_error = this->check_thread_mutex.Lock(the_mutex_is_acquired, A4_Lib::Mutex::Just_Try);
     End_State
     
@@ -382,6 +602,7 @@ Error_Code  Active_Object::Check_Threads (void)
           the_error = this->thread_future_vector[the_offset].get();
           
           App_Log->Write (A4_Lib::Logging::Error, "Worker thread terminated with error %1.5f and will be restarted.", A4_Error::Get_Dot_Error_Code(the_error)); // 
+          this->num_thread_restarts.fetch_add(1, std::memory_order_relaxed);
           this->thread_future_vector.erase(this->thread_future_vector.begin() + the_offset);
         } // for if then
     End_State
@@ -442,6 +663,215 @@ Error_Code  Active_Object::Process_Message (A4_Lib::Message_Block::Pointer   &th
   return the_method_error.Get_Error_Code();  
 } // Process_Message
 
+/**
+ * @brief Call the dequeued method request or Process_Message and record the queue wait and the processing time.
+ * @param the_message_block - IN - OUT - processed unless the_request is set
+ * @param the_request - IN - called when set
+ * @param the_worker_statistics - IN - OUT - the slot owned by the calling worker
+ * @return the Process_Message error - a request failure belongs to its future and is only counted
+ */
+Error_Code  Active_Object::Dispatch (A4_Lib::Message_Block::Pointer    &the_message_block,
+                                     A4_Lib::Method_Request::Pointer   &the_request,
+                                     A4_Lib::Worker_Statistics         &the_worker_statistics)
+{ // begin
+  Error_Code    the_error = No_Error;
+
+  std::int64_t  the_start_time = A4_Lib::Monotonic_Nano_Seconds();
+  std::int64_t  the_enqueue_time = (the_request != nullptr) ? the_request->Get_Enqueue_Time() : the_message_block->Get_Enqueue_Time();
+
+  if (the_start_time > the_enqueue_time)
+    the_worker_statistics.queue_wait.Record(static_cast<std::uint64_t>(the_start_time - the_enqueue_time));
+  else the_worker_statistics.queue_wait.Record(0);
+
+  A4_Lib::Trace_Receive  the_trace_receive((the_request != nullptr) ? the_request->Get_Trace_Context() : the_message_block->Get_Trace_Context()); // continue the producer's trace on this worker - until the span below has ended
+  A4_Lib::Trace_Span     the_trace_span("Active_Object::Dispatch");
+
+  if (the_request != nullptr)
+  { // begin
+    the_worker_statistics.num_requests.Increment();
+
+    if (the_request->Call() != No_Error) // a callable failure belongs to its future - it has been logged, the worker carries on
+      the_worker_statistics.num_errors.Increment();
+  } // if then
+  else { // begin
+    the_worker_statistics.num_messages.Increment();
+
+    the_error = this->Process_Message(the_message_block);
+
+    if (the_error != No_Error)
+      the_worker_statistics.num_errors.Increment();
+  } // if else
+
+  the_worker_statistics.process_time.Record(static_cast<std::uint64_t>(A4_Lib::Monotonic_Nano_Seconds() - the_start_time));
+
+  return the_error;
+} // Dispatch
+
+/**
+ * @brief Take a statistics slot for the calling worker - a free one is reused so the totals survive thread restarts.
+ * @param the_slot - OUT
+ */
+Error_Code  Active_Object::Acquire_Statistics_Slot (A4_Lib::Worker_Statistics   *&the_slot)
+{ // begin
+  std::unique_ptr<A4_Lib::Worker_Statistics>  the_new_slot;
+
+  bool    the_mutex_is_acquired = false;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      the_method_error = this->statistics_mutex.Lock(the_mutex_is_acquired);
+    End_State
+
+    State(2)
+      if (this->free_statistics_slots.empty() != true)
+      { // reuse
+        the_slot = this->free_statistics_slots.back();
+
+        this->free_statistics_slots.pop_back();
+      } // if then
+      else { // begin
+        the_new_slot.reset(new (std::nothrow) A4_Lib::Worker_Statistics);
+
+        if (the_new_slot == nullptr)
+          the_method_error = A4_Error (A4_Active_Object_Module_ID, ASS_Allocation_Error, "Memory allocation error - could not allocate a new worker statistics slot.");
+        else { // begin
+          this->statistics_slots.push_back(std::move(the_new_slot)); // will throw on failure
+
+          the_slot = this->statistics_slots.back().get();
+        } // if else
+      } // if else
+    End_State
+
+    State(3)
+      the_method_error = this->statistics_mutex.Unlock(the_mutex_is_acquired);
+    End_State
+  End_Method_State_Block
+
+  if (the_mutex_is_acquired == true)
+    (void) this->statistics_mutex.Unlock(the_mutex_is_acquired);
+
+  return the_method_error.Get_Error_Code();
+} // Acquire_Statistics_Slot
+
+/**
+ * @brief Return the slot of an exiting worker (or finished slice) for reuse.
+ * @param the_slot - IN - may be nullptr - OUT - nullptr
+ */
+void  Active_Object::Release_Statistics_Slot (A4_Lib::Worker_Statistics   *&the_slot)
+{ // begin
+  bool    the_mutex_is_acquired = false;
+
+  if (the_slot == nullptr)
+    return;
+
+  if (this->statistics_mutex.Lock(the_mutex_is_acquired) == No_Error)
+  { // begin
+    this->free_statistics_slots.push_back(the_slot);
+
+    (void) this->statistics_mutex.Unlock(the_mutex_is_acquired);
+  } // if then
+
+  the_slot = nullptr;
+} // Release_Statistics_Slot
+
+/**
+ * @brief Return the slots bound to Executor pool threads for reuse - no slice of this instance may be running.
+ */
+void  Active_Object::Release_Pool_Thread_Slots (void)
+{ // begin
+  for (std::size_t the_offset = 0; the_offset < this->pool_thread_slots.size(); the_offset++)
+    this->Release_Statistics_Slot(this->pool_thread_slots [the_offset]);
+
+  this->pool_thread_slots.clear();
+} // Release_Pool_Thread_Slots
+
+/**
+ * @brief Log_Statistics once the interval set by Set_Statistics_Log_Interval has passed - only the worker that moves the deadline writes.
+ */
+void  Active_Object::Check_Statistics_Log (void)
+{ // begin
+  std::time_t   the_interval = this->statistics_log_interval.load(std::memory_order_relaxed);
+  std::time_t   the_next_time = this->next_statistics_log_time.load(std::memory_order_relaxed);
+  std::time_t   the_current_time = 0;
+
+  if (the_interval == 0)
+    return;
+
+  the_current_time = A4_Lib::Now();
+
+  if ((the_current_time >= the_next_time) && (this->next_statistics_log_time.compare_exchange_strong(the_next_time, the_current_time + the_interval) == true))
+    (void) this->Log_Statistics();
+} // Check_Statistics_Log
+
+/**
+ * @brief Process up to the_slice_size queued method requests and message blocks without waiting - called by an Executor pool thread.
+ * If nothing was queued, \b Handle_Timeout is called instead - the executor only schedules an idle object when its timeout is due.
+ * @param the_slice_size - IN - non-zero
+ * @note  Each pool thread binds a statistics slot on its first slice of this instance and keeps it until Stop, so a slice
+ *        takes no lock of its own.
+ * @return No_Error (success)
+ */
+Error_Code  Active_Object::Run_Slice (std::size_t   the_slice_size)
+{ // begin
+  A4_Lib::Message_Block::Pointer  the_message_block;
+  A4_Lib::Method_Request::Pointer the_request;
+
+  A4_Lib::Worker_Statistics       *the_statistics_slot = nullptr;
+
+  std::size_t                     the_count = 0;
+  std::size_t                     the_pool_thread_index = Executor::pool_thread_index;
+
+  bool                            is_slot_bound = (the_pool_thread_index < this->pool_thread_slots.size());
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (is_slot_bound == true)
+      { // begin
+        if (this->pool_thread_slots [the_pool_thread_index] == nullptr)
+          the_method_error = this->Acquire_Statistics_Slot(this->pool_thread_slots [the_pool_thread_index]); // the thread's first slice
+
+        the_statistics_slot = this->pool_thread_slots [the_pool_thread_index];
+      } // if then
+      else the_method_error = this->Acquire_Statistics_Slot(the_statistics_slot); // not a pool thread of the attached executor - one per slice
+    End_State
+
+    State(2)
+      while ((the_count < the_slice_size) && (the_method_error == No_Error))
+      { // begin
+        the_method_error = this->message_queue.Dequeue(the_message_block, the_request, 0); // zero - do not wait
+
+        if ((the_request != nullptr) || (the_message_block != nullptr))
+          the_method_error = this->Dispatch(the_message_block, the_request, *the_statistics_slot);
+        else break; // drained
+
+        the_count += 1;
+
+        the_message_block.reset();
+        the_request.reset();
+      } // while
+    End_State
+
+    State(3)
+      if (the_count == 0)
+      { // idle
+        the_statistics_slot->num_timeouts.Increment();
+
+        the_method_error = this->Handle_Timeout();
+
+        if (the_method_error != No_Error)
+          the_statistics_slot->num_errors.Increment();
+      } // if then
+
+      this->Check_Statistics_Log();
+    End_State
+  End_Method_State_Block
+
+  if (is_slot_bound != true)
+    this->Release_Statistics_Slot(the_statistics_slot);
+
+  return the_method_error.Get_Error_Code();
+} // Run_Slice
+
 #ifdef A4_Lib_Windows
 
   /**
@@ -469,6 +899,9 @@ Error_Code  Active_Object::Process_Message (A4_Lib::Message_Block::Pointer   &th
 Error_Code  Active_Object::Worker_Thread_Method (void)
 { // begin
   A4_Lib::Message_Block::Pointer  the_message_block;
+  A4_Lib::Method_Request::Pointer the_request;
+
+  A4_Lib::Worker_Statistics       *the_statistics_slot = nullptr;
   
   int                             the_main_loop = 0;
   
@@ -478,6 +911,8 @@ Error_Code  Active_Object::Worker_Thread_Method (void)
 
   Method_State_Block_Begin(5)
     State(1)   
+      the_method_error = this->Acquire_Statistics_Slot(the_statistics_slot); // owned by this thread until it exits
+
       Define_Target_State(the_main_loop);
     End_State
     
@@ -487,13 +922,20 @@ Error_Code  Active_Object::Worker_Thread_Method (void)
     End_State
       
     State(3)
-      the_method_error = this->message_queue.Dequeue(the_message_block, this->message_queue_wait);
+      the_method_error = this->message_queue.Dequeue(the_message_block, the_request, this->message_queue_wait);
     End_State
       
     State(4)
-      if (the_message_block == nullptr)
-        the_method_error = this->Handle_Timeout(); // no message with no error means timeout
-      else the_method_error = this->Process_Message(the_message_block);
+      if ((the_request != nullptr) || (the_message_block != nullptr))
+        the_method_error = this->Dispatch(the_message_block, the_request, *the_statistics_slot);
+      else { // no message with no error means timeout
+        the_statistics_slot->num_timeouts.Increment();
+
+        the_method_error = this->Handle_Timeout();
+
+        if (the_method_error != No_Error)
+          the_statistics_slot->num_errors.Increment();
+      } // if else
     End_State
         
     State(5)
@@ -501,10 +943,16 @@ Error_Code  Active_Object::Worker_Thread_Method (void)
       { // garbage collect
         the_message_block.reset();
       } // if then
+
+      the_request.reset(); // returns the request to the pool
       
       if (this->next_check_thread_time < A4_Lib::Now()) // <-- test to be sure the thread count is still being checked, there may not be any idle time
         the_method_error = this->Check_Threads(); 
+
+      this->Check_Statistics_Log();
       
+      A4_Lib::Error_Trace::Drain(); // a failure handled in this pass - the loop never leaves its frame to close the chain
+
       Set_Target_State(the_main_loop);
     End_State
   End_Method_State_Block
@@ -513,6 +961,10 @@ Error_Code  Active_Object::Worker_Thread_Method (void)
   { // garbage collect
     the_message_block.reset();
   } // if then
+
+  the_request.reset();
+
+  this->Release_Statistics_Slot(the_statistics_slot);
     
   if ((this->Is_Started() == true) && (the_method_error != No_Error))
     (void) this->Check_Threads(); // see if the thread needs restarting
@@ -28,11 +28,19 @@
 * 
 */
 
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Executor.hh"
 #include "A4_Message_Queue.hh"
+#include "A4_Method_Request.hh"
+#include "A4_Method_State_Block.hh"
 
 #ifndef A4_DotNet
 #include "A4_Mutex.hh"
+#include <atomic>
 #include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #endif // A4_DotNet
 
@@ -61,6 +69,9 @@ namespace A4_Lib
 
     virtual bool Is_Initialized(void);
 
+    Error_Code  Attach_Executor (A4_Lib::Executor::Pointer  the_executor,
+                                 std::size_t                the_max_concurrency = 1); // before Start - the object then owns no threads
+
     virtual Error_Code  Start(void);
     virtual Error_Code  Stop(void);
 
@@ -73,6 +84,28 @@ namespace A4_Lib
 
     bool    Message_Queue_Is_Empty(void);
 
+    std::size_t   Message_Queue_Size(void); // queued message blocks
+    std::size_t   Message_Queue_Max_Size(void) const; // the_maximum_queued_items passed to Initialize
+
+    bool    Wait_For_Message_Queue_Space(std::int64_t   the_max_milli_seconds_to_wait); // true once Enqueue_Message would not have to wait
+
+    Error_Code  Get_Statistics (A4_Lib::Active_Object_Statistics  &the_statistics); // OUT - messages_per_second covers the time since the previous call
+
+    Error_Code  Log_Statistics (A4_Lib::Logging::Detail   the_detail_level = A4_Lib::Logging::Info);
+
+    Error_Code  Set_Statistics_Log_Interval (std::time_t   the_seconds); // zero (the default) disables the periodic Log_Statistics
+
+  #ifndef A4_DotNet
+    template <typename The_Callable>
+      Error_Code  Submit (The_Callable                                                     the_callable,
+                          std::future<decltype(std::declval<The_Callable &>()())>          &the_future,
+                          bool                                                             is_high_prio_prepend = false);
+
+    template <typename The_Callable>
+      Error_Code  Post (The_Callable    the_callable,
+                        bool            is_high_prio_prepend = false); // Submit without a future - the result is discarded
+  #endif // A4_DotNet
+
     Error_Code  Increment_Thread_Count(bool   &the_count_was_incremented);
     Error_Code  Decrement_Thread_Count(void);
 
@@ -83,8 +116,25 @@ namespace A4_Lib
     virtual   Error_Code  Handle_Timeout (void);  /**< called when no messages need to be processed */
 
   private:
+    friend class Executor;
+
     Error_Code  Worker_Thread_Method (void); // performs default message queue handling - the number of active threads is configurable
 
+    Error_Code  Run_Slice (std::size_t   the_slice_size); // called by an Executor pool thread - processes up to the_slice_size queued items without blocking
+
+    Error_Code  Enqueue_Request (A4_Lib::Method_Request::Pointer   &the_request,
+                                 bool                              is_high_prio_prepend); // used by Submit & Post
+
+    Error_Code  Dispatch (A4_Lib::Message_Block::Pointer    &the_message_block,
+                          A4_Lib::Method_Request::Pointer   &the_request,
+                          A4_Lib::Worker_Statistics         &the_worker_statistics); // call the dequeued item & record it
+
+    Error_Code  Acquire_Statistics_Slot (A4_Lib::Worker_Statistics   *&the_slot); // OUT - owned by the calling worker until released
+    void        Release_Statistics_Slot (A4_Lib::Worker_Statistics   *&the_slot); // IN - OUT - nullptr
+    void        Release_Pool_Thread_Slots (void); // once the executor runs no slice of this instance
+
+    void        Check_Statistics_Log (void); // Log_Statistics when the interval has passed
+
     Error_Code  Check_Threads (void); // check & start missing threads (or all of them on start up )
 
     Error_Code  Set_Active (bool  the_active_state); // increments a usage count & allows another thread to be created in the pool
@@ -99,10 +149,28 @@ namespace A4_Lib
     std::time_t	    next_check_thread_time; /**< The number of \b seconds to wait before each run of Check_Threads. */
 
   private: //  data
+    A4_Lib::Request_Pool::Pointer   request_pool; /**< method requests and their promise state are carved from here - declared before the queue so it outlives any queued request */
+
+    A4_Lib::Executor::Pointer       executor; /**< when set, the shared pool that runs this object instead of its own worker threads */
+    A4_Lib::Executor_Attachment     executor_attachment; /**< scheduling state - guarded by the executor */
+
     A4_Lib::Message_Queue	    message_queue; /**< The blocking message queue - called exclusively by the \b Worker_Thread_Method method. */
 
     std::vector<std::future<Error_Code>> thread_future_vector; /**< Contains the future Error_Code of a terminating thread. */
 
+    std::vector<std::unique_ptr<A4_Lib::Worker_Statistics>>  statistics_slots; /**< one per concurrent worker - slots are reused, never freed before the instance */
+    std::vector<A4_Lib::Worker_Statistics *>                 free_statistics_slots; /**< slots not owned by a worker right now */
+    std::vector<A4_Lib::Worker_Statistics *>                 pool_thread_slots; /**< by Executor pool thread index - bound on the thread's first slice, read & written only by that thread until Stop */
+
+    A4_Lib::Mutex                 statistics_mutex; /**< guards the slot vectors and the interval fields - never taken per message */
+
+    std::atomic<std::uint64_t>    num_thread_restarts; /**< terminated worker threads found by Check_Threads */
+    std::int64_t                  last_statistics_time; /**< monotonic nano-seconds of the previous Get_Statistics */
+    std::uint64_t                 last_statistics_count; /**< messages & requests at the previous Get_Statistics */
+
+    std::atomic<std::time_t>      statistics_log_interval; /**< seconds - zero disables the periodic Log_Statistics */
+    std::atomic<std::time_t>      next_statistics_log_time; /**< the worker that moves this forward writes the log */
+
     std::size_t       min_num_worker_threads;  /**< the minimum number of active threads required for this active object */
     std::size_t       num_active_threads; /**< can be thought of as the number of processes that require a dedicated thread */
 
@@ -131,8 +199,91 @@ namespace A4_Lib
       EM_Not_Started              = 7, /**< The instance is not started - no new messages may be Enqueued. */
       PM_Message_Not_Handled      = 8, /**< This method should not be called but overridden by the subclass. The message was not processed. */
       S_Bad_Thread_Count          = 9, /**< Failed to start a required thread - could be a system resource issue, but most probably a coding error. */
+      SU_Not_Started              = 10, /**< \b Submit: The instance is not started - no new method requests may be submitted. */
+      SU_Invalid_Future_State     = 11, /**< \b Submit: Invalid parameter state - the_future is already valid - a previous result would be lost. */
+      AE_Not_Initialized          = 12, /**< \b Attach_Executor: The instance is not initialized. */
+      AE_Already_Started          = 13, /**< \b Attach_Executor: The instance is already started - an executor must be attached before Start. */
+      AE_Invalid_Address          = 14, /**< \b Attach_Executor: Invalid parameter address - the_executor is nullptr. */
+      AE_Invalid_Concurrency      = 15, /**< \b Attach_Executor: Invalid parameter value - the_max_concurrency must be non-zero. */
+      ER_Not_Started              = 16, /**< \b Enqueue_Request: The instance is not started - no new method requests may be enqueued. */
+      ASS_Allocation_Error        = 17, /**< \b Acquire_Statistics_Slot: Memory allocation error - could not allocate a new worker statistics slot. */
+      SSLI_Invalid_Interval       = 18, /**< \b Set_Statistics_Log_Interval: Invalid parameter value - the_seconds must not be negative. */
     }; // Active_Object_Errors
   } Active_Object;
+
+#ifndef A4_DotNet
+/**
+ * @brief Run the_callable on one of the worker threads and deliver its result through the_future - no Message_Block and no
+ *        Process_Message override is needed. Method requests are dequeued ahead of pending message blocks.
+ * @param the_callable - IN - takes no arguments - its return value (or exception) is delivered to the_future
+ * @param the_future - IN - must not be valid, OUT - the future result of the_callable
+ * @param is_high_prio_prepend - IN - if \b true, the request is placed in the front of the request lane.
+ * @return No_Error, SU_Not_Started, SU_Invalid_Future_State or a Message_Queue error
+ */
+  template <typename The_Callable>
+    Error_Code  Active_Object::Submit (The_Callable                                                     the_callable,
+                                       std::future<decltype(std::declval<The_Callable &>()())>          &the_future,
+                                       bool                                                             is_high_prio_prepend)
+  { // begin
+    typedef decltype(std::declval<The_Callable &>()())  The_Result_Type;
+    typedef Method_Request_T<The_Result_Type, The_Callable>   The_Request_Type;
+
+    Method_Request::Pointer         the_request;
+
+    Method_State_Block_Begin(3)
+      State(1)
+        if (this->Is_Started() != true)
+          the_method_error = A4_Error (A4_Active_Object_Module_ID, SU_Not_Started, "The instance is not started - no new method requests may be submitted.");
+        else if (the_future.valid() == true)
+          the_method_error = A4_Error (A4_Active_Object_Module_ID, SU_Invalid_Future_State, "Invalid parameter state - the_future is already valid - a previous result would be lost.");
+      End_State
+
+      State(2) // the shared state and the request both come from the pool
+        std::promise<The_Result_Type>   the_promise(std::allocator_arg, Request_Pool_Allocator<The_Request_Type>(this->request_pool));
+
+        the_future = the_promise.get_future();
+
+        the_request = std::allocate_shared<The_Request_Type>(Request_Pool_Allocator<The_Request_Type>(this->request_pool), std::move(the_callable), std::move(the_promise));
+      End_State
+
+      State(3)
+        the_method_error = this->Enqueue_Request(the_request, is_high_prio_prepend);
+
+        if (the_method_error != No_Error)
+          the_future = std::future<The_Result_Type>(); // the request (and its promise) has been discarded
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Submit
+
+/**
+ * @brief Run the_callable on one of the worker threads - nobody waits for the result.
+ * @param the_callable - IN - takes no arguments - its return value is discarded, an exception is logged
+ * @param is_high_prio_prepend - IN - if \b true, the request is placed in the front of the request lane and the queue limit is not applied.
+ * @return No_Error, ER_Not_Started or a Message_Queue error
+ */
+  template <typename The_Callable>
+    Error_Code  Active_Object::Post (The_Callable    the_callable,
+                                     bool            is_high_prio_prepend)
+  { // begin
+    typedef Post_Request_T<The_Callable>  The_Request_Type;
+
+    Method_Request::Pointer   the_request;
+
+    Method_State_Block_Begin(2)
+      State(1)
+        the_request = std::allocate_shared<The_Request_Type>(Request_Pool_Allocator<The_Request_Type>(this->request_pool), std::move(the_callable));
+      End_State
+
+      State(2)
+        the_method_error = this->Enqueue_Request(the_request, is_high_prio_prepend);
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Post
+#endif // A4_DotNet
 } // namespace A4_Lib
 
 #endif // __A4_Active_Object_Defined__
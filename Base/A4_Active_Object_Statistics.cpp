@@ -0,0 +1,142 @@
+/**
+ * @brief   Active Object instrumentation implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Active_Object_Statistics.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Active_Object_Statistics.hh"
+
+using namespace A4_Lib;
+
+/**
+ * @brief Retrieve the mean sample in nano-seconds.
+ */
+double  Latency_Histogram_Snapshot::Mean (void) const
+{ // begin
+  if (this->count == 0)
+    return 0.0;
+
+  return static_cast<double>(this->sum) / static_cast<double>(this->count);
+} // Mean
+
+/**
+ * @brief Retrieve the value below which the_percentile of the samples fall - accurate to the bucket width (12.5%).
+ * @param the_percentile - IN - 0.0..100.0
+ */
+std::uint64_t   Latency_Histogram_Snapshot::Percentile (double  the_percentile) const
+{ // begin
+  std::uint64_t   the_target = 0;
+  std::uint64_t   the_running_count = 0;
+
+  if (this->count == 0)
+    return 0;
+
+  if (the_percentile >= 100.0)
+    return this->max;
+
+  the_target = static_cast<std::uint64_t>((the_percentile / 100.0) * static_cast<double>(this->count)) + 1;
+
+  for (std::size_t the_bucket = 0; the_bucket < this->buckets.size(); the_bucket++)
+  { // begin
+    the_running_count += this->buckets [the_bucket];
+
+    if (the_running_count >= the_target)
+      return (Latency_Histogram::Bucket_Upper_Bound(the_bucket) < this->max) ? Latency_Histogram::Bucket_Upper_Bound(the_bucket) : this->max;
+  } // for
+
+  return this->max;
+} // Percentile
+
+/**
+ * @brief Retrieve the bucket of a sample - linear below Linear_Buckets, then Sub_Buckets per power of two.
+ */
+std::size_t   Latency_Histogram::Bucket_Of (std::uint64_t   the_nano_seconds) noexcept
+{ // begin
+  std::size_t   the_exponent = 0;
+
+  if (the_nano_seconds < Statistics_Constant::Linear_Buckets)
+    return static_cast<std::size_t>(the_nano_seconds);
+
+  the_exponent = 63 - static_cast<std::size_t>(__builtin_clzll(the_nano_seconds)); // >= 4
+
+  return Statistics_Constant::Linear_Buckets + ((the_exponent - 4) * Statistics_Constant::Sub_Buckets) +
+         static_cast<std::size_t>((the_nano_seconds >> (the_exponent - Statistics_Constant::Sub_Buckets_Bits)) & (Statistics_Constant::Sub_Buckets - 1));
+} // Bucket_Of
+
+/**
+ * @brief Retrieve the largest value that falls into the_bucket.
+ */
+std::uint64_t   Latency_Histogram::Bucket_Upper_Bound (std::size_t   the_bucket) noexcept
+{ // begin
+  std::size_t   the_exponent = 0;
+  std::uint64_t the_sub_bucket = 0;
+
+  if (the_bucket < Statistics_Constant::Linear_Buckets)
+    return the_bucket;
+
+  the_exponent = ((the_bucket - Statistics_Constant::Linear_Buckets) / Statistics_Constant::Sub_Buckets) + 4;
+  the_sub_bucket = (the_bucket - Statistics_Constant::Linear_Buckets) % Statistics_Constant::Sub_Buckets;
+
+  return (std::uint64_t(1) << the_exponent) + ((the_sub_bucket + 1) << (the_exponent - Statistics_Constant::Sub_Buckets_Bits)) - 1; // + - the top sub-bucket carries into the next power of two
+} // Bucket_Upper_Bound
+
+/**
+ * @brief Record one sample - must only be called by the owning worker.
+ * @param the_nano_seconds - IN
+ */
+void  Latency_Histogram::Record (std::uint64_t   the_nano_seconds) noexcept
+{ // begin
+  std::atomic<std::uint64_t>  &the_bucket = this->buckets [Latency_Histogram::Bucket_Of(the_nano_seconds)];
+
+  // single writer - a relaxed load & store is enough, readers only need a torn-free value
+  the_bucket.store(the_bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  this->count.store(this->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  this->sum.store(this->sum.load(std::memory_order_relaxed) + the_nano_seconds, std::memory_order_relaxed);
+
+  if (the_nano_seconds > this->max.load(std::memory_order_relaxed))
+    this->max.store(the_nano_seconds, std::memory_order_relaxed);
+} // Record
+
+/**
+ * @brief Merge this histogram into the_snapshot.
+ * @param the_snapshot - IN - OUT
+ */
+void  Latency_Histogram::Add_To (Latency_Histogram_Snapshot  &the_snapshot) const
+{ // begin
+  std::uint64_t   the_max = this->max.load(std::memory_order_relaxed);
+
+  for (std::size_t the_bucket = 0; the_bucket < this->buckets.size(); the_bucket++)
+    the_snapshot.buckets [the_bucket] += this->buckets [the_bucket].load(std::memory_order_relaxed);
+
+  the_snapshot.count += this->count.load(std::memory_order_relaxed);
+  the_snapshot.sum += this->sum.load(std::memory_order_relaxed);
+
+  if (the_max > the_snapshot.max)
+    the_snapshot.max = the_max;
+} // Add_To
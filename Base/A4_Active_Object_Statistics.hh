@@ -0,0 +1,150 @@
+#ifndef __A4_Active_Object_Statistics_Defined__
+#define __A4_Active_Object_Statistics_Defined__
+/**
+ * @brief   Active Object instrumentation - per-worker counters and log-linear latency histograms.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Active_Object_Statistics.hh
+ * @note  Every worker (thread, or Executor pool thread) owns a Worker_Statistics slot and is its only writer, so the hot
+ *        path is a relaxed load and store per counter - no read-modify-write and no shared cache line. Readers merge the
+ *        slots into an Active_Object_Statistics snapshot.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Module_ID.hh"
+
+#ifndef A4_DotNet
+#include <array>
+#include <atomic>
+#include <chrono>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Statistics_Constant
+  { // begin
+    static const std::size_t  Linear_Buckets = 16; /**< values 0..15 ns have a bucket each */
+    static const std::size_t  Sub_Buckets_Bits = 3; /**< every power of two above is split into 8 linear sub-buckets - 12.5% resolution */
+    static const std::size_t  Sub_Buckets = (1 << Sub_Buckets_Bits);
+    static const std::size_t  Num_Buckets = Linear_Buckets + ((64 - 4) * Sub_Buckets); /**< covers the whole std::uint64_t range */
+  } // namespace Statistics_Constant
+
+  /**
+   * @brief Retrieve a monotonic nano-second clock - used to time stamp enqueued messages.
+   */
+  inline std::int64_t   Monotonic_Nano_Seconds (void)
+  { // begin
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  } // Monotonic_Nano_Seconds
+
+  /**
+   * @brief Merged, plain copy of one or more Latency_Histograms.
+   */
+  typedef class Latency_Histogram_Snapshot
+  { // begin
+  public: // methods
+    std::uint64_t   Count (void) const {return this->count;};
+    std::uint64_t   Max (void) const {return this->max;};
+    double          Mean (void) const; // nano-seconds
+    std::uint64_t   Percentile (double  the_percentile) const; // 0.0..100.0 - the upper bound of the bucket, in nano-seconds
+
+  public: // data
+    std::array<std::uint64_t, Statistics_Constant::Num_Buckets>   buckets = {}; /**< counts */
+    std::uint64_t   count = 0; /**< number of samples */
+    std::uint64_t   sum = 0; /**< nano-seconds */
+    std::uint64_t   max = 0; /**< nano-seconds */
+  } Latency_Histogram_Snapshot;
+
+#ifndef A4_DotNet
+  /**
+   * @brief Log-linear histogram of nano-second durations - single writer, any number of readers.
+   */
+  typedef class Latency_Histogram
+  { // begin
+  public: // methods
+    void  Record (std::uint64_t   the_nano_seconds) noexcept; // owner thread only
+
+    void  Add_To (Latency_Histogram_Snapshot  &the_snapshot) const; // merge - any thread
+
+    static std::size_t    Bucket_Of (std::uint64_t   the_nano_seconds) noexcept;
+    static std::uint64_t  Bucket_Upper_Bound (std::size_t   the_bucket) noexcept;
+
+  private: // data
+    std::array<std::atomic<std::uint64_t>, Statistics_Constant::Num_Buckets>  buckets = {}; /**< counts */
+    std::atomic<std::uint64_t>  count {0}; /**< number of samples */
+    std::atomic<std::uint64_t>  sum {0}; /**< nano-seconds */
+    std::atomic<std::uint64_t>  max {0}; /**< nano-seconds */
+  } Latency_Histogram;
+
+  /**
+   * @brief Single writer counter - the owner bumps it with a relaxed load and store.
+   */
+  typedef class Worker_Counter
+  { // begin
+  public: // methods
+    void            Increment (void) noexcept {this->value.store(this->value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);};
+    void            Add (std::uint64_t  the_amount) noexcept {this->value.store(this->value.load(std::memory_order_relaxed) + the_amount, std::memory_order_relaxed);};
+    std::uint64_t   Get (void) const noexcept {return this->value.load(std::memory_order_relaxed);};
+
+  private: // data
+    std::atomic<std::uint64_t>  value {0};
+  } Worker_Counter;
+
+  /**
+   * @brief The counters and histograms owned by one worker - cache line aligned so neighbouring workers do not share a line.
+   */
+  typedef struct alignas(64) Worker_Statistics
+  { // begin
+    Worker_Counter      num_messages; /**< Process_Message calls */
+    Worker_Counter      num_requests; /**< Method_Request calls (Submit & Post) */
+    Worker_Counter      num_timeouts; /**< Handle_Timeout calls */
+    Worker_Counter      num_errors; /**< Process_Message / Handle_Timeout / request failures */
+
+    Latency_Histogram   queue_wait; /**< enqueue to dequeue */
+    Latency_Histogram   process_time; /**< Process_Message or request duration */
+  } Worker_Statistics;
+#endif // A4_DotNet
+
+  /**
+   * @brief Snapshot returned by Active_Object::Get_Statistics.
+   */
+  typedef struct Active_Object_Statistics
+  { // begin
+    std::uint64_t   num_messages = 0; /**< Process_Message calls since Initialize */
+    std::uint64_t   num_requests = 0; /**< Method_Request calls since Initialize */
+    std::uint64_t   num_timeouts = 0; /**< Handle_Timeout calls since Initialize */
+    std::uint64_t   num_errors = 0; /**< failed calls since Initialize */
+    std::uint64_t   num_thread_restarts = 0; /**< worker threads found terminated and replaced by Check_Threads */
+
+    std::size_t     queue_size = 0; /**< message blocks waiting right now */
+    std::size_t     num_workers = 0; /**< statistics slots in use - worker threads, or the pool threads that have run the instance */
+
+    double          interval_seconds = 0.0; /**< time since the previous Get_Statistics (or Initialize) */
+    double          messages_per_second = 0.0; /**< messages and requests over interval_seconds */
+
+    Latency_Histogram_Snapshot  queue_wait; /**< nano-seconds - enqueue to dequeue */
+    Latency_Histogram_Snapshot  process_time; /**< nano-seconds - Process_Message or request duration */
+  } Active_Object_Statistics;
+} // namespace A4_Lib
+
+#endif // __A4_Active_Object_Statistics_Defined__
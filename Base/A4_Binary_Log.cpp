@@ -0,0 +1,367 @@
+/**
+ * @brief   Deferred-format log event implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Binary_Log.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Binary_Log.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  std::atomic<const char *>     the_formats [Binary_Log_Constant::Max_Formats]; /**< by id - slot 0 is never used */
+  std::atomic<std::uint32_t>    the_next_format_id {1};
+
+  /**
+   * @brief The next encoded argument.
+   */
+  typedef struct Decoded_Argument
+  { // begin
+    char            tag; /**< Log_Arguments::Argument_Tag - zero when the arguments are used up */
+    std::uint64_t   bits; /**< the integer, double or pointer */
+    const char      *string;
+    std::size_t     string_length;
+  } Decoded_Argument;
+
+  Decoded_Argument  Next_Argument (const char   *&the_next,
+                                   const char   *the_end) noexcept
+  { // begin
+    Decoded_Argument  the_argument = {0, 0, nullptr, 0};
+    std::uint16_t     the_length = 0;
+
+    if (the_next >= the_end)
+      return the_argument;
+
+    the_argument.tag = *the_next++;
+
+    if (the_argument.tag == Log_Arguments::String_Tag)
+    { // begin
+      if (static_cast<std::size_t>(the_end - the_next) < sizeof(the_length))
+        the_argument.tag = 0;
+      else
+      { // begin
+        std::memcpy(&the_length, the_next, sizeof(the_length));
+        the_next += sizeof(the_length);
+
+        if (static_cast<std::size_t>(the_end - the_next) < the_length)
+          the_length = static_cast<std::uint16_t>(the_end - the_next);
+
+        the_argument.string = the_next;
+        the_argument.string_length = the_length;
+        the_next += the_length;
+      } // else
+    } // if then
+    else if (static_cast<std::size_t>(the_end - the_next) < sizeof(the_argument.bits))
+      the_argument.tag = 0;
+    else
+    { // begin
+      std::memcpy(&the_argument.bits, the_next, sizeof(the_argument.bits));
+      the_next += sizeof(the_argument.bits);
+    } // else
+
+    return the_argument;
+  } // Next_Argument
+
+  std::int64_t  As_Signed (const Decoded_Argument   &the_argument) noexcept
+  { // begin
+    double  the_real = 0.0;
+
+    if (the_argument.tag != Log_Arguments::Real_Tag)
+      return static_cast<std::int64_t>(the_argument.bits);
+
+    std::memcpy(&the_real, &the_argument.bits, sizeof(the_real));
+
+    return static_cast<std::int64_t>(the_real);
+  } // As_Signed
+
+  double  As_Real (const Decoded_Argument   &the_argument) noexcept
+  { // begin
+    double  the_real = 0.0;
+
+    if (the_argument.tag == Log_Arguments::Signed_Tag)
+      return static_cast<double>(static_cast<std::int64_t>(the_argument.bits));
+    else if (the_argument.tag != Log_Arguments::Real_Tag)
+      return static_cast<double>(the_argument.bits);
+
+    std::memcpy(&the_real, &the_argument.bits, sizeof(the_real));
+
+    return the_real;
+  } // As_Real
+
+  const char          *Conversions = "diuoxXceEfFgGaAsp"; /**< anything else is not a conversion - it takes no argument and is printed as it is */
+  const std::int64_t  Max_Star_Value = 256; /**< a '*' width or precision is clamped to +/- this */
+  const std::size_t   Max_Field_Length = 10; /**< flags, width and precision each keep at most this many characters */
+
+  /**
+   * @brief Append a width or precision to the_specification - a '*' takes its value from the next argument.
+   * @param the_field - IN - the digits, or "*"
+   * @param the_field_length - IN
+   * @param is_precision - IN - a negative '*' precision is left out, a negative '*' width left-justifies
+   * @return \b false when the '*' argument is missing
+   */
+  bool  Put_Field (const char     *the_field,
+                   std::size_t    the_field_length,
+                   bool           is_precision,
+                   const char     *&the_next,
+                   const char     *the_end,
+                   char           *the_specification,
+                   std::size_t    &the_spec_length) noexcept
+  { // begin
+    std::int64_t  the_value = 0;
+
+    if ((the_field_length != 1) || (*the_field != '*'))
+    { // begin - as written
+      if (is_precision == true)
+        the_specification [the_spec_length++] = '.';
+
+      for (std::size_t the_offset = 0; (the_offset < the_field_length) && (the_offset < Max_Field_Length); the_offset++)
+        the_specification [the_spec_length++] = the_field [the_offset];
+
+      return true;
+    } // if then
+
+    Decoded_Argument  the_argument = Next_Argument(the_next, the_end);
+
+    if (the_argument.tag == 0)
+      return false;
+
+    the_value = As_Signed(the_argument); // a string is zero
+
+    if (the_value > Max_Star_Value)
+      the_value = Max_Star_Value;
+    else if (the_value < -Max_Star_Value)
+      the_value = -Max_Star_Value;
+
+    if ((is_precision == true) && (the_value < 0))
+      return true; // as if there were no precision
+
+    the_spec_length += static_cast<std::size_t>(std::snprintf(the_specification + the_spec_length, 8, (is_precision == true) ? ".%lld" : "%lld", static_cast<long long>(the_value)));
+
+    return true;
+  } // Put_Field
+} // namespace
+
+/**
+ * @brief Give the_format an id - called once per A4_Log_Event call site.
+ * @param the_format - IN - static, kept by address
+ * @return the id - 0 when Max_Formats call sites are registered already
+ */
+std::uint32_t   Log_Format_Registry::Register (const char   *the_format) noexcept
+{ // begin
+  std::uint32_t   the_format_id = the_next_format_id.fetch_add(1, std::memory_order_relaxed);
+
+  if ((the_format == nullptr) || (the_format_id >= Binary_Log_Constant::Max_Formats))
+    return 0;
+
+  the_formats [the_format_id].store(the_format, std::memory_order_release);
+
+  return the_format_id;
+} // Register
+
+/**
+ * @param the_format_id - IN - from Register
+ * @return the format string - nullptr for an unknown id
+ */
+const char  *Log_Format_Registry::Get_Format (std::uint32_t   the_format_id) noexcept
+{ // begin
+  if ((the_format_id == 0) || (the_format_id >= Binary_Log_Constant::Max_Formats))
+    return nullptr;
+
+  return the_formats [the_format_id].load(std::memory_order_acquire);
+} // Get_Format
+
+/**
+ * @brief printf the_format with the encoded arguments - each conversion takes the next argument, whatever its length
+ *        modifier, converted to the type the conversion needs. A '*' width or precision takes an argument first, as printf
+ *        does - an unknown conversion takes none and is printed as it is. Tools/A4_Log_Decode.py must do the same.
+ * @param the_format - IN
+ * @param the_arguments - IN - from Encode
+ * @param the_length - IN - bytes
+ * @param the_text - OUT - the formatted event is appended
+ */
+Error_Code  Log_Arguments::Format (const char    *the_format,
+                                   const char    *the_arguments,
+                                   std::size_t   the_length,
+                                   std::string   &the_text)
+{ // begin
+  const char  *the_next = the_arguments;
+  const char  *the_end = the_arguments + the_length;
+  const char  *the_cursor = the_format;
+
+  char        the_specification [64]; // % flags width .precision ll conversion
+  char        the_buffer [512];
+
+  Method_State_Block_Begin(1)
+    State(1)
+      while ((the_cursor != nullptr) && (*the_cursor != '\0'))
+      { // begin
+        const char  *the_percent = std::strchr(the_cursor, '%');
+        const char  *the_flags = nullptr;
+        const char  *the_width = nullptr;
+        const char  *the_precision = nullptr; // nullptr - none
+        std::size_t the_flags_length = 0;
+        std::size_t the_width_length = 0;
+        std::size_t the_precision_length = 0;
+        std::size_t the_spec_length = 1;
+        int         the_printed = 0;
+        char        the_conversion = '\0';
+
+        if (the_percent == nullptr)
+        { // begin - the rest is literal
+          the_text += the_cursor;
+          break;
+        } // if then
+
+        the_text.append(the_cursor, static_cast<std::size_t>(the_percent - the_cursor));
+        the_cursor = the_percent + 1;
+
+        if (*the_cursor == '%')
+        { // begin
+          the_text += '%';
+          the_cursor += 1;
+          continue;
+        } // if then
+
+        // the whole specification is read before any argument is taken
+        for (the_flags = the_cursor; (*the_cursor != '\0') && (std::strchr("-+ #0", *the_cursor) != nullptr); the_cursor++)
+          the_flags_length += 1;
+
+        for (the_width = the_cursor; (*the_cursor != '\0') && ((std::isdigit(static_cast<unsigned char>(*the_cursor)) != 0) || ((*the_cursor == '*') && (the_cursor == the_width))); the_cursor++)
+          the_width_length += 1;
+
+        if (*the_cursor == '.')
+          for (the_precision = ++the_cursor; (*the_cursor != '\0') && ((std::isdigit(static_cast<unsigned char>(*the_cursor)) != 0) || ((*the_cursor == '*') && (the_cursor == the_precision))); the_cursor++)
+            the_precision_length += 1;
+
+        while ((*the_cursor != '\0') && (std::strchr("hlLqjzt", *the_cursor) != nullptr))
+          the_cursor += 1; // the argument is 64 bits whatever the modifier says
+
+        if ((the_conversion = *the_cursor) != '\0')
+          the_cursor += 1;
+
+        if ((the_conversion == '\0') || (std::strchr(Conversions, the_conversion) == nullptr) ||
+            ((the_width_length > 1) && (std::memchr(the_width, '*', the_width_length) != nullptr)) ||
+            ((the_precision_length > 1) && (std::memchr(the_precision, '*', the_precision_length) != nullptr)))
+        { // begin - not a conversion - it takes no argument
+          the_text.append(the_percent, static_cast<std::size_t>(the_cursor - the_percent));
+          continue;
+        } // if then
+
+        the_specification [0] = '%';
+
+        for (std::size_t the_offset = 0; (the_offset < the_flags_length) && (the_offset < Max_Field_Length); the_offset++)
+          the_specification [the_spec_length++] = the_flags [the_offset];
+
+        if ((Put_Field(the_width, the_width_length, false, the_next, the_end, the_specification, the_spec_length) == false) ||
+            ((the_precision != nullptr) && (Put_Field(the_precision, the_precision_length, true, the_next, the_end, the_specification, the_spec_length) == false)))
+        { // begin
+          the_text += "(missing)";
+          continue;
+        } // if then
+
+        Decoded_Argument  the_argument = Next_Argument(the_next, the_end);
+
+        if (the_argument.tag == 0)
+        { // begin
+          the_text += "(missing)";
+          continue;
+        } // if then
+
+        switch (the_conversion)
+        { // begin
+          case 'd':
+          case 'i':
+            std::memcpy(the_specification + the_spec_length, "lld", 4);
+            the_printed = std::snprintf(the_buffer, sizeof(the_buffer), the_specification, static_cast<long long>(As_Signed(the_argument)));
+          break;
+
+          case 'u':
+          case 'o':
+          case 'x':
+          case 'X':
+            the_specification [the_spec_length] = 'l';
+            the_specification [the_spec_length + 1] = 'l';
+            the_specification [the_spec_length + 2] = the_conversion;
+            the_specification [the_spec_length + 3] = '\0';
+            the_printed = std::snprintf(the_buffer, sizeof(the_buffer), the_specification, static_cast<unsigned long long>(As_Signed(the_argument)));
+          break;
+
+          case 'c':
+            std::memcpy(the_specification + the_spec_length, "c", 2);
+            the_printed = std::snprintf(the_buffer, sizeof(the_buffer), the_specification, static_cast<int>(As_Signed(the_argument)));
+          break;
+
+          case 'e':
+          case 'E':
+          case 'f':
+          case 'F':
+          case 'g':
+          case 'G':
+          case 'a':
+          case 'A':
+            the_specification [the_spec_length] = the_conversion;
+            the_specification [the_spec_length + 1] = '\0';
+            the_printed = std::snprintf(the_buffer, sizeof(the_buffer), the_specification, As_Real(the_argument));
+          break;
+
+          case 's':
+            if (the_argument.tag != String_Tag)
+              the_text += "(not a string)";
+            else if (the_spec_length == 1)
+              the_text.append(the_argument.string, the_argument.string_length);
+            else
+            { // begin - width or precision
+              std::string   the_string (the_argument.string, the_argument.string_length);
+
+              std::memcpy(the_specification + the_spec_length, "s", 2);
+              the_printed = std::snprintf(the_buffer, sizeof(the_buffer), the_specification, the_string.c_str());
+            } // else
+          break;
+
+          case 'p':
+            the_printed = std::snprintf(the_buffer, sizeof(the_buffer), "0x%llx", static_cast<unsigned long long>(the_argument.bits));
+          break;
+
+          default: // Conversions lists the cases above
+          break;
+        } // switch
+
+        if (the_printed > 0)
+          the_text.append(the_buffer, (static_cast<std::size_t>(the_printed) < sizeof(the_buffer)) ? static_cast<std::size_t>(the_printed) : (sizeof(the_buffer) - 1));
+      } // while
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Format
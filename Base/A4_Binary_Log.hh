@@ -0,0 +1,197 @@
+#ifndef __A4_Binary_Log_Defined__
+#define __A4_Binary_Log_Defined__
+/**
+ * @brief   Deferred-format log events - format string ids and the argument encoding.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Binary_Log.hh
+ * @note  A4_Log_Event (A4_File_Logger.hh) registers its format string once per call site and stages only the format id,
+ *        a timestamp and the encoded arguments - no printf on the calling thread:
+ *
+ *          A4_Log_Event(A4_Lib::Logging::Info, "order %llu filled at %.2f for %s", the_order_id, the_price, the_account);
+ *
+ *        The File_Logger worker formats the event into the text log, or - after File_Logger::Set_Binary_Mode(true) - writes
+ *        it to a binary log file as it is, for Tools/A4_Log_Decode.py to format offline.
+ *
+ *        Each argument is a tag byte and its value: integers as 64 bits, floating point as a double, strings (const char *,
+ *        char arrays, std::string) as a 16 bit length and the characters, pointers as 64 bits. Length modifiers in the format
+ *        are ignored - the encoded argument decides. A '*' width or precision takes an argument, as printf does; an unknown
+ *        conversion takes none and is printed as it is. Arguments beyond Max_Argument_Bytes are left out and print as (missing).
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Binary_Log_Constant
+  { // begin
+    static const std::size_t  Max_Formats = 16384; /**< distinct A4_Log_Event call sites */
+    static const std::size_t  Max_Argument_Bytes = 1024; /**< encoded arguments of one event */
+    static const char         File_Magic [8] = {'A', '4', 'B', 'L', 'O', 'G', '0', '1'}; /**< the first bytes of a binary log file */
+  } // namespace Binary_Log_Constant
+
+  /**
+   * @brief The format strings of the A4_Log_Event call sites - ids are never reused.
+   */
+  typedef class Log_Format_Registry
+  { // begin
+  public: // methods
+    A4_Export static std::uint32_t  Register (const char  *the_format) noexcept; // the_format must be static - returns 0 when the registry is full
+    A4_Export static const char     *Get_Format (std::uint32_t  the_format_id) noexcept; // nullptr for an unknown id
+  } Log_Format_Registry;
+
+  namespace Log_Arguments
+  { // begin
+    enum Argument_Tag : char
+    { // begin
+      Signed_Tag    = 'i',
+      Unsigned_Tag  = 'u',
+      Real_Tag      = 'd',
+      String_Tag    = 's',
+      Pointer_Tag   = 'p',
+    }; // Argument_Tag
+
+    /**
+     * @brief Where the next argument goes.
+     */
+    typedef struct Encoder
+    { // begin
+      char  *next;
+      char  *end;
+    } Encoder;
+
+    inline void   Put_Value (Encoder        &the_encoder,
+                             Argument_Tag   the_tag,
+                             const void     *the_value,
+                             std::size_t    the_length) noexcept
+    { // begin
+      if (static_cast<std::size_t>(the_encoder.end - the_encoder.next) < (the_length + 1))
+      { // begin - no room - this and every later argument are left out
+        the_encoder.end = the_encoder.next;
+        return;
+      } // if then
+
+      *the_encoder.next = the_tag;
+      std::memcpy(the_encoder.next + 1, the_value, the_length);
+      the_encoder.next += the_length + 1;
+    } // Put_Value
+
+    inline void   Put_String (Encoder       &the_encoder,
+                              const char    *the_string,
+                              std::size_t   the_length) noexcept
+    { // begin
+      std::size_t     the_room = static_cast<std::size_t>(the_encoder.end - the_encoder.next);
+      std::uint16_t   the_stored_length = 0;
+
+      if (the_room < (1 + sizeof(the_stored_length)))
+      { // begin
+        the_encoder.end = the_encoder.next;
+        return;
+      } // if then
+
+      if (the_length > (the_room - 1 - sizeof(the_stored_length)))
+        the_length = the_room - 1 - sizeof(the_stored_length); // truncated
+
+      if (the_length > UINT16_MAX)
+        the_length = UINT16_MAX;
+
+      the_stored_length = static_cast<std::uint16_t>(the_length);
+
+      Put_Value(the_encoder, String_Tag, &the_stored_length, sizeof(the_stored_length));
+      std::memcpy(the_encoder.next, the_string, the_length);
+      the_encoder.next += the_length;
+    } // Put_String
+
+    template <typename The_Arg> inline void   Put (Encoder         &the_encoder,
+                                                   const The_Arg   &the_arg) noexcept
+    { // begin
+      if constexpr (std::is_convertible<const The_Arg &, const char *>::value == true)
+      { // begin - string literals, char arrays and pointers
+        const char  *the_string = the_arg;
+
+        if (the_string == nullptr)
+          the_string = "(null)";
+
+        Put_String(the_encoder, the_string, std::strlen(the_string));
+      } // if then
+      else if constexpr (std::is_same<The_Arg, std::string>::value == true)
+        Put_String(the_encoder, the_arg.data(), the_arg.length());
+      else if constexpr (std::is_floating_point<The_Arg>::value == true)
+      { // begin
+        double  the_value = static_cast<double>(the_arg);
+
+        Put_Value(the_encoder, Real_Tag, &the_value, sizeof(the_value));
+      } // if then
+      else if constexpr ((std::is_integral<The_Arg>::value == true) && (std::is_signed<The_Arg>::value == true))
+      { // begin
+        std::int64_t  the_value = static_cast<std::int64_t>(the_arg);
+
+        Put_Value(the_encoder, Signed_Tag, &the_value, sizeof(the_value));
+      } // if then
+      else if constexpr ((std::is_integral<The_Arg>::value == true) || (std::is_enum<The_Arg>::value == true))
+      { // begin
+        std::uint64_t   the_value = static_cast<std::uint64_t>(the_arg);
+
+        Put_Value(the_encoder, Unsigned_Tag, &the_value, sizeof(the_value));
+      } // if then
+      else
+      { // begin
+        static_assert(std::is_pointer<The_Arg>::value == true, "A4_Log_Event arguments are numbers, strings or pointers");
+
+        std::uint64_t   the_value = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(the_arg));
+
+        Put_Value(the_encoder, Pointer_Tag, &the_value, sizeof(the_value));
+      } // else
+    } // Put
+
+    /**
+     * @brief Encode the_args into the_buffer.
+     * @return the number of bytes used
+     */
+    template <typename... The_Args> inline std::size_t  Encode (char                *the_buffer,
+                                                                std::size_t         the_size,
+                                                                const The_Args &... the_args) noexcept
+    { // begin
+      Encoder   the_encoder = {the_buffer, the_buffer + the_size};
+
+      (Put(the_encoder, the_args), ...);
+
+      return static_cast<std::size_t>(the_encoder.next - the_buffer);
+    } // Encode
+
+    A4_Export Error_Code  Format (const char    *the_format,
+                                  const char    *the_arguments,
+                                  std::size_t   the_length,
+                                  std::string   &the_text); // appends the formatted event to the_text
+  } // namespace Log_Arguments
+} // namespace A4_Lib
+
+#endif // __A4_Binary_Log_Defined__
@@ -0,0 +1,428 @@
+/**
+ * @brief   Composite logger implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Composite_Logger.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Composite_Logger.hh"
+#include "A4_Method_State_Block.hh"
+#include "A4_Utils.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief The record timestamp - the system clock, as the File_Logger's.
+   */
+  inline std::int64_t   Epoch_Nano_Seconds (void) noexcept
+  { // begin
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+  } // Epoch_Nano_Seconds
+} // namespace
+
+/**
+ * @brief default constructor
+ */
+Composite_Logger::Composite_Logger (void)
+{ // begin
+  this->sequence_number = 0;
+} // constructor
+
+/**
+ * @brief default destructor - the sinks opened here are closed
+ */
+Composite_Logger::~Composite_Logger (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Allocate a new singleton instance and assign the address to the member pointer.
+ * @return No_Error, AS_Already_Allocated, AS_Allocation_Error
+ */
+Error_Code  Composite_Logger::Allocate_Singleton (void)
+{ // begin
+  std::shared_ptr<Composite_Logger>   the_new_instance;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if (Logger::Instance() != nullptr)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, AS_Already_Allocated, "The logging singleton has already been allocated.");
+    End_State
+
+    State(2)
+      the_new_instance = std::make_shared<Composite_Logger>();
+
+      if (the_new_instance == nullptr)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, AS_Allocation_Error, "Memory allocation error - could not allocate a new A4_Lib::Composite_Logger instance.");
+      else the_method_error = the_new_instance->Set_Instance_Pointer(the_new_instance);
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_new_instance != nullptr)
+      the_new_instance.reset();
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Allocate_Singleton
+
+/**
+ * @brief The singleton as a Composite_Logger - for Add_Sink & Open.
+ * @return nullptr when no singleton was allocated, or another Logger was
+ */
+Composite_Logger::Pointer  Composite_Logger::Instance (void)
+{ // begin
+  return std::dynamic_pointer_cast<Composite_Logger>(Logger::Instance());
+} // Instance
+
+/**
+ * @brief Add a destination - its detail level & queue size are set on the sink itself.
+ * @param the_sink - IN - set up, open or not - Open opens it when it is not
+ * @return No_Error, ASI_Invalid_Sink, ASI_Already_Open, ASI_Too_Many_Sinks
+ */
+Error_Code  Composite_Logger::Add_Sink (Log_Sink::Pointer  the_sink)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (the_sink == nullptr)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, ASI_Invalid_Sink, "Invalid parameter address - the_sink is nullptr.");
+      else if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, ASI_Already_Open, "Invalid state - sinks are added before Open.");
+      else if (this->sinks.size() >= Composite_Logger_Constant::Max_Sinks)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, ASI_Too_Many_Sinks, "Invalid state - Composite_Logger_Constant::Max_Sinks have been added.");
+      else { // begin
+        this->sinks.push_back(the_sink);
+        this->is_opened_here.push_back(false);
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Add_Sink
+
+/**
+ * @brief Open the sinks that are not open yet, then start taking log lines.
+ * @param the_detail_level - IN - the Logger detail level - the most detailed level any sink takes
+ * @return No_Error, O_No_Sinks or a Log_Sink / Logger error - the sinks opened here are closed again
+ */
+Error_Code  Composite_Logger::Open (Logging::Detail  the_detail_level)
+{ // begin
+  std::size_t   the_index = 0;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Logger_Base_Module_ID, O_Already_Open, "Instance is already open.");
+      else if (this->sinks.empty() == true)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, O_No_Sinks, "Invalid state - Add_Sink was not called.");
+      else this->Set_Detail_Level(the_detail_level);
+    End_State
+
+    State(2)
+      for (the_index = 0; (the_index < this->sinks.size()) && (the_method_error == No_Error); the_index++)
+      { // begin
+        if (this->sinks [the_index]->Is_Open() != true)
+        { // begin
+          the_method_error = this->sinks [the_index]->Open();
+          this->is_opened_here [the_index] = (the_method_error == No_Error);
+        } // if then
+      } // for
+    End_State
+
+    State(3)
+      the_method_error = this->Logger::Open();
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_method_error != No_Error)
+    { // begin
+      for (the_index = 0; the_index < this->sinks.size(); the_index++)
+      { // begin
+        if (this->is_opened_here [the_index] == true)
+          (void) this->sinks [the_index]->Close();
+
+        this->is_opened_here [the_index] = false;
+      } // for
+    } // if then
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Open
+
+/**
+ * @brief Stop taking log lines, then close the sinks Open opened - each delivers its queue first.
+ * @return No_Error or a Logger / Log_Sink error
+ */
+Error_Code  Composite_Logger::Close (void)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      the_method_error = this->Logger::Close();
+    End_State
+
+    State(2)
+      for (std::size_t the_index = 0; the_index < this->sinks.size(); the_index++)
+      { // a sink that fails to close does not keep the others open
+        if (this->is_opened_here [the_index] == true)
+        { // begin
+          Error_Code  the_error = this->sinks [the_index]->Close();
+
+          if (the_method_error == No_Error)
+            the_method_error = the_error;
+        } // if then
+
+        this->is_opened_here [the_index] = false;
+      } // for
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Close
+
+/**
+ * @brief Generic write method - used in the End_Method_State_Block macro
+ * @param the_log_text - IN
+ * @param the_calling_function_name - IN
+ * @param the_error - IN
+ * @param the_state - IN
+ * @param the_message_detail_level - IN
+ * @param the_nano_seconds - IN - when the error happened, nano-seconds since the system clock epoch - 0 means now
+ * @return No_Error upon success.
+ */
+Error_Code  Composite_Logger::Write (std::string       the_log_text,
+                                     std::string       the_calling_function_name,
+                                     Error_Code        the_error,
+                                     Method_State      the_state,
+                                     Logging::Detail   the_message_detail_level,
+                                     std::int64_t      the_nano_seconds)
+{ // begin
+  std::string   the_formatted_log_text;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if ((Is_Enabled(the_message_detail_level, A4_Error::Get_Module_ID(the_error)) != true) || (this->Is_Open() != true)) // filtered by the module that raised the_error
+        Terminate_The_Method_Block; // message doesn't need logging
+      else the_method_error = A4_Lib::SNPrintf (the_formatted_log_text, "%s - Error Code %1.5f returned from %s at machine state %d",
+                                                Max_Error_Message_Length,
+                                                the_log_text.c_str(), A4_Error::Get_Dot_Error_Code(the_error), the_calling_function_name.c_str(), static_cast<int>(the_state));
+    End_State
+
+    State(2)
+      the_method_error = this->Fan_Out (the_formatted_log_text, the_message_detail_level, A4_Error::Get_Module_ID(the_error), the_nano_seconds);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Write
+
+/**
+ * @brief Write a log entry without formatting it.
+ * @param the_log_text - IN
+ * @param the_message_detail_level - IN
+ * @return No_Error, W2_Invalid_Text_Length
+ */
+Error_Code  Composite_Logger::Write (std::string       the_log_text,
+                                     Logging::Detail   the_message_detail_level)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_log_text.length() < 1)
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, W2_Invalid_Text_Length, "Invalid parameter length - the_log_text is empty.");
+    End_State
+
+    State(2)
+      if ((Is_Enabled(the_message_detail_level) != true) || (this->Is_Open() != true))
+        Terminate_The_Method_Block; // message doesn't need logging
+      else the_method_error = this->Fan_Out (the_log_text, the_message_detail_level, 0);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Write
+
+/**
+ * @brief Write a log entry that contains a variable number of arguments.
+ * @param the_message_detail_level - IN
+ * @param the_log_text - IN - the printf style format
+ * @param ... - IN - the variable list to be used
+ * @return No_Error, W3_Invalid_Text_Length
+ */
+Error_Code  Composite_Logger::Write (Logging::Detail   the_message_detail_level,
+                                     const char        *the_log_text,
+                                     ...)
+{ // begin
+  std::string   the_formatted_text;
+
+  va_list the_va_list;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if ((the_log_text == nullptr) || (the_log_text [0] == '\0'))
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, W3_Invalid_Text_Length, "Invalid parameter length - the_log_text is empty.");
+    End_State
+
+    State(2)
+      if ((Is_Enabled(the_message_detail_level) != true) || (this->Is_Open() != true))
+        Terminate_The_Method_Block; // message doesn't need logging
+      else { // format the_log_text
+        va_start (the_va_list, the_log_text);
+          the_method_error = A4_Lib::SNPrintf (the_formatted_text, the_log_text, A4_Lib::Max_Error_Message_Length, the_va_list);
+        va_end (the_va_list);
+      } // if else
+    End_State
+
+    State(3)
+      the_method_error = this->Fan_Out (the_formatted_text, the_message_detail_level, 0);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Write (variadic)
+
+/**
+ * @brief Write a formatted log entry at the detail level set for the_module_id - see A4_Module_Log.
+ * @param the_module_id - IN
+ * @param the_message_detail_level - IN
+ * @param the_log_text - IN - the printf style format
+ * @param ... - IN - the variable list to be used
+ * @return No_Error, W4_Invalid_Text_Length
+ */
+Error_Code  Composite_Logger::Write (Module_ID         the_module_id,
+                                     Logging::Detail   the_message_detail_level,
+                                     const char        *the_log_text,
+                                     ...)
+{ // begin
+  std::string   the_formatted_text;
+
+  va_list the_va_list;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if ((the_log_text == nullptr) || (the_log_text [0] == '\0'))
+        the_method_error = A4_Error (A4_Composite_Logger_Module_ID, W4_Invalid_Text_Length, "Invalid parameter length - the_log_text is NULL or empty.");
+    End_State
+
+    State(2)
+      if ((Is_Enabled(the_message_detail_level, the_module_id) != true) || (this->Is_Open() != true))
+        Terminate_The_Method_Block; // message doesn't need logging
+      else { // format the_log_text
+        va_start (the_va_list, the_log_text);
+          the_method_error = A4_Lib::SNPrintf (the_formatted_text, the_log_text, A4_Lib::Max_Error_Message_Length, the_va_list);
+        va_end (the_va_list);
+      } // if else
+    End_State
+
+    State(3)
+      the_method_error = this->Fan_Out (the_formatted_text, the_message_detail_level, the_module_id);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Write (module)
+
+/**
+ * @brief Format the log line once - the File_Logger's text line - and submit the one record to each sink that takes
+ *        the_message_detail_level.
+ * @param the_log_text - IN
+ * @param the_message_detail_level - IN
+ * @param the_module_id - IN - 0 when not known
+ * @param the_nano_seconds - IN - the record timestamp, nano-seconds since the system clock epoch - 0 means now
+ * @return No_Error, FO_Allocation_Error
+ * \note  No sink waits on another - Log_Sink::Submit drops into a full queue. A line logged on a sink's own drain - a
+ *        failure beneath its Deliver - skips that sink. A failed allocation is returned, not logged - the error line
+ *        would come straight back here.
+ */
+Error_Code  Composite_Logger::Fan_Out (const std::string  &the_log_text,
+                                       Logging::Detail    the_message_detail_level,
+                                       Module_ID          the_module_id,
+                                       std::int64_t       the_nano_seconds)
+{ // begin
+  std::shared_ptr<Log_Sink_Record>  the_record;
+  char                              the_timestamp [Timestamp_Constant::Max_Timestamp_Length];
+  std::size_t                       the_timestamp_length = 0;
+  char                              the_prefix [128];
+  int                               the_length = 0;
+
+  bool  is_wanted = false;
+
+  for (const Log_Sink::Pointer &the_sink : this->sinks)
+    is_wanted = (is_wanted == true) || ((the_sink->Is_Enabled(the_message_detail_level) == true) && (the_sink->Is_Draining_Here() != true));
+
+  if (is_wanted != true)
+    return No_Error; // no sink keeps this level - nothing is formatted
+
+  try
+  { // begin
+    the_record = std::make_shared<Log_Sink_Record>();
+
+    the_record->detail = the_message_detail_level;
+    the_record->module_id = the_module_id;
+    the_record->sequence = this->sequence_number.fetch_add(1); // atomic increment the log sequence
+    the_record->nano_seconds = (the_nano_seconds != 0) ? the_nano_seconds : Epoch_Nano_Seconds();
+
+    if (A4_Lib::Timestamp_String (the_record->nano_seconds, the_timestamp, sizeof(the_timestamp), the_timestamp_length) != No_Error)
+      the_timestamp [0] = '\0'; // the line still goes out
+
+    if (the_message_detail_level == Logging::Content_Dump)
+      the_length = std::snprintf (the_prefix, sizeof(the_prefix), "%lld: ", static_cast<long long>(the_record->sequence));
+    else the_length = std::snprintf (the_prefix, sizeof(the_prefix), "%s (%06jd) %s - ",
+                                     Get_Detail_Level_Name(the_message_detail_level), static_cast<std::intmax_t>(the_record->sequence), the_timestamp);
+
+    the_record->message_offset = (the_length > 0) ? std::min(static_cast<std::size_t>(the_length), sizeof(the_prefix) - 1) : 0;
+
+    the_record->line.reserve(the_record->message_offset + the_log_text.length() + 2);
+    the_record->line.assign(the_prefix, the_record->message_offset);
+    the_record->line.append(the_log_text, 0, Composite_Logger_Constant::Max_Line_Length - the_record->message_offset - 2);
+
+    if (the_message_detail_level != Logging::Content_Dump)
+      the_record->line += "\r\n";
+  } // try
+  catch (...)
+  { // begin
+    return A4_Error::Make_Error_Code(A4_Composite_Logger_Module_ID, FO_Allocation_Error);
+  } // catch
+
+  Log_Sink_Record::Pointer  the_shared_record (std::move(the_record));
+
+  for (const Log_Sink::Pointer &the_sink : this->sinks)
+    if ((the_sink->Is_Enabled(the_message_detail_level) == true) && (the_sink->Is_Draining_Here() != true)) // not back into the sink that failed
+      (void) the_sink->Submit(the_shared_record);
+
+  return No_Error;
+} // Fan_Out
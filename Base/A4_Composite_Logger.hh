@@ -0,0 +1,129 @@
+#ifndef __A4_Composite_Logger_Defined__
+#define __A4_Composite_Logger_Defined__
+/**
+ * @brief   A Logger singleton that formats each line once and fans it out to several Log_Sinks.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Composite_Logger.hh
+ * @note  Allocate_Singleton, Add_Sink for each destination - a File_Log_Sink, a Memory_Log_Sink, a UDP_Log_Sink - then
+ *        Open. The writing thread formats the line - as the File_Logger does in text mode - into one shared record and
+ *        submits it to every sink whose own detail level takes it. Each sink delivers on worker threads of its own,
+ *        from a bounded queue that drops once it is full, so a sink that falls behind never holds up the writing
+ *        thread or the other sinks.
+ *
+ *        The Logger detail level is the first gate - Logger::Is_Enabled, the A4_Log macros and the module levels all
+ *        apply before a line is formatted. Set it to the most detailed level any sink wants, and each sink's
+ *        Set_Detail_Level to what it keeps.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Logger.hh"
+#include "A4_Log_Sink.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#endif // A4_DotNet
+
+#define A4_Composite_Log  A4_Lib::Composite_Logger::Instance()
+
+namespace A4_Lib
+{ // begin
+  namespace Composite_Logger_Constant
+  { // begin
+    static const std::size_t  Max_Sinks = 16;
+    static const std::size_t  Max_Line_Length = A4_Lib::Max_Error_Message_Length + 128; /**< as File_Logger_Constants::Max_Record_Length */
+  } // namespace Composite_Logger_Constant
+
+  typedef class Composite_Logger : public A4_Lib::Logger
+  { // begin
+    public: // construction
+      Composite_Logger (void);
+      Composite_Logger (Composite_Logger &) = delete;
+      virtual ~Composite_Logger (void);
+
+    public: // types
+      typedef std::shared_ptr<Composite_Logger>   Pointer;
+
+    public: // methods
+      static Error_Code   Allocate_Singleton (void); // allocate a new singleton instance
+      static Pointer      Instance (void); // nullptr unless the singleton is a Composite_Logger
+
+      A4_Export Error_Code  Add_Sink (Log_Sink::Pointer  the_sink); // before Open - a sink that is not open yet is opened by Open
+
+      A4_Export Error_Code  Open (Logging::Detail  the_detail_level); // the sinks first
+      A4_Export virtual Error_Code  Close (void) override; // the sinks deliver what they hold, each for up to Log_Sink_Constant::Max_Shutdown_Wait
+
+      A4_Export std::size_t   Get_Num_Sinks (void) const {return this->sinks.size();};
+
+      A4_Export virtual Error_Code  Write (std::string       the_log_text,
+                                           std::string       the_calling_function_name,
+                                           Error_Code        the_error,
+                                           Method_State      the_state,
+                                           Logging::Detail   the_message_detail_level,
+                                           std::int64_t      the_nano_seconds = 0) override;
+
+      A4_Export virtual Error_Code  Write (std::string       the_log_text,
+                                           Logging::Detail   the_message_detail_level) override;
+
+      A4_Export virtual Error_Code  Write (Logging::Detail   the_message_detail_level,
+                                           const char        *the_log_text,
+                                           ...) override;
+
+      A4_Export virtual Error_Code  Write (Module_ID         the_module_id,
+                                           Logging::Detail   the_message_detail_level,
+                                           const char        *the_log_text,
+                                           ...) override;
+
+    private: // methods
+      Error_Code  Fan_Out (const std::string  &the_log_text,
+                           Logging::Detail    the_message_detail_level,
+                           Module_ID          the_module_id,
+                           std::int64_t       the_nano_seconds = 0); // format the record once and submit it to the sinks that take it
+
+    private: // data
+      std::vector<Log_Sink::Pointer>  sinks; /**< set before Open - read without a lock afterwards */
+      std::vector<bool>               is_opened_here; /**< per sink - Open opened it, Close closes it */
+      std::atomic_int_fast64_t        sequence_number; /**< unique number for each log entry */
+
+    public: // errors
+      enum Composite_Logger_Errors /**< Errors unique to Composite_Logger */
+      { // begin
+        AS_Already_Allocated    = 0, /**< \b Allocate_Singleton: The logging singleton has already been allocated. */
+        AS_Allocation_Error     = 1, /**< \b Allocate_Singleton: Memory allocation error - could not allocate a new A4_Lib::Composite_Logger instance. */
+        ASI_Invalid_Sink        = 2, /**< \b Add_Sink: Invalid parameter address - the_sink is nullptr. */
+        ASI_Already_Open        = 3, /**< \b Add_Sink: Invalid state - sinks are added before Open. */
+        ASI_Too_Many_Sinks      = 4, /**< \b Add_Sink: Invalid state - Composite_Logger_Constant::Max_Sinks have been added. */
+        O_No_Sinks              = 5, /**< \b Open: Invalid state - Add_Sink was not called. */
+        W2_Invalid_Text_Length  = 6, /**< \b Write (2-parameter): Invalid parameter length - the_log_text is empty. */
+        W3_Invalid_Text_Length  = 7, /**< \b Write (variadic): Invalid parameter length - the_log_text is empty. */
+        W4_Invalid_Text_Length  = 8, /**< \b Write (module): Invalid parameter length - the_log_text is NULL or empty. */
+        FO_Allocation_Error     = 9, /**< \b Fan_Out: Memory allocation error - could not allocate the Log_Sink_Record. */
+      }; // Composite_Logger_Errors
+  } Composite_Logger;
+} // namespace A4_Lib
+
+#endif // __A4_Composite_Logger_Defined__
@@ -0,0 +1,369 @@
+/**
+ * @brief   Coroutine Active Object implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Coroutine_Active_Object.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Coroutine_Active_Object.hh"
+
+#ifdef A4_Lib_Coroutines
+#include "A4_Method_State_Block.hh"
+#include "A4_Utils.hh"
+
+#include <chrono>
+#include <condition_variable>
+#include <algorithm>
+#include <map>
+#include <thread>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin - the timer service is private to this translation unit
+  /**
+   * @brief One thread shared by every Coroutine_Active_Object - resumes timed-out handlers through their owner.
+   */
+  class Timer_Service
+  { // begin
+  public: // construction
+    Timer_Service(void) : is_running(true), timer_thread(&Timer_Service::Timer_Thread_Method, this) {};
+
+    ~Timer_Service(void)
+    { // begin
+      A4_Cleanup_Begin
+        { // begin
+          std::lock_guard<std::mutex>   the_lock(this->timer_mutex);
+
+          this->is_running = false;
+          this->timer_condition.notify_one();
+        } // end
+
+        if (this->timer_thread.joinable() == true)
+          this->timer_thread.join();
+      A4_End_Cleanup
+    } // destructor
+
+  public: // methods
+    static Timer_Service &  Instance (void)
+    { // begin
+      static Timer_Service  the_instance; // started on first use
+
+      return the_instance;
+    } // Instance
+
+    void  Add (std::chrono::steady_clock::time_point  the_deadline,
+               Coroutine_Active_Object                *the_owner,
+               std::coroutine_handle<>                the_handle)
+    { // begin
+      std::lock_guard<std::mutex>   the_lock(this->timer_mutex);
+
+      bool  is_earliest = ((this->timers.empty() == true) || (the_deadline < this->timers.begin()->first));
+
+      this->timers.emplace(the_deadline, Entry {the_owner, the_handle});
+
+      if (is_earliest == true)
+        this->timer_condition.notify_one();
+    } // Add
+
+    void  Cancel (Coroutine_Active_Object   *the_owner)
+    { // begin - the owner is going away - its suspended handlers are destroyed rather than resumed
+      std::unique_lock<std::mutex>  the_lock(this->timer_mutex);
+
+      this->timer_condition.wait(the_lock, [this, the_owner] () {return this->resuming_owner != the_owner;}); // an expired entry is being handed to the owner
+
+      for (std::multimap<std::chrono::steady_clock::time_point, Entry>::iterator the_entry = this->timers.begin(); the_entry != this->timers.end();)
+        if (the_entry->second.owner == the_owner)
+        { // begin
+          the_entry->second.handle.destroy();
+          the_entry = this->timers.erase(the_entry);
+        } // if then
+        else ++the_entry;
+    } // Cancel
+
+  private: // types
+    struct Entry
+    { // begin
+      Coroutine_Active_Object   *owner;
+      std::coroutine_handle<>   handle;
+    }; // Entry
+
+  private: // methods
+    void  Timer_Thread_Method (void)
+    { // begin
+      std::unique_lock<std::mutex>  the_lock(this->timer_mutex);
+
+      while (this->is_running == true)
+      { // begin
+        if (this->timers.empty() == true)
+        { // nothing to do
+          this->timer_condition.wait(the_lock);
+          continue;
+        } // if then
+
+        std::chrono::steady_clock::time_point   the_deadline = this->timers.begin()->first;
+
+        if (std::chrono::steady_clock::now() < the_deadline)
+        { // not yet
+          (void) this->timer_condition.wait_until(the_lock, the_deadline);
+          continue;
+        } // if then
+
+        Entry   the_entry = this->timers.begin()->second;
+
+        this->timers.erase(this->timers.begin());
+
+        this->resuming_owner = the_entry.owner; // Cancel waits until Resume has returned
+
+        the_lock.unlock(); // Resume posts to the owner's queue - do not hold the timer lock
+        the_entry.owner->Resume(the_entry.handle);
+        the_lock.lock();
+
+        this->resuming_owner = nullptr;
+        this->timer_condition.notify_all();
+      } // while
+    } // Timer_Thread_Method
+
+  private: // data
+    std::multimap<std::chrono::steady_clock::time_point, Entry>   timers; /**< ordered by deadline */
+    std::mutex                  timer_mutex; /**< guards timers & is_running */
+    std::condition_variable     timer_condition; /**< signalled when an earlier deadline arrives or on shut down */
+    Coroutine_Active_Object     *resuming_owner = nullptr; /**< the owner the timer thread is resuming outside the lock */
+    bool                        is_running; /**< cleared by the destructor */
+    std::thread                 timer_thread; /**< declared last - started once everything else is constructed */
+  }; // Timer_Service
+} // namespace - end
+
+/**
+ * @brief  A member coroutine has completed - its frame is about to be released.
+ */
+Coroutine_Task::promise_type::~promise_type(void)
+{ // begin
+  if (this->owner != nullptr)
+    this->owner->num_pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+} // destructor
+
+/**
+ * @brief  The handler ended with co_return - log a failure, there is nobody to return it to.
+ * @param the_error_code - IN
+ */
+void  Coroutine_Task::promise_type::return_value (Error_Code  the_error_code)
+{ // begin
+  if (the_error_code != No_Error)
+    (void) App_Log->Write (A4_Lib::Logging::Error, "Coroutine handler completed with error %1.5f", A4_Error::Get_Dot_Error_Code(the_error_code));
+} // return_value
+
+/**
+ * @brief  An exception escaped the handler - log it, the frame is released as if the handler had completed.
+ */
+void  Coroutine_Task::promise_type::unhandled_exception (void)
+{ // begin
+  (void) App_Log->Write (A4_Lib::Logging::Error, "Exception thrown by a coroutine handler - error %1.5f",
+                         A4_Error::Get_Dot_Error_Code(A4_Error (A4_Coroutine_Active_Object_Module_ID, Coroutine_Active_Object::PT_Task_Exception, "The handler threw an exception.").Get_Error_Code()));
+} // unhandled_exception
+
+/**
+ * @brief Default constructor
+ */
+Coroutine_Active_Object::Coroutine_Active_Object(void)
+{ // begin
+  this->num_pending_tasks = 0;
+  this->num_pending_replies = 0;
+} // constructor
+
+/**
+ * @brief Default destructor - handlers still waiting on a timer or on an undelivered resumption are destroyed.
+ * @note  Waits for every Await_Reply request a target still holds - each one resumes through this instance.
+ *        Handlers suspended on a Channel must have completed before the instance is destroyed.
+ */
+Coroutine_Active_Object::~Coroutine_Active_Object(void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+
+  A4_Cleanup_Begin
+    Timer_Service::Instance().Cancel(this);
+
+    while (this->num_pending_replies.load(std::memory_order_acquire) > 0)
+      A4_Lib::Sleep_MS(10); // a target still holds a reply - it is called or discarded, never kept
+
+    this->Destroy_Undelivered_Resumes();
+  A4_End_Cleanup
+} // destructor
+
+/**
+ * @brief Let started handlers complete, stop the worker thread(s) and destroy the handlers whose resumption was never delivered.
+ * @note  Handlers are given up to Coroutine_Active_Object_Constant::Max_Stop_Drain_Wait_MS - a handler still suspended afterwards stays suspended.
+ */
+Error_Code  Coroutine_Active_Object::Stop (void)
+{ // begin
+  std::chrono::steady_clock::time_point   the_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Coroutine_Active_Object_Constant::Max_Stop_Drain_Wait_MS);
+
+  Method_State_Block_Begin(2)
+    State(1) // the worker threads are still needed to resume the handlers
+      while ((this->Is_Started() == true) && (this->Num_Pending_Tasks() > 0) && (std::chrono::steady_clock::now() < the_deadline))
+        A4_Lib::Sleep_MS(10);
+    End_State
+
+    State(2)
+      the_method_error = this->Active_Object::Stop();
+    End_State
+  End_Method_State_Block
+
+  this->Destroy_Undelivered_Resumes(); // also when the instance was already stopped - nothing will resume them
+
+  return the_method_error.Get_Error_Code();
+} // Stop
+
+/**
+ * @brief  Retrieve the number of handlers that have started but not yet completed.
+ */
+std::size_t   Coroutine_Active_Object::Num_Pending_Tasks (void) const
+{ // begin
+  return this->num_pending_tasks.load(std::memory_order_relaxed);
+} // Num_Pending_Tasks
+
+/**
+ * @brief Continue a suspended handler on one of this object's worker threads.
+ * @param the_handle - IN
+ * @note  Resumptions go to the front of the request lane without a queue limit - finishing in-flight work comes before new work.
+ */
+void  Coroutine_Active_Object::Resume (std::coroutine_handle<>   the_handle)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_handle == nullptr)
+        the_method_error = A4_Error (A4_Coroutine_Active_Object_Module_ID, RS_Invalid_Handle, "Invalid parameter value - the_handle is empty.");
+    End_State
+
+    State(2)
+      { // begin - the request only names the instance, so a request dropped by Stop leaves the handle here
+        std::lock_guard<std::mutex>   the_lock(this->resume_mutex);
+
+        this->resumes.push_back(the_handle);
+      } // end
+
+      if ((this->Post([this] () {this->Resume_Next();}, true) != No_Error) && (this->Take_Resume(the_handle) == true))
+      { // a stopped object - the handler can never continue
+        the_handle.destroy();
+
+        the_method_error = A4_Error (A4_Coroutine_Active_Object_Module_ID, RS_Resume_Not_Posted, "The resumption could not be posted - the suspended handler has been destroyed.");
+      } // if then
+    End_State
+  End_Method_State_Block
+} // Resume
+
+/**
+ * @brief On a worker thread - continue the oldest delivered resumption.
+ */
+void  Coroutine_Active_Object::Resume_Next (void)
+{ // begin
+  std::coroutine_handle<>   the_handle;
+
+  { // begin
+    std::lock_guard<std::mutex>   the_lock(this->resume_mutex);
+
+    if (this->resumes.empty() == true)
+      return; // destroyed by Stop or taken back by a failed Resume
+
+    the_handle = this->resumes.front();
+    this->resumes.pop_front();
+  } // end
+
+  the_handle.resume();
+} // Resume_Next
+
+/**
+ * @brief Take the_handle back after its Resume_Next request could not be posted.
+ * @return \b false if a Resume_Next of an earlier request already took it.
+ */
+bool  Coroutine_Active_Object::Take_Resume (std::coroutine_handle<>   the_handle)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock(this->resume_mutex);
+
+  std::deque<std::coroutine_handle<>>::iterator   the_entry = std::find(this->resumes.begin(), this->resumes.end(), the_handle);
+
+  if (the_entry == this->resumes.end())
+    return false;
+
+  this->resumes.erase(the_entry);
+
+  return true;
+} // Take_Resume
+
+/**
+ * @brief The worker thread(s) are stopped - the Resume_Next requests still queued will never run, so their handlers are destroyed.
+ */
+void  Coroutine_Active_Object::Destroy_Undelivered_Resumes (void)
+{ // begin
+  std::deque<std::coroutine_handle<>>   the_handles;
+
+  { // begin - destroy outside the lock - a frame may own objects that Resume this instance
+    std::lock_guard<std::mutex>   the_lock(this->resume_mutex);
+
+    the_handles.swap(this->resumes);
+  } // end
+
+  for (std::coroutine_handle<> &the_handle : the_handles)
+    the_handle.destroy();
+} // Destroy_Undelivered_Resumes
+
+/**
+ * @brief co_await a delay - the worker thread is released meanwhile.
+ * @param the_milli_seconds - IN - zero does not suspend
+ */
+Coroutine_Active_Object::Timer_Awaitable   Coroutine_Active_Object::Await_Timer (std::uint64_t  the_milli_seconds)
+{ // begin
+  return Timer_Awaitable(*this, the_milli_seconds);
+} // Await_Timer
+
+void  Coroutine_Active_Object::Timer_Awaitable::await_suspend (std::coroutine_handle<>   the_handle)
+{ // begin
+  Timer_Service::Instance().Add(std::chrono::steady_clock::now() + std::chrono::milliseconds(this->milli_seconds), &this->owner, the_handle);
+} // await_suspend
+
+/**
+ * @brief Start the coroutine handler - returns as soon as it completes or first suspends.
+ * @param the_message_block - IN - the handler becomes owner - OUT - nullptr
+ */
+Error_Code  Coroutine_Active_Object::Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_message_block == nullptr)
+        the_method_error = A4_Error (A4_Coroutine_Active_Object_Module_ID, PM_Invalid_Address, "Invalid parameter address - the_message_block is nullptr.");
+    End_State
+
+    State(2)
+      (void) this->Process_Message_Async(std::move(the_message_block));
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Process_Message
+
+#endif // A4_Lib_Coroutines
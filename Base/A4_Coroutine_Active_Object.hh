@@ -0,0 +1,426 @@
+#ifndef __A4_Coroutine_Active_Object_Defined__
+#define __A4_Coroutine_Active_Object_Defined__
+/**
+ * @brief   Coroutine Active Object - an Active_Object whose message handler may co_await without holding a worker thread.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Coroutine_Active_Object.hh
+ * @note  Requires C++20 coroutine support - the header is empty otherwise (check A4_Lib_Coroutines).
+ *        A handler suspended on another object's reply, a timer or a Channel is resumed through this object's own
+ *        request lane, so it always continues on one of this object's worker (or Executor) threads.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Active_Object.hh"
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) && !defined(A4_DotNet)
+#define A4_Lib_Coroutines
+#endif
+
+#ifdef A4_Lib_Coroutines
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace A4_Lib
+{ // begin
+  namespace Coroutine_Active_Object_Constant
+  { // begin
+    static const std::uint64_t  Max_Stop_Drain_Wait_MS = 5000; /**< Stop lets started handlers complete for up to this long before the worker threads are stopped */
+  } // namespace Coroutine_Active_Object_Constant
+
+  class Coroutine_Active_Object;
+
+  /**
+   * @brief Return type of a coroutine message handler - the coroutine starts immediately and its frame is released when it completes.
+   * @note  Handlers end with \b co_return an Error_Code - a failure is logged, there is nobody to return it to.
+   */
+  typedef class Coroutine_Task
+  { // begin
+  public: // types
+    struct promise_type
+    { // begin
+      promise_type(void) = default;
+
+      template <typename The_Owner_Type,
+                typename... The_Arg_Types> requires std::is_base_of_v<Coroutine_Active_Object, std::remove_reference_t<The_Owner_Type>>
+        promise_type (The_Owner_Type   &the_owner,
+                      The_Arg_Types    &...); // member coroutines - counted as pending by the owner - deduced, some compilers match neither a base class parameter nor an unqualified owner type
+
+      ~promise_type(void);
+
+      Coroutine_Task          get_return_object (void) noexcept {return Coroutine_Task();};
+      std::suspend_never      initial_suspend (void) noexcept {return std::suspend_never();};
+      std::suspend_never      final_suspend (void) noexcept {return std::suspend_never();};
+
+      void  return_value (Error_Code  the_error_code);
+      void  unhandled_exception (void);
+
+      Coroutine_Active_Object   *owner = nullptr; /**< set for member coroutines of a Coroutine_Active_Object */
+    }; // promise_type
+  } Coroutine_Task;
+
+  typedef class Coroutine_Active_Object : public Active_Object
+  { // begin definition
+  public: // construction
+    Coroutine_Active_Object(void);
+    virtual ~Coroutine_Active_Object(void);
+
+  public: // methods
+    virtual Error_Code  Stop (void) override; // lets started handlers complete first - resumptions that were never delivered are destroyed
+
+    void          Resume (std::coroutine_handle<>   the_handle); // continue a suspended handler on this object's worker thread(s)
+
+    std::size_t   Num_Pending_Tasks (void) const; // handlers started but not yet completed
+
+  public: // awaitables
+    /**
+     * @brief Awaitable returned by Await_Reply - the callable runs on the target object, the handler resumes on its owner.
+     */
+    template <typename The_Result_Type,
+              typename The_Callable> class Reply_Awaitable
+    { // begin
+    public: // construction
+      Reply_Awaitable (Coroutine_Active_Object  &the_owner,
+                       Active_Object            &the_target,
+                       The_Callable             &&the_callable,
+                       The_Result_Type          *the_result) : owner(the_owner), target(the_target), callable(std::move(the_callable)), result(the_result) {};
+
+    public: // coroutine interface
+      bool        await_ready (void) const noexcept {return false;};
+      void        await_suspend (std::coroutine_handle<>   the_handle);
+      Error_Code  await_resume (void) noexcept {return this->error_code;};
+
+    private: // types
+      /**
+       * @brief The request posted to the target - resumes the handler whether it is called or discarded by the target.
+       */
+      class Reply_Request
+      { // begin
+      public: // construction
+        Reply_Request (Reply_Awaitable          *the_awaitable,
+                       std::coroutine_handle<>  the_handle);
+        Reply_Request (Reply_Request  &&the_other) noexcept : awaitable(the_other.awaitable), handle(std::exchange(the_other.handle, nullptr)) {};
+        Reply_Request (const Reply_Request &) = delete;
+        ~Reply_Request(void);
+
+      public: // methods
+        void  operator () (void); // on the target worker thread
+
+      private: // methods
+        void  Complete (void); // hand the handler back to its owner
+
+      private: // data
+        Reply_Awaitable           *awaitable; /**< lives in the suspended handler's frame */
+        std::coroutine_handle<>   handle; /**< nullptr once the handler has been handed back */
+      }; // Reply_Request
+
+    private: // data
+      Coroutine_Active_Object   &owner; /**< resumed here */
+      Active_Object             &target; /**< the callable runs here */
+      The_Callable              callable; /**< the request */
+      The_Result_Type           *result; /**< OUT - nullptr for a void callable */
+      Error_Code                error_code = No_Error; /**< the outcome of the exchange */
+    }; // Reply_Awaitable
+
+    /**
+     * @brief Awaitable returned by Await_Timer.
+     */
+    typedef class Timer_Awaitable
+    { // begin
+    public: // construction
+      Timer_Awaitable (Coroutine_Active_Object  &the_owner,
+                       std::uint64_t            the_milli_seconds) : owner(the_owner), milli_seconds(the_milli_seconds) {};
+
+    public: // coroutine interface
+      bool        await_ready (void) const noexcept {return this->milli_seconds == 0;};
+      void        await_suspend (std::coroutine_handle<>   the_handle);
+      Error_Code  await_resume (void) noexcept {return No_Error;};
+
+    private: // data
+      Coroutine_Active_Object   &owner; /**< resumed here */
+      std::uint64_t             milli_seconds; /**< the delay */
+    } Timer_Awaitable;
+
+  protected: // methods - for use in Process_Message_Async
+    template <typename The_Result_Type,
+              typename The_Callable>
+      Reply_Awaitable<The_Result_Type, The_Callable>  Await_Reply (Active_Object    &the_target,
+                                                                   The_Callable     the_callable,
+                                                                   The_Result_Type  &the_result); // co_await - OUT the_result, returns Error_Code
+
+    template <typename The_Callable>
+      Reply_Awaitable<void, The_Callable>  Await_Reply (Active_Object    &the_target,
+                                                        The_Callable     the_callable); // co_await - for a void callable
+
+    Timer_Awaitable   Await_Timer (std::uint64_t  the_milli_seconds); // co_await - resumes after at least the_milli_seconds
+
+  protected: // overridables
+    virtual Coroutine_Task  Process_Message_Async (A4_Lib::Message_Block::Pointer   the_message_block) = 0; /**< \b Must be overridden - the coroutine message handler. */
+
+    virtual Error_Code      Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block) override; // starts Process_Message_Async
+
+  private: // methods
+    void  Resume_Next (void); // on a worker thread - continue the oldest delivered resumption
+    bool  Take_Resume (std::coroutine_handle<>   the_handle); // false - already taken by Resume_Next
+    void  Destroy_Undelivered_Resumes (void); // the worker threads are stopped - nothing will resume them
+
+  private: // data
+    friend struct Coroutine_Task::promise_type;
+
+    std::atomic<std::size_t>  num_pending_tasks; /**< handlers started but not yet completed */
+    std::atomic<std::size_t>  num_pending_replies; /**< Await_Reply requests held by a target - each one resumes through this instance */
+
+    std::deque<std::coroutine_handle<>>   resumes; /**< handlers waiting for a worker thread - one Resume_Next request is posted for each */
+    std::mutex                            resume_mutex; /**< guards resumes */
+
+  public: // errors
+    enum Coroutine_Active_Object_Errors
+    { // begin
+      RS_Invalid_Handle           = 0, /**< \b Resume: Invalid parameter value - the_handle is empty. */
+      RS_Resume_Not_Posted        = 1, /**< \b Resume: The resumption could not be posted - the suspended handler has been destroyed. */
+      AR_Callable_Exception       = 2, /**< \b Await_Reply: The callable threw an exception on the target object. */
+      AR_Not_Posted               = 3, /**< \b Await_Reply: The callable could not be posted to the target object. */
+      PM_Invalid_Address          = 4, /**< \b Process_Message: Invalid parameter address - the_message_block is nullptr. */
+      PT_Task_Exception           = 5, /**< \b Coroutine_Task: The handler threw an exception. */
+    }; // Coroutine_Active_Object_Errors
+  } Coroutine_Active_Object;
+
+  /**
+   * @brief Multi-producer queue a Coroutine_Active_Object handler can co_await - Send never blocks, Receive suspends while empty.
+   * @param The_Value_Type - move constructible
+   * @note  A Channel must outlive every handler suspended on it, and so must the handler's owner - Stop waits for such handlers only up to Max_Stop_Drain_Wait_MS.
+   */
+  template <typename The_Value_Type> class Channel
+  { // begin
+  public: // construction
+    Channel(void) = default;
+    Channel(Channel &) = delete;
+    virtual ~Channel(void) = default;
+
+    Channel & operator = (Channel &) = delete;
+
+  public: // awaitables
+    class Receive_Awaitable
+    { // begin
+    public: // construction
+      Receive_Awaitable (Channel                  &the_channel,
+                         Coroutine_Active_Object  &the_owner,
+                         The_Value_Type           &the_value) : channel(the_channel), owner(the_owner), value(the_value) {};
+
+    public: // coroutine interface
+      bool        await_ready (void) const noexcept {return false;};
+      bool        await_suspend (std::coroutine_handle<>   the_handle) {return this->channel.Suspend_Receiver(this->owner, the_handle, this->value);};
+      Error_Code  await_resume (void) noexcept {return No_Error;};
+
+    private: // data
+      Channel                   &channel;
+      Coroutine_Active_Object   &owner;
+      The_Value_Type            &value; /**< OUT */
+    }; // Receive_Awaitable
+
+  public: // methods
+    void  Send (The_Value_Type  the_value); // hands the value to a suspended receiver, or keeps it
+
+    Receive_Awaitable   Receive (Coroutine_Active_Object   &the_owner,
+                                 The_Value_Type            &the_value) {return Receive_Awaitable(*this, the_owner, the_value);}; // co_await
+
+    std::size_t   Size (void);
+
+  private: // types
+    struct Receiver
+    { // begin
+      Coroutine_Active_Object   *owner;
+      std::coroutine_handle<>   handle;
+      The_Value_Type            *value;
+    }; // Receiver
+
+  private: // methods
+    bool  Suspend_Receiver (Coroutine_Active_Object   &the_owner,
+                            std::coroutine_handle<>   the_handle,
+                            The_Value_Type            &the_value); // false - a value was ready, do not suspend
+
+  private: // data
+    std::deque<The_Value_Type>  values; /**< sent but not yet received */
+    std::deque<Receiver>        receivers; /**< suspended in Receive - FIFO */
+    std::mutex                  channel_mutex; /**< guards values & receivers */
+  }; // Channel
+
+// --- template implementation ---
+
+  template <typename The_Owner_Type,
+            typename... The_Arg_Types> requires std::is_base_of_v<Coroutine_Active_Object, std::remove_reference_t<The_Owner_Type>>
+    Coroutine_Task::promise_type::promise_type (The_Owner_Type   &the_owner,
+                                                The_Arg_Types    &...) : owner(&the_owner)
+  { // begin
+    this->owner->num_pending_tasks.fetch_add(1, std::memory_order_relaxed);
+  } // promise_type
+
+/**
+ * @brief Post the callable to the target object. The resumption is posted back to the owner by the target worker thread.
+ * @note  A request the target cannot accept, or discards unserved, resumes the handler with AR_Not_Posted - the awaitable must not be touched once it is posted.
+ */
+  template <typename The_Result_Type,
+            typename The_Callable>
+    void  Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>::await_suspend (std::coroutine_handle<>   the_handle)
+  { // begin
+    (void) this->target.Post(Reply_Request(this, the_handle));
+  } // await_suspend
+
+  template <typename The_Result_Type,
+            typename The_Callable>
+    Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>::Reply_Request::Reply_Request (Reply_Awaitable          *the_awaitable,
+                                                                                                           std::coroutine_handle<>  the_handle) : awaitable(the_awaitable), handle(the_handle)
+  { // begin
+    this->awaitable->owner.num_pending_replies.fetch_add(1, std::memory_order_relaxed); // the owner outlives the request
+  } // constructor
+
+/**
+ * @brief A request that was never called - not posted or dropped by a stopped target - still hands the handler back.
+ */
+  template <typename The_Result_Type,
+            typename The_Callable>
+    Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>::Reply_Request::~Reply_Request(void)
+  { // begin
+    if (this->handle == nullptr)
+      return; // called or moved from
+
+    this->awaitable->error_code = A4_Error (A4_Coroutine_Active_Object_Module_ID, AR_Not_Posted, "The callable could not be posted to the target object.").Get_Error_Code();
+
+    this->Complete();
+  } // destructor
+
+  template <typename The_Result_Type,
+            typename The_Callable>
+    void  Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>::Reply_Request::operator () (void)
+  { // begin
+    try { // begin
+      if constexpr (std::is_void<The_Result_Type>::value)
+        this->awaitable->callable();
+      else *this->awaitable->result = this->awaitable->callable();
+    } // try
+    catch (...) { // begin
+      this->awaitable->error_code = A4_Error (A4_Coroutine_Active_Object_Module_ID, AR_Callable_Exception, "The callable threw an exception on the target object.").Get_Error_Code();
+    } // catch
+
+    this->Complete();
+  } // operator ()
+
+/**
+ * @brief The awaitable may be released as soon as the handler is resumed - only the owner is used afterwards.
+ */
+  template <typename The_Result_Type,
+            typename The_Callable>
+    void  Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>::Reply_Request::Complete (void)
+  { // begin
+    Coroutine_Active_Object   &the_owner = this->awaitable->owner;
+
+    the_owner.Resume(std::exchange(this->handle, nullptr));
+    the_owner.num_pending_replies.fetch_sub(1, std::memory_order_release); // the owner may be destroyed from here on
+  } // Complete
+
+/**
+ * @brief co_await the result of the_callable run on the_target.
+ * @param the_target - IN - any started Active_Object
+ * @param the_callable - IN - takes no arguments
+ * @param the_result - OUT - the value returned by the_callable - must outlive the co_await
+ * @return an awaitable - co_await yields No_Error, AR_Callable_Exception or AR_Not_Posted
+ */
+  template <typename The_Result_Type,
+            typename The_Callable>
+    Coroutine_Active_Object::Reply_Awaitable<The_Result_Type, The_Callable>  Coroutine_Active_Object::Await_Reply (Active_Object    &the_target,
+                                                                                                                   The_Callable     the_callable,
+                                                                                                                   The_Result_Type  &the_result)
+  { // begin
+    return Reply_Awaitable<The_Result_Type, The_Callable>(*this, the_target, std::move(the_callable), &the_result);
+  } // Await_Reply
+
+  template <typename The_Callable>
+    Coroutine_Active_Object::Reply_Awaitable<void, The_Callable>  Coroutine_Active_Object::Await_Reply (Active_Object    &the_target,
+                                                                                                        The_Callable     the_callable)
+  { // begin
+    return Reply_Awaitable<void, The_Callable>(*this, the_target, std::move(the_callable), nullptr);
+  } // Await_Reply (void)
+
+/**
+ * @brief Deliver the_value to the oldest suspended receiver, or keep it for the next Receive.
+ * @param the_value - IN
+ */
+  template <typename The_Value_Type>
+    void  Channel<The_Value_Type>::Send (The_Value_Type  the_value)
+  { // begin
+    Receiver    the_receiver = {nullptr, nullptr, nullptr};
+
+    { // begin - hand over under the lock, resume outside it
+      std::lock_guard<std::mutex>   the_lock(this->channel_mutex);
+
+      if (this->receivers.empty() == true)
+      { // nobody is waiting
+        this->values.push_back(std::move(the_value));
+        return;
+      } // if then
+
+      the_receiver = this->receivers.front();
+      this->receivers.pop_front();
+
+      *the_receiver.value = std::move(the_value);
+    } // end - hand over
+
+    the_receiver.owner->Resume(the_receiver.handle);
+  } // Send
+
+  template <typename The_Value_Type>
+    bool  Channel<The_Value_Type>::Suspend_Receiver (Coroutine_Active_Object   &the_owner,
+                                                     std::coroutine_handle<>   the_handle,
+                                                     The_Value_Type            &the_value)
+  { // begin
+    std::lock_guard<std::mutex>   the_lock(this->channel_mutex);
+
+    if (this->values.empty() != true)
+    { // ready - no need to suspend
+      the_value = std::move(this->values.front());
+      this->values.pop_front();
+
+      return false;
+    } // if then
+
+    this->receivers.push_back(Receiver {&the_owner, the_handle, &the_value});
+
+    return true;
+  } // Suspend_Receiver
+
+  template <typename The_Value_Type>
+    std::size_t   Channel<The_Value_Type>::Size (void)
+  { // begin
+    std::lock_guard<std::mutex>   the_lock(this->channel_mutex);
+
+    return this->values.size();
+  } // Size
+} // namespace A4_Lib
+
+#endif // A4_Lib_Coroutines
+#endif // __A4_Coroutine_Active_Object_Defined__
@@ -39,97 +39,87 @@
 #include "A4_Utils.hh" // <-- warning - cyclical dependency
 
 #include <cstdarg>
+#include <cstdio>
 
 ///////////////////////////////   implementation   ////////////////////////////
+
+namespace
+{ // begin
+  thread_local char   error_message_buffer [A4_Lib::Max_Error_Message_Length]; /**< Get_Error_Message formats here - one per thread */
+} // namespace
   
 /**
- * \brief Default char constructor as of 2016-01
+ * \brief Default char constructor as of 2016-01 - the message is kept by address, nothing is copied.
  * @param the_module_id - IN - 6-byte value identifying the Module
  * @param the_error_offset - IN - 2-byte value representing a distinct error condition
- * @param the_error_message - IN
+ * @param the_error_message - IN - static - a string literal
  * @param the_error_detail_level - IN
  * @param the_log_detail_override - IN - example: if the Application logging level is  Warning, then setting this value to Info would allow an Info level log entry as an exception.
  */
 A4_Error::A4_Error (Module_ID                 the_module_id, 
                     Error_Offset              the_error_offset,
-                    std::string               the_error_message,  
+                    const char                *the_error_message,  
                     A4_Lib::Logging::Detail   the_error_detail_level ,	
-                    A4_Lib::Logging::Detail   the_log_detail_override) 
+                    A4_Lib::Logging::Detail   the_log_detail_override) noexcept
+  : A4_Error(Make_Error_Code(the_module_id, the_error_offset))
   { // begin
-    this->error_code = this->Make_Error_Code(the_module_id, the_error_offset);
-    this->error_message = the_error_message;
+    this->message_format = the_error_message;
     this->error_detail_level = the_error_detail_level;
     this->log_detail_override = the_log_detail_override;    
   } // end default constructor
 
 /**
- * \brief Default wchar_t constructor as of 2016-01
+ * \brief std::string constructor - for messages built at run time. The text is copied into the inline buffer.
  * @param the_module_id - IN - 6-byte value identifying the Module
  * @param the_error_offset - IN - 2-byte value representing a distinct error condition
- * @param the_error_message - IN
+ * @param the_error_message - IN - truncated to Max_Captured_Text - 1 bytes
  * @param the_error_detail_level - IN
- * @param the_log_detail_override - IN - example: if the Application logging level is  Warning, then setting this value to Info would allow an Info level log entry as an exception.
+ * @param the_log_detail_override - IN
  */
 A4_Error::A4_Error (Module_ID                 the_module_id, 
                     Error_Offset              the_error_offset,
-                    std::wstring	      the_error_message,  
+                    const std::string         &the_error_message,  
                     A4_Lib::Logging::Detail   the_error_detail_level ,	
-                    A4_Lib::Logging::Detail   the_log_detail_override)
+                    A4_Lib::Logging::Detail   the_log_detail_override) 
+  : A4_Error(Make_Error_Code(the_module_id, the_error_offset))
   { // begin
-    this->error_code = this->Make_Error_Code(the_module_id, the_error_offset);  
-    this->error_message.clear();
-    (void) A4_Lib::WChar_to_Char(the_error_message, this->error_message); // <-- this breaks an A4 rule - no initialization in a constructor - but errors should still be logged
-
+    this->message_format = "%s";
+    this->is_format = true;
     this->error_detail_level = the_error_detail_level;
     this->log_detail_override = the_log_detail_override;    
-  } // end default wchar_t constructor
 
+    this->Capture_Text(the_error_message.c_str(), the_error_message.size());
+  } // end std::string constructor
 
 /**
- * \brief Simple constructor with default initialization
- * @param the_error_code
- */
-A4_Error::A4_Error(Error_Code the_error_code)
-{ // begin
-  this->error_code = the_error_code;
-  this->error_detail_level = A4_Lib::Logging::Error;
-  this->log_detail_override = A4_Lib::Logging::Off;
-} // end constructor (2)
-
-
-/**
- * \brief  std::string Variadic constructor
- * @param the_module_id - IN
- * @param the_error_offset - IN
+ * \brief Default wchar_t constructor as of 2016-01
+ * @param the_module_id - IN - 6-byte value identifying the Module
+ * @param the_error_offset - IN - 2-byte value representing a distinct error condition
+ * @param the_error_message - IN - converted and truncated to Max_Captured_Text - 1 bytes
  * @param the_error_detail_level - IN
- * @param the_error_msg_format - IN
- * @param ... - IN - must match the formated string or the error text will reflect new problem while the error code reamins.
+ * @param the_log_detail_override - IN - example: if the Application logging level is  Warning, then setting this value to Info would allow an Info level log entry as an exception.
  */
-A4_Error::A4_Error (Module_ID                 the_module_id, // top 6-bytes  
-                    Error_Offset              the_error_offset,// bottom 2-bytes...should be sufficient for human writers
-                    A4_Lib::Logging::Detail   the_error_detail_level, // the detail level of the error (info, warning, error, etc
-                    std::string               the_error_msg_format, // error message text and formatting
-                    ...) // items to format in the error message
-{ // begin
-  char    the_buffer[A4_Lib::Max_Error_Message_Length];
-  
-  va_list the_va_list;
-  va_start (the_va_list, the_error_msg_format);
-  
-  if (std::vsnprintf (the_buffer, A4_Lib::Max_Error_Message_Length, the_error_msg_format.c_str(), the_va_list) < 0)
-    this->error_message = "Variadic error message was not formatted correctly";
-  else this->error_message = the_buffer;
-  
-  this->error_code = this->Make_Error_Code(the_module_id, the_error_offset);
+A4_Error::A4_Error (Module_ID                 the_module_id, 
+                    Error_Offset              the_error_offset,
+                    const std::wstring	      &the_error_message,  
+                    A4_Lib::Logging::Detail   the_error_detail_level ,	
+                    A4_Lib::Logging::Detail   the_log_detail_override)
+  : A4_Error(Make_Error_Code(the_module_id, the_error_offset))
+  { // begin
+    std::string   the_char_message;
 
-  this->error_detail_level = the_error_detail_level;  
-  
-  va_end (the_va_list);  
-} // variadic char error constructor
+    (void) A4_Lib::WChar_to_Char(the_error_message, the_char_message); // <-- this breaks an A4 rule - no initialization in a constructor - but errors should still be logged
 
+    this->message_format = "%s";
+    this->is_format = true;
+    this->error_detail_level = the_error_detail_level;
+    this->log_detail_override = the_log_detail_override;    
+
+    this->Capture_Text(the_char_message.c_str(), the_char_message.size());
+  } // end default wchar_t constructor
 
 /**
- * \brief  std::wstring Variadic constructor
+ * \brief  std::wstring Variadic constructor - wide formats are formatted at once and the result copied into the inline buffer.
  * @param the_module_id - IN
  * @param the_error_offset - IN
  * @param the_error_detail_level - IN
@@ -141,46 +131,64 @@ A4_Error::A4_Error (Module_ID                 the_module_id, // top 6-bytes
                     A4_Lib::Logging::Detail   the_error_detail_level, // the detail level of the error (info, warning, error, etc
                     std::wstring              the_error_msg_format, // error message text and formatting
                                               ...) // items to format in the error message
+  : A4_Error(Make_Error_Code(the_module_id, the_error_offset))
 { // begin
   wchar_t    the_buffer [A4_Lib::Max_Error_Message_Length];
   char       *the_char_buf = NULL;
 
   memset (the_buffer, 0, sizeof (the_buffer));
+
+  this->message_format = "%s";
+  this->is_format = true;
+  this->error_detail_level = the_error_detail_level;  
   
   va_list the_va_list;
   va_start (the_va_list, the_error_msg_format);
   
   if (std::vswprintf (the_buffer, A4_Lib::Max_Error_Message_Length, the_error_msg_format.c_str(), the_va_list) < 0)
-    this->error_message = "Variadic error message was not formatted correctly";
+    this->Capture_Value(AT_Static_String, reinterpret_cast<std::uint64_t>("Variadic error message was not formatted correctly"));
   else { // begin
     (void) A4_Lib::WChar_to_Char(the_buffer, std::wcslen(the_buffer), (char *&) the_char_buf);
   
     if (the_char_buf != NULL)
     {
-      this->error_message = the_char_buf;
+      this->Capture_Text(the_char_buf, std::strlen(the_char_buf));
       delete[] the_char_buf;
     } // if then
-    else this->error_message = "A4_Lib::WChar_to_Char did not return a char string.";
+    else this->Capture_Value(AT_Static_String, reinterpret_cast<std::uint64_t>("A4_Lib::WChar_to_Char did not return a char string."));
   } // if else
   
-  this->error_code = this->Make_Error_Code(the_module_id, the_error_offset);
-
-  this->error_detail_level = the_error_detail_level;  
-  
   va_end (the_va_list);  
 } // variadic wchar_t error constructor
 
 
 /**
- * \brief Default destructor
+ * \brief Copy a string argument into the inline buffer - truncated to the room left, an empty string once it is full.
+ * @param the_text - IN - may be nullptr
+ * @param the_length - IN - excluding the terminator
  */
-A4_Error::~A4_Error(void)
+void  A4_Error::Capture_Text (const char    *the_text,
+                              std::size_t   the_length) noexcept
 { // begin
-  this->error_message.clear();
-  this->error_code = No_Error;
-  this->error_detail_level = A4_Lib::Logging::Off;
-  this->log_detail_override = A4_Lib::Logging::Off;
-} // end destructor
+  std::size_t   the_room = Max_Captured_Text - this->text_length;
+
+  if ((this->num_arguments >= Max_Captured_Arguments) || (the_room == 0))
+    return;
+
+  if (the_text == nullptr)
+    the_length = 0;
+  else if (the_length > (the_room - 1))
+    the_length = the_room - 1;
+
+  if (the_length > 0)
+    std::memcpy(this->argument_text + this->text_length, the_text, the_length);
+
+  this->argument_text [this->text_length + the_length] = '\0';
+
+  this->Capture_Value(AT_Text, this->text_length);
+
+  this->text_length = static_cast<std::uint8_t>(this->text_length + the_length + 1);
+} // Capture_Text
 
 
 /**
@@ -196,35 +204,227 @@ Dot_Error_Code A4_Error::Make_Dot_Code (Module_ID      the_module_id,
 } // end Make_Dot_Code
 
 /**
- * \brief Create a single Error_Code value from the Module_ID and Error_Offset
- * @param the_module_id - IN
- * @param the_error_offset - IN
- * @return An Error_Code containing the Module_ID and Error_Offset
+ * \brief Retrieve the error text - formatted now, into a buffer owned by the calling thread.
+ * @return valid until the next Get_Error_Message on this thread
  */
-Error_Code  A4_Error::Make_Error_Code (Module_ID    the_module_id,
-                                       Error_Offset the_error_offset)
+const char  * A4_Error::Get_Error_Message (void) noexcept
 { // begin
-  return (the_module_id << 16) + the_error_offset;
-} // Make_Error_Code
+  if (this->is_format != true)
+    return this->Get_Error_Message_Format(); // static text - nothing to format
+
+  (void) this->Format_Message(error_message_buffer, sizeof(error_message_buffer));
+
+  return error_message_buffer;
+} // end Get_Error_Message
 
 /**
- * \brief Retrieve the error text.
+ * \brief Format the message with the captured arguments. Supports the printf flags, width, precision and the conversions
+ *        d i u o x X c e E f F g G a A s p - length modifiers are ignored since every argument was captured at full width.
+ *        A * width or precision takes an integer argument, as printf does - its magnitude is limited to Max_Star_Value.
+ *        A conversion that does not suit its argument, or has none, is written as <?> or <missing>.
+ * @param the_buffer - OUT
+ * @param the_buffer_size - IN - including the terminator
+ * @return the length of the formatted text
  */
-const char  * A4_Error::Get_Error_Message (void) noexcept
+std::size_t   A4_Error::Format_Message (char          *the_buffer,
+                                        std::size_t   the_buffer_size) const noexcept
 { // begin
-  return this->error_message.c_str();
-} // end Get_Error_Message
+  const char    *the_format = this->Get_Error_Message_Format();
 
+  char          the_specification [32];
+  std::size_t   the_specification_length = 0;
+  std::size_t   the_length = 0;
+  std::size_t   the_argument = 0;
+  int           the_written = 0;
+  std::int64_t  the_star_value = 0;
 
+  bool          is_mismatch = false;
 
-/**
- * \brief Retrieve the 64-bit error code value.
- * @return 
- */
-Error_Code  A4_Error::Get_Error_Code (void) const
-{
-  return this->error_code;
-} // end Get_Error_Code
+  Argument_Type the_type = AT_Signed;
+  std::uint64_t the_value = 0;
+  double        the_double = 0.0;
+  char          the_conversion = 0;
+
+  if ((the_buffer == nullptr) || (the_buffer_size == 0))
+    return 0;
+
+  if (this->is_format != true)
+  { // plain text
+    the_length = std::strlen(the_format);
+
+    if (the_length >= the_buffer_size)
+      the_length = the_buffer_size - 1;
+
+    std::memcpy(the_buffer, the_format, the_length);
+    the_buffer [the_length] = '\0';
+
+    return the_length;
+  } // if then
+
+  while ((*the_format != '\0') && ((the_length + 1) < the_buffer_size))
+  { // begin
+    if (*the_format != '%')
+    { // literal text
+      the_buffer [the_length++] = *the_format++;
+      continue;
+    } // if then
+
+    if (the_format [1] == '%')
+    { // escaped
+      the_buffer [the_length++] = '%';
+      the_format += 2;
+      continue;
+    } // if then
+
+    // flags, width & precision are kept - a * is replaced by its argument - the length modifier is replaced
+    the_specification_length = 0;
+    the_specification [the_specification_length++] = *the_format++;
+
+    is_mismatch = false;
+
+    while ((*the_format != '\0') && (std::strchr("-+ #0123456789.*", *the_format) != nullptr) && (the_specification_length < 20))
+    { // begin
+      if (*the_format != '*')
+        the_specification [the_specification_length++] = *the_format;
+      else if (the_argument < this->num_arguments)
+      { // begin
+        the_type = this->argument_types [the_argument];
+        the_star_value = static_cast<std::int64_t>(this->argument_values [the_argument++]);
+
+        if ((the_type != AT_Signed) && (the_type != AT_Unsigned))
+          is_mismatch = true;
+        else if ((the_star_value < 0) && (the_specification [the_specification_length - 1] == '.'))
+          the_specification_length -= 1; // a negative precision is taken as omitted
+        else { // a negative width is a - flag
+          if (the_star_value > A4_Error::Max_Star_Value)
+            the_star_value = A4_Error::Max_Star_Value;
+          else if (the_star_value < -A4_Error::Max_Star_Value)
+            the_star_value = -A4_Error::Max_Star_Value;
+
+          the_specification_length += static_cast<std::size_t>(std::snprintf(the_specification + the_specification_length, sizeof(the_specification) - the_specification_length,
+                                                                             "%lld", static_cast<long long>(the_star_value)));
+        } // if else
+      } // if then
+      // else - <missing> below
+
+      the_format += 1;
+    } // while
+
+    while ((*the_format != '\0') && (std::strchr("hljztLqI", *the_format) != nullptr))
+      the_format += 1;
+
+    the_conversion = *the_format;
+
+    if (the_conversion == '\0')
+      break;
+
+    the_format += 1;
+    the_written = 0;
+
+    if (is_mismatch == true)
+      the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, "<?>"); // the * argument was not an integer
+    else if (the_argument >= this->num_arguments)
+      the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, "<missing>");
+    else { // begin
+      the_type = this->argument_types [the_argument];
+      the_value = this->argument_values [the_argument];
+
+      if (the_type == AT_Double)
+        std::memcpy(&the_double, &the_value, sizeof(the_double));
+      else if (the_type == AT_Signed)
+        the_double = static_cast<double>(static_cast<std::int64_t>(the_value));
+      else the_double = static_cast<double>(the_value);
+
+      is_mismatch = true; // until a conversion suits the argument
+
+      switch (the_conversion)
+      { // begin
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+          if ((the_type == AT_Text) || (the_type == AT_Static_String))
+            break;
+
+          if (the_type == AT_Double)
+            the_value = static_cast<std::uint64_t>(static_cast<std::int64_t>(the_double));
+
+          the_specification [the_specification_length++] = 'l';
+          the_specification [the_specification_length++] = 'l';
+          the_specification [the_specification_length++] = the_conversion;
+          the_specification [the_specification_length] = '\0';
+
+          is_mismatch = false;
+
+          if ((the_conversion == 'd') || (the_conversion == 'i'))
+            the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification, static_cast<long long>(the_value));
+          else the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification, static_cast<unsigned long long>(the_value));
+          break;
+
+        case 'c':
+          if ((the_type != AT_Signed) && (the_type != AT_Unsigned))
+            break;
+
+          the_specification [the_specification_length++] = 'c';
+          the_specification [the_specification_length] = '\0';
+
+          is_mismatch = false;
+
+          the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification, static_cast<int>(the_value));
+          break;
+
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+          if ((the_type == AT_Text) || (the_type == AT_Static_String) || (the_type == AT_Pointer))
+            break;
+
+          the_specification [the_specification_length++] = the_conversion;
+          the_specification [the_specification_length] = '\0';
+
+          is_mismatch = false;
+
+          the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification, the_double);
+          break;
+
+        case 's':
+          if ((the_type != AT_Text) && (the_type != AT_Static_String))
+            break;
+
+          the_specification [the_specification_length++] = 's';
+          the_specification [the_specification_length] = '\0';
+
+          is_mismatch = false;
+
+          the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification,
+                                      (the_type == AT_Text) ? (this->argument_text + the_value) : reinterpret_cast<const char *>(the_value));
+          break;
+
+        case 'p':
+          the_specification [the_specification_length++] = 'p';
+          the_specification [the_specification_length] = '\0';
+
+          is_mismatch = false;
+
+          the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, the_specification, reinterpret_cast<const void *>(the_value));
+          break;
+
+        default:
+          break;
+      } // switch
+
+      if (is_mismatch == true)
+        the_written = std::snprintf(the_buffer + the_length, the_buffer_size - the_length, "<?>");
+    } // if else
+
+    the_argument += 1;
+
+    if (the_written > 0)
+      the_length += static_cast<std::size_t>(the_written);
+
+    if (the_length >= the_buffer_size)
+      the_length = the_buffer_size - 1; // truncated
+  } // while
+
+  the_buffer [the_length] = '\0';
+
+  return the_length;
+} // Format_Message
 
 
 /// Retrieve the error offset
@@ -275,40 +475,3 @@ void A4_Error::Set (Error_Code  the_error_code)
   this->error_code = the_error_code;
 } // end Set
 
-
-/**
- * \brief Error_Code Assignment operator
- */
-A4_Error &  A4_Error::operator = (const Error_Code  the_error_code) // <-- use this for new development
-{
-  this->error_code = the_error_code;
-  this->error_message = "Error from called method";
-  
-  return *this;  
-} // end assignment operator
-
-/**
- * \brief (deprecated) instance copy operator
- * @param the_instance
- * @return 
- */
-A4_Error &  A4_Error::operator = (const A4_Error &the_instance)
-{ // BEGIN
-  this->error_code = the_instance.error_code;
-  this->error_detail_level = the_instance.error_detail_level;
-  this->error_message = the_instance.error_message;
-  this->log_detail_override = the_instance.log_detail_override;
-  return *this;
-} // end operator = (3)
-
-
-bool  A4_Error::operator == (Error_Code  the_error_code)
-{ // begin
-  return (this->error_code == the_error_code);
-}// end operator ==
-
-
-bool  A4_Error::operator != (Error_Code  the_error_code)
-{ // BEGIN
-  return (this->error_code != the_error_code);
-} // end operator !=
\ No newline at end of file
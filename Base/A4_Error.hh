@@ -36,47 +36,92 @@
 
 #include "A4_Lib_Base.hh"
 
+#include <cstring>
+#include <type_traits>
+
+/**
+ * \brief  One entry of the static error catalogue (A4_Error_Catalogue.hh) - generated from the *_Errors enums.
+ */
+typedef struct A4_Error_Descriptor
+{ // begin
+  Error_Code                error_code; /**< (Module_ID << 16) + Error_Offset */
+  const char                *message; /**< the doc comment of the enum value */
+  const char                *format; /**< printf style, as passed where the error is raised - nullptr when the message takes no arguments */
+  A4_Lib::Logging::Detail   detail_level;
+} A4_Error_Descriptor;
+
+/**
+ * \note  An A4_Error is a small, trivially copyable value - the error code, a pointer to a static message (a string literal
+ *        or a catalogue entry) and the formatting arguments captured in an inline buffer. The success path allocates nothing
+ *        and the message is only formatted when a sink calls Get_Error_Message (or Format_Message).
+ *
+ *        Captured \b const char[N] arrays (string literals, This_Function_Name) are kept by address; \b char * and std::string
+ *        arguments are copied into the inline buffer and truncated to Max_Captured_Text bytes in total.
+ */
 typedef class A4_Error
 { // begin
+public: // constants
+  static const std::size_t  Max_Captured_Arguments = 6; /**< further arguments are dropped - formatted as <missing> */
+  static const std::size_t  Max_Captured_Text = 96; /**< bytes for copied string arguments, terminators included */
+  static const std::int64_t Max_Star_Value = 4096; /**< Format_Message limit on a * width or precision - the message buffer is smaller */
+
 public: // construction
 // char version
   A4_Export A4_Error (Module_ID                   the_module_id, // top 6-bytes  
                       Error_Offset                the_error_offset,// bottom 2-bytes...should be sufficient for human writers
-	              std::string		  the_error_message = "Problem returned from called method",  // users should pass something useful to his parameter
+	              const char		  *the_error_message = "Problem returned from called method",  // must be static - a string literal - it is not copied
+	              A4_Lib::Logging::Detail	  the_error_detail_level = A4_Lib::Logging::Error, // the detail level of the error (info, warning, error, etc
+	              A4_Lib::Logging::Detail	  the_log_detail_override = A4_Lib::Logging::Off) noexcept; // override the setting of the file logger
+
+  A4_Export A4_Error (Module_ID                   the_module_id, // top 6-bytes  
+                      Error_Offset                the_error_offset,// bottom 2-bytes...should be sufficient for human writers
+	              const std::string		  &the_error_message,  // copied (and truncated) into the inline buffer
 	              A4_Lib::Logging::Detail	  the_error_detail_level = A4_Lib::Logging::Error, // the detail level of the error (info, warning, error, etc
 	              A4_Lib::Logging::Detail	  the_log_detail_override = A4_Lib::Logging::Off); // override the setting of the file logger
   
   // wchar_t version
   A4_Export A4_Error (Module_ID                   the_module_id, // top 6-bytes  
                       Error_Offset                the_error_offset,// bottom 2-bytes...should be sufficient for human writers
-	              std::wstring	          the_error_message = L"Error from called method",  // users should pass something useful to his parameter ** do not use A4_TEXT
+	              const std::wstring	  &the_error_message,  // converted and copied into the inline buffer ** do not use A4_TEXT
 	              A4_Lib::Logging::Detail	  the_error_detail_level = A4_Lib::Logging::Error, // the detail level of the error (info, warning, error, etc
 	              A4_Lib::Logging::Detail	  the_log_detail_override = A4_Lib::Logging::Off); // override the setting of the file logger
   
-  A4_Export A4_Error(Error_Code the_error_code = No_Error);
+  A4_Error(Error_Code the_error_code = No_Error) noexcept : error_code(the_error_code), message_format(nullptr), error_detail_level(A4_Lib::Logging::Error),
+                                                           log_detail_override(A4_Lib::Logging::Off), is_format(false), num_arguments(0), text_length(0) {}; // the success path
   
-// variadic
-  A4_Export A4_Error (Module_ID                 the_module_id, // top 6-bytes  
-                      Error_Offset              the_error_offset,// bottom 2-bytes...should be sufficient for human writers
-	              A4_Lib::Logging::Detail   the_error_detail_level, // the detail level of the error (info, warning, error, etc
-                      std::string               the_error_msg_format, // error message text and formatting
-                      ...); // items to format in the error message
+// catalogue - see A4_Catalogue_Error - only the descriptor's address is kept
+  template <typename... The_Arguments>
+    A4_Error (const A4_Error_Descriptor   &the_descriptor, // static - an A4_Lib::Error_Catalogue entry
+              const The_Arguments &...    the_arguments) noexcept; // items to format in the descriptor's format
+
+// variadic - the arguments are captured, not formatted
+  template <typename... The_Arguments>
+    A4_Error (Module_ID                 the_module_id, // top 6-bytes  
+              Error_Offset              the_error_offset,// bottom 2-bytes...should be sufficient for human writers
+	      A4_Lib::Logging::Detail   the_error_detail_level, // the detail level of the error (info, warning, error, etc
+              const char                *the_error_msg_format, // must be static - a printf style format - see Format_Message
+              const The_Arguments &...  the_arguments) noexcept; // items to format in the error message
  
   A4_Export A4_Error (Module_ID                 the_module_id, // top 6-bytes  
                       Error_Offset              the_error_offset,// bottom 2-bytes...should be sufficient for human writers
 	              A4_Lib::Logging::Detail   the_error_detail_level, // the detail level of the error (info, warning, error, etc
-                      std::wstring              the_error_msg_format, // error message text and formatting
+                      std::wstring              the_error_msg_format, // error message text and formatting - formatted at once
                       ...); // items to format in the error message  
 
-  A4_Export virtual ~A4_Error(void);
+  ~A4_Error(void) = default;
 
 public: // types
   typedef double  Dot_Error_Code;
   
 public: // methods
-  A4_Export const char *  Get_Error_Message (void) noexcept;
+  A4_Export const char *  Get_Error_Message (void) noexcept; // formats into a thread-local buffer - valid until the next call on this thread
+
+  A4_Export std::size_t   Format_Message (char          *the_buffer,
+                                          std::size_t   the_buffer_size) const noexcept; // returns the length, the_buffer is always terminated
+
+  const char *  Get_Error_Message_Format (void) const noexcept {return (this->message_format != nullptr) ? this->message_format : "";}; // the static text, unformatted
   
-  A4_Export Error_Code  Get_Error_Code (void) const; // <-- use this for new development
+  Error_Code  Get_Error_Code (void) const noexcept {return this->error_code;}; // <-- use this for new development
   A4_Export Error_Code  Get_Error_Offset (void); // <-- use this when you want a module-specific error offset
 
   A4_Export Dot_Error_Code  Get_Dot_Error_Code (void) const;
@@ -91,25 +136,162 @@ public: // methods
   A4_Export static Dot_Error_Code Make_Dot_Code (Module_ID    the_module_id,
                                        Error_Offset the_error_offset);
 
- A4_Export  static Error_Code  Make_Error_Code (Module_ID    the_module_id,
-                                      Error_Offset the_error_offset);
+  static constexpr Error_Code  Make_Error_Code (Module_ID    the_module_id,
+                                                Error_Offset the_error_offset) noexcept {return (the_module_id << 16) + the_error_offset;};
+
+  static constexpr Module_ID  Get_Module_ID (Error_Code  the_error_code) noexcept {return the_error_code >> 16;}; // the reverse of Make_Error_Code
 
 public: // operators
-  A4_Export A4_Error &  operator = (const Error_Code  the_error_code); 
+  A4_Error &  operator = (const Error_Code  the_error_code) noexcept; // the hot path of every State - inline
   
-  A4_Export A4_Error &  operator = (const A4_Error &the_instance);
+  A4_Error &  operator = (const A4_Error &the_instance) = default;
 
-  A4_Export bool  operator == (Error_Code  the_error_code); // <-- use this for new development
+  bool  operator == (Error_Code  the_error_code) const noexcept {return (this->error_code == the_error_code);}; // <-- use this for new development
   
-  A4_Export bool  operator != (Error_Code  the_error_code);// <-- use this for new development
+  bool  operator != (Error_Code  the_error_code) const noexcept {return (this->error_code != the_error_code);}; // <-- use this for new development
+
+private: // types
+  enum Argument_Type : std::uint8_t
+  { // begin
+    AT_Signed         = 0, /**< any signed integral or enumeration */
+    AT_Unsigned       = 1, /**< unsigned integral - and the raw bits of small trivially copyable types such as std::thread::id */
+    AT_Double         = 2, /**< float, double & long double - narrowed to double */
+    AT_Pointer        = 3, /**< any other pointer - formatted with %p */
+    AT_Static_String  = 4, /**< kept by address */
+    AT_Text           = 5, /**< copied - the value is the offset into argument_text */
+  }; // Argument_Type
+
+private: // methods
+  template <typename The_Type>
+    void  Capture (const The_Type   &the_argument) noexcept;
+
+  void  Capture_Value (Argument_Type  the_type,
+                       std::uint64_t  the_value) noexcept;
+
+  A4_Export void  Capture_Text (const char    *the_text,
+                                std::size_t   the_length) noexcept;
 
 private: // data
-  Error_Code            error_code;
+  Error_Code                error_code;
   
-  std::string		error_message;
+  const char                *message_format; /**< static - the message, or its printf style format when is_format is set */
+
+  A4_Lib::Logging::Detail   error_detail_level;
+  A4_Lib::Logging::Detail   log_detail_override;
+
+  bool                      is_format; /**< message_format holds conversions for the captured arguments */
+
+  std::uint8_t              num_arguments; /**< captured */
+  std::uint8_t              text_length; /**< bytes of argument_text in use */
 
-  A4_Lib::Logging::Detail	error_detail_level;
-  A4_Lib::Logging::Detail	log_detail_override;
+  Argument_Type             argument_types [Max_Captured_Arguments]; /**< not initialized beyond num_arguments */
+  std::uint64_t             argument_values [Max_Captured_Arguments]; /**< integral bits, double bits, pointer or text offset */
+
+  char                      argument_text [Max_Captured_Text]; /**< copied string arguments, each terminated */
 }A4_Error;
 
+/**
+ * \brief  Variadic constructor - the format is kept by address and the arguments are captured for a later Get_Error_Message.
+ * @param the_module_id - IN
+ * @param the_error_offset - IN
+ * @param the_error_detail_level - IN
+ * @param the_error_msg_format - IN - static
+ * @param the_arguments - IN - must match the_error_msg_format or the error text will reflect the mismatch while the error code remains.
+ */
+template <typename... The_Arguments>
+  A4_Error::A4_Error (Module_ID                 the_module_id,
+                      Error_Offset              the_error_offset,
+                      A4_Lib::Logging::Detail   the_error_detail_level,
+                      const char                *the_error_msg_format,
+                      const The_Arguments &...  the_arguments) noexcept
+  : error_code(Make_Error_Code(the_module_id, the_error_offset)), message_format(the_error_msg_format), error_detail_level(the_error_detail_level),
+    log_detail_override(A4_Lib::Logging::Off), is_format(true), num_arguments(0), text_length(0)
+{ // begin
+  (this->Capture(the_arguments), ...);
+} // variadic constructor
+
+/**
+ * \brief  Catalogue constructor - the code, detail level and format come from the_descriptor.
+ * @param the_descriptor - IN - static
+ * @param the_arguments - IN - must match the_descriptor.format
+ */
+template <typename... The_Arguments>
+  A4_Error::A4_Error (const A4_Error_Descriptor   &the_descriptor,
+                      const The_Arguments &...    the_arguments) noexcept
+  : error_code(the_descriptor.error_code), message_format(((sizeof...(The_Arguments) > 0) && (the_descriptor.format != nullptr)) ? the_descriptor.format : the_descriptor.message),
+    error_detail_level(the_descriptor.detail_level), log_detail_override(A4_Lib::Logging::Off), is_format(sizeof...(The_Arguments) > 0),
+    num_arguments(0), text_length(0)
+{ // begin
+  (this->Capture(the_arguments), ...);
+} // catalogue constructor
+
+/**
+ * \brief Error_Code Assignment operator
+ */
+inline A4_Error &  A4_Error::operator = (const Error_Code  the_error_code) noexcept // <-- use this for new development
+{ // begin
+  this->error_code = the_error_code;
+  this->message_format = "Error from called method";
+  this->is_format = false;
+  this->num_arguments = 0;
+  this->text_length = 0;
+  
+  return *this;  
+} // end assignment operator
+
+/**
+ * \brief Record one formatting argument by kind.
+ */
+template <typename The_Type>
+  void  A4_Error::Capture (const The_Type   &the_argument) noexcept
+{ // begin
+  typedef typename std::decay<The_Type>::type  The_Decayed_Type;
+
+  std::uint64_t   the_bits = 0;
+  double          the_double = 0.0;
+
+  if constexpr (std::is_same<The_Type, std::string>::value)
+    this->Capture_Text(the_argument.c_str(), the_argument.size());
+  else if constexpr (std::is_array<The_Type>::value && std::is_same<The_Decayed_Type, const char *>::value)
+    this->Capture_Value(AT_Static_String, reinterpret_cast<std::uint64_t>(static_cast<const char *>(the_argument))); // literal or static table
+  else if constexpr (std::is_same<The_Decayed_Type, const char *>::value || std::is_same<The_Decayed_Type, char *>::value)
+    this->Capture_Text(the_argument, (the_argument != nullptr) ? std::strlen(the_argument) : 0);
+  else if constexpr (std::is_floating_point<The_Type>::value)
+  { // begin
+    the_double = static_cast<double>(the_argument);
+    std::memcpy(&the_bits, &the_double, sizeof(the_bits));
+
+    this->Capture_Value(AT_Double, the_bits);
+  } // if then
+  else if constexpr (std::is_enum<The_Type>::value)
+    this->Capture_Value(AT_Signed, static_cast<std::uint64_t>(static_cast<std::int64_t>(the_argument)));
+  else if constexpr (std::is_integral<The_Type>::value && std::is_signed<The_Type>::value)
+    this->Capture_Value(AT_Signed, static_cast<std::uint64_t>(static_cast<std::int64_t>(the_argument)));
+  else if constexpr (std::is_integral<The_Type>::value)
+    this->Capture_Value(AT_Unsigned, static_cast<std::uint64_t>(the_argument));
+  else if constexpr (std::is_pointer<The_Decayed_Type>::value)
+    this->Capture_Value(AT_Pointer, reinterpret_cast<std::uint64_t>(static_cast<const void *>(the_argument)));
+  else { // begin
+    static_assert(std::is_trivially_copyable<The_Type>::value && (sizeof(The_Type) <= sizeof(std::uint64_t)), "A4_Error cannot capture this argument type");
+
+    std::memcpy(&the_bits, &the_argument, sizeof(The_Type));
+
+    this->Capture_Value(AT_Unsigned, the_bits);
+  } // if else
+} // Capture
+
+/**
+ * \brief Append a captured value - dropped when all Max_Captured_Arguments are in use.
+ */
+inline void  A4_Error::Capture_Value (Argument_Type  the_type,
+                                      std::uint64_t  the_value) noexcept
+{ // begin
+  if (this->num_arguments >= Max_Captured_Arguments)
+    return;
+
+  this->argument_types [this->num_arguments] = the_type;
+  this->argument_values [this->num_arguments] = the_value;
+  this->num_arguments += 1;
+} // Capture_Value
+
 #endif // __A4_Error_Defined__
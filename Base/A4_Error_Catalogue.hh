@@ -0,0 +1,442 @@
+#ifndef __A4_Error_Catalogue_Defined__
+#define __A4_Error_Catalogue_Defined__
+/**
+ * @brief   Static error catalogue - (Module_ID, Error_Offset) to message, detail level and format.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Catalogue.hh
+ * @note  GENERATED by Tools/A4_Error_Catalogue.py from the *_Errors enums - do not edit, edit the enum doc comments and
+ *        run "python3 Tools/A4_Error_Catalogue.py generate".
+ *
+ *        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated);
+ *
+ *        resolves the entry at compile time - an unknown code does not compile - and the error holds only the entry's
+ *        address, so no text is built unless a sink formats it.
+ */
+
+#include "A4_Error.hh"
+#include "A4_Lib_Module_ID.hh"
+
+namespace A4_Lib
+{ // begin
+  namespace Error_Catalogue
+  { // begin
+    inline constexpr A4_Error_Descriptor  Entries [] = /**< sorted by error_code */
+    { // begin
+      // A4_Method_State_Block_Module_ID - A4_Process_Block_Errors
+      {(Error_Code(0) << 16) + 0, "Invalid Target State value which must be between 0..A4_Max_Target_States-1", nullptr, Logging::Error}, // STS_Undefined_Target_State1
+      {(Error_Code(0) << 16) + 1, "Invalid Target State - The max state number must be less than A4_Max_Target_States", nullptr, Logging::Error}, // DTS_Invalid_Target_State
+      {(Error_Code(0) << 16) + 2, "Invalid Target State - Set_Target_State must point to a defined target state", nullptr, Logging::Error}, // STS_Undefined_Target_State2
+      {(Error_Code(0) << 16) + 3, "Undefined method state was encountered - probably skipped a State.", "Undefined method state was encountered in %s at line=%d in the_method_state=%d", Logging::Error}, // EMSB_Undefined_State
+      {(Error_Code(0) << 16) + 4, "An exception was thrown and caught at a specific State.", "Exception thrown in %s at line=%d in the_method_state=%d", Logging::Error}, // ES_Exception_Caught
+      // A4_Utils_Module_ID - A4_Lib_Errors
+      {(Error_Code(1) << 16) + 0, "Invalid parameter value - the_date < min value required for a positive conversion to a time_t", nullptr, Logging::Error}, // DTTT_Invalid_Date
+      {(Error_Code(1) << 16) + 1, "Invalid parameter value - the_maxlen", nullptr, Logging::Error}, // SNP_Invalid_Maxlen
+      {(Error_Code(1) << 16) + 2, "Invalid parameter value - the_buffer is NULL", nullptr, Logging::Error}, // SNP_Invalid_Buffer_Address
+      {(Error_Code(1) << 16) + 3, "Invalid parameter value - the_format is NULL", nullptr, Logging::Error}, // SNP_Invalid_Format_Address
+      {(Error_Code(1) << 16) + 4, "The call to std::vsnprintf failed", nullptr, Logging::Error}, // SNP_Format_Error
+      {(Error_Code(1) << 16) + 5, "Invalid parameter value - the_maxlen", nullptr, Logging::Error}, // SNPW_Invalid_Maxlen
+      {(Error_Code(1) << 16) + 6, "Invalid parameter value - the_buffer is NULL", nullptr, Logging::Error}, // SNPW_Invalid_Buffer_Address
+      {(Error_Code(1) << 16) + 7, "Invalid parameter value - the_format is NULL", nullptr, Logging::Error}, // SNPW_Invalid_Format_Address
+      {(Error_Code(1) << 16) + 8, "The call to std::vswprintf failed", nullptr, Logging::Error}, // SNPW_Format_Error
+      {(Error_Code(1) << 16) + 9, "Invalid parameter value - the_delimiting_character is zero.", nullptr, Logging::Error}, // PCV_Invalid_Delimiter_Char
+      {(Error_Code(1) << 16) + 10, "Invalid parameter contents - the_input_string is empty.", nullptr, Logging::Error}, // PCV_Empty_Input_String
+      {(Error_Code(1) << 16) + 11, "Invalid parameter contents: the_input_string does not contain an Equal Sign", nullptr, Logging::Error}, // LV_Missing_Equal_Sign
+      {(Error_Code(1) << 16) + 12, "Invalid parameter contents: the_input_string does not contain an Equal Sign", nullptr, Logging::Error}, // RV_Missing_Equal_Sign
+      {(Error_Code(1) << 16) + 13, "Invalid parameter value - the_output_string is not initialized to NULL - memory leak?", nullptr, Logging::Error}, // CtWC_Invalid_Output_State
+      {(Error_Code(1) << 16) + 14, "Invalid parameter value - the_input_string is NULL.", nullptr, Logging::Error}, // CtWC_Invalid_Input_Address
+      {(Error_Code(1) << 16) + 15, "Invalid parameter value - the_input_length is zero.", nullptr, Logging::Error}, // CtWC_Invalid_Input_Length
+      {(Error_Code(1) << 16) + 16, "Memory allocation error - could not allocate the_output_string.", nullptr, Logging::Error}, // CtWC_Memory_Allocation_Error
+      {(Error_Code(1) << 16) + 17, "Failed to set Locale to user defaults", nullptr, Logging::Error}, // CtWC_Setlocale_Error
+      {(Error_Code(1) << 16) + 18, "Call to std::mbstowcs failed", nullptr, Logging::Error}, // CtWC_Conversion_Error
+      {(Error_Code(1) << 16) + 19, "Invalid parameter value - the_output_string is not initialized to NULL - memory leak?", nullptr, Logging::Error}, // WCtC_Invalid_Output_State
+      {(Error_Code(1) << 16) + 20, "Invalid parameter value - the_input_string is NULL.", nullptr, Logging::Error}, // WCtC_Invalid_Input_Address
+      {(Error_Code(1) << 16) + 21, "Invalid parameter value - the_input_length is zero.", nullptr, Logging::Error}, // WCtC_Invalid_Input_Length
+      {(Error_Code(1) << 16) + 22, "Memory allocation error - could not allocate the_output_string.", nullptr, Logging::Error}, // WCtC_Memory_Allocation_Error
+      {(Error_Code(1) << 16) + 23, "Failed to set Locale to user defaults", nullptr, Logging::Error}, // WCtC_Setlocale_Error
+      {(Error_Code(1) << 16) + 24, "Call to std::wcstombs failed", nullptr, Logging::Error}, // WCtC_Conversion_Error
+      {(Error_Code(1) << 16) + 25, "Invalid parameter length - the_input_string is empty.", nullptr, Logging::Error}, // WCtC2_Empty_Input_String
+      {(Error_Code(1) << 16) + 26, "No output string was created.", nullptr, Logging::Error}, // WCtC2_No_Output_String
+      {(Error_Code(1) << 16) + 27, "Invalid parameter value - the_format is too short", nullptr, Logging::Error}, // SNPA_Invalid_FormatLength
+      {(Error_Code(1) << 16) + 28, "Invalid parameter value - the_maximum_length is to short", nullptr, Logging::Error}, // SNPA_Invalid_Maximum_Length
+      {(Error_Code(1) << 16) + 29, "Invalid parameter address - the_byte_array is NULL.", nullptr, Logging::Error}, // BTHS_Invalid_Byte_Array_Address
+      {(Error_Code(1) << 16) + 30, "Invalid parameter value - the_byte_array_length is zero.", nullptr, Logging::Error}, // BTHS_Invalid_Byte_Array_Length
+      {(Error_Code(1) << 16) + 31, "Invalid parameter length - the_string is empty.", nullptr, Logging::Error}, // SMWWA_Invalid_String_Len
+      {(Error_Code(1) << 16) + 32, "Memory allocation error - could not allocate N bytes for the local buffer.", "Memory allocation error - could not allocate %lld bytes for the local buffer.", Logging::Error}, // SNPA_Memory_Allocation_Error
+      {(Error_Code(1) << 16) + 33, "The call to std::vsnprintf failed", nullptr, Logging::Error}, // SNPA_Format_Error2
+      {(Error_Code(1) << 16) + 34, "Call to localtime failed", nullptr, Logging::Error}, // HRTS_localtime_Error
+      {(Error_Code(1) << 16) + 35, "Call to std::fopen failed - Is this a Linux system?", nullptr, Logging::Error}, // GLCN_FOpen_Error
+      {(Error_Code(1) << 16) + 36, "Invalid parameter length - the_string is empty.", nullptr, Logging::Error}, // R_Empty_Input_String
+      {(Error_Code(1) << 16) + 37, "Invalid parameter length - the_string_to_replace is empty.", nullptr, Logging::Error}, // R_Empty_String_To_Replace
+      {(Error_Code(1) << 16) + 38, "Invalid parameter length - the_replacement_string is empty.", nullptr, Logging::Error}, // R_Empty_Replacement_String
+      {(Error_Code(1) << 16) + 39, "Invalid parameter value - the_delimiting_character is zero.", nullptr, Logging::Error}, // PCV2_Invalid_Delimiter_Char
+      {(Error_Code(1) << 16) + 40, "Invalid parameter contents - the_input_string is empty.", nullptr, Logging::Error}, // PCV2_Empty_Input_String
+      {(Error_Code(1) << 16) + 41, "Invalid parameter length - the_wildcard_string is empty.", nullptr, Logging::Error}, // WTRW_Empty_Wildcard_String
+      {(Error_Code(1) << 16) + 42, "Invalid parameter length - the_wildcard_string is empty.", nullptr, Logging::Error}, // WTRA_Empty_Wildcard_String
+      {(Error_Code(1) << 16) + 43, "Invalid parameter length - the_wildcard_string is empty.", nullptr, Logging::Error}, // SMWW_Invalid_Wildcard_String_Len
+      {(Error_Code(1) << 16) + 44, "Invalid parameter length - the_string is empty.", nullptr, Logging::Error}, // SMWW_Invalid_String_Len
+      {(Error_Code(1) << 16) + 45, "Invalid parameter value - the_format is too short", nullptr, Logging::Error}, // SNPW_Invalid_FormatLength
+      {(Error_Code(1) << 16) + 46, "Invalid parameter value - the_maximum_length is to short", nullptr, Logging::Error}, // SNPW_Invalid_Maximum_Length
+      {(Error_Code(1) << 16) + 47, "Memory allocation error - could not allocate the_maximum_length bytes for the local buffer.", "Memory allocation error - could not allocate %lld bytes for the local buffer.", Logging::Error}, // SNPW_Memory_Allocation_Error
+      {(Error_Code(1) << 16) + 48, "The call to std::vswprintf failed", nullptr, Logging::Error}, // SNPW_Format_Error2
+      {(Error_Code(1) << 16) + 49, "Call to localtime failed", "Call to localtime failed with error %d", Logging::Error}, // TTTS_localtime_s_Error
+      {(Error_Code(1) << 16) + 50, "Call to std::fgets failed.", nullptr, Logging::Error}, // GLCN_FGets_Error
+      {(Error_Code(1) << 16) + 51, "Call to std::fclose failed.", nullptr, Logging::Error}, // GLCN_FClose_Error
+      {(Error_Code(1) << 16) + 52, "Invalid parameter length - the_wildcard_string is empty.", nullptr, Logging::Error}, // SMWWA_Invalid_Wildcard_String_Len
+      {(Error_Code(1) << 16) + 53, "Call to localtime failed with error X", "Call to localtime failed with error %d", Logging::Error}, // TTTST_localtime_s_Error
+      {(Error_Code(1) << 16) + 54, "Invalid parameter state - the_time_info.tm_mday == X", "Invalid parameter state - the_time_info.tm_mday == %d", Logging::Error}, // STTT_Invalid_Day
+      {(Error_Code(1) << 16) + 55, "Invalid parameter value - the_buffer is NULL or shorter than Max_Timestamp_Length", nullptr, Logging::Error}, // TS_Invalid_Buffer
+      {(Error_Code(1) << 16) + 56, "Call to localtime failed", "Call to localtime failed with error %d", Logging::Error}, // TS_localtime_Error
+      // A4_Active_Object_Module_ID - Active_Object_Errors
+      {(Error_Code(2) << 16) + 0, "Invalid parameter value - the_number_of_worker_threads is less than the minimum.", nullptr, Logging::Error}, // I_Insufficient_Threads
+      {(Error_Code(2) << 16) + 1, "Instance is already initialized.", nullptr, Logging::Error}, // I_Already_Initialized
+      {(Error_Code(2) << 16) + 2, "The instance is already started.", nullptr, Logging::Error}, // S_Already_Started
+      {(Error_Code(2) << 16) + 3, "The instance is not initialized.", nullptr, Logging::Error}, // S_Not_Initialized
+      {(Error_Code(2) << 16) + 4, "The instance is already stopped.", nullptr, Logging::Error}, // S_Not_Started
+      {(Error_Code(2) << 16) + 5, "Invalid parameter value - the_message_queue_wait < Min_Message_Queue_Wait_MS", nullptr, Logging::Error}, // I_Invalid_MQ_Wait
+      {(Error_Code(2) << 16) + 6, "Invalid parameter value - the_maximum_queued_items is too small.", nullptr, Logging::Error}, // I_Invalid_Max_Queued_Items
+      {(Error_Code(2) << 16) + 7, "The instance is not started - no new messages may be Enqueued.", nullptr, Logging::Error}, // EM_Not_Started
+      {(Error_Code(2) << 16) + 8, "This method should not be called but overridden by the subclass. The message was not processed.", nullptr, Logging::Error}, // PM_Message_Not_Handled
+      {(Error_Code(2) << 16) + 9, "Failed to start a required thread - could be a system resource issue, but most probably a coding error.", "Failed to start the required %lld threads, instead %lld were created.", Logging::Error}, // S_Bad_Thread_Count
+      {(Error_Code(2) << 16) + 10, "The instance is not started - no new method requests may be submitted.", nullptr, Logging::Error}, // SU_Not_Started
+      {(Error_Code(2) << 16) + 11, "Invalid parameter state - the_future is already valid - a previous result would be lost.", nullptr, Logging::Error}, // SU_Invalid_Future_State
+      {(Error_Code(2) << 16) + 12, "The instance is not initialized.", nullptr, Logging::Error}, // AE_Not_Initialized
+      {(Error_Code(2) << 16) + 13, "The instance is already started - an executor must be attached before Start.", nullptr, Logging::Error}, // AE_Already_Started
+      {(Error_Code(2) << 16) + 14, "Invalid parameter address - the_executor is nullptr.", nullptr, Logging::Error}, // AE_Invalid_Address
+      {(Error_Code(2) << 16) + 15, "Invalid parameter value - the_max_concurrency must be non-zero.", nullptr, Logging::Error}, // AE_Invalid_Concurrency
+      {(Error_Code(2) << 16) + 16, "The instance is not started - no new method requests may be enqueued.", nullptr, Logging::Error}, // ER_Not_Started
+      {(Error_Code(2) << 16) + 17, "Memory allocation error - could not allocate a new worker statistics slot.", nullptr, Logging::Error}, // ASS_Allocation_Error
+      {(Error_Code(2) << 16) + 18, "Invalid parameter value - the_seconds must not be negative.", nullptr, Logging::Error}, // SSLI_Invalid_Interval
+      // A4_Config_File_Module_ID - App_Config_Errors
+      {(Error_Code(3) << 16) + 0, "Memory allocation error - could not allocate the root node.", nullptr, Logging::Error}, // RC_Root_Allocation_Error
+      {(Error_Code(3) << 16) + 1, "A duplicate Section was detected. These must be unique - see log for the name", "A duplicate Section [%s] was detected. These must be unique.", Logging::Error}, // INN_Duplicate_Section
+      {(Error_Code(3) << 16) + 2, "The required section is missing - see log for the name", "The required section [%s] is missing.", Logging::Error}, // INN_Missing_Section
+      {(Error_Code(3) << 16) + 3, "The required section is missing - see log for the name", "The required section [%s] is missing.", Logging::Error}, // INN_Missing_Section2
+      {(Error_Code(3) << 16) + 4, "An unsupported node type was encounterd - see the log for the enumeration value.", "An unsupported node type (%d) was encountered.", Logging::Error}, // INN_Unsupported_Node_Type
+      {(Error_Code(3) << 16) + 5, "An Undefined node type was encountered.", nullptr, Logging::Error}, // INN_Undefined_Node_Type
+      {(Error_Code(3) << 16) + 6, "A duplicate Pair was detected - see log for details", "A duplicate Pair was detected (Section [%s] and Key %s).", Logging::Error}, // INN_Duplicate_Pair_Found
+      {(Error_Code(3) << 16) + 7, "Instance is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(3) << 16) + 8, "Invalid parameter value - the_filespec is empty", nullptr, Logging::Error}, // O_Empty_Fiename
+      {(Error_Code(3) << 16) + 9, "Missing configuration file - besure to verify the filespec", "Missing file- %s does not exist.", Logging::Error}, // O_No_File
+      {(Error_Code(3) << 16) + 10, "Failed to open the configuration file", "Failed to open the configuration file %s.", Logging::Error}, // O_File_Open_Failure
+      {(Error_Code(3) << 16) + 11, "Instance is not open. Not possible to read anything.", nullptr, Logging::Error}, // GS_Not_Open
+      {(Error_Code(3) << 16) + 12, "Invalid parameter value - the_section_name is empty", nullptr, Logging::Error}, // GS_No_Section
+      {(Error_Code(3) << 16) + 13, "Invalid parameter value - the_key_name is empty", nullptr, Logging::Error}, // GS_No_Key
+      {(Error_Code(3) << 16) + 14, "n Invalid Section Length was encountered", nullptr, Logging::Error}, // RL_Invalid_Section_Length
+      {(Error_Code(3) << 16) + 15, "An invalid Value Name / Value was encountered", nullptr, Logging::Error}, // RL_Invalid_Pair_Length
+      {(Error_Code(3) << 16) + 16, "Memory allocation error - could not allocate a new App_Config_Node", nullptr, Logging::Error}, // RL_Allocation_Error
+      {(Error_Code(3) << 16) + 17, "An invalid Node Type was encountered", nullptr, Logging::Error}, // RL_Unsupported_Node_Type
+      {(Error_Code(3) << 16) + 18, "Failed to open the configuration file.", nullptr, Logging::Error}, // RCJ_File_Open_Failure
+      {(Error_Code(3) << 16) + 19, "This instance is not open.", nullptr, Logging::Error}, // C_Not_Open
+      {(Error_Code(3) << 16) + 20, "Invalid state - the instance needs to be Open.", nullptr, Logging::Error}, // GSD_Not_Open
+      {(Error_Code(3) << 16) + 21, "Invalid parameter length - the_section_name is empty.", nullptr, Logging::Error}, // GVBS_No_Section_Name
+      {(Error_Code(3) << 16) + 22, "Invalid state - the instance needs to be Open.", nullptr, Logging::Error}, // GVBS_Not_Open
+      {(Error_Code(3) << 16) + 23, "Section %s was not found in the configuration file", nullptr, Logging::Error}, // GVBS_Section_Not_Found
+      // A4_Log_Module_ID - File_Logger_Errors
+      {(Error_Code(4) << 16) + 0, "Invalid parameter length - the_header_text is too long - must be < File_Logger_Constants::Max_Header_Text_Length", nullptr, Logging::Error}, // SLHT_Text_Too_Long
+      {(Error_Code(4) << 16) + 1, "The logging singleton has already been allocated", nullptr, Logging::Error}, // AS_Already_Allocated
+      {(Error_Code(4) << 16) + 2, "Memory allocation error - could not allocate a new A4_Lib::File_Logger instance.", nullptr, Logging::Error}, // AS_Allocation_Error
+      {(Error_Code(4) << 16) + 3, "Invalid parameter address - the_message_block == nullptr", nullptr, Logging::Error}, // PM_Invalid_Message_Block
+      {(Error_Code(4) << 16) + 4, "File_Logger singleton is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(4) << 16) + 5, "File_Logger is not open.", nullptr, Logging::Error}, // C_Not_Open
+      {(Error_Code(4) << 16) + 6, "Invalid parameter length - the_log_filespec is too short.", nullptr, Logging::Error}, // ILF_Invalid_Filespec_Length
+      {(Error_Code(4) << 16) + 7, "Invalid parameter value - the_max_log_file_size is too small.", nullptr, Logging::Error}, // O_Invalid_Max_Log_File_Size
+      {(Error_Code(4) << 16) + 8, "Parsing the_log_filespec resulted in a parsed vector that is too short.", nullptr, Logging::Error}, // ILF_Invalid_Filespec_Vector_Size
+      {(Error_Code(4) << 16) + 9, "Parsing the file name resulted in a parsed vector that is too short.", nullptr, Logging::Error}, // ILF_Invalid_Filename_Vector_Size
+      {(Error_Code(4) << 16) + 10, "Invalid member state - this->log_file is not NULL.", nullptr, Logging::Error}, // OLF_File_Already_Open
+      {(Error_Code(4) << 16) + 11, "Call to Log_File_Writer::Open resulted in error", "Call to Log_File_Writer::Open resulted in error for filespec %s", Logging::Error}, // OLF_fopen_Error
+      {(Error_Code(4) << 16) + 12, "Call to Log_File_Writer::Close resulted in error", nullptr, Logging::Error}, // CLF_fclose_Error
+      {(Error_Code(4) << 16) + 13, "Invalid state - the log file is not open.", nullptr, Logging::Error}, // IW_Log_File_Not_Open
+      {(Error_Code(4) << 16) + 14, "Call to Log_File_Writer::Write_Batch failed - enough storage space?", nullptr, Logging::Error}, // IW_FWrite_Error
+      {(Error_Code(4) << 16) + 15, "Invalid parameter length - the_log_text is empty.", nullptr, Logging::Error}, // W2_Invalid_Text_Length
+      {(Error_Code(4) << 16) + 16, "Invalid parameter length - the_log_text is empty.", nullptr, Logging::Error}, // W3_Invalid_Text_Length
+      {(Error_Code(4) << 16) + 17, "Memory allocation error - could not allocate the calling thread's Log_Staging_Buffer.", nullptr, Logging::Error}, // SR_Allocation_Error
+      {(Error_Code(4) << 16) + 18, "The calling thread's Log_Staging_Buffer stayed full for Max_Staging_Wait_MS - the log line was dropped.", nullptr, Logging::Error}, // SR_Staging_Buffer_Full
+      {(Error_Code(4) << 16) + 19, "Invalid state - the File_Logger is already open.", nullptr, Logging::Error}, // SBM_Already_Open
+      {(Error_Code(4) << 16) + 20, "Invalid parameter value - the_format_id is not registered.", nullptr, Logging::Error}, // SE_Invalid_Format_ID
+      {(Error_Code(4) << 16) + 21, "Call to Log_File_Writer::Write_Batch failed writing the binary log file magic.", nullptr, Logging::Error}, // OLF_Magic_Write_Error
+      {(Error_Code(4) << 16) + 22, "Invalid state - the log file is not open.", nullptr, Logging::Error}, // F_Not_Open
+      {(Error_Code(4) << 16) + 23, "Invalid state - the File_Logger is already open.", nullptr, Logging::Error}, // SIU_Already_Open
+      {(Error_Code(4) << 16) + 24, "Invalid parameter length - the_log_text is NULL or empty.", nullptr, Logging::Error}, // W4_Invalid_Text_Length
+      {(Error_Code(4) << 16) + 25, "Invalid state - the File_Logger is already open.", nullptr, Logging::Error}, // SJM_Already_Open
+      {(Error_Code(4) << 16) + 26, "Invalid state - binary mode is set, the two are exclusive.", nullptr, Logging::Error}, // SJM_Binary_Mode
+      {(Error_Code(4) << 16) + 27, "Invalid state - JSON mode is set, the two are exclusive.", nullptr, Logging::Error}, // SBM_JSON_Mode
+      {(Error_Code(4) << 16) + 28, "Invalid state - the File_Logger is already open.", nullptr, Logging::Error}, // SC_Already_Open
+      {(Error_Code(4) << 16) + 29, "Built without zlib - rolled-over log files cannot be compressed.", nullptr, Logging::Error}, // SC_Not_Supported
+      {(Error_Code(4) << 16) + 30, "Invalid state - the File_Logger is already open.", nullptr, Logging::Error}, // SCR_Already_Open
+      {(Error_Code(4) << 16) + 31, "Invalid parameter value - the_size is outside Log_Crash_Ring_Constant::Min_Size .. Max_Size.", nullptr, Logging::Error}, // SCR_Invalid_Size
+      {(Error_Code(4) << 16) + 32, "Call to Log_File_Writer::Write_Batch failed writing the recovered records - enough storage space?", nullptr, Logging::Error}, // OCR_Write_Error
+      // A4_Observer_Module_ID - Observer_Errors
+      {(Error_Code(5) << 16) + 0, "Method not implemented - need to provide an override", nullptr, Logging::Error}, // N_Not_Implemented
+      // A4_Observable_Module_ID - Observable_Errors
+      {(Error_Code(6) << 16) + 0, "Invalid parameter address - the_observer_instance", nullptr, Logging::Error}, // RO_Invalid_Observer_Address
+      {(Error_Code(6) << 16) + 2, "The observer instance was not found in the observer map", nullptr, Logging::Error}, // UO_Observer_Not_Found
+      {(Error_Code(6) << 16) + 4, "UO Erase Failed", nullptr, Logging::Error}, // UO_Erase_Failed
+      {(Error_Code(6) << 16) + 6, "An invalid Observer address was encountered.", nullptr, Logging::Error}, // NO_Invalid_Observer_Address2
+      {(Error_Code(6) << 16) + 8, "Duplicate address - the_observer_instance is already registered.", nullptr, Logging::Error}, // ROSP_Duplicate_Observer
+      {(Error_Code(6) << 16) + 10, "An invalid Observer address was encountered.", nullptr, Logging::Error}, // NO_Invalid_Observer_Address
+      {(Error_Code(6) << 16) + 12, "Instance state - this instance already has a non-NULL value for c_observer_instance.", nullptr, Logging::Error}, // SO_Instance_Already_Set
+      {(Error_Code(6) << 16) + 14, "Invalid state - this instance is marked as Shared.", nullptr, Logging::Error}, // SO_Instance_Is_Shared2
+      {(Error_Code(6) << 16) + 16, "Invalid parameter address - the_new_instance is not nullptr", nullptr, Logging::Error}, // A_Already_Allocated
+      {(Error_Code(6) << 16) + 18, "Duplicate address - the_observer_instance is already registered.", nullptr, Logging::Error}, // ROSP_Duplicate_Observer2
+      // A4_Message_Block_Module_ID - Message_Block_Errors
+      {(Error_Code(8) << 16) + 0, "Invalid parameter value - the_max_data_length must be > zero.", nullptr, Logging::Error}, // SD_Invalid_Num_Bytes
+      {(Error_Code(8) << 16) + 1, "Invalid parameter address - the_data is NULL", nullptr, Logging::Error}, // SD_Invalid_Data_Address
+      {(Error_Code(8) << 16) + 2, "Invalid parameter address - the_data is NULL", nullptr, Logging::Error}, // GD_Invalid_Data_Address
+      {(Error_Code(8) << 16) + 3, "Invalid parameter value - the_byte_offset is larger than this->data_length.", nullptr, Logging::Error}, // GD_Invalid_Byte_Offset
+      {(Error_Code(8) << 16) + 4, "Invalid parameter value - the_max_data_length is smaller than this->data_length - your buffer is too small.", nullptr, Logging::Error}, // GD_Invalid_Num_Bytes
+      {(Error_Code(8) << 16) + 5, "The data length at vector offset X is zero. This means the data stored was passed as a std::shared_ptr and must be retrieved the same way.", "The data length at vector offset %ld is zero. This means the data stored was passed as a std::shared_ptr and must be retrieved the same way.", Logging::Error}, // GD_Invalid_Data_Length
+      {(Error_Code(8) << 16) + 6, "Invalid parameter address - the_data == nullptr", nullptr, Logging::Error}, // SD_Invalid_Data_Address2
+      {(Error_Code(8) << 16) + 7, "Memory allocation error - could not allocate X bytes for the new shared pointer.", "Memory allocation error - could not allocate %ld bytes for the new shared pointer.", Logging::Error}, // SD_Allocation_Error
+      {(Error_Code(8) << 16) + 8, "Invalid parameter value - the_vector_offset X must be less than Y", "Invalid parameter value - the_vector_offset (%ld) must be less than %ld", Logging::Error}, // GD_Invalid_Offset
+      {(Error_Code(8) << 16) + 9, "No child message block has been Set, so none to Get.", nullptr, Logging::Error}, // GCMB_Child_Not_Set
+      {(Error_Code(8) << 16) + 10, "Invalid parameter state - the_child must equal nullptr - check for memory issue.", nullptr, Logging::Error}, // GCMB_Invalid_Address
+      {(Error_Code(8) << 16) + 11, "Memory allocation error - could not allocate a new Message_Block instance.", nullptr, Logging::Error}, // A_Allocation_Error
+      {(Error_Code(8) << 16) + 12, "Invalid parameter value - the_child == nullptr", nullptr, Logging::Error}, // SCMB_Invalid_Child
+      {(Error_Code(8) << 16) + 13, "The child message block has already been set. This method is not recursive!", nullptr, Logging::Error}, // SCMB_Child_Already_Set
+      {(Error_Code(8) << 16) + 14, "Invalid parameter state - the_new_instance != nullptr, indicating a possible memory leak.", nullptr, Logging::Error}, // A_Invalid_Parameter_State
+      {(Error_Code(8) << 16) + 15, "This instance does not have any data.", nullptr, Logging::Error}, // GD_No_Data
+      {(Error_Code(8) << 16) + 16, "Invalid parameter length - the_string is empty.", nullptr, Logging::Error}, // SD_Empty_String
+      {(Error_Code(8) << 16) + 17, "Invalid parameter value - the_byte_offset is larger than this->data_length", nullptr, Logging::Error}, // GDS_Invalid_Byte_Offset
+      {(Error_Code(8) << 16) + 18, "Memory allocation error - could not allocate a new string buffer.", nullptr, Logging::Error}, // GD_Allocation_Error
+      {(Error_Code(8) << 16) + 19, "Invalid number of bytes retrieved X when Y were expected.", "Invalid number of bytes retrieved (%lld) when %lld were expected.", Logging::Error}, // GDS_Invalid_Bytes_Retrieved
+      {(Error_Code(8) << 16) + 20, "An invalid number of bytes were retrieved X instead of the expected Y bytes.", "An invalid number of bytes were retrieved (%lld) instead of the expected %lld bytes.", Logging::Error}, // GDT_Incorrect_Bytes_Retrieved
+      {(Error_Code(8) << 16) + 21, "Invalid number of bytes retrieved (%lld) when %lld were expected.", nullptr, Logging::Error}, // GDAS_Invalid_Bytes_Retrieved
+      {(Error_Code(8) << 16) + 22, "Memory allocation error - could not allocate a new string buffer.", nullptr, Logging::Error}, // GDAS_Allocation_Error
+      {(Error_Code(8) << 16) + 23, "Invalid parameter length - the_string is empty.", nullptr, Logging::Error}, // SDAS_Empty_String
+      {(Error_Code(8) << 16) + 24, "Invalid parameter value - the_byte_offset is larger than this->data_length", nullptr, Logging::Error}, // GDAS_Invalid_Byte_Offset
+      // A4_Message_Queue_Module_ID - Message_Queue_Errors
+      {(Error_Code(9) << 16) + 0, "Invalid parameter address - the_message_block is nullptr", nullptr, Logging::Error}, // EQ_Invalid_Address
+      {(Error_Code(9) << 16) + 1, "Memory allocation error - could not allocate a new Message_Queue instance.", nullptr, Logging::Error}, // A_Allocation_Error
+      {(Error_Code(9) << 16) + 2, "Invalid parameter value - the_max_milli_seconds_to_wait < 0", nullptr, Logging::Error}, // EQ_Negative_Time
+      {(Error_Code(9) << 16) + 3, "The message queue is no longer activated - message not inserted into the queue.", nullptr, Logging::Error}, // EQ_Not_Activated2
+      {(Error_Code(9) << 16) + 4, "Could not Enqueue the message block within the allotted time.", nullptr, Logging::Error}, // EQ_Timeout2
+      {(Error_Code(9) << 16) + 5, "Message queue is not in an Activated state - could not enqueue the message block.", nullptr, Logging::Error}, // EQ_Not_Activated
+      {(Error_Code(9) << 16) + 6, "Message queue is not in an Activated state - could not dequeue the message block.", nullptr, Logging::Error}, // DQ_Not_Activated
+      {(Error_Code(9) << 16) + 7, "Invalid parameter address - the_message_block is not nullptr, indicating a memory leak?", nullptr, Logging::Error}, // DQ_Invalid_Input_Address
+      {(Error_Code(9) << 16) + 8, "Invalid parameter value - the_max_milli_seconds_to_wait < 0", nullptr, Logging::Error}, // DQ_Negative_Time
+      {(Error_Code(9) << 16) + 9, "Instance is already initialized.", nullptr, Logging::Error}, // I_Already_Initialized
+      {(Error_Code(9) << 16) + 10, "Invalid parameter value - the_maximum_queued_items should be set to a non-zero value.", nullptr, Logging::Error}, // I_Invalid_Max_Value
+      {(Error_Code(9) << 16) + 11, "Invalid parameter state - the_new_queue must equal nullptr - memory leak?", nullptr, Logging::Error}, // A_Invalid_Initial_State
+      {(Error_Code(9) << 16) + 12, "Invalid parameter address - the_request is nullptr", nullptr, Logging::Error}, // EQR_Invalid_Address
+      {(Error_Code(9) << 16) + 13, "Message queue is not in an Activated state - could not enqueue the method request.", nullptr, Logging::Error}, // EQR_Not_Activated
+      {(Error_Code(9) << 16) + 14, "Invalid parameter value - the_max_milli_seconds_to_wait < 0", nullptr, Logging::Error}, // EQR_Negative_Time
+      {(Error_Code(9) << 16) + 15, "Could not Enqueue the method request within the allotted time.", nullptr, Logging::Error}, // EQR_Timeout
+      {(Error_Code(9) << 16) + 16, "Message queue is not in an Activated state - could not dequeue.", nullptr, Logging::Error}, // DQR_Not_Activated
+      {(Error_Code(9) << 16) + 17, "Invalid parameter address - the_message_block or the_request is not nullptr, indicating a memory leak?", nullptr, Logging::Error}, // DQR_Invalid_Input_Address
+      {(Error_Code(9) << 16) + 18, "Invalid parameter value - the_max_milli_seconds_to_wait < 0", nullptr, Logging::Error}, // DQR_Negative_Time
+      // A4_Timed_Mutex_Module_ID - Timed_Mutex_Errors
+      {(Error_Code(10) << 16) + 0, "Invalid parameter value - the_max_milli_seconds_to_wait < 0", nullptr, Logging::Error}, // L_Negative_Time
+      {(Error_Code(10) << 16) + 2, "Invalid parameter value - the_mutex_is_locked should be true if the mutex has already been locked.", nullptr, Logging::Error}, // U_Invalid_Param
+      {(Error_Code(10) << 16) + 4, "The calling thread is not the owner of this mutex instance.", nullptr, Logging::Error}, // U_Not_The_Owner
+      // A4_Mutex_Module_ID - Mutex_Errors
+      {(Error_Code(11) << 16) + 0, "the_mutex_is_locked is not false. Is the mutex already acquired or is the parameter not initialized?", nullptr, Logging::Error}, // L_Invalid_Acquired_State
+      {(Error_Code(11) << 16) + 1, "Invalid parameter value - the_mutex_is_locked is not true", nullptr, Logging::Error}, // U_Invalid_Parameter_Value
+      {(Error_Code(11) << 16) + 2, "The current thread already owns this mutex - fix the error or consider using the A4_Lib::Recursive_Mutex.", nullptr, Logging::Error}, // L_Recursive_Call
+      {(Error_Code(11) << 16) + 3, "The calling thread is not the owner of this mutex instance.", nullptr, Logging::Error}, // U_Not_The_Owner
+      {(Error_Code(11) << 16) + 4, "Invalid mutex state - attempting to unlock a Mutex that is not currently locked by this thread.", nullptr, Logging::Error}, // U_Not_Locked
+      // A4_Shared_Timed_Mutex_Module_ID - Shared_Timed_Mutex_Errors
+      {(Error_Code(19) << 16) + 0, "Invalid parameter value - the_mutex_is_locked - needs to be false or you need to use a Recursive mutex.", nullptr, Logging::Error}, // L_Already_Locked1
+      {(Error_Code(19) << 16) + 2, "Invalid parameter value - the_mutex_is_locked - needs to be true.", nullptr, Logging::Error}, // U_Not_Locked1
+      {(Error_Code(19) << 16) + 4, "U ID Not Erased", "Thread ID %ld was not erased from this->thread_id_map", Logging::Error}, // U_ID_Not_Erased
+      // A4_File_Util_Module_ID - A4_File_Util_Errors
+      {(Error_Code(26) << 16) + 0, "Invalid parameter value - the_filespec is empty.", nullptr, Logging::Error}, // GFLMT_Invalid_Filespec
+      {(Error_Code(26) << 16) + 2, "Invalid parameter value - the_filespec is empty.", nullptr, Logging::Error}, // GFCT_Invalid_Filespec
+      {(Error_Code(26) << 16) + 4, "Invalid parameter length - the_filespec is empty.", nullptr, Logging::Error}, // GFS_Invalid_Filespec
+      {(Error_Code(26) << 16) + 6, "Invalid parameter length - the_search_string is empty", nullptr, Logging::Error}, // GFV_Empty_Search_String
+      {(Error_Code(26) << 16) + 8, "the_search_string did not parse into a searchable vector.", nullptr, Logging::Error}, // GLFV_Empty_Vector1
+      {(Error_Code(26) << 16) + 10, "GLFV Folder Not Found", "Folder '%s' was not found", Logging::Error}, // GLFV_Folder_Not_Found
+      {(Error_Code(26) << 16) + 12, "DF No File Exists", "No file exists with name %s", Logging::Error}, // DF_No_File_Exists
+      // A4_Logger_Base_Module_ID - Logger_Errors
+      {(Error_Code(28) << 16) + 0, "Invalid parameter address - the_instance_pointer == nullptr", nullptr, Logging::Error}, // SIP_Invalid_Pointer_Address
+      {(Error_Code(28) << 16) + 1, "method Write must be overridden in the subclass, not called here.", nullptr, Logging::Error}, // W_Not_Implemented
+      {(Error_Code(28) << 16) + 2, "Open has already been called and the log is open for business", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(28) << 16) + 3, "Instance is already closed or was never open.", nullptr, Logging::Error}, // C_Already_Closed
+      {(Error_Code(28) << 16) + 4, "method Write must be overridden in the subclass, not called here.", nullptr, Logging::Error}, // W_Not_Implemented2
+      {(Error_Code(28) << 16) + 5, "method Write must be overridden in the subclass, not called here.", nullptr, Logging::Error}, // W_Not_Implemented3
+      {(Error_Code(28) << 16) + 6, "method Write (module) must be overridden in the subclass, not called here.", nullptr, Logging::Error}, // W_Not_Implemented4
+      {(Error_Code(28) << 16) + 7, "Invalid parameter value - the_module_id is not below Max_Filtered_Modules.", nullptr, Logging::Error}, // SMDL_Invalid_Module_ID
+      // A4_Property_Value_Map_Module_ID - Property_Value_Map_Errors
+      {(Error_Code(32) << 16) + 0, "AP Invalid Property Name Length", nullptr, Logging::Error}, // AP_Invalid_Property_Name_Length
+      {(Error_Code(32) << 16) + 2, "Invalid parameter length - the_property_name is empty.", nullptr, Logging::Error}, // RP_Invalid_Property_Name_Len
+      {(Error_Code(32) << 16) + 4, "GVT Not Found", nullptr, Logging::Error}, // GVT_Not_Found
+      // A4_Connection_Module_ID - Connection_Errors
+      {(Error_Code(33) << 16) + 0, "Invalid parameter value - the_connection_id", nullptr, Logging::Error}, // SCI_Invalid_Connection_ID
+      {(Error_Code(33) << 16) + 1, "This instance is already initialized.", nullptr, Logging::Error}, // I_Already_Initialized
+      // A4_Credential_Module_ID - Credential_Errors
+      {(Error_Code(35) << 16) + 0, "Instance is already initialized.", nullptr, Logging::Error}, // I_Already_Initialized
+      {(Error_Code(35) << 16) + 1, "Invalid parameter value - the_credential_type", nullptr, Logging::Error}, // I_Undefined_Credential_Type
+      {(Error_Code(35) << 16) + 2, "Invalid instance state - not initialized.", nullptr, Logging::Error}, // GCT_Not_Initialized
+      // A4_Method_Request_Module_ID - Request_Pool_Errors
+      {(Error_Code(49) << 16) + 0, "Invalid parameter state - the_new_pool must equal nullptr - memory leak?", nullptr, Logging::Error}, // A_Invalid_Initial_State
+      {(Error_Code(49) << 16) + 1, "Memory allocation error - could not allocate a new Request_Pool instance.", nullptr, Logging::Error}, // A_Allocation_Error
+      {(Error_Code(49) << 16) + 2, "The submitted callable threw an exception - it has been passed on to the future (or discarded when posted).", nullptr, Logging::Error}, // C_Callable_Exception
+      // A4_Executor_Module_ID - Executor_Errors
+      {(Error_Code(50) << 16) + 0, "Invalid parameter state - the_new_executor must equal nullptr - memory leak?", nullptr, Logging::Error}, // A_Invalid_Initial_State
+      {(Error_Code(50) << 16) + 1, "Memory allocation error - could not allocate a new Executor instance.", nullptr, Logging::Error}, // A_Allocation_Error
+      {(Error_Code(50) << 16) + 2, "Instance is already initialized.", nullptr, Logging::Error}, // I_Already_Initialized
+      {(Error_Code(50) << 16) + 3, "Invalid parameter value - the_number_of_worker_threads is less than the minimum.", nullptr, Logging::Error}, // I_Insufficient_Threads
+      {(Error_Code(50) << 16) + 4, "Invalid parameter value - the_idle_wait < Min_Idle_Wait_MS.", nullptr, Logging::Error}, // I_Invalid_Idle_Wait
+      {(Error_Code(50) << 16) + 5, "Invalid parameter value - the_slice_size must be non-zero.", nullptr, Logging::Error}, // I_Invalid_Slice_Size
+      {(Error_Code(50) << 16) + 6, "The instance is already started.", nullptr, Logging::Error}, // S_Already_Started
+      {(Error_Code(50) << 16) + 7, "The instance is not initialized.", nullptr, Logging::Error}, // S_Not_Initialized
+      {(Error_Code(50) << 16) + 8, "Failed to start the required number of pool threads.", "Failed to start the required %lld threads, instead %lld were created.", Logging::Error}, // S_Bad_Thread_Count
+      {(Error_Code(50) << 16) + 9, "The instance is already stopped.", nullptr, Logging::Error}, // ST_Not_Started
+      {(Error_Code(50) << 16) + 10, "Invalid parameter address - the_active_object is nullptr.", nullptr, Logging::Error}, // AT_Invalid_Address
+      {(Error_Code(50) << 16) + 11, "The active object is already attached to this executor.", nullptr, Logging::Error}, // AT_Already_Attached
+      {(Error_Code(50) << 16) + 12, "Invalid parameter address - the_active_object is nullptr.", nullptr, Logging::Error}, // DT_Invalid_Address
+      {(Error_Code(50) << 16) + 13, "The active object is not attached to this executor.", nullptr, Logging::Error}, // DT_Not_Attached
+      // A4_Coroutine_Active_Object_Module_ID - Coroutine_Active_Object_Errors
+      {(Error_Code(51) << 16) + 0, "Invalid parameter value - the_handle is empty.", nullptr, Logging::Error}, // RS_Invalid_Handle
+      {(Error_Code(51) << 16) + 1, "The resumption could not be posted - the suspended handler has been destroyed.", nullptr, Logging::Error}, // RS_Resume_Not_Posted
+      {(Error_Code(51) << 16) + 2, "The callable threw an exception on the target object.", nullptr, Logging::Error}, // AR_Callable_Exception
+      {(Error_Code(51) << 16) + 3, "The callable could not be posted to the target object.", nullptr, Logging::Error}, // AR_Not_Posted
+      {(Error_Code(51) << 16) + 4, "Invalid parameter address - the_message_block is nullptr.", nullptr, Logging::Error}, // PM_Invalid_Address
+      {(Error_Code(51) << 16) + 5, "The handler threw an exception.", nullptr, Logging::Error}, // PT_Task_Exception
+      // A4_Pipeline_Module_ID - Pipeline_Errors
+      {(Error_Code(52) << 16) + 0, "The pipeline is started - stages must be added before Start.", nullptr, Logging::Error}, // AS_Already_Started
+      {(Error_Code(52) << 16) + 1, "Invalid parameter value - the_parallelism must be non-zero.", nullptr, Logging::Error}, // AS_Invalid_Parallelism
+      {(Error_Code(52) << 16) + 2, "Invalid parameter value - the_queue_depth is less than Active_Object_Constant::Min_Queued_Messages.", nullptr, Logging::Error}, // AS_Invalid_Queue_Depth
+      {(Error_Code(52) << 16) + 3, "The stage already belongs to a pipeline.", nullptr, Logging::Error}, // AS_Already_Added
+      {(Error_Code(52) << 16) + 4, "The pipeline is already started.", nullptr, Logging::Error}, // S_Already_Started
+      {(Error_Code(52) << 16) + 5, "The pipeline has no stages.", nullptr, Logging::Error}, // S_No_Stages
+      {(Error_Code(52) << 16) + 6, "The pipeline is already stopped.", nullptr, Logging::Error}, // ST_Not_Started
+      {(Error_Code(52) << 16) + 7, "The pipeline is not started.", nullptr, Logging::Error}, // EQ_Not_Started
+      {(Error_Code(52) << 16) + 8, "The stage has not been added to a Pipeline.", nullptr, Logging::Error}, // PM_Not_In_Pipeline
+      {(Error_Code(52) << 16) + 9, "The next stage was stopped while waiting for room in its queue - the message was dropped.", nullptr, Logging::Error}, // FW_Next_Stage_Stopped
+      {(Error_Code(52) << 16) + 10, "A stage did not drain before it was stopped - queued messages were dropped.", "%zu stage(s) did not drain before they were stopped - queued messages were dropped.", Logging::Error}, // ST_Drain_Timeout
+      // A4_Method_Profiler_Module_ID - Method_Profiler_Errors
+      {(Error_Code(53) << 16) + 0, "Invalid parameter state - the_profile must be empty.", nullptr, Logging::Error}, // GP_Invalid_Output_State
+      {(Error_Code(53) << 16) + 1, "The application log is not open.", nullptr, Logging::Error}, // LP_Log_Not_Open
+      // A4_Error_Rate_Limiter_Module_ID - Error_Rate_Limiter_Errors
+      {(Error_Code(54) << 16) + 0, "Invalid parameter value - the_interval_seconds must be greater than zero.", nullptr, Logging::Error}, // SL_Invalid_Interval
+      // A4_Tracer_Module_ID - Tracer_Errors
+      {(Error_Code(55) << 16) + 0, "Invalid parameter length - the_filespec is empty.", nullptr, Logging::Error}, // WCT_Empty_Filespec
+      {(Error_Code(55) << 16) + 1, "Call to std::fopen failed.", "Call to std::fopen failed for %s", Logging::Error}, // WCT_FOpen_Error
+      {(Error_Code(55) << 16) + 2, "Call to std::fputs or std::fclose failed - enough storage space?", nullptr, Logging::Error}, // WCT_Write_Error
+      // A4_Error_Sink_Module_ID - Error_Sink_Errors
+      {(Error_Code(56) << 16) + 0, "Invalid parameter address - the_sink is nullptr.", nullptr, Logging::Error}, // R_Invalid_Sink_Address
+      {(Error_Code(56) << 16) + 1, "the_sink is already registered.", nullptr, Logging::Error}, // R_Already_Registered
+      {(Error_Code(56) << 16) + 2, "Max_Error_Sinks sinks are already registered.", "Max_Error_Sinks (%zu) sinks are already registered.", Logging::Error}, // R_Too_Many_Sinks
+      {(Error_Code(56) << 16) + 3, "the_sink is not registered.", nullptr, Logging::Error}, // U_Not_Registered
+      {(Error_Code(56) << 16) + 4, "Memory allocation error - the_counts could not be filled.", nullptr, Logging::Error}, // GC_Allocation_Error
+      // A4_Log_File_Writer_Module_ID - Log_File_Writer_Errors
+      {(Error_Code(57) << 16) + 0, "Invalid state - a log file is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(57) << 16) + 1, "Call to open failed for the log file.", "Call to open resulted in error %d for filespec %s", Logging::Error}, // O_open_Error
+      {(Error_Code(57) << 16) + 2, "Call to fstat failed for the opened log file.", "Call to fstat resulted in error %d for filespec %s", Logging::Error}, // O_fstat_Error
+      {(Error_Code(57) << 16) + 3, "Invalid state - no log file is open.", nullptr, Logging::Error}, // WB_Not_Open
+      {(Error_Code(57) << 16) + 4, "Call to writev failed - enough storage space?", "Call to writev resulted in error %d - enough storage space?", Logging::Error}, // WB_writev_Error
+      {(Error_Code(57) << 16) + 5, "Call to fdatasync failed.", "Call to fdatasync resulted in error %d", Logging::Error}, // S_Sync_Error
+      {(Error_Code(57) << 16) + 6, "Call to close failed.", "Call to close resulted in error %d", Logging::Error}, // C_close_Error
+      {(Error_Code(57) << 16) + 7, "Call to fcntl failed clearing O_APPEND - writing with writev.", "Call to fcntl resulted in error %d clearing O_APPEND - writing with writev", Logging::Warning}, // SIU_fcntl_Error
+      // A4_Log_Uring_Module_ID - Log_Uring_Errors
+      {(Error_Code(58) << 16) + 0, "Invalid state - the ring is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(58) << 16) + 1, "io_uring is not available on this platform.", nullptr, Logging::Warning}, // O_Not_Supported
+      {(Error_Code(58) << 16) + 2, "Call to io_uring_setup failed.", "Call to io_uring_setup resulted in error %d - writing with writev", Logging::Warning}, // O_Setup_Error
+      {(Error_Code(58) << 16) + 3, "Call to mmap failed for the io_uring rings.", "Call to mmap resulted in error %d for the io_uring rings - writing with writev", Logging::Warning}, // O_mmap_Error
+      {(Error_Code(58) << 16) + 4, "Memory allocation error - could not allocate the registered buffers.", "Memory allocation error - could not allocate %zu io_uring buffers - writing with writev", Logging::Warning}, // O_Allocation_Error
+      {(Error_Code(58) << 16) + 5, "Call to io_uring_register failed for the buffers - RLIMIT_MEMLOCK?", "Call to io_uring_register resulted in error %d for the buffers - writing with writev", Logging::Warning}, // O_Register_Error
+      {(Error_Code(58) << 16) + 6, "Invalid state - the ring is not open.", nullptr, Logging::Error}, // A_Not_Open
+      {(Error_Code(58) << 16) + 7, "Call to io_uring_enter failed submitting a write, and so did writing the buffer with pwrite.", "Call to io_uring_enter resulted in error %d submitting a log file write, and pwrite in error %d", Logging::Error}, // S_Enter_Error
+      {(Error_Code(58) << 16) + 8, "Call to io_uring_enter failed waiting for a completion.", "Call to io_uring_enter resulted in error %d waiting for a log file write", Logging::Error}, // R_Enter_Error
+      {(Error_Code(58) << 16) + 9, "A log file write completed with an error - enough storage space?", "A log file write completed with error %d - enough storage space?", Logging::Error}, // R_Write_Error
+      // A4_Log_Compressor_Module_ID - Log_Compressor_Errors
+      {(Error_Code(59) << 16) + 0, "Invalid parameter value - the_level is outside Min_Level .. Max_Level.", nullptr, Logging::Error}, // SL_Invalid_Level
+      {(Error_Code(59) << 16) + 1, "Invalid parameter length - the_filespec is empty.", nullptr, Logging::Error}, // EF_Invalid_Filespec
+      {(Error_Code(59) << 16) + 2, "Built without zlib - the log file is left as it is.", nullptr, Logging::Error}, // CF_Not_Supported
+      {(Error_Code(59) << 16) + 3, "Invalid parameter length - the_filespec is empty.", nullptr, Logging::Error}, // CF_Invalid_Filespec
+      {(Error_Code(59) << 16) + 4, "Call to fopen failed for the log file.", "Call to fopen resulted in error %d for %s", Logging::Error}, // CF_fopen_Error
+      {(Error_Code(59) << 16) + 5, "Call to gzopen failed for the compressed file.", "Call to gzopen resulted in error %d for %s", Logging::Error}, // CF_gzopen_Error
+      {(Error_Code(59) << 16) + 6, "Call to fread failed reading the log file.", nullptr, Logging::Error}, // CF_Read_Error
+      {(Error_Code(59) << 16) + 7, "Call to gzwrite failed - enough storage space?", nullptr, Logging::Error}, // CF_gzwrite_Error
+      {(Error_Code(59) << 16) + 8, "Call to gzclose failed completing the compressed file - enough storage space?", nullptr, Logging::Error}, // CF_gzclose_Error
+      {(Error_Code(59) << 16) + 9, "Call to rename failed for the completed compressed file.", "Call to rename resulted in error %d for %s", Logging::Error}, // CF_rename_Error
+      {(Error_Code(59) << 16) + 10, "Call to remove failed for the compressed log file - both copies are kept.", "Call to remove resulted in error %d for %s - both copies are kept", Logging::Warning}, // CF_remove_Error
+      // A4_Log_Crash_Ring_Module_ID - Log_Crash_Ring_Errors
+      {(Error_Code(60) << 16) + 0, "Invalid state - the ring file is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(60) << 16) + 1, "Invalid parameter value - the_size is outside Min_Size .. Max_Size.", nullptr, Logging::Error}, // O_Invalid_Size
+      {(Error_Code(60) << 16) + 2, "Call to open failed for the ring file.", "Call to open resulted in error %d for filespec %s", Logging::Error}, // O_open_Error
+      {(Error_Code(60) << 16) + 3, "Call to fstat failed for the ring file.", "Call to fstat resulted in error %d for filespec %s", Logging::Error}, // O_fstat_Error
+      {(Error_Code(60) << 16) + 4, "Call to ftruncate failed sizing the ring file - enough storage space?", "Call to ftruncate resulted in error %d for filespec %s", Logging::Error}, // O_ftruncate_Error
+      {(Error_Code(60) << 16) + 5, "Memory allocation error - could not copy the unwritten records.", nullptr, Logging::Error}, // O_Allocation_Error
+      {(Error_Code(60) << 16) + 6, "Call to mmap failed for the ring file.", "Call to MapViewOfFile resulted in error %lu", Logging::Error}, // M_mmap_Error
+      // A4_Log_Sink_Module_ID - Log_Sink_Errors
+      {(Error_Code(61) << 16) + 0, "Invalid state - the sink is already open.", nullptr, Logging::Error}, // O_Already_Open
+      {(Error_Code(61) << 16) + 1, "Invalid parameter value - the_max_queued is less than Log_Sink_Constant::Min_Max_Queued.", nullptr, Logging::Error}, // O_Invalid_Max_Queued
+      {(Error_Code(61) << 16) + 2, "Invalid state - the sink is not open.", nullptr, Logging::Error}, // C_Not_Open
+      {(Error_Code(61) << 16) + 3, "Invalid parameter address - the_record is nullptr.", nullptr, Logging::Error}, // S_Invalid_Record
+      {(Error_Code(61) << 16) + 4, "Call to Active_Object::Post failed - the queue is delivered by the next Submit.", nullptr, Logging::Error}, // S_Drain_Post_Error
+      {(Error_Code(61) << 16) + 5, ":Set_File: Invalid state - the sink is already open.", nullptr, Logging::Error}, // SF_Already_Open
+      {(Error_Code(61) << 16) + 6, ":Set_File: Invalid parameter length - the_filespec is empty.", nullptr, Logging::Error}, // SF_Invalid_Filespec
+      {(Error_Code(61) << 16) + 7, ":Set_File: Invalid parameter value - the_max_file_size is less than Log_Sink_Constant::Min_Max_File_Size.", nullptr, Logging::Error}, // SF_Invalid_Max_Size
+      {(Error_Code(61) << 16) + 8, ":Set_File: Invalid parameter value - the_num_rotated_files is outside 1 .. Max_Num_Rotated_Files.", nullptr, Logging::Error}, // SF_Invalid_Num_Files
+      {(Error_Code(61) << 16) + 9, ":Open_Sink: Invalid state - Set_File was not called.", nullptr, Logging::Error}, // OS_No_Filespec
+      {(Error_Code(61) << 16) + 10, ":Rotate: Call to rename failed for a rotated log file - writing on in the same file.", nullptr, Logging::Error}, // R_rename_Error
+      {(Error_Code(61) << 16) + 11, ":Set_Capacity: Invalid state - the sink is already open.", nullptr, Logging::Error}, // SC_Already_Open
+      {(Error_Code(61) << 16) + 12, ":Set_Capacity: Invalid parameter value - the_max_records is zero.", nullptr, Logging::Error}, // SC_Invalid_Capacity
+      {(Error_Code(61) << 16) + 13, ":Set_Collector: Invalid state - the sink is already open.", nullptr, Logging::Error}, // SCO_Already_Open
+      {(Error_Code(61) << 16) + 14, ":Set_Collector: Invalid parameter length - the_host is empty.", nullptr, Logging::Error}, // SCO_Invalid_Host
+      {(Error_Code(61) << 16) + 15, ":Open_Sink: Call to getaddrinfo failed for the collector host.", "Call to getaddrinfo resulted in error %d for host %s", Logging::Error}, // OS_getaddrinfo_Error
+      {(Error_Code(61) << 16) + 16, ":Open_Sink: Call to socket failed.", "Call to socket resulted in error %d", Logging::Error}, // OS_socket_Error
+      {(Error_Code(61) << 16) + 17, ":Open_Sink: Call to connect failed for the collector address.", "Call to connect resulted in error %d for host %s", Logging::Error}, // OS_connect_Error
+      {(Error_Code(61) << 16) + 18, ":Deliver: Call to send failed - the collector is not listening? Counted, not logged.", nullptr, Logging::Error}, // D_send_Error
+      {(Error_Code(61) << 16) + 19, ":Flush_Sink: Call to Log_File_Writer::Write_Batch failed - counted, the writer logs the cause to the other sinks.", nullptr, Logging::Error}, // D_Write_Error
+      // A4_Composite_Logger_Module_ID - Composite_Logger_Errors
+      {(Error_Code(62) << 16) + 0, "The logging singleton has already been allocated.", nullptr, Logging::Error}, // AS_Already_Allocated
+      {(Error_Code(62) << 16) + 1, "Memory allocation error - could not allocate a new A4_Lib::Composite_Logger instance.", nullptr, Logging::Error}, // AS_Allocation_Error
+      {(Error_Code(62) << 16) + 2, "Invalid parameter address - the_sink is nullptr.", nullptr, Logging::Error}, // ASI_Invalid_Sink
+      {(Error_Code(62) << 16) + 3, "Invalid state - sinks are added before Open.", nullptr, Logging::Error}, // ASI_Already_Open
+      {(Error_Code(62) << 16) + 4, "Invalid state - Composite_Logger_Constant::Max_Sinks have been added.", nullptr, Logging::Error}, // ASI_Too_Many_Sinks
+      {(Error_Code(62) << 16) + 5, "Invalid state - Add_Sink was not called.", nullptr, Logging::Error}, // O_No_Sinks
+      {(Error_Code(62) << 16) + 6, "Invalid parameter length - the_log_text is empty.", nullptr, Logging::Error}, // W2_Invalid_Text_Length
+      {(Error_Code(62) << 16) + 7, "Invalid parameter length - the_log_text is empty.", nullptr, Logging::Error}, // W3_Invalid_Text_Length
+      {(Error_Code(62) << 16) + 8, "Invalid parameter length - the_log_text is NULL or empty.", nullptr, Logging::Error}, // W4_Invalid_Text_Length
+      {(Error_Code(62) << 16) + 9, "Memory allocation error - could not allocate the Log_Sink_Record.", nullptr, Logging::Error}, // FO_Allocation_Error
+    }; // Entries
+
+    inline constexpr std::size_t  Num_Entries = sizeof(Entries) / sizeof(Entries [0]);
+
+    /**
+     * @brief Retrieve the entry of the_error_code - nullptr when the code is not catalogued.
+     */
+    constexpr const A4_Error_Descriptor *  Find (Error_Code  the_error_code) noexcept
+    { // begin
+      std::size_t   the_low = 0;
+      std::size_t   the_high = Num_Entries;
+
+      while (the_low < the_high)
+      { // begin
+        std::size_t   the_middle = the_low + ((the_high - the_low) / 2);
+
+        if (Entries [the_middle].error_code == the_error_code)
+          return &Entries [the_middle];
+
+        if (Entries [the_middle].error_code < the_error_code)
+          the_low = the_middle + 1;
+        else the_high = the_middle;
+      } // while
+
+      return nullptr;
+    } // Find
+
+    /**
+     * @brief Retrieve the entry of the_error_code - resolved, and checked, at compile time.
+     */
+    template <Error_Code  the_error_code>
+      constexpr const A4_Error_Descriptor &  Entry (void) noexcept
+    { // begin
+      constexpr const A4_Error_Descriptor   *the_entry = Find(the_error_code);
+
+      static_assert(the_entry != nullptr, "the error code is not in the catalogue - run Tools/A4_Error_Catalogue.py generate");
+
+      return *the_entry;
+    } // Entry
+  } // namespace Error_Catalogue
+} // namespace A4_Lib
+
+/**
+ * @brief Build an A4_Error from its catalogue entry - any arguments are captured for the entry's format.
+ */
+#define A4_Catalogue_Error(the_module_id, the_error_offset, ...) \
+  A4_Error (A4_Lib::Error_Catalogue::Entry<A4_Error::Make_Error_Code(the_module_id, the_error_offset)>(), ##__VA_ARGS__)
+
+#endif // __A4_Error_Catalogue_Defined__
@@ -0,0 +1,218 @@
+/**
+ * @brief   Error rate limiter implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Rate_Limiter.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Error_Rate_Limiter.hh"
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Method_State_Block.hh"
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief One (function, state, error code) site - claimed once, never released.
+   */
+  typedef struct alignas(64) Error_Rate_Site
+  { // begin
+    std::atomic<std::uint64_t>  key {0}; /**< zero while the slot is free */
+    std::atomic<const char *>   function_name {nullptr}; /**< set after key - Report_Suppressed skips the slot until then */
+    std::atomic<Method_State>   method_state {0};
+    std::atomic<Error_Code>     error_code {No_Error};
+
+    std::atomic<std::int64_t>   interval_start {0}; /**< Monotonic_Nano_Seconds */
+    std::atomic<std::uint32_t>  num_logged {0}; /**< in the current interval */
+    std::atomic<std::uint64_t>  num_suppressed {0}; /**< since the last summary */
+  } Error_Rate_Site;
+
+  Error_Rate_Site   the_sites [Error_Rate_Constant::Num_Sites];
+
+  std::atomic<std::uint32_t>  the_configured_max_per_interval {Error_Rate_Constant::Default_Max_Per_Interval};
+  std::atomic<std::int64_t>   the_configured_interval {static_cast<std::int64_t>(Error_Rate_Constant::Default_Interval_Seconds) * 1000000000};
+
+  /**
+   * @brief Retrieve the non-zero key of a site - splitmix64 of its parts.
+   */
+  std::uint64_t   Key_Of (const char     *the_function_name,
+                          Method_State   the_method_state,
+                          Error_Code     the_error_code) noexcept
+  { // begin
+    std::uint64_t   the_key = reinterpret_cast<std::uintptr_t>(the_function_name) ^ (the_error_code * 0x9E3779B97F4A7C15ull) ^ (static_cast<std::uint64_t>(the_method_state) << 48);
+
+    the_key = (the_key ^ (the_key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    the_key = (the_key ^ (the_key >> 27)) * 0x94D049BB133111EBull;
+    the_key = the_key ^ (the_key >> 31);
+
+    return (the_key != 0) ? the_key : 1;
+  } // Key_Of
+
+  /**
+   * @brief Retrieve the slot of a site, claiming a free one on its first error - nullptr when the probes are exhausted.
+   */
+  Error_Rate_Site *  Find_Site (const char     *the_function_name,
+                                Method_State   the_method_state,
+                                Error_Code     the_error_code) noexcept
+  { // begin
+    std::uint64_t   the_key = Key_Of(the_function_name, the_method_state, the_error_code);
+
+    for (std::size_t the_probe = 0; the_probe < Error_Rate_Constant::Max_Probes; the_probe++)
+    { // begin
+      Error_Rate_Site   &the_site = the_sites [(the_key + the_probe) & (Error_Rate_Constant::Num_Sites - 1)];
+      std::uint64_t     the_current = the_site.key.load(std::memory_order_acquire);
+
+      if (the_current == the_key)
+        return &the_site;
+
+      if ((the_current == 0) && (the_site.key.compare_exchange_strong(the_current, the_key, std::memory_order_acq_rel) == true))
+      { // begin
+        the_site.method_state.store(the_method_state, std::memory_order_relaxed);
+        the_site.error_code.store(the_error_code, std::memory_order_relaxed);
+        the_site.function_name.store(the_function_name, std::memory_order_release);
+
+        return &the_site;
+      } // if then
+
+      if (the_current == the_key) // lost the claim to the same site
+        return &the_site;
+    } // for
+
+    return nullptr;
+  } // Find_Site
+
+  /**
+   * @brief Start a new interval for the_site if the current one ended before the_now - the winner writes the summary.
+   */
+  void  Roll_Interval (Error_Rate_Site  &the_site,
+                       std::int64_t     the_now) noexcept
+  { // begin
+    std::int64_t    the_start = the_site.interval_start.load(std::memory_order_acquire);
+    std::uint64_t   the_num_suppressed = 0;
+    const char      *the_function_name = nullptr;
+
+    if ((the_now - the_start) < the_configured_interval.load(std::memory_order_relaxed))
+      return;
+
+    if (the_site.interval_start.compare_exchange_strong(the_start, the_now, std::memory_order_acq_rel) == false)
+      return; // another thread rolled it
+
+    the_site.num_logged.store(0, std::memory_order_relaxed);
+
+    if (((the_num_suppressed = the_site.num_suppressed.exchange(0, std::memory_order_relaxed)) == 0) ||
+        ((the_function_name = the_site.function_name.load(std::memory_order_acquire)) == nullptr))
+      return;
+
+    try
+    { // begin
+      if (App_Log->Is_Open() == true)
+        (void) App_Log->Write(Logging::Error, "Suppressed %llu repeats of Error Code %1.5f from %s at machine state %d in the last %lld s",
+                              static_cast<unsigned long long>(the_num_suppressed), A4_Error::Get_Dot_Error_Code(the_site.error_code.load(std::memory_order_relaxed)),
+                              the_function_name, static_cast<int>(the_site.method_state.load(std::memory_order_relaxed)),
+                              static_cast<long long>((the_now - the_start) / 1000000000));
+    } // try
+    catch (...) {}
+  } // Roll_Interval
+} // namespace
+
+/**
+ * @brief Count an error against its site.
+ * @param the_function_name - IN - static - This_Function_Name
+ * @param the_method_state - IN
+ * @param the_error_code - IN
+ * @return \b true when the error should be logged.
+ */
+bool  Error_Rate_Limiter::Admit (const char     *the_function_name,
+                                 Method_State   the_method_state,
+                                 Error_Code     the_error_code) noexcept
+{ // begin
+  std::uint32_t     the_limit = the_configured_max_per_interval.load(std::memory_order_relaxed);
+  Error_Rate_Site   *the_site = nullptr;
+
+  if (the_limit == 0)
+    return true;
+
+  if ((the_site = Find_Site(the_function_name, the_method_state, the_error_code)) == nullptr)
+    return true;
+
+  Roll_Interval(*the_site, Monotonic_Nano_Seconds());
+
+  if (the_site->num_logged.fetch_add(1, std::memory_order_relaxed) < the_limit)
+    return true;
+
+  the_site->num_suppressed.fetch_add(1, std::memory_order_relaxed);
+
+  return false;
+} // Admit
+
+/**
+ * @brief Write the summaries of sites that went quiet - their next error would otherwise have written it.
+ */
+void  Error_Rate_Limiter::Report_Suppressed (void) noexcept
+{ // begin
+  std::int64_t  the_now = Monotonic_Nano_Seconds();
+
+  for (Error_Rate_Site &the_site : the_sites)
+  { // begin
+    if ((the_site.key.load(std::memory_order_relaxed) != 0) && (the_site.num_suppressed.load(std::memory_order_relaxed) != 0))
+      Roll_Interval(the_site, the_now);
+  } // for
+} // Report_Suppressed
+
+/**
+ * @brief Set the suppression thresholds - takes effect with each site's next interval.
+ * @param the_max_per_interval - IN - errors logged per site and interval, zero to log them all
+ * @param the_interval_seconds - IN - > 0
+ */
+Error_Code  Error_Rate_Limiter::Set_Limits (std::uint32_t   the_max_per_interval,
+                                            std::time_t     the_interval_seconds)
+{ // begin
+  Fast_State_Block_Begin(2)
+    Fast_State(1)
+      if (the_interval_seconds <= 0)
+        the_method_error = A4_Error (A4_Error_Rate_Limiter_Module_ID, SL_Invalid_Interval, "Invalid parameter value - the_interval_seconds must be greater than zero.");
+    End_Fast_State
+
+    Fast_State(2)
+      the_configured_interval.store(static_cast<std::int64_t>(the_interval_seconds) * 1000000000, std::memory_order_relaxed);
+      the_configured_max_per_interval.store(the_max_per_interval, std::memory_order_relaxed);
+    End_Fast_State
+  End_Fast_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Limits
+
+/**
+ * @brief Retrieve the suppression thresholds.
+ */
+void  Error_Rate_Limiter::Get_Limits (std::uint32_t   &the_max_per_interval,
+                                      std::time_t     &the_interval_seconds) noexcept
+{ // begin
+  the_max_per_interval = the_configured_max_per_interval.load(std::memory_order_relaxed);
+  the_interval_seconds = static_cast<std::time_t>(the_configured_interval.load(std::memory_order_relaxed) / 1000000000);
+} // Get_Limits
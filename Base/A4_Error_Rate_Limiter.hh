@@ -0,0 +1,82 @@
+#ifndef __A4_Error_Rate_Limiter_Defined__
+#define __A4_Error_Rate_Limiter_Defined__
+/**
+ * @brief   Suppression of repeated identical errors - the first N per interval are logged, the rest are counted.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Rate_Limiter.hh
+ * @note  A site is a (function, state, error code) triple. Each site has a lock-free slot in a fixed table; an error is
+ *        logged while its site has logged fewer than Max_Per_Interval errors in the current interval and is counted
+ *        otherwise. The first error of the next interval - or Report_Suppressed, called by the File_Logger when idle -
+ *        writes one summary:
+ *
+ *          Suppressed 48211 repeats of Error Code 3.00004 from ... at machine state 2 in the last 10 s
+ *
+ *        Sites that do not fit in the table are never suppressed.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <ctime>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Error_Rate_Constant
+  { // begin
+    static const std::size_t    Num_Sites = 1024; /**< table slots - a power of two */
+    static const std::size_t    Max_Probes = 16; /**< slots tried before a site is left unlimited */
+    static const std::uint32_t  Default_Max_Per_Interval = 100; /**< errors logged per site and interval */
+    static const std::time_t    Default_Interval_Seconds = 10;
+  } // namespace Error_Rate_Constant
+
+  /**
+   * @brief Per-site error rate limiting for the Method State Block error log.
+   */
+  typedef class Error_Rate_Limiter
+  { // begin
+  public: // methods
+    A4_Export static bool   Admit (const char     *the_function_name,
+                                   Method_State   the_method_state,
+                                   Error_Code     the_error_code) noexcept; // true - log it, false - counted as suppressed
+
+    A4_Export static void   Report_Suppressed (void) noexcept; // summarize the sites whose interval has ended
+
+    A4_Export static Error_Code   Set_Limits (std::uint32_t   the_max_per_interval, // zero turns suppression off
+                                              std::time_t     the_interval_seconds);
+
+    A4_Export static void   Get_Limits (std::uint32_t   &the_max_per_interval,
+                                        std::time_t     &the_interval_seconds) noexcept;
+
+  public: // errors
+    enum Error_Rate_Limiter_Errors
+    { // begin
+      SL_Invalid_Interval           = 0, /**< \b Set_Limits: Invalid parameter value - the_interval_seconds must be greater than zero. */
+    }; // Error_Rate_Limiter_Errors
+  } Error_Rate_Limiter;
+} // namespace A4_Lib
+
+#endif // __A4_Error_Rate_Limiter_Defined__
@@ -0,0 +1,286 @@
+/**
+ * @brief   Error sink registry and counter sink implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Sink.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Error_Sink.hh"
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <mutex>
+#include <thread>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief What Dispatch reads - a sink is only released once no thread is using its slot.
+   */
+  typedef struct alignas(64) Sink_Slot
+  { // begin
+    std::atomic<Error_Sink *>     sink {nullptr};
+    std::atomic<std::uint32_t>    num_users {0}; /**< threads inside Dispatch on this slot */
+  } Sink_Slot;
+
+  /**
+   * @brief The owners of the registered sinks - never destroyed, sinks may fail during static destruction.
+   */
+  typedef struct Sink_Registry
+  { // begin
+    std::mutex            mutex; /**< Register & Unregister */
+    Error_Sink::Pointer   sinks [Error_Sink_Constant::Max_Error_Sinks];
+  } Sink_Registry;
+
+  Sink_Slot   the_sink_slots [Error_Sink_Constant::Max_Error_Sinks];
+
+  Sink_Registry   &Registry (void)
+  { // begin
+    static Sink_Registry  *the_registry = new Sink_Registry();
+
+    return *the_registry;
+  } // Registry
+
+  /**
+   * @brief The first table slot for the_error_code - Fibonacci hashing.
+   */
+  inline std::size_t  Counter_Offset (Error_Code  the_error_code) noexcept
+  { // begin
+    return static_cast<std::size_t>((the_error_code * 0x9E3779B97F4A7C15ull) >> 32) & (Error_Sink_Constant::Num_Counted_Codes - 1);
+  } // Counter_Offset
+} // namespace
+
+/**
+ * @brief Add a sink - it receives every failure from now on.
+ * @param the_sink - IN - kept until Unregister
+ */
+Error_Code  Error_Sink::Register (Error_Sink::Pointer   the_sink)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_sink == nullptr)
+        the_method_error = A4_Error (A4_Error_Sink_Module_ID, R_Invalid_Sink_Address, "Invalid parameter address - the_sink is nullptr.");
+    End_State
+
+    State(2)
+      Sink_Registry   &the_registry = Registry();
+      std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+      std::size_t     the_free_offset = Error_Sink_Constant::Max_Error_Sinks;
+
+      for (std::size_t the_offset = 0; (the_offset < Error_Sink_Constant::Max_Error_Sinks) && (the_method_error == No_Error); the_offset++)
+      { // begin
+        if (the_registry.sinks [the_offset] == the_sink)
+          the_method_error = A4_Error (A4_Error_Sink_Module_ID, R_Already_Registered, "the_sink is already registered.");
+        else if ((the_registry.sinks [the_offset] == nullptr) && (the_free_offset == Error_Sink_Constant::Max_Error_Sinks))
+          the_free_offset = the_offset;
+      } // for
+
+      if ((the_method_error == No_Error) && (the_free_offset == Error_Sink_Constant::Max_Error_Sinks))
+        the_method_error = A4_Error (A4_Error_Sink_Module_ID, R_Too_Many_Sinks, A4_Lib::Logging::Error, "Max_Error_Sinks (%zu) sinks are already registered.",
+                                     Error_Sink_Constant::Max_Error_Sinks);
+      else if (the_method_error == No_Error)
+      { // begin
+        the_registry.sinks [the_free_offset] = the_sink;
+        the_sink_slots [the_free_offset].sink.store(the_sink.get(), std::memory_order_release);
+        Error_Sink::num_registered.fetch_add(1, std::memory_order_relaxed);
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Register
+
+/**
+ * @brief Remove a sink - returns once no thread is inside its Receive.
+ * @param the_sink - IN
+ *
+ * \note  Not from inside a Receive - it would wait for itself.
+ */
+Error_Code  Error_Sink::Unregister (const Error_Sink::Pointer   &the_sink)
+{ // begin
+  Error_Sink::Pointer   the_released_sink; // destroyed after the registry is unlocked
+
+  Method_State_Block_Begin(1)
+    State(1)
+      Sink_Registry   &the_registry = Registry();
+      std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+      std::size_t     the_offset = 0;
+
+      while ((the_offset < Error_Sink_Constant::Max_Error_Sinks) && ((the_sink == nullptr) || (the_registry.sinks [the_offset] != the_sink)))
+        the_offset++;
+
+      if (the_offset == Error_Sink_Constant::Max_Error_Sinks)
+        the_method_error = A4_Error (A4_Error_Sink_Module_ID, U_Not_Registered, "the_sink is not registered.");
+      else
+      { // begin
+        the_sink_slots [the_offset].sink.store(nullptr, std::memory_order_seq_cst);
+
+        while (the_sink_slots [the_offset].num_users.load(std::memory_order_seq_cst) != 0)
+          std::this_thread::yield();
+
+        the_released_sink = std::move(the_registry.sinks [the_offset]);
+        Error_Sink::num_registered.fetch_sub(1, std::memory_order_relaxed);
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Unregister
+
+/**
+ * @brief Hand a failed call chain to every registered sink.
+ * @param the_frames - IN - innermost first
+ * @param the_num_frames - IN
+ */
+void  Error_Sink::Dispatch (const Error_Trace_Entry   *the_frames,
+                            std::size_t               the_num_frames) noexcept
+{ // begin
+  for (Sink_Slot &the_slot : the_sink_slots)
+  { // begin
+    if (the_slot.sink.load(std::memory_order_relaxed) == nullptr)
+      continue;
+
+    the_slot.num_users.fetch_add(1, std::memory_order_seq_cst);
+
+    Error_Sink  *the_sink = the_slot.sink.load(std::memory_order_seq_cst);
+
+    if (the_sink != nullptr)
+      the_sink->Receive(the_frames, the_num_frames);
+
+    the_slot.num_users.fetch_sub(1, std::memory_order_release);
+  } // for
+} // Dispatch
+
+/**
+ * @brief Hand a single failed frame to every registered sink.
+ * @param the_method_error - IN
+ * @param the_function_name - IN - static
+ * @param the_method_state - IN
+ */
+void  Error_Sink::Dispatch (const A4_Error   &the_method_error,
+                            const char       *the_function_name,
+                            Method_State     the_method_state) noexcept
+{ // begin
+  Error_Trace_Entry   the_frame = {the_method_error, the_function_name, the_method_state, Monotonic_Nano_Seconds()};
+
+  Error_Sink::Dispatch(&the_frame, 1);
+} // Dispatch
+
+/**
+ * @brief Count the chain once, by its root cause.
+ * @param the_frames - IN - innermost first
+ * @param the_num_frames - IN
+ */
+void  Error_Counter_Sink::Receive (const Error_Trace_Entry   *the_frames,
+                                   std::size_t               the_num_frames) noexcept
+{ // begin
+  Error_Code    the_error_code = (the_num_frames == 0) ? No_Error : the_frames [0].error.Get_Error_Code();
+  std::size_t   the_offset = Counter_Offset(the_error_code);
+
+  if (the_error_code == No_Error)
+    return;
+
+  for (std::size_t the_probe = 0; the_probe < Error_Sink_Constant::Max_Probes; the_probe++, the_offset = (the_offset + 1) & (Error_Sink_Constant::Num_Counted_Codes - 1))
+  { // begin
+    Counter     &the_counter = this->counters [the_offset];
+    Error_Code  the_slot_code = the_counter.error_code.load(std::memory_order_acquire);
+
+    if ((the_slot_code == No_Error) && (the_counter.error_code.compare_exchange_strong(the_slot_code, the_error_code, std::memory_order_acq_rel) == true))
+      the_slot_code = the_error_code; // claimed
+
+    if (the_slot_code == the_error_code)
+    { // begin
+      the_counter.count.fetch_add(1, std::memory_order_relaxed);
+
+      return;
+    } // if then
+  } // for
+
+  this->num_uncounted.fetch_add(1, std::memory_order_relaxed);
+} // Receive
+
+/**
+ * @brief The number of chains whose root cause was the_error_code.
+ * @param the_error_code - IN
+ */
+std::uint64_t   Error_Counter_Sink::Get_Count (Error_Code   the_error_code) const noexcept
+{ // begin
+  std::size_t   the_offset = Counter_Offset(the_error_code);
+
+  for (std::size_t the_probe = 0; (the_probe < Error_Sink_Constant::Max_Probes) && (the_error_code != No_Error); the_probe++,
+       the_offset = (the_offset + 1) & (Error_Sink_Constant::Num_Counted_Codes - 1))
+  { // begin
+    Error_Code  the_slot_code = this->counters [the_offset].error_code.load(std::memory_order_acquire);
+
+    if (the_slot_code == the_error_code)
+      return this->counters [the_offset].count.load(std::memory_order_relaxed);
+    else if (the_slot_code == No_Error)
+      break;
+  } // for
+
+  return 0;
+} // Get_Count
+
+/**
+ * @brief Every counted error code with its count.
+ * @param the_counts - OUT - replaced
+ */
+Error_Code  Error_Counter_Sink::Get_Counts (Error_Count_Vector   &the_counts) const
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      try
+      { // begin
+        the_counts.clear();
+
+        for (const Counter &the_counter : this->counters)
+        { // begin
+          Error_Code  the_error_code = the_counter.error_code.load(std::memory_order_acquire);
+
+          if (the_error_code != No_Error)
+            the_counts.emplace_back(the_error_code, the_counter.count.load(std::memory_order_relaxed));
+        } // for
+      } // try
+      catch (...)
+      { // begin
+        the_method_error = A4_Error (A4_Error_Sink_Module_ID, GC_Allocation_Error, "Memory allocation error - the_counts could not be filled.");
+      } // catch
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Get_Counts
+
+/**
+ * @brief Errors not counted because Max_Probes slots around their code's were taken.
+ */
+std::uint64_t   Error_Counter_Sink::Get_Num_Uncounted (void) const noexcept
+{ // begin
+  return this->num_uncounted.load(std::memory_order_relaxed);
+} // Get_Num_Uncounted
@@ -0,0 +1,150 @@
+#ifndef __A4_Error_Sink_Defined__
+#define __A4_Error_Sink_Defined__
+/**
+ * @brief   Pluggable destinations for the errors of failed Method State Blocks.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Sink.hh
+ * @note  The Error_Trace hands the root cause of every failed call chain to each registered Error_Sink, on the
+ *        failing thread, as the failed frame ends - only the text log entry waits for the chain to close. A sink sees
+ *        every failure: the Error_Rate_Limiter thins only the text log, which can be turned off with
+ *        Set_Text_Log_Enabled(false) once a sink covers it.
+ *
+ *        Error_Counter_Sink keeps a lock-free count per root cause error code - register one and read the counts as
+ *        metrics:
+ *
+ *          std::shared_ptr<A4_Lib::Error_Counter_Sink>  the_counters = std::make_shared<A4_Lib::Error_Counter_Sink>();
+ *          the_error = A4_Lib::Error_Sink::Register(the_counters);
+ *          ...
+ *          the_counters->Get_Counts(the_count_vector);
+ *
+ *        Receive runs inside End_Method_State_Block - it must not block, throw or unregister a sink.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Error_Trace.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Error_Sink_Constant
+  { // begin
+    static const std::size_t  Max_Error_Sinks = 8; /**< registered at once */
+    static const std::size_t  Num_Counted_Codes = 1024; /**< Error_Counter_Sink table slots - a power of two */
+    static const std::size_t  Max_Probes = 16; /**< slots tried before an error code is counted as uncounted */
+  } // namespace Error_Sink_Constant
+
+  /**
+   * @brief The interface of an error destination and the registry of the active ones.
+   */
+  typedef class Error_Sink
+  { // begin
+  public: // construction
+    Error_Sink (void) = default;
+    Error_Sink (Error_Sink &) = delete;
+    virtual ~Error_Sink (void) = default;
+
+  public: // types
+    typedef std::shared_ptr<Error_Sink>   Pointer;
+
+  public: // methods
+    /**
+     * @brief One failed call chain - as it starts, so the Error_Trace passes its root cause alone.
+     * @param the_frames - IN - innermost (the root cause) first
+     * @param the_num_frames - IN - >= 1
+     */
+    virtual void  Receive (const Error_Trace_Entry   *the_frames,
+                           std::size_t               the_num_frames) noexcept = 0;
+
+    A4_Export static Error_Code   Register (Error_Sink::Pointer   the_sink);
+    A4_Export static Error_Code   Unregister (const Error_Sink::Pointer   &the_sink); // returns once no thread is inside its Receive
+
+    static bool   Is_Any_Registered (void) noexcept {return Error_Sink::num_registered.load(std::memory_order_relaxed) != 0;};
+
+    A4_Export static void   Dispatch (const Error_Trace_Entry   *the_frames,
+                                      std::size_t               the_num_frames) noexcept; // Error_Trace
+
+    A4_Export static void   Dispatch (const A4_Error   &the_method_error,
+                                      const char       *the_function_name,
+                                      Method_State     the_method_state) noexcept; // a chain of one
+
+    static void   Set_Text_Log_Enabled (bool  is_enabled) noexcept {Error_Sink::is_text_log_enabled.store(is_enabled, std::memory_order_relaxed);};
+    static bool   Is_Text_Log_Enabled (void) noexcept {return Error_Sink::is_text_log_enabled.load(std::memory_order_relaxed);};
+
+  private: // data
+    inline static std::atomic<std::size_t>  num_registered {0};
+    inline static std::atomic<bool>         is_text_log_enabled {true}; /**< the App_Log entry written by the Error_Trace */
+
+  public: // errors
+    enum Error_Sink_Errors
+    { // begin
+      R_Invalid_Sink_Address        = 0, /**< \b Register: Invalid parameter address - the_sink is nullptr. */
+      R_Already_Registered          = 1, /**< \b Register: the_sink is already registered. */
+      R_Too_Many_Sinks              = 2, /**< \b Register: Max_Error_Sinks sinks are already registered. */
+      U_Not_Registered              = 3, /**< \b Unregister: the_sink is not registered. */
+    }; // Error_Sink_Errors
+  } Error_Sink;
+
+  /**
+   * @brief Counts failed call chains by the error code of their root cause - lock-free.
+   */
+  typedef class Error_Counter_Sink : public Error_Sink
+  { // begin
+  public: // types
+    typedef std::pair<Error_Code, std::uint64_t>  Error_Count;
+    typedef std::vector<Error_Count>              Error_Count_Vector;
+
+  public: // methods
+    virtual void  Receive (const Error_Trace_Entry   *the_frames,
+                           std::size_t               the_num_frames) noexcept override;
+
+    A4_Export std::uint64_t   Get_Count (Error_Code   the_error_code) const noexcept;
+    A4_Export Error_Code      Get_Counts (Error_Count_Vector   &the_counts) const; // every counted error code, in no particular order
+    A4_Export std::uint64_t   Get_Num_Uncounted (void) const noexcept; // errors whose code did not fit in the table
+
+  private: // types
+    typedef struct Counter
+    { // begin
+      std::atomic<Error_Code>     error_code {No_Error}; /**< No_Error while the slot is free */
+      std::atomic<std::uint64_t>  count {0};
+    } Counter;
+
+  private: // data
+    Counter                     counters [Error_Sink_Constant::Num_Counted_Codes];
+    std::atomic<std::uint64_t>  num_uncounted {0};
+
+  public: // errors
+    enum Error_Counter_Sink_Errors
+    { // begin
+      GC_Allocation_Error           = 4, /**< \b Get_Counts: Memory allocation error - the_counts could not be filled. */
+    }; // Error_Counter_Sink_Errors
+  } Error_Counter_Sink;
+} // namespace A4_Lib
+
+#endif // __A4_Error_Sink_Defined__
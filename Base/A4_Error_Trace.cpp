@@ -0,0 +1,198 @@
+/**
+ * @brief   Thread-local error trace implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Trace.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Error_Trace.hh"
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Error_Rate_Limiter.hh"
+#include "A4_Error_Sink.hh"
+#include "A4_Logger.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  thread_local std::unique_ptr<Error_Trace>   the_owned_trace; /**< frees the ring when its thread exits */
+} // namespace
+
+/**
+ * @brief Add a failed frame to this thread's ring - the chain is written when this is the outermost frame, the ring is
+ *        full or the chain has been open too long. An open chain this frame did not call is written first.
+ *        A frame that starts a chain is its root cause - it goes to the Error_Sinks now, only the text log waits.
+ * @param the_method_error - IN
+ * @param the_function_name - IN - static
+ * @param the_method_state - IN
+ */
+void  Error_Trace::Record (const A4_Error   &the_method_error,
+                           const char       *the_function_name,
+                           Method_State     the_method_state) noexcept
+{ // begin
+  Error_Trace       *the_trace = Error_Trace::current;
+  A4_Error          the_error = the_method_error;
+  std::int64_t      the_now = 0;
+  bool              is_root_cause = false;
+
+  if ((the_trace != nullptr) && (the_trace->num_entries != 0) && (Error_Trace::depth > the_trace->caller_depth))
+    the_trace->Write(); // not a caller of the open chain - a sibling (or its callee) failed under the same live caller
+
+  if ((Error_Trace::depth <= 1) && ((the_trace == nullptr) || (the_trace->num_entries == 0)))
+    the_trace = nullptr; // a chain of one - no need to keep it
+  else if ((the_trace == nullptr) && ((the_trace = new (std::nothrow) Error_Trace()) != nullptr))
+  { // begin
+    the_owned_trace.reset(the_trace);
+    Error_Trace::current = the_trace;
+  } // if then
+
+  if (the_trace == nullptr)
+  { // begin - log the frame as it is
+    if (Error_Sink::Is_Any_Registered() == true)
+      Error_Sink::Dispatch(the_error, the_function_name, the_method_state);
+
+    try
+    { // begin
+      if ((Error_Sink::Is_Text_Log_Enabled() == true) && (App_Log->Is_Open() == true) && (Error_Rate_Limiter::Admit(the_function_name, the_method_state, the_error.Get_Error_Code()) == true))
+        (void) App_Log->Write(the_error.Get_Error_Message(), the_function_name, the_error.Get_Error_Code(), the_method_state, Logging::Error);
+    } // try
+    catch (...) {}
+
+    return;
+  } // if then
+
+  the_now = Monotonic_Nano_Seconds();
+  is_root_cause = (the_trace->num_entries == 0);
+
+  if (the_trace->num_entries == Error_Trace_Constant::Max_Trace_Entries)
+    the_trace->Write();
+
+  the_trace->entries [the_trace->num_entries].error = the_method_error;
+  the_trace->entries [the_trace->num_entries].function_name = the_function_name;
+  the_trace->entries [the_trace->num_entries].state = the_method_state;
+  the_trace->entries [the_trace->num_entries].nano_seconds = the_now;
+  the_trace->num_entries += 1;
+  the_trace->caller_depth = Error_Trace::depth - 1; // this frame is the outermost so far
+
+  if ((Error_Trace::depth <= 1) || ((the_now - the_trace->entries [0].nano_seconds) > Error_Trace_Constant::Max_Pending_Nano_Seconds))
+    the_trace->Write();
+
+  if ((is_root_cause == true) && (Error_Sink::Is_Any_Registered() == true))
+  { // begin - the ring is consistent before a sink runs
+    Error_Trace_Entry   the_root_cause = {the_error, the_function_name, the_method_state, the_now};
+
+    Error_Sink::Dispatch(&the_root_cause, 1);
+  } // if then
+} // Record
+
+/**
+ * @brief Write this thread's open chain - e.g. from a long running loop that never leaves its outermost frame.
+ */
+void  Error_Trace::Drain (void) noexcept
+{ // begin
+  if ((Error_Trace::current != nullptr) && (Error_Trace::current->num_entries != 0))
+    Error_Trace::current->Write();
+} // Drain
+
+/**
+ * @brief Write this thread's open chain when its oldest entry is older than Max_Pending_Nano_Seconds - a clean frame
+ *        ended beneath the caller of the chain, which may not return for a long time.
+ */
+void  Error_Trace::Drain_Overdue (void) noexcept
+{ // begin
+  if ((Error_Trace::current != nullptr) && (Error_Trace::current->num_entries != 0) &&
+      ((Monotonic_Nano_Seconds() - Error_Trace::current->entries [0].nano_seconds) > Error_Trace_Constant::Max_Pending_Nano_Seconds))
+    Error_Trace::current->Write();
+} // Drain_Overdue
+
+/**
+ * @brief Write the chain as one log entry and empty the ring - Record has given its root cause to the Error_Sinks.
+ *
+ * \note  The chain is copied and the ring emptied before App_Log->Write is called - its own Method State Blocks end here
+ *        as well, and a failure among them starts a new chain rather than overwriting this one.
+ */
+void  Error_Trace::Write (void) noexcept
+{ // begin
+  char                the_buffer [512];
+  std::size_t         the_num_entries = this->num_entries;
+  Error_Trace_Entry   the_entries [Error_Trace_Constant::Max_Trace_Entries];
+  std::int64_t        the_nano_seconds = 0; // when the root cause failed, system clock
+
+  for (std::size_t the_entry = 0; the_entry < the_num_entries; the_entry++)
+    the_entries [the_entry] = this->entries [the_entry];
+
+  this->num_entries = 0;
+
+  try
+  { // begin
+    if ((the_num_entries == 0) || (Error_Sink::Is_Text_Log_Enabled() == false) || (App_Log->Is_Open() == false))
+      return;
+
+    if (Error_Rate_Limiter::Admit(the_entries [0].function_name, the_entries [0].state, the_entries [0].error.Get_Error_Code()) == false)
+      return; // the root cause is repeating - counted in its site's summary
+
+    std::string   the_text;
+
+    the_nano_seconds = static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()) -
+                       (Monotonic_Nano_Seconds() - the_entries [0].nano_seconds);
+
+    (void) the_entries [0].error.Format_Message(the_buffer, sizeof(the_buffer));
+    the_text = the_buffer;
+
+    for (std::size_t the_entry = 1; the_entry < the_num_entries; the_entry++)
+    { // begin
+      (void) std::snprintf(the_buffer, sizeof(the_buffer), " <- %s state=%d", the_entries [the_entry].function_name, static_cast<int>(the_entries [the_entry].state));
+      the_text += the_buffer;
+
+      if (the_entries [the_entry].error != the_entries [the_entry - 1].error.Get_Error_Code())
+      { // begin - the frame raised its own error
+        (void) std::snprintf(the_buffer, sizeof(the_buffer), " [Error Code %1.5f: ", the_entries [the_entry].error.Get_Dot_Error_Code());
+        the_text += the_buffer;
+
+        (void) the_entries [the_entry].error.Format_Message(the_buffer, sizeof(the_buffer));
+        the_text += the_buffer;
+        the_text += "]";
+      } // if then
+    } // for
+
+    if (the_num_entries > 1)
+    { // begin
+      (void) std::snprintf(the_buffer, sizeof(the_buffer), " (%zu frames in %lld us)", the_num_entries,
+                           static_cast<long long>((the_entries [the_num_entries - 1].nano_seconds - the_entries [0].nano_seconds) / 1000));
+      the_text += the_buffer;
+    } // if then
+
+    (void) App_Log->Write(the_text, the_entries [0].function_name, the_entries [0].error.Get_Error_Code(), the_entries [0].state, Logging::Error, the_nano_seconds);
+  } // try
+  catch (...) {}
+} // Write
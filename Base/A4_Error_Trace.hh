@@ -0,0 +1,128 @@
+#ifndef __A4_Error_Trace_Defined__
+#define __A4_Error_Trace_Defined__
+/**
+ * @brief   Thread-local error trace - one consolidated log entry per failed call chain.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Error_Trace.hh
+ * @note  Every Method State Block is an Error_Trace_Frame. A block that ends with an error records (error, function, state,
+ *        time) in its thread's ring instead of writing to App_Log, and the chain is written as a single entry once it is
+ *        closed:
+ *
+ *          - the outermost frame of the thread ends with an error,
+ *          - the caller of the outermost failed frame, or a frame further out, ends without an error - the failure was
+ *            handled. A call that succeeds deeper down - a cleanup made before the failed frame returns - leaves it open,
+ *          - the ring is full or, at the next frame that ends, its oldest entry is older than Max_Pending_Nano_Seconds, or
+ *          - Error_Trace::Drain is called - the Active_Object and Executor worker loops call it after each message.
+ *
+ *        The entry reports the innermost (root cause) error code, function and state, followed by the frames it passed,
+ *        and is stamped with the time of the root cause rather than the time it was written.
+ *        Repeats of the same root cause are thinned by the Error_Rate_Limiter.
+ *        Define \b A4_Synchronous_Error_Logging to log every frame as it ends instead.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Error.hh"
+
+namespace A4_Lib
+{ // begin
+  namespace Error_Trace_Constant
+  { // begin
+    static const std::size_t    Max_Trace_Entries = 16; /**< frames kept per thread - a longer chain is written in parts */
+    static const std::int64_t   Max_Pending_Nano_Seconds = 1000000000; /**< an open chain older than this is written at its next frame */
+  } // namespace Error_Trace_Constant
+
+  /**
+   * @brief One failed frame.
+   */
+  typedef struct Error_Trace_Entry
+  { // begin
+    A4_Error        error; /**< as the frame ended - formatted only when the chain is written */
+    const char      *function_name; /**< static - This_Function_Name */
+    Method_State    state;
+    std::int64_t    nano_seconds; /**< Monotonic_Nano_Seconds */
+  } Error_Trace_Entry;
+
+  /**
+   * @brief The ring of one thread - allocated by its first failure.
+   */
+  typedef class Error_Trace
+  { // begin
+  public: // methods
+    static void   Enter_Frame (void) noexcept {Error_Trace::depth += 1;};
+    static void   Leave_Frame (void) noexcept {Error_Trace::depth -= 1;};
+
+    static void   End_Frame (const A4_Error   &the_method_error,
+                             const char       *the_function_name,
+                             Method_State     the_method_state) noexcept; // End_Method_State_Block
+
+    A4_Export static void   Drain (void) noexcept; // write this thread's open chain, if any
+
+  private: // methods
+    A4_Export static void   Drain_Overdue (void) noexcept; // write the open chain once it is older than Max_Pending_Nano_Seconds
+
+    A4_Export static void   Record (const A4_Error   &the_method_error,
+                                    const char       *the_function_name,
+                                    Method_State     the_method_state) noexcept;
+
+    void  Write (void) noexcept;
+
+  private: // data
+    inline static thread_local std::uint32_t  depth = 0; /**< Method State Blocks running on this thread */
+    inline static thread_local Error_Trace    *current = nullptr; /**< this thread's ring */
+
+    std::size_t         num_entries = 0;
+    std::uint32_t       caller_depth = 0; /**< the depth of the frame that called the outermost failed frame */
+    Error_Trace_Entry   entries [Error_Trace_Constant::Max_Trace_Entries]; /**< innermost first */
+  } Error_Trace;
+
+  /**
+   * @brief Counts the Method State Blocks running on the thread - declared by Method_State_Block_Begin.
+   */
+  typedef class Error_Trace_Frame
+  { // begin
+  public: // construction
+    Error_Trace_Frame (void) noexcept {Error_Trace::Enter_Frame();};
+    Error_Trace_Frame (Error_Trace_Frame &) = delete;
+    ~Error_Trace_Frame (void) {Error_Trace::Leave_Frame();};
+  } Error_Trace_Frame;
+
+  /**
+   * @brief Record a failed frame, or close the open chain when this frame succeeded at or above the caller of its outermost
+   *        failed frame - or the chain has waited too long for that.
+   */
+  inline void   Error_Trace::End_Frame (const A4_Error   &the_method_error,
+                                        const char       *the_function_name,
+                                        Method_State     the_method_state) noexcept
+  { // begin
+    if (the_method_error != No_Error)
+      Error_Trace::Record(the_method_error, the_function_name, the_method_state);
+    else if ((Error_Trace::current == nullptr) || (Error_Trace::current->num_entries == 0))
+      return; // nothing open - the common case
+    else if (Error_Trace::depth <= Error_Trace::current->caller_depth)
+      Error_Trace::Drain(); // the caller carried on - the chain is closed
+    else Error_Trace::Drain_Overdue(); // a long running caller - don't hold the failure until it returns
+  } // End_Frame
+} // namespace A4_Lib
+
+#endif // __A4_Error_Trace_Defined__
@@ -0,0 +1,480 @@
+/**
+ * @brief   Executor - shared worker pool implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Executor.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Executor.hh"
+#include "A4_Active_Object.hh"
+#include "A4_Method_State_Block.hh"
+#include "A4_Utils.hh"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace A4_Lib;
+
+/**
+ * @brief Default constructor
+ */
+Executor::Executor(void)
+{ // begin
+  this->next_sweep_ms = 0;
+  this->num_worker_threads = 0;
+  this->idle_wait = 0;
+  this->slice_size = 0;
+  this->is_initialized = false;
+  this->is_started = false;
+} // constructor
+
+/**
+ * @brief Default destructor - stops the pool threads
+ */
+Executor::~Executor(void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+
+  this->is_initialized = false;
+} // destructor
+
+/// @brief  Allocate a new Executor::Pointer
+/// @param the_new_executor - IN - nullptr - OUT - the new instance
+//
+Error_Code   Executor::Allocate (Executor::Pointer    &the_new_executor)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_new_executor != nullptr)
+        the_method_error = A4_Error (A4_Executor_Module_ID, A_Invalid_Initial_State, "Invalid parameter state - the_new_executor must equal nullptr - memory leak?");
+    End_State
+
+    State(2)
+      the_new_executor = std::make_shared<Executor>();
+
+      if (the_new_executor == nullptr)
+        the_method_error = A4_Error (A4_Executor_Module_ID, A_Allocation_Error, "Memory allocation error - could not allocate a new Executor instance.");
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Allocate
+
+/**
+ * @brief Initialize this instance
+ * @param the_number_of_worker_threads - IN - the fixed size of the pool - must be >= Executor_Constant::Min_Num_Threads
+ * @param the_idle_wait - IN - milli-seconds an idle pool thread waits before checking for due timeouts - must be >= Min_Idle_Wait_MS
+ * @param the_slice_size - IN - the number of messages an object may process before its pool thread moves on - must be non-zero
+ */
+Error_Code  Executor::Initialize (std::size_t     the_number_of_worker_threads,
+                                  std::uint64_t   the_idle_wait,
+                                  std::size_t     the_slice_size)
+{ // begin
+  Method_State_Block_Begin(5)
+    State(1)
+      if (this->Is_Initialized() == true)
+        the_method_error = A4_Error (A4_Executor_Module_ID, I_Already_Initialized, "Instance is already initialized.");
+    End_State
+
+    State(2)
+      if (the_number_of_worker_threads < Executor_Constant::Min_Num_Threads)
+        the_method_error = A4_Error (A4_Executor_Module_ID, I_Insufficient_Threads, "Invalid parameter value - the_number_of_worker_threads is less than the minimum.");
+    End_State
+
+    State(3)
+      if (the_idle_wait < Executor_Constant::Min_Idle_Wait_MS)
+        the_method_error = A4_Error (A4_Executor_Module_ID, I_Invalid_Idle_Wait, "Invalid parameter value - the_idle_wait < Min_Idle_Wait_MS.");
+    End_State
+
+    State(4)
+      if (the_slice_size < 1)
+        the_method_error = A4_Error (A4_Executor_Module_ID, I_Invalid_Slice_Size, "Invalid parameter value - the_slice_size must be non-zero.");
+    End_State
+
+    State(5)
+      this->num_worker_threads = the_number_of_worker_threads;
+      this->idle_wait = the_idle_wait;
+      this->slice_size = the_slice_size;
+
+      this->is_initialized = true;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Initialize
+
+/**
+ * @brief   Retrieve the current initialization status.
+ */
+bool  Executor::Is_Initialized (void) const
+{ // begin
+  return this->is_initialized;
+} // Is_Initialized
+
+/**
+ * @brief   Retrieve the current started state.
+ */
+bool  Executor::Is_Started (void) const
+{ // begin
+  return this->is_started;
+} // Is_Started
+
+/**
+ * @brief  Start the pool threads. Must be initialized.
+ */
+Error_Code  Executor::Start (void)
+{ // begin
+  bool    the_mutex_is_acquired = false;
+  bool    is_stop_required = false;
+
+  Method_State_Block_Begin(5)
+    State(1)
+      the_method_error = this->start_stop_mutex.Lock(the_mutex_is_acquired);
+    End_State
+
+    State(2)
+      if (this->Is_Started() == true)
+        the_method_error = A4_Error (A4_Executor_Module_ID, S_Already_Started, "The instance is already started.");
+    End_State
+
+    State(3)
+      if (this->Is_Initialized() != true)
+        the_method_error = A4_Error (A4_Executor_Module_ID, S_Not_Initialized, "The instance is not initialized.");
+    End_State
+
+    State(4)
+      this->is_started = true;
+
+      while (this->thread_future_vector.size() < this->num_worker_threads)
+        this->thread_future_vector.push_back (std::async(std::launch::async, &Executor::Worker_Thread_Method, this, this->thread_future_vector.size()));
+    End_State
+
+    State(5)
+      if (this->Num_Threads() != this->num_worker_threads)
+      { // oops - something is wrong...
+        the_method_error = A4_Error (A4_Executor_Module_ID, S_Bad_Thread_Count, A4_Lib::Logging::Error,
+                                     "Failed to start the required %lld threads, instead %lld were created.", this->num_worker_threads, this->Num_Threads());
+
+        is_stop_required = true; // once the start_stop_mutex is released
+      } // if then
+      else the_method_error = this->start_stop_mutex.Unlock(the_mutex_is_acquired);
+    End_State
+  End_Method_State_Block
+
+  if (the_mutex_is_acquired == true)
+    (void) this->start_stop_mutex.Unlock(the_mutex_is_acquired);
+
+  if (is_stop_required == true)
+    (void) this->Stop();
+
+  return the_method_error.Get_Error_Code();
+} // Start
+
+/**
+ * @brief  Stop the pool threads. Objects that remain attached stay attached but are no longer run.
+ */
+Error_Code  Executor::Stop (void)
+{ // begin
+  bool    the_mutex_is_acquired = false;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      the_method_error = this->start_stop_mutex.Lock(the_mutex_is_acquired);
+    End_State
+
+    State(2)
+      if (this->Is_Started() != true)
+        the_method_error = A4_Error (A4_Executor_Module_ID, ST_Not_Started, "The instance is already stopped.");
+      else { // wake every pool thread
+        std::lock_guard<std::mutex>   the_lock(this->ready_mutex);
+
+        this->is_started = false;
+        this->ready_condition.notify_all();
+      } // if else
+    End_State
+
+    State(3)
+      for (std::size_t the_offset = 0; the_offset < this->thread_future_vector.size(); the_offset++)
+        (void) this->thread_future_vector [the_offset].get();
+
+      this->thread_future_vector.clear();
+
+      { // begin - whatever is left will not run - release the slots so Detach does not wait for it
+        std::lock_guard<std::mutex>   the_lock(this->ready_mutex);
+
+        while (this->ready_queue.empty() != true)
+        { // begin
+          this->ready_queue.front()->executor_attachment.num_scheduled -= 1;
+          this->ready_queue.pop_front();
+        } // while
+
+        this->detach_condition.notify_all();
+      } // end
+
+      the_method_error = this->start_stop_mutex.Unlock(the_mutex_is_acquired);
+    End_State
+  End_Method_State_Block
+
+  if (the_mutex_is_acquired == true)
+    (void) this->start_stop_mutex.Unlock(the_mutex_is_acquired);
+
+  return the_method_error.Get_Error_Code();
+} // Stop
+
+/**
+ * @brief  Retrieve the current number of running pool threads.
+ */
+std::size_t   Executor::Num_Threads (void)
+{ // begin
+  std::size_t   the_number_of_threads = 0;
+
+  for (std::size_t the_offset = 0; the_offset < this->thread_future_vector.size(); the_offset++)
+    if (this->thread_future_vector [the_offset].wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      the_number_of_threads += 1;
+
+  return the_number_of_threads;
+} // Num_Threads
+
+/**
+ * @brief  Retrieve the number of attached active objects.
+ */
+std::size_t   Executor::Num_Attached (void)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock(this->ready_mutex);
+
+  return this->attached_objects.size();
+} // Num_Attached
+
+/**
+ * @brief  Retrieve a monotonic milli-second clock.
+ */
+std::int64_t  Executor::Now_MS (void)
+{ // begin
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} // Now_MS
+
+/**
+ * @brief  Attach an active object - called by Active_Object::Start.
+ * @param the_active_object - IN
+ */
+Error_Code  Executor::Attach (Active_Object   *the_active_object)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_active_object == nullptr)
+        the_method_error = A4_Error (A4_Executor_Module_ID, AT_Invalid_Address, "Invalid parameter address - the_active_object is nullptr.");
+    End_State
+
+    State(2)
+      std::lock_guard<std::mutex>   the_lock(this->ready_mutex);
+
+      if (the_active_object->executor_attachment.is_attached == true)
+        the_method_error = A4_Error (A4_Executor_Module_ID, AT_Already_Attached, "The active object is already attached to this executor.");
+      else { // begin
+        this->attached_objects.push_back(the_active_object);
+
+        the_active_object->executor_attachment.is_attached = true;
+        the_active_object->executor_attachment.next_timeout_ms = Executor::Now_MS() + static_cast<std::int64_t>(the_active_object->message_queue_wait);
+
+        if (the_active_object->message_queue.Is_Empty() != true)
+          (void) this->Schedule_Locked(the_active_object); // messages were queued before the object was started
+      } // if else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Attach
+
+/**
+ * @brief  Detach an active object - called by Active_Object::Stop.
+ * @param the_active_object - IN
+ * @note   Blocks until every running slice of the object has finished - must not be called from the object's own Process_Message.
+ */
+Error_Code  Executor::Detach (Active_Object   *the_active_object)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_active_object == nullptr)
+        the_method_error = A4_Error (A4_Executor_Module_ID, DT_Invalid_Address, "Invalid parameter address - the_active_object is nullptr.");
+    End_State
+
+    State(2)
+      std::unique_lock<std::mutex>  the_lock(this->ready_mutex);
+
+      std::vector<Active_Object *>::iterator  the_position = std::find(this->attached_objects.begin(), this->attached_objects.end(), the_active_object);
+
+      if (the_position == this->attached_objects.end())
+        the_method_error = A4_Error (A4_Executor_Module_ID, DT_Not_Attached, "The active object is not attached to this executor.");
+      else { // begin
+        this->attached_objects.erase(the_position);
+
+        the_active_object->executor_attachment.is_attached = false;
+
+        for (std::deque<Active_Object *>::iterator the_entry = this->ready_queue.begin(); the_entry != this->ready_queue.end();)
+          if (*the_entry == the_active_object)
+          { // not yet running - just drop it
+            the_entry = this->ready_queue.erase(the_entry);
+            the_active_object->executor_attachment.num_scheduled -= 1;
+          } // if then
+          else ++the_entry;
+
+        while (the_active_object->executor_attachment.num_scheduled > 0)
+          this->detach_condition.wait(the_lock); // a running slice signals when it ends
+      } // if else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Detach
+
+/**
+ * @brief  Place the_active_object on the ready queue unless it is already at its concurrency limit.
+ * @return \b true if the object was placed on the ready queue
+ */
+bool  Executor::Schedule_Locked (Active_Object   *the_active_object)
+{ // begin
+  Executor_Attachment   &the_attachment = the_active_object->executor_attachment;
+
+  if ((this->is_started != true) || (the_attachment.is_attached != true) || (the_attachment.num_scheduled >= the_attachment.max_concurrency))
+    return false; // a running slice will re-schedule the object when it ends
+
+  the_attachment.num_scheduled += 1;
+
+  this->ready_queue.push_back(the_active_object);
+  this->ready_condition.notify_one();
+
+  return true;
+} // Schedule_Locked
+
+/**
+ * @brief  Work has arrived for the_active_object.
+ * @param the_active_object - IN
+ * @return No_Error, or the exception caught locking the ready queue or growing it - the work stays queued on the object
+ *         and runs when its next Handle_Timeout is due at the latest
+ */
+Error_Code  Executor::Schedule (Active_Object   *the_active_object) noexcept
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      std::lock_guard<std::mutex>   the_lock(this->ready_mutex); // will throw on failure
+
+      (void) this->Schedule_Locked(the_active_object); // will throw on failure
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Schedule
+
+/**
+ * @brief  Schedule every attached object whose Handle_Timeout is due.
+ * @param the_current_ms - IN - Now_MS()
+ */
+void  Executor::Schedule_Due_Timeouts (std::int64_t   the_current_ms)
+{ // begin
+  for (std::size_t the_offset = 0; the_offset < this->attached_objects.size(); the_offset++)
+  { // begin
+    Active_Object   *the_active_object = this->attached_objects [the_offset];
+
+    if (the_active_object->executor_attachment.next_timeout_ms <= the_current_ms)
+    { // an empty slice calls Handle_Timeout
+      the_active_object->executor_attachment.next_timeout_ms = the_current_ms + static_cast<std::int64_t>(the_active_object->message_queue_wait);
+
+      (void) this->Schedule_Locked(the_active_object);
+    } // if then
+  } // for
+} // Schedule_Due_Timeouts
+
+/**
+ * @brief Pool thread - runs a slice of each ready object in turn and sweeps for due timeouts when idle.
+ * @param the_pool_thread_index - IN - 0 .. num_worker_threads - 1 - an object's statistics slot for this thread is found by it
+ * @return No_Error (success)
+ */
+Error_Code  Executor::Worker_Thread_Method (std::size_t   the_pool_thread_index)
+{ // begin
+  Active_Object   *the_active_object = nullptr;
+
+  std::int64_t    the_current_ms = 0;
+
+  int             the_main_loop = 0;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      Executor::pool_thread_index = the_pool_thread_index;
+
+      Define_Target_State(the_main_loop);
+    End_State
+
+    State(2)
+      std::unique_lock<std::mutex>  the_lock(this->ready_mutex);
+
+      the_active_object = nullptr;
+
+      if ((this->ready_queue.empty() == true) && (this->is_started == true))
+        (void) this->ready_condition.wait_for(the_lock, std::chrono::milliseconds(this->idle_wait));
+
+      the_current_ms = Executor::Now_MS();
+
+      if (this->next_sweep_ms <= the_current_ms)
+      { // one thread at a time, at most once per idle_wait
+        this->next_sweep_ms = the_current_ms + static_cast<std::int64_t>(this->idle_wait);
+
+        this->Schedule_Due_Timeouts(the_current_ms);
+      } // if then
+
+      if (this->ready_queue.empty() != true)
+      { // begin
+        the_active_object = this->ready_queue.front();
+        this->ready_queue.pop_front();
+      } // if then
+      else if (this->is_started != true)
+        Terminate_The_Method_Block; // shut down
+    End_State
+
+    State(3)
+      if (the_active_object != nullptr)
+      { // run a slice outside the lock
+        (void) the_active_object->Run_Slice(this->slice_size); // errors are in this thread's Error_Trace - the pool thread carries on
+
+        A4_Lib::Error_Trace::Drain(); // this loop never leaves its frame - write them now, not when the pool stops
+
+        std::lock_guard<std::mutex>   the_lock(this->ready_mutex);
+
+        the_active_object->executor_attachment.num_scheduled -= 1;
+
+        if ((the_active_object->message_queue.Is_Empty() != true) && (this->Schedule_Locked(the_active_object) == true))
+          ; // more work - yield to the other ready objects and come back to it
+        else if (the_active_object->executor_attachment.num_scheduled == 0)
+          this->detach_condition.notify_all(); // a Detach may be waiting
+      } // if then
+
+      Set_Target_State(the_main_loop);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Worker_Thread_Method
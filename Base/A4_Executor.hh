@@ -0,0 +1,163 @@
+#ifndef __A4_Executor_Defined__
+#define __A4_Executor_Defined__
+/**
+ * @brief   Executor - a fixed-size worker pool shared by many Active_Objects.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Executor.hh
+ * @note  An attached Active_Object keeps its own Message_Queue but owns no threads. Whenever work arrives it is placed on
+ *        the executor's ready queue and one of the pool threads runs a bounded slice of it. An object is never scheduled on
+ *        more threads than its concurrency limit, so a limit of one keeps the familiar serial Process_Message semantics.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Module_ID.hh"
+
+#ifndef A4_DotNet
+#include "A4_Mutex.hh"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  class Active_Object; // attached objects
+
+  namespace Executor_Constant
+  { // begin
+    static const std::size_t    Min_Num_Threads = 1; /**< a pool needs at least one thread */
+    static const std::size_t    Default_Num_Threads = 4; /**< enough for a few dozen mostly idle active objects */
+    static const std::uint64_t  Min_Idle_Wait_MS = 10; /**< shorter idle waits burn cpu for no benefit */
+    static const std::uint64_t  Default_Idle_Wait_MS = 100; /**< how often an idle pool thread looks for due Handle_Timeout calls */
+    static const std::size_t    Default_Slice_Size = 32; /**< messages processed per scheduling of an object before it yields its pool thread */
+    static const std::size_t    Not_A_Pool_Thread = ~std::size_t(0); /**< Executor::pool_thread_index of a thread the executor did not start */
+  } // namespace Executor_Constant
+
+  /**
+   * @brief Per-object scheduling state - owned by the Active_Object, guarded by the executor's ready_mutex.
+   */
+  typedef struct Executor_Attachment
+  { // begin
+    std::size_t     max_concurrency = 1; /**< the maximum number of pool threads running this object at once - 1 is serial */
+    std::size_t     num_scheduled = 0; /**< entries on the ready queue plus slices currently running */
+    std::int64_t    next_timeout_ms = 0; /**< steady clock milli-seconds - when Handle_Timeout is next due */
+    bool            is_attached = false; /**< the object is known to the executor */
+  } Executor_Attachment;
+
+  typedef class Executor
+  { // begin
+  public: // construction
+    Executor(void);
+    Executor(Executor &) = delete;
+    virtual ~Executor(void);
+
+    Executor & operator = (Executor &) = delete;
+
+  public: // types
+    typedef std::shared_ptr<Executor>   Pointer;
+
+  public: // methods
+    static Error_Code   Allocate (Executor::Pointer   &the_new_executor);
+
+    Error_Code  Initialize (std::size_t     the_number_of_worker_threads = Executor_Constant::Default_Num_Threads,
+                            std::uint64_t   the_idle_wait = Executor_Constant::Default_Idle_Wait_MS,
+                            std::size_t     the_slice_size = Executor_Constant::Default_Slice_Size);
+
+    bool  Is_Initialized (void) const;
+
+    Error_Code  Start (void);
+    Error_Code  Stop (void);
+
+    bool  Is_Started (void) const;
+
+    std::size_t   Num_Threads (void);
+    std::size_t   Num_Attached (void);
+
+#ifndef A4_DotNet
+  protected: // methods - called by Active_Object
+    friend class Active_Object;
+
+    Error_Code  Attach (Active_Object   *the_active_object);
+    Error_Code  Detach (Active_Object   *the_active_object); // blocks until no slice of the object is running
+
+    Error_Code  Schedule (Active_Object   *the_active_object) noexcept; // work has arrived - a no-op when already at the concurrency limit
+
+  private: // methods
+    Error_Code  Worker_Thread_Method (std::size_t   the_pool_thread_index);
+
+    void        Schedule_Due_Timeouts (std::int64_t   the_current_ms); // ready_mutex must be held
+
+    bool        Schedule_Locked (Active_Object   *the_active_object); // ready_mutex must be held
+
+    static std::int64_t   Now_MS (void);
+
+  private: // data
+    std::deque<Active_Object *>   ready_queue; /**< objects with pending work - an object appears at most max_concurrency times */
+    std::vector<Active_Object *>  attached_objects; /**< every attached object - swept for due timeouts */
+
+    std::mutex                    ready_mutex; /**< guards ready_queue, attached_objects and every Executor_Attachment */
+    std::condition_variable       ready_condition; /**< signalled when an object is placed on the ready queue */
+    std::condition_variable       detach_condition; /**< signalled when the last running slice of an object ends */
+
+    std::vector<std::future<Error_Code>>  thread_future_vector; /**< one per pool thread */
+
+    A4_Lib::Mutex                 start_stop_mutex; /**< used to prevent overlapping calls to Start & Stop */
+
+    std::int64_t                  next_sweep_ms; /**< steady clock milli-seconds - when the attached objects are next checked for due timeouts */
+
+    inline static thread_local std::size_t  pool_thread_index = Executor_Constant::Not_A_Pool_Thread; /**< 0 .. num_worker_threads - 1 on a pool thread - set once as it starts */
+
+    std::size_t                   num_worker_threads; /**< the fixed size of the pool */
+    std::uint64_t                 idle_wait; /**< milli-seconds a pool thread waits for work before sweeping for timeouts */
+    std::size_t                   slice_size; /**< messages processed per scheduling of an object */
+
+    bool                          is_initialized; /**< indicates whether the instance has been Initialized. */
+    bool                          is_started; /**< indicates whether the instance has been Started. */
+#endif // A4_DotNet
+
+  public: // errors
+    enum Executor_Errors
+    { // begin
+      A_Invalid_Initial_State     = 0, /**< \b Allocate: Invalid parameter state - the_new_executor must equal nullptr - memory leak? */
+      A_Allocation_Error          = 1, /**< \b Allocate: Memory allocation error - could not allocate a new Executor instance. */
+      I_Already_Initialized       = 2, /**< \b Initialize: Instance is already initialized. */
+      I_Insufficient_Threads      = 3, /**< \b Initialize: Invalid parameter value - the_number_of_worker_threads is less than the minimum. */
+      I_Invalid_Idle_Wait         = 4, /**< \b Initialize: Invalid parameter value - the_idle_wait < Min_Idle_Wait_MS. */
+      I_Invalid_Slice_Size        = 5, /**< \b Initialize: Invalid parameter value - the_slice_size must be non-zero. */
+      S_Already_Started           = 6, /**< \b Start: The instance is already started. */
+      S_Not_Initialized           = 7, /**< \b Start: The instance is not initialized. */
+      S_Bad_Thread_Count          = 8, /**< \b Start: Failed to start the required number of pool threads. */
+      ST_Not_Started              = 9, /**< \b Stop: The instance is already stopped. */
+      AT_Invalid_Address          = 10, /**< \b Attach: Invalid parameter address - the_active_object is nullptr. */
+      AT_Already_Attached         = 11, /**< \b Attach: The active object is already attached to this executor. */
+      DT_Invalid_Address          = 12, /**< \b Detach: Invalid parameter address - the_active_object is nullptr. */
+      DT_Not_Attached             = 13, /**< \b Detach: The active object is not attached to this executor. */
+    }; // Executor_Errors
+  } Executor;
+} // namespace A4_Lib
+
+#endif // __A4_Executor_Defined__
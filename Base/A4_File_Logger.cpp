@@ -37,28 +37,105 @@
 #include "A4_Method_State_Block.hh"
 #include "A4_Utils.hh"
 #include "A4_File_Util.hh"
+#include "A4_JSON_Line_Writer.hh"
 
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <thread>
 
 #ifdef A4_Lib_Windows
   #include "A4_Win_Helper.hh"
 #endif
 
+namespace
+{ // begin
+  /**
+   * @brief The calling thread's staging buffer for one File_Logger.
+   */
+  typedef struct Staging_Entry
+  { // begin
+    A4_Lib::Log_Staging_Buffer::Pointer   buffer;
+    std::uint64_t                         generation = 0; /**< the File_Logger::staging_generation the buffer is registered with - never reused, so it names the instance */
+  } Staging_Entry;
+
+  /**
+   * @brief The calling thread's staging buffers, one per File_Logger it writes to - marked finished when the thread exits
+   *        (or the entry is replaced), the worker then drops each once it is empty.
+   */
+  typedef struct Staging_Handle
+  { // begin
+    Staging_Entry   entries [A4_Lib::File_Logger_Constants::Max_Staging_Loggers];
+    std::size_t     next_replaced = 0; /**< round robin - when every entry is taken */
+
+    /**
+     * @brief The entry of the_generation - or, when there is none, a free entry or the one to replace.
+     */
+    Staging_Entry & Find (std::uint64_t   the_generation) noexcept
+    { // begin
+      Staging_Entry   *the_free_entry = nullptr;
+
+      for (Staging_Entry &the_entry : this->entries)
+        if (the_entry.generation == the_generation)
+          return the_entry;
+        else if ((the_entry.buffer == nullptr) && (the_free_entry == nullptr))
+          the_free_entry = &the_entry;
+
+      if (the_free_entry != nullptr)
+        return *the_free_entry;
+
+      the_free_entry = &this->entries [this->next_replaced]; // the entries were taken in order - this one is the oldest
+
+      this->next_replaced = (this->next_replaced + 1) % A4_Lib::File_Logger_Constants::Max_Staging_Loggers;
+
+      return *the_free_entry;
+    } // Find
+
+    ~Staging_Handle (void)
+    { // begin
+      for (Staging_Entry &the_entry : this->entries)
+        if (the_entry.buffer != nullptr)
+          the_entry.buffer->Set_Finished();
+    } // destructor
+  } Staging_Handle;
+
+  thread_local Staging_Handle   the_staging_handle;
+  thread_local char             the_record [A4_Lib::File_Logger_Constants::Max_Record_Length]; /**< formatted here, then copied into the staging buffer */
+
+  std::atomic<std::uint64_t>    the_next_staging_generation {1};
+  
+  /**
+   * @brief The record timestamp - the system clock, like High_Res_Timestamp_String.
+   */
+  inline std::int64_t   Epoch_Nano_Seconds (void) noexcept
+  { // begin
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+  } // Epoch_Nano_Seconds
+} // namespace
+
 
 /**
  * \brief default constructor
  */
 A4_Lib::File_Logger::File_Logger(void) 
 { // begin
-  this->log_file = NULL;
+  this->flush_policy = {File_Logger_Constants::Buffer_Flush_Interval, 0, false};
   this->sequence_number = 1; // start the count at one
   this->max_log_file_size = 0;
   this->rollover_sequence = 0;
   this->is_closing = false;
   this->last_flush_time = A4_Lib::Now();
   this->file_creation_time = 0;
+  this->is_write_pending = false;
+  this->num_dropped_records = 0;
+  this->staging_generation = the_next_staging_generation.fetch_add(1);
+  this->is_binary_mode = false;
+  this->is_json_mode = false;
+  this->is_compression_enabled = false;
+  this->crash_ring_size = 0;
 } // constructor
 
 /**
@@ -158,6 +235,9 @@ Error_Code  A4_Lib::File_Logger::Init_Rollover_Sequence(void)
   
   int            the_int_value = 0;
   
+  bool           is_compressed = false; /**< the file name ends in Log_Compressor_Constant::Extension */
+  bool           is_compressible = false; /**< an uncompressed log file of an earlier run */
+  
   Method_State_Block_Begin(7)
     State(1) 
       the_search_string = this->log_folder + this->log_filename + "*";
@@ -180,9 +260,15 @@ Error_Code  A4_Lib::File_Logger::Init_Rollover_Sequence(void)
     End_State
             
     State(4)
-      if (the_filename_parts.size() == 2)
+      is_compressed = ((the_filename_parts.size() == 3) && (("." + the_filename_parts[2]) == Log_Compressor_Constant::Extension));
+    
+      if ((the_filename_parts.size() == 2) || (is_compressed == true))
         the_method_error = A4_Lib::Parse_CSV_Values (the_filename_parts[0], the_filename_parts, '-');
       else { // not a file we're looking for
+        if ((the_filename_parts.size() == 4) && (("." + the_filename_parts[2]) == Log_Compressor_Constant::Extension) && 
+            (("." + the_filename_parts[3]) == Log_Compressor_Constant::Partial_Extension))
+          (void) A4_Lib::Delete_File(this->log_folder + the_filename_vector[the_offset]); // a compression cut short - the log file is still there
+        
         the_offset += 1;
         Set_Target_State(the_file_loop);         
       } // if else
@@ -197,9 +283,19 @@ Error_Code  A4_Lib::File_Logger::Init_Rollover_Sequence(void)
           the_max_sequence = the_int_value;
       } // if then
     
-      if (this->log_archive_days != 0)  
+      is_compressible = ((this->is_compression_enabled == true) && (is_compressed != true) && (the_filename_parts.size() == 2));
+    
+      if (the_filename_parts.size() != 2)
+      { // no sequence number - the crash ring, or another file whose name starts with the log file's - not ours to delete
+        the_offset += 1;
+        Set_Target_State(the_file_loop);
+      } // if then
+      else if (this->log_archive_days != 0)  
         the_method_error = A4_Lib::Get_File_Creation_Time (this->log_folder + the_filename_vector[the_offset], the_creation_time);
       else {
+        if (is_compressible == true)
+          this->uncompressed_log_files.push_back(the_filename_vector[the_offset]);
+        
         the_offset += 1;
         Set_Target_State(the_file_loop);       
       } // if else
@@ -208,7 +304,12 @@ Error_Code  A4_Lib::File_Logger::Init_Rollover_Sequence(void)
     State(6)
       if ((the_current_time - the_creation_time) > (A4_Lib::One_Day_In_Seconds * this->log_archive_days))
         the_method_error = A4_Lib::Delete_File(this->log_folder + the_filename_vector[the_offset]);
-      else the_method_error = this->log_file_timestamps.Insert(the_filename_vector[the_offset], the_creation_time); // save the name & timestamp for later deletion
+      else { // save the name & timestamp for later deletion
+        if (is_compressible == true)
+          this->uncompressed_log_files.push_back(the_filename_vector[the_offset]);
+        
+        the_method_error = this->log_file_timestamps.Insert(the_filename_vector[the_offset], the_creation_time);
+      } // if else
     End_State
 
     State(7)
@@ -234,10 +335,11 @@ Error_Code A4_Lib::File_Logger::Open (std::string      the_log_filespec,
                                       std::uint64_t    the_max_log_file_size)
 { // begin
   
-  Method_State_Block_Begin(9)
+  Method_State_Block_Begin(13)
     State(1)
       if (this->Is_Open () == true)
         the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::O_Already_Open, "File_Logger singleton is already open.");
+      else this->Set_Detail_Level (the_log_level);
     End_State
           
     State(2)
@@ -273,12 +375,33 @@ Error_Code A4_Lib::File_Logger::Open (std::string      the_log_filespec,
     End_State            
 
     State(8)
-      the_method_error = this->Open_Log_File();
+      if ((this->is_compression_enabled == true) && (this->log_compressor.Is_Initialized() != true))
+        the_method_error = this->log_compressor.Initialize();
     End_State
             
     State(9)
+      if (this->is_compression_enabled == true)
+        the_method_error = this->log_compressor.Start();
+    End_State
+            
+    State(10)
+      the_method_error = this->Open_Log_File();
+    End_State
+            
+    State(11)
+      the_method_error = this->Open_Crash_Ring();
+    End_State
+            
+    State(12)
       the_method_error = this->A4_Lib::Logger::Open();
     End_State
+            
+    State(13) // the files an earlier run left uncompressed - a failure is logged, the log stays open
+      for (std::size_t i = 0; i < this->uncompressed_log_files.size(); i++)
+        (void) this->Compress_Rolled_File(this->uncompressed_log_files[i]);
+    
+      this->uncompressed_log_files.clear();
+    End_State
   End_Method_State_Block
 
   return the_method_error.Get_Error_Code();
@@ -291,7 +414,7 @@ Error_Code A4_Lib::File_Logger::Close(void)
 { // begin
   std::size_t  the_count = 0;
   
-  Method_State_Block_Begin(4)
+  Method_State_Block_Begin(7)
     State(1)
       if (this->Is_Started () != true)
         the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::C_Not_Open, "File_Logger is not open.");
@@ -310,12 +433,26 @@ Error_Code A4_Lib::File_Logger::Close(void)
       the_method_error = this->Stop();
     End_State
               
-    State(3)
-      if (this->log_file != NULL)
+    State(3) // whatever the worker did not collect before it stopped
+      if (this->log_writer.Is_Open() == true)
+        the_method_error = this->Write_Staged_Records();
+    End_State
+              
+    State(4)
+      if (this->log_writer.Is_Open() == true)
         the_method_error = Close_Log_File();
     End_State
             
-    State(4)
+    State(5) // a record staged after the last sweep stays in the ring for the next Open
+      the_method_error = this->crash_ring.Close();
+    End_State
+            
+    State(6) // a file being compressed is finished - the queued ones are found by the next Open
+      if (this->log_compressor.Is_Started() == true)
+        the_method_error = this->log_compressor.Stop();
+    End_State
+            
+    State(7)
       the_method_error = this->A4_Lib::Logger::Close();
     End_State
   End_Method_State_Block
@@ -325,48 +462,139 @@ Error_Code A4_Lib::File_Logger::Close(void)
 
 /**
  * \brief Open the log file with the assembled filespec peices.
- * @return No_Error, OLF_File_Already_Open, OLF_fopen_Error
+ * @return No_Error, OLF_File_Already_Open, OLF_fopen_Error, OLF_Magic_Write_Error
  * \note Assumes that this->log_file_mutex is held by the calling method or is not required to be held.
  */
 Error_Code  A4_Lib::File_Logger::Open_Log_File (void)
 { // begin
   std::string   the_filespec;
-  std::string   the_format_mask;
+  std::string   the_filename;
+  std::string   the_folder_delimiter;
   
 #ifdef A4_Lib_Windows
-  the_format_mask = "%s\\%s-%05d%s";
-#else
-  the_format_mask = "%s%s-%05d%s";  
+  the_folder_delimiter = "\\";
 #endif
   
-  Method_State_Block_Begin(3)
+  Method_State_Block_Begin(4)
     State(1)  
-      if (this->log_file != NULL)
-        the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::OLF_File_Already_Open, "Invalid member state - this->log_file is not NULL.");
-      else the_method_error = A4_Lib::SNPrintf(the_filespec, the_format_mask, A4_Lib::File_Logger_Constants::Max_Filename_Length, 
-                                               this->log_folder.c_str(), this->log_filename.c_str(), static_cast<int>(this->rollover_sequence.fetch_add(1)), log_extension.c_str());
+      if (this->log_writer.Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::OLF_File_Already_Open, "Invalid member state - this->log_writer is open.");
+      else the_method_error = A4_Lib::SNPrintf(the_filename, "%s-%05d%s", A4_Lib::File_Logger_Constants::Max_Filename_Length, 
+                                               this->log_filename.c_str(), static_cast<int>(this->rollover_sequence.fetch_add(1)), log_extension.c_str());
     End_State
           
     State(2)
-      this->log_file = std::fopen (the_filespec.c_str(), "a");
+      the_filespec = this->log_folder + the_folder_delimiter + the_filename;
     
-      if (this->log_file == NULL)
+      if (this->log_writer.Open (the_filespec) != No_Error)
         the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::OLF_fopen_Error, A4_Lib::Logging::Error,
-                                     "Call to std::fopen resulted in error %d for filespec %s", errno, the_filespec.c_str());
-      else the_method_error = this->Make_Opening_Entry();
+                                     "Call to Log_File_Writer::Open resulted in error for filespec %s", the_filespec.c_str());
+      else if (this->is_binary_mode == true)
+      { // every file carries the Format_Records of its own events
+        this->is_format_written.assign(Binary_Log_Constant::Max_Formats, false);
+        
+        if (this->log_writer.Get_Size() == 0)
+        { // begin
+          this->log_writer.Add_Copy(Binary_Log_Constant::File_Magic, sizeof(Binary_Log_Constant::File_Magic));
+          
+          if (this->log_writer.Write_Batch() != No_Error)
+            the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::OLF_Magic_Write_Error, "Call to Log_File_Writer::Write_Batch failed writing the binary log file magic.");
+        } // if then
+      } // if then
     End_State
             
     State(3)
+      the_method_error = this->Make_Opening_Entry();
+    End_State
+            
+    State(4)
       this->file_creation_time = A4_Lib::Now();
       this->last_rollover_time = this->file_creation_time;
+      this->current_log_filename = the_filename;
       
-      the_method_error = this->log_file_timestamps.Insert (the_filespec, this->file_creation_time);
+      the_method_error = this->log_file_timestamps.Insert (the_filename, this->file_creation_time); // the name - Delete_Expired_Log_Files adds the folder
     End_State
   End_Method_State_Block
 
   return the_method_error.Get_Error_Code();  
 } // Open_Log_File
 
+/**
+ * \brief Open this->crash_ring and append the records an earlier run staged but never wrote - it crashed, most likely.
+ *        They follow a Warning line, in sequence number order, with the sequence numbers & times of that run.
+ * @return No_Error, OCR_Write_Error, or a Log_Crash_Ring::Open error
+ * \note  The events of that run are written as text - their format ids were its own.
+ */
+Error_Code  A4_Lib::File_Logger::Open_Crash_Ring (void)
+{ // begin
+  Crash_Ring_Record_Vector  the_records;
+  std::string               the_log_message;
+  std::string               the_text;
+  bool                      the_mutex_is_locked = false;
+  
+  Method_State_Block_Begin(5)
+    State(1)
+      if (this->crash_ring_size == 0)
+        Terminate_The_Method_Block; // no crash ring
+      else the_method_error = this->crash_ring.Open (this->log_folder + this->log_filename + Log_Crash_Ring_Constant::Extension, this->crash_ring_size, the_records);
+    End_State
+          
+    State(2)
+      if (the_records.empty() == true)
+        Terminate_The_Method_Block; // the earlier run wrote everything
+      else the_method_error = A4_Lib::SNPrintf (the_log_message, "%zu log records an earlier run staged but did not write - recovered from its crash ring:", 
+                                                Max_Error_Message_Length, the_records.size());
+    End_State
+            
+    State(3)
+      the_method_error = this->Format_and_Enque_Message (the_log_message, A4_Lib::Logging::Warning, true);
+    End_State
+            
+    State(4)
+      the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
+    End_State
+            
+    State(5)
+      for (Crash_Ring_Record &the_record : the_records)
+      { // begin
+        the_record.header.ring_slot = 0;
+        the_text.clear();
+        
+        if ((the_record.header.kind == Event_Record) && 
+            (Log_Arguments::Format (the_record.format.c_str(), the_record.payload.data(), the_record.header.length, the_text) == No_Error))
+        { // the text takes the place of the arguments
+          the_record.header.kind = Message_Record;
+          the_record.header.format_id = 0;
+          the_record.header.length = static_cast<std::uint32_t>(the_text.length());
+          the_record.payload.swap(the_text);
+        } // if then
+        
+        if ((the_record.header.kind != Line_Record) && (the_record.header.kind != Message_Record))
+          continue; // an event that could not be formatted
+        else if (this->is_binary_mode == true)
+        { // begin
+          this->log_writer.Add_Copy(reinterpret_cast<const char *>(&the_record.header), sizeof(the_record.header));
+          this->log_writer.Add_Copy(the_record.payload.data(), the_record.payload.length());
+        } // if then
+        else if (the_record.header.kind == Line_Record)
+          this->log_writer.Add_Copy(the_record.payload.data(), the_record.payload.length());
+        else if (this->Format_Record_Text(the_record.header, the_record.payload.data(), the_text) == No_Error)
+          this->log_writer.Add_Copy(the_text.data(), the_text.length());
+      } // for
+      
+      if (this->log_writer.Write_Batch() != No_Error)
+        the_method_error = A4_Error (A4_Log_Module_ID, OCR_Write_Error, "Call to Log_File_Writer::Write_Batch failed writing the recovered records - enough storage space?");
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_mutex_is_locked == true)
+      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+  A4_End_Cleanup
+            
+  return the_method_error.Get_Error_Code();
+} // Open_Crash_Ring
+
 /**
  * \brief Close this->log_file - Assumes that this->log_file_mutex is held by the calling method or is not required to be held.
  * @return No_Error, 
@@ -375,7 +603,7 @@ Error_Code  A4_Lib::File_Logger::Close_Log_File (void)
 {
   Method_State_Block_Begin(2)
     State(1) 
-      if (this->log_file == NULL)
+      if (this->log_writer.Is_Open() != true)
       { // file is not open - not fatal, but not good
         std::cout << "A4_Lib::File_Logger::Close_Log_File called for a file that is not open.";
         Terminate_The_Method_Block;
@@ -383,13 +611,10 @@ Error_Code  A4_Lib::File_Logger::Close_Log_File (void)
       else this->Make_Closing_Entry ();
     End_State
           
-    State(2)
-      (void) std::fflush(this->log_file); 
-    
-      if (std::fclose (this->log_file) != 0)
+    State(2) // synced first - closed even when that fails
+      if (this->log_writer.Close () != No_Error)
         the_method_error = A4_Error (A4_Log_Module_ID, File_Logger::CLF_fclose_Error, A4_Lib::Logging::Error,
-                                     "Call to std::fclose resulted in error %d ", errno);
-      this->log_file = NULL; // even when fclose fails
+                                     "Call to Log_File_Writer::Close resulted in error");
     End_State
   End_Method_State_Block
 
@@ -496,17 +721,13 @@ Error_Code  A4_Lib::File_Logger::Set_Log_Header_Text (std::string the_header_tex
 } // Set_Log_Header_Text
 
 /**
- * \brief Write the contents of the_message_block to the open log file
- * @param the_message_block - IN - contains a log message to write / OUT - nullptr
+ * \brief A wake-up from a thread that staged log records - write every staging buffer to the open log file
+ * @param the_message_block - IN - carries no data / OUT - nullptr
  * @return No_Error upon success.
  */
 Error_Code  A4_Lib::File_Logger::Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block) 
 { // begin
-  std::string  the_log_message;
-  
-  bool  the_mutex_is_locked = false;
-  
-  Method_State_Block_Begin(5)
+  Method_State_Block_Begin(2)
     State(1)
       if (this->Is_Started () != true)
       { // begin
@@ -518,38 +739,11 @@ Error_Code  A4_Lib::File_Logger::Process_Message (A4_Lib::Message_Block::Pointer
     State(2)
       if (the_message_block == nullptr)
         the_method_error = A4_Error (A4_Log_Module_ID, PM_Invalid_Message_Block, "Invalid parameter address - the_message_block == nullptr");
-      else the_method_error = the_message_block->Get_Data(the_log_message);
-    End_State
-          
-    State(3)
-      if (the_log_message.length() > 0)
-        the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
-      else { // no message to write
-        std::cerr << "An empty log message string was retrieved from the_message_block";
-        Terminate_The_Method_Block;
-      } // if else
-    End_State
-            
-    State(4)
-      if (std::fwrite(the_log_message.c_str(), 1, the_log_message.length(), this->log_file) != the_log_message.length())
-      { // failure
-        std::cerr << "fwrite did not write the entire message length - out of storage space?";
-      } // if then
-      else { // test whether the file has grown too much
-        if (std::ftell (this->log_file) > static_cast<long int>(this->max_log_file_size))
-          the_method_error = Rollover_Log_File (A4_Lib::Now ()); // perhaps the logs volume is high enough where Handle_Timeout method is not called.
-        } // if else
-    End_State
-            
-    State(5)
-      the_method_error = this->log_file_mutex.Unlock (the_mutex_is_locked);
+      else the_method_error = this->Write_Staged_Records(true);
     End_State
   End_Method_State_Block
 
   A4_Cleanup_Begin
-    if (the_mutex_is_locked == true)
-      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
-
     if (the_message_block != nullptr)
       the_message_block.reset();
   A4_End_Cleanup
@@ -565,29 +759,37 @@ Error_Code  A4_Lib::File_Logger::Handle_Timeout (void)
 { // begin
   std::time_t  the_time = 0;
   
-  Method_State_Block_Begin(3)
+  Method_State_Block_Begin(5)
     State(1) // first address any base class admin.
       the_method_error = this->Active_Object::Handle_Timeout();
     End_State
           
-    State(2)
+    State(2) // records staged while a wake-up was already pending
+      if (this->log_writer.Is_Open() == true)
+        the_method_error = this->Write_Staged_Records();
+    End_State
+          
+    State(3)
       the_time = A4_Lib::Now();
     
-      if ((the_time - this->last_flush_time) > File_Logger_Constants::Buffer_Flush_Interval)
-        the_method_error = this->Flush_File_Buffer (the_time);
+      the_method_error = this->Flush_File_Buffer (the_time);
     End_State
             
-    State(3)
+    State(4)
       if ((the_time - this->last_rollover_time) > File_Logger_Constants::Rollover_Check_Interval)
         the_method_error = this->Rollover_Log_File (the_time);
     End_State
+
+    State(5) // the summaries of errors that stopped repeating
+      Error_Rate_Limiter::Report_Suppressed();
+    End_State
   End_Method_State_Block
 
   return the_method_error.Get_Error_Code();
 } // Handle_Timeout
 
 /**
- * \brief Flush the file buffer periodically to ensure everything is committed to the output file.
+ * \brief Sync the log file to storage once Log_Flush_Policy::sync_interval has passed since the last sync.
  * @param the_current_time - IN
  * @return 
  */
@@ -603,9 +805,9 @@ Error_Code  A4_Lib::File_Logger::Flush_File_Buffer(std::time_t  the_current_time
     State(2)
       if (the_mutex_is_locked != true)
         Terminate_The_Method_Block; // maybe an issue, maybe not
-      else {
+      else if ((this->flush_policy.sync_interval > 0) && ((the_current_time - this->last_flush_time) >= this->flush_policy.sync_interval)) {
         this->last_flush_time = the_current_time;
-        (void) std::fflush(this->log_file);               
+        (void) this->log_writer.Sync();
       } // if else
     
       the_method_error = this->log_file_mutex.Unlock (the_mutex_is_locked);
@@ -625,9 +827,11 @@ Error_Code  A4_Lib::File_Logger::Flush_File_Buffer(std::time_t  the_current_time
  */
 Error_Code  A4_Lib::File_Logger::Rollover_Log_File (std::time_t  the_current_time)
 { // begin
+  std::string   the_closed_filename;
+  
   bool  the_mutex_is_locked = false;
   
-  Method_State_Block_Begin(6)
+  Method_State_Block_Begin(7)
     State(1)  
       the_method_error = this->log_file_mutex.Lock(the_mutex_is_locked);
     End_State
@@ -639,8 +843,11 @@ Error_Code  A4_Lib::File_Logger::Rollover_Log_File (std::time_t  the_current_tim
     End_State
             
     State(3)
-      if (((the_current_time - this->file_creation_time) > A4_Lib::One_Day_In_Seconds) || (static_cast<std::size_t>(std::ftell (this->log_file)) > this->max_log_file_size))
-        the_method_error = this->Close_Log_File (); // time to rollover the log
+      if (((the_current_time - this->file_creation_time) > A4_Lib::One_Day_In_Seconds) || (this->log_writer.Get_Size() > this->max_log_file_size))
+      { // time to rollover the log
+        the_closed_filename = this->current_log_filename;
+        the_method_error = this->Close_Log_File ();
+      } // if then
       else { // not yet time to rollover the log file
         the_method_error = this->log_file_mutex.Unlock (the_mutex_is_locked);
         Terminate_The_Method_Block;
@@ -658,6 +865,11 @@ Error_Code  A4_Lib::File_Logger::Rollover_Log_File (std::time_t  the_current_tim
     State(6)
       the_method_error = this->log_file_mutex.Unlock (the_mutex_is_locked);
     End_State
+            
+    State(7) // compressed by the log_compressor threads - not here
+      if (this->is_compression_enabled == true)
+        the_method_error = this->Compress_Rolled_File (the_closed_filename);
+    End_State
   End_Method_State_Block
 
   if (the_mutex_is_locked == true)
@@ -679,22 +891,29 @@ Error_Code  A4_Lib::File_Logger::Delete_Expired_Log_Files(std::time_t  the_curre
   
   Method_State the_map_loop = 0;
   
+  bool  the_mutex_is_locked = false;
  
-  Method_State_Block_Begin(6)
-    State(1)
-      the_method_error = this->log_file_timestamps.Begin(it);
+  Method_State_Block_Begin(7)
+    State(1) // Begin requires the map lock
+      if (this->log_archive_days == 0)
+        Terminate_The_Method_Block; // the log files are kept forever
+      else the_method_error = this->log_file_timestamps.Lock(the_mutex_is_locked);
     End_State
           
     State(2)
-      Define_Target_State (the_map_loop);
+      the_method_error = this->log_file_timestamps.Begin(it);
     End_State
           
     State(3)
+      Define_Target_State (the_map_loop);
+    End_State
+          
+    State(4)
       if (it == this->log_file_timestamps.End())
         Terminate_The_Method_Block;
     End_State
             
-    State(4)
+    State(5)
       if ((the_current_time - it->second ) > the_timeout)
       { // begin
         the_method_error = A4_Lib::Delete_File (this->log_folder + it->first);
@@ -705,17 +924,20 @@ Error_Code  A4_Lib::File_Logger::Delete_Expired_Log_Files(std::time_t  the_curre
       } // if else
     End_State
             
-    State(5)
+    State(6)
       the_method_error = this->log_file_timestamps.Erase (it->first);
     End_State
             
-    State(6)
+    State(7)
       //the_method_error = this->log_file_timestamps.Begin (it);
        the_method_error = this->log_file_timestamps.Begin(it); // iterator is now invalid - start again
        Set_Target_State (the_map_loop);
     End_State
   End_Method_State_Block  
   
+  if (the_mutex_is_locked == true)
+    (void) this->log_file_timestamps.Unlock (the_mutex_is_locked);
+  
   return the_method_error.Get_Error_Code();   
 } // Delete_Expired_Log_Files
 
@@ -735,27 +957,34 @@ bool A4_Lib::File_Logger::Is_Closing(void) const
  * @param the_error - IN
  * @param the_state - IN
  * @param the_message_detail_level - IN
+ * @param the_nano_seconds - IN - when the error happened, nano-seconds since the system clock epoch - 0 means now
  * @return No_Error upon success.
  */
 Error_Code  A4_Lib::File_Logger::Write(std::string       the_log_text,
                                        std::string       the_calling_function_name,
                                        Error_Code        the_error,
                                        Method_State      the_state,
-                                       Logging::Detail   the_message_detail_level)
+                                       Logging::Detail   the_message_detail_level,
+                                       std::int64_t      the_nano_seconds)
 { // begin
   std::string  the_formatted_log_text;
   
+  Log_Line_Context  the_context = {A4_Error::Get_Module_ID(the_error), the_error, the_calling_function_name.c_str(), the_state};
+  
   Method_State_Block_Begin(2)
     State(1) 
-      if (((the_message_detail_level > this->Get_Detail_Level()) && (the_message_detail_level != A4_Lib::Logging::Module_Specific)) || (this->Is_Closing() == true)) // always want to see the module-specific stuff
+      if ((Is_Enabled(the_message_detail_level, the_context.module_id) != true) || (this->Is_Closing() == true)) // filtered by the module that raised the_error
         Terminate_The_Method_Block; // message doesn't need logging
-      else the_method_error = A4_Lib::SNPrintf (the_formatted_log_text,  "%s - Error Code %1.5f returned from %s at machine state %d", 
-                                                Max_Error_Message_Length, 
-                                                the_log_text.c_str(), A4_Error::Get_Dot_Error_Code(the_error), the_calling_function_name.c_str(), static_cast<int>(the_state));
+      else if (this->is_json_mode != true) // the JSON line has fields for these
+        the_method_error = A4_Lib::SNPrintf (the_formatted_log_text,  "%s - Error Code %1.5f returned from %s at machine state %d", 
+                                             Max_Error_Message_Length, 
+                                             the_log_text.c_str(), A4_Error::Get_Dot_Error_Code(the_error), the_calling_function_name.c_str(), static_cast<int>(the_state));
     End_State
           
     State(2)
-      the_method_error = this->Format_and_Enque_Message (the_formatted_log_text, the_message_detail_level);
+      if (this->is_json_mode == true)
+        the_method_error = this->Format_and_Enque_Message (the_log_text, the_message_detail_level, false, &the_context, the_nano_seconds);
+      else the_method_error = this->Format_and_Enque_Message (the_formatted_log_text, the_message_detail_level, false, nullptr, the_nano_seconds);
     End_State
   End_Method_State_Block
 
@@ -780,7 +1009,7 @@ Error_Code A4_Lib::File_Logger::Write (std::string       the_log_text,
     End_State
           
     State(2)
-      if (((the_message_detail_level > this->Get_Detail_Level()) && (the_message_detail_level != A4_Lib::Logging::Module_Specific)) || (this->Is_Closing() == true))  // always want to see the module-specific stuff
+      if ((Is_Enabled(the_message_detail_level) != true) || (this->Is_Closing() == true))  // always want to see the module-specific stuff
         Terminate_The_Method_Block; // message doesn't need logging   
       else the_method_error = this->Format_and_Enque_Message (the_log_text, the_message_detail_level);
     End_State
@@ -792,21 +1021,19 @@ Error_Code A4_Lib::File_Logger::Write (std::string       the_log_text,
 /**
  * @brief Write a log entry that contains a variable number of arguments.
  * @param the_message_detail_level - IN
- * @param the_log_text - IN - the text to be formatted
+ * @param the_log_text - IN - the printf style format
  * @param ... - IN - the variable list to be used
  * @return No_Error, W3_Invalid_Text_Length
  */
 Error_Code    A4_Lib::File_Logger::Write (A4_Lib::Logging::Detail    the_message_detail_level,
-                                          std::string                the_log_text, 
+                                          const char                 *the_log_text, 
                                           ...)
 { // begin
-  std::string the_formatted_text;
-  
   va_list the_va_list;  
   
-  Method_State_Block_Begin(3)
+  Method_State_Block_Begin(2)
     State(1)  
-      if (the_log_text.length() < 1)
+      if ((the_log_text == nullptr) || (the_log_text [0] == '\0'))
       { // no text to write
         the_method_error = A4_Error (A4_Log_Module_ID, W3_Invalid_Text_Length, "Invalid parameter length - the_log_text is empty.");
         std::cout << "Invalid parameter calling A4_Lib::File_Logger::Write(string, Detail) - the_log_text was emoty.";
@@ -814,108 +1041,915 @@ Error_Code    A4_Lib::File_Logger::Write (A4_Lib::Logging::Detail    the_message
     End_State
           
     State(2)
-      if (((the_message_detail_level > this->Get_Detail_Level()) && (the_message_detail_level != A4_Lib::Logging::Module_Specific)) || (this->Is_Closing() == true))  // always want to see the module-specific stuff
+      if ((Is_Enabled(the_message_detail_level) != true) || (this->Is_Closing() == true))  // always want to see the module-specific stuff
         Terminate_The_Method_Block; // message doesn't need logging  
       else { // format the_log_text
         va_start (the_va_list, the_log_text);
-          the_method_error = A4_Lib::SNPrintf (the_formatted_text, the_log_text, A4_Lib::Max_Error_Message_Length, the_va_list);
+          the_method_error = this->Format_and_Enque_Arguments (the_message_detail_level, nullptr, the_log_text, the_va_list);
         va_end (the_va_list); 
       } // if else
     End_State
-              
-    State(3)
-      the_method_error = this->Format_and_Enque_Message (the_formatted_text, the_message_detail_level);            
-    End_State
   End_Method_State_Block
 
   return the_method_error.Get_Error_Code();  
 } // Write (variadic)
+
+/**
+ * @brief Write a formatted log entry at the detail level set for the_module_id - see A4_Module_Log.
+ * @param the_module_id - IN
+ * @param the_message_detail_level - IN
+ * @param the_log_text - IN - the printf style format
+ * @param ... - IN - the variable list to be used
+ * @return No_Error, W4_Invalid_Text_Length
+ */
+Error_Code    A4_Lib::File_Logger::Write (Module_ID                  the_module_id,
+                                          A4_Lib::Logging::Detail    the_message_detail_level,
+                                          const char                 *the_log_text, 
+                                          ...)
+{ // begin
+  Log_Line_Context  the_context = {the_module_id, No_Error, nullptr, 0};
+  
+  va_list the_va_list;  
+  
+  Method_State_Block_Begin(2)
+    State(1)  
+      if ((the_log_text == nullptr) || (the_log_text [0] == '\0'))
+        the_method_error = A4_Error (A4_Log_Module_ID, W4_Invalid_Text_Length, "Invalid parameter length - the_log_text is empty.");
+    End_State
+          
+    State(2)
+      if ((Is_Enabled(the_message_detail_level, the_module_id) != true) || (this->Is_Closing() == true))
+        Terminate_The_Method_Block; // message doesn't need logging  
+      else { // format the_log_text
+        va_start (the_va_list, the_log_text);
+          the_method_error = this->Format_and_Enque_Arguments (the_message_detail_level, &the_context, the_log_text, the_va_list);
+        va_end (the_va_list); 
+      } // if else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();  
+} // Write (module)
 /**
- * \brief synchronousy write this->log_file
+ * \brief synchronousy write this->log_writer
  * @param the_log_message - IN
  * @return No_Error, IW_Log_File_Not_Open, IW_FWrite_Error
+ * \note  A binary log file gets the_log_message as a Line_Record.
  */
 Error_Code  A4_Lib::File_Logger::Internal_Write (std::string   &the_log_message)
 {
-  Method_State_Block_Begin(2)
+  Log_Record_Header   the_header = {static_cast<std::uint32_t>(the_log_message.length()), Line_Record, 0, 0, 0, 0, 0, 0};
+  
+  bool  the_mutex_is_locked = false;
+  
+  Method_State_Block_Begin(3)
     State(1) 
-      if (this->log_file == NULL)
+      the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
+    End_State
+          
+    State(2) 
+      if (this->log_writer.Is_Open() != true)
         the_method_error = A4_Error (A4_Log_Module_ID, IW_Log_File_Not_Open, "Invalid state - the log file is not open.");
     End_State
           
-    State(2)
-      if (std::fwrite(the_log_message.c_str(), 1, the_log_message.length(), this->log_file) != the_log_message.length())
-        the_method_error = A4_Error (A4_Log_Module_ID, IW_FWrite_Error, "Call to std::fwrite failed - enough storage space?");
+    State(3)
+      if (this->is_binary_mode == true)
+        this->log_writer.Add_Copy(reinterpret_cast<const char *>(&the_header), sizeof(the_header));
+    
+      this->log_writer.Add_Copy(the_log_message.c_str(), the_log_message.length());
+    
+      if (this->log_writer.Write_Batch() != No_Error)
+        the_method_error = A4_Error (A4_Log_Module_ID, IW_FWrite_Error, "Call to Log_File_Writer::Write_Batch failed - enough storage space?");
     End_State
   End_Method_State_Block
             
+  A4_Cleanup_Begin
+    if (the_mutex_is_locked == true)
+      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+  A4_End_Cleanup
+            
   return the_method_error.Get_Error_Code();   
 } // Internal_Write
 
 /**
- * \brief Format the_log_text and insert it into the active object message queue - the log text twill be written by one of the worker threads.
+ * \brief Format the_log_text and append it to the calling thread's staging buffer - the log text will be written by one of the worker threads.
  * @param the_log_text - IN
  * @param the_message_detail_level - IN
- * @param is_high_prio_prepend - IN
+ * @param is_high_prio_prepend - IN - write synchronously, ahead of the staged records
+ * @param the_context - IN - the module, error, function & state fields of a JSON line - may be nullptr
+ * @param the_nano_seconds - IN - the record timestamp, nano-seconds since the system clock epoch - 0 means now
  * @return 
+ * \note  In binary mode the line prefix is left to the worker or the decoder - only the_log_text is staged.
  */
-Error_Code  A4_Lib::File_Logger::Format_and_Enque_Message (std::string       &the_log_text, 
-                                                           Logging::Detail   the_message_detail_level,
-                                                           bool              is_high_prio_prepend)
+Error_Code  A4_Lib::File_Logger::Format_and_Enque_Message (std::string             &the_log_text, 
+                                                           Logging::Detail         the_message_detail_level,
+                                                           bool                    is_high_prio_prepend,
+                                                           const Log_Line_Context  *the_context,
+                                                           std::int64_t            the_nano_seconds)
 { // begin
-  A4_Lib::Message_Block::Pointer  the_msg_block;
-  
   std::string  the_detail_level_string;
-  std::string  the_formatted_text;
-  std::string  the_timestamp;
+  char         the_timestamp [Timestamp_Constant::Max_Timestamp_Length];
+  std::size_t  the_timestamp_length = 0;
   
-  std::int64_t the_sequence = 0;
+  Log_Record_Header   the_header = {0, Line_Record, static_cast<std::uint8_t>(the_message_detail_level), 0, 0, 0, 0, 0};
   
-  Method_State_Block_Begin(7)
-    State_NoTry(1) 
-      if ((the_message_detail_level > this->Get_Detail_Level())  && (the_message_detail_level != A4_Lib::Logging::Module_Specific)) // always want to see the module-specific stuff
-        Terminate_The_Method_Block; // message doesn't need logging
-    End_State_NoTry
-          
-    State(2) 
-      the_method_error = this->Get_Detail_Level_String (the_message_detail_level, the_detail_level_string);
+  int          the_length = 0;
+  
+  Method_State_Block_Begin(4)
+    State(1) 
+      the_header.sequence = this->sequence_number.fetch_add(1); // atomic increment the log sequence
+    
+      if ((this->is_binary_mode == true) && (is_high_prio_prepend == false))
+      { // begin
+        the_header.kind = Message_Record;
+        the_header.length = static_cast<std::uint32_t>(std::min(the_log_text.length(), File_Logger_Constants::Max_Record_Length));
+        the_header.nano_seconds = (the_nano_seconds != 0) ? the_nano_seconds : Epoch_Nano_Seconds();
+        
+        the_method_error = this->Stage_Record (the_header, the_log_text.c_str());
+        Terminate_The_Method_Block;
+      } // if then
+      else if (this->is_json_mode != true) // the JSON line takes the static level name
+        the_method_error = this->Get_Detail_Level_String (the_message_detail_level, the_detail_level_string);
     End_State
           
-    State(3)
-      the_method_error = A4_Lib::High_Res_Timestamp_String (the_timestamp);
+    State(2)
+      the_header.nano_seconds = (the_nano_seconds != 0) ? the_nano_seconds : Epoch_Nano_Seconds();
+      the_method_error = A4_Lib::Timestamp_String (the_header.nano_seconds, the_timestamp, sizeof(the_timestamp), the_timestamp_length);
     End_State
             
-    State(4)
-      the_sequence = this->sequence_number.fetch_add(1); // atomic increment the log sequence
+    State(3)
+      if (this->is_json_mode == true)
+        the_length = static_cast<int>(this->Format_JSON_Line (the_header, the_context, the_log_text.data(), the_log_text.length(), the_record, sizeof(the_record)));
+      else if (the_message_detail_level == A4_Lib::Logging::Content_Dump)
+        the_length = std::snprintf (the_record, sizeof(the_record), "%lld: %s", static_cast<long long>(the_header.sequence), the_log_text.c_str());
+      else the_length = std::snprintf (the_record, sizeof(the_record), "%s (%06jd) %s - %s\r\n", 
+                                       the_detail_level_string.c_str(), static_cast<std::intmax_t>(the_header.sequence), the_timestamp, the_log_text.c_str());
     
-      if (the_message_detail_level == A4_Lib::Logging::Content_Dump)
-        the_method_error = A4_Lib::SNPrintf (the_formatted_text, "%lld: %s", A4_Lib::Max_Error_Message_Length, the_sequence, the_log_text.c_str());
-      else the_method_error = A4_Lib::SNPrintf (the_formatted_text, "%s (%06jd) %s - %s\r\n", A4_Lib::Max_Error_Message_Length, 
-                                                the_detail_level_string.c_str(), the_sequence, the_timestamp.c_str(), the_log_text.c_str());
+      if (the_length < 0)
+        Terminate_The_Method_Block; // nothing sensible to write
+      else if (static_cast<std::size_t>(the_length) >= sizeof(the_record))
+      { // truncated - keep the line ending
+        the_length = static_cast<int>(sizeof(the_record) - 1);
+        std::memcpy(the_record + the_length - 5, "...\r\n", 5);
+      } // if then
     End_State
             
-    State(5)
+    State(4)
+      the_header.length = static_cast<std::uint32_t>(the_length);
+      
       if (is_high_prio_prepend == false)
-        the_method_error = A4_Lib::Message_Block::Allocate(the_msg_block);
+        the_method_error = this->Stage_Record (the_header, the_record);
       else { // write synchronously to the log file
+        std::string   the_formatted_text (the_record, static_cast<std::size_t>(the_length));
+        
         the_method_error = this->Internal_Write (the_formatted_text);
-        Terminate_The_Method_Block;
       } // if else
     End_State
-            
-    State(6)
-      the_method_error = the_msg_block->Set_Data(the_formatted_text, 0);
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();  
+} // Format_and_Enque_Message
+
+/**
+ * \brief Format the variadic Write arguments once, straight into the calling thread's record after the line prefix, and
+ *        append the record to its staging buffer - no std::string, no heap, no second printf.
+ * @param the_message_detail_level - IN
+ * @param the_context - IN - the module field of a JSON line - may be nullptr
+ * @param the_log_text - IN - the printf style format
+ * @param the_va_list - IN - consumed
+ * @return No_Error, SR_Allocation_Error, SR_Staging_Buffer_Full
+ * \note  A JSON line escapes the message, so in JSON mode it is formatted first and goes through Format_and_Enque_Message.
+ */
+Error_Code  A4_Lib::File_Logger::Format_and_Enque_Arguments (Logging::Detail         the_message_detail_level,
+                                                             const Log_Line_Context  *the_context,
+                                                             const char              *the_log_text,
+                                                             va_list                 the_va_list)
+{ // begin
+  char         the_timestamp [Timestamp_Constant::Max_Timestamp_Length];
+  std::size_t  the_timestamp_length = 0;
+  std::size_t  the_prefix_length = 0;
+  std::size_t  the_length = 0;
+  int          the_message_length = 0;
+  
+  Log_Record_Header   the_header = {0, Line_Record, static_cast<std::uint8_t>(the_message_detail_level), 0, 0, 0, 0, 0};
+  
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->is_json_mode == true)
+      { // begin
+        char          the_message [Max_Error_Message_Length];
+        std::string   the_text;
+        
+        if ((the_message_length = std::vsnprintf (the_message, sizeof(the_message), the_log_text, the_va_list)) >= 0)
+        { // begin
+          the_text.assign(the_message, std::min(static_cast<std::size_t>(the_message_length), sizeof(the_message) - 1));
+          the_method_error = this->Format_and_Enque_Message (the_text, the_message_detail_level, false, the_context);
+        } // if then
+        
+        Terminate_The_Method_Block;
+      } // if then
+      else
+      { // begin
+        the_header.sequence = this->sequence_number.fetch_add(1); // atomic increment the log sequence
+        the_header.nano_seconds = Epoch_Nano_Seconds();
+        
+        if (this->is_binary_mode == true)
+          the_header.kind = Message_Record; // the worker or the decoder adds the prefix
+        else if (the_message_detail_level == A4_Lib::Logging::Content_Dump)
+          the_prefix_length = static_cast<std::size_t>(std::snprintf (the_record, sizeof(the_record), "%lld: ", static_cast<long long>(the_header.sequence)));
+        else if ((the_method_error = A4_Lib::Timestamp_String (the_header.nano_seconds, the_timestamp, sizeof(the_timestamp), the_timestamp_length)) == No_Error)
+          the_prefix_length = static_cast<std::size_t>(std::snprintf (the_record, sizeof(the_record), "%s (%06jd) %s - ", 
+                                                                      Get_Detail_Level_Name(the_message_detail_level), static_cast<std::intmax_t>(the_header.sequence), the_timestamp));
+      } // else
     End_State
-            
-    State(7)
-      the_method_error = this->Enqueue_Message(the_msg_block);
+    
+    State(2)
+      if ((the_message_length = std::vsnprintf (the_record + the_prefix_length, sizeof(the_record) - the_prefix_length, the_log_text, the_va_list)) < 0)
+        Terminate_The_Method_Block; // nothing sensible to write
+      else if (((the_length = the_prefix_length + static_cast<std::size_t>(the_message_length)) >= sizeof(the_record)) && 
+               ((this->is_binary_mode == true) || (the_message_detail_level == A4_Lib::Logging::Content_Dump)))
+        the_length = sizeof(the_record) - 1; // truncated - no line ending to keep
+      else if ((this->is_binary_mode == true) || (the_message_detail_level == A4_Lib::Logging::Content_Dump))
+        ; // as written - no line ending
+      else if ((the_length + 2) < sizeof(the_record))
+      { // begin
+        the_record [the_length++] = '\r';
+        the_record [the_length++] = '\n';
+      } // if then
+      else
+      { // truncated - keep the line ending
+        the_length = sizeof(the_record) - 1;
+        std::memcpy(the_record + the_length - 5, "...\r\n", 5);
+      } // else
+    End_State
+    
+    State(3)
+      the_header.length = static_cast<std::uint32_t>(the_length);
+      the_method_error = this->Stage_Record (the_header, the_record);
     End_State
   End_Method_State_Block
 
-  A4_Cleanup_Begin
-    if (the_msg_block != nullptr)
-      the_msg_block.reset();
-  A4_End_Cleanup
-            
   return the_method_error.Get_Error_Code();  
-} // Format_and_Enque_Message       
\ No newline at end of file
+} // Format_and_Enque_Arguments
+
+/**
+ * \brief Append a record to the calling thread's staging buffer and make sure the worker will collect it.
+ * @param the_header - IN
+ * @param the_payload - IN - the_header.length bytes
+ * @return No_Error, SR_Allocation_Error, SR_Staging_Buffer_Full
+ * \note  The wake-up message is only queued when none is pending - while the worker keeps finding records it queues
+ *        the wake-up itself, so a busy log costs the producers no Message_Queue operation at all. With a crash ring the record is copied there first - a dropped record stays in it.
+ */
+Error_Code  A4_Lib::File_Logger::Stage_Record (const Log_Record_Header  &the_header,
+                                               const char               *the_payload)
+{ // begin
+  Staging_Entry                   &the_entry = the_staging_handle.Find(this->staging_generation);
+  A4_Lib::Message_Block::Pointer  the_msg_block;
+  Log_Record_Header               the_staged_header = the_header;
+  
+  std::chrono::steady_clock::time_point   the_deadline;
+  
+  Method_State_Block_Begin(3)
+    State(1)
+      if ((the_entry.buffer == nullptr) || (the_entry.generation != this->staging_generation))
+      { // the first record of this thread to this instance
+        try
+        { // begin
+          Log_Staging_Buffer::Pointer   the_buffer = std::make_shared<Log_Staging_Buffer>();
+          
+          { // begin
+            std::lock_guard<std::mutex>   the_lock (this->staging_mutex);
+            
+            this->staging_buffers.push_back(the_buffer);
+          } // lock scope
+          
+          if (the_entry.buffer != nullptr)
+            the_entry.buffer->Set_Finished(); // replaced - its instance drops it once it is empty
+          
+          the_entry.buffer = the_buffer;
+          the_entry.generation = this->staging_generation;
+        } // try
+        catch (...)
+        { // begin
+          the_method_error = A4_Error (A4_Log_Module_ID, SR_Allocation_Error, "Memory allocation error - could not allocate the calling thread's Log_Staging_Buffer.");
+        } // catch
+      } // if then
+    End_State
+            
+    State(2)
+      if (this->crash_ring.Is_Open() == true)
+        the_staged_header.ring_slot = this->crash_ring.Append(the_header, the_payload, (the_header.kind == Event_Record) ? Log_Format_Registry::Get_Format(the_header.format_id) : nullptr);
+    
+      while ((the_entry.buffer->Push(the_staged_header, the_payload) == false) && (the_method_error == No_Error))
+      { // the worker is behind by a whole buffer
+        if (the_deadline.time_since_epoch().count() == 0)
+          the_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(File_Logger_Constants::Max_Staging_Wait_MS); // the clock is only read once the buffer is full
+        else if (std::chrono::steady_clock::now() > the_deadline)
+        { // begin
+          this->num_dropped_records.fetch_add(1, std::memory_order_relaxed);
+          the_method_error = A4_Error (A4_Log_Module_ID, SR_Staging_Buffer_Full, "The calling thread's Log_Staging_Buffer stayed full for Max_Staging_Wait_MS - the log line was dropped.");
+        } // if then
+        else std::this_thread::yield();
+      } // while
+    
+      std::atomic_thread_fence(std::memory_order_seq_cst); // the record is published before is_write_pending is read - pairs with Write_Staged_Records
+    
+      if ((this->is_write_pending.load(std::memory_order_relaxed) == true) || (this->is_write_pending.exchange(true) == true))
+        Terminate_The_Method_Block; // the worker has yet to sweep - it will find this record
+      else if ((the_method_error = A4_Lib::Message_Block::Allocate(the_msg_block)) != No_Error)
+        this->is_write_pending.store(false); // the next record tries again
+    End_State
+            
+    State(3)
+      if ((the_method_error = this->Enqueue_Message(the_msg_block)) != No_Error)
+        this->is_write_pending.store(false); // the next record tries again
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_msg_block != nullptr)
+      the_msg_block.reset();
+  A4_End_Cleanup
+            
+  return the_method_error.Get_Error_Code();  
+} // Stage_Record
+
+/**
+ * \brief Write the pending records of every staging buffer to this->log_writer, oldest first per thread - runs on the
+ *        worker threads, one at a time.
+ * @param is_woken - IN - called for the wake-up message - is_write_pending is this call's to clear
+ * @return No_Error upon success.
+ * \note  Lines of different threads may appear out of sequence number order - the sequence number shows the order they were written in.
+ *        The whole sweep is one Log_File_Writer batch - staged bytes are written from the staging buffers, which are
+ *        released once the batch is written.
+ * \note  While records keep arriving the wake-up message queues itself again and is_write_pending stays set - a busy
+ *        log costs the producers no Message_Queue operation at all. A sweep that finds nothing clears it.
+ */
+Error_Code  A4_Lib::File_Logger::Write_Staged_Records (bool  is_woken)
+{ // begin
+  A4_Lib::Message_Block::Pointer  the_msg_block;
+  
+  bool          the_mutex_is_locked = false;
+  bool          is_write_failed = false;
+  bool          is_error_written = false; // an Error line is in the batch
+  bool          is_staged = false; // a record was staged after is_write_pending was cleared
+  bool          is_wake_handled = (is_woken != true); // is_write_pending is cleared or the wake-up message is queued again
+  std::size_t   the_num_records = 0;
+  
+  Method_State_Block_Begin(6)
+    State(1)
+      the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
+    End_State
+          
+    State(2)
+      if ((the_mutex_is_locked != true) || (this->log_writer.Is_Open() != true))
+        Terminate_The_Method_Block; // the records stay staged
+      else { // begin
+        std::lock_guard<std::mutex>   the_lock (this->staging_mutex);
+        
+        std::string               the_text; // reused for every record formatted here
+        std::vector<std::size_t>  the_cursors; // by staging buffer - released once the batch is written
+        
+        the_cursors.reserve(this->staging_buffers.size());
+        
+        for (Log_Staging_Buffer::Pointer &the_buffer : this->staging_buffers)
+        { // begin
+          std::size_t   the_cursor = the_buffer->Get_Begin();
+          std::size_t   the_end = the_buffer->Get_End();
+          
+          const Log_Record_Header   *the_header = nullptr;
+          
+          while ((the_header = the_buffer->Next(the_cursor, the_end)) != nullptr)
+          { // begin
+            this->Batch_Record(*the_header, the_text);
+            is_error_written |= (the_header->detail == A4_Lib::Logging::Error);
+            the_num_records += 1;
+          } // while
+          
+          the_cursors.push_back(the_cursor);
+        } // for
+        
+        is_write_failed = (this->log_writer.Write_Batch() != No_Error);
+        
+        if ((is_write_failed != true) && (this->crash_ring.Is_Open() == true))
+          is_write_failed = (this->log_writer.Wait_For_Writes() != No_Error); // through io_uring the batch is only submitted - the ring keeps a record until it is in the file
+        
+        for (std::size_t the_offset = 0; the_offset < the_cursors.size(); the_offset++)
+        { // begin
+          if ((is_write_failed != true) && (this->crash_ring.Is_Open() == true))
+          { // the written records are no longer needed after a crash
+            std::size_t               the_cursor = this->staging_buffers [the_offset]->Get_Begin();
+            const Log_Record_Header   *the_header = nullptr;
+            
+            while ((the_header = this->staging_buffers [the_offset]->Next(the_cursor, the_cursors [the_offset])) != nullptr)
+              this->crash_ring.Mark_Written(the_header->ring_slot, the_header->sequence);
+          } // if then
+          
+          this->staging_buffers [the_offset]->Release(the_cursors [the_offset]); // written or lost - either way the producer gets the space back
+        } // for
+      
+        // the buffers of exited threads are gone once written
+        this->staging_buffers.erase(std::remove_if(this->staging_buffers.begin(), this->staging_buffers.end(), [](const Log_Staging_Buffer::Pointer &the_buffer)
+                                    {return (the_buffer->Is_Finished() == true) && (the_buffer->Is_Empty() == true);}),
+                                    this->staging_buffers.end());
+      } // if else
+    End_State
+            
+    State(3)
+      if (is_write_failed == true)
+        std::cerr << "writev did not write every staged log record - out of storage space?";
+      else if (this->log_writer.Get_Size() > this->max_log_file_size)
+        the_method_error = Rollover_Log_File (A4_Lib::Now ()); // perhaps the logs volume is high enough where Handle_Timeout method is not called.
+      else if (((this->flush_policy.is_sync_on_error == true) && (is_error_written == true)) ||
+               ((this->flush_policy.sync_bytes > 0) && (this->log_writer.Get_Unsynced_Bytes() >= this->flush_policy.sync_bytes)))
+        (void) this->log_writer.Sync(); // a failure is logged by Sync
+    End_State
+            
+    State(4)
+      the_method_error = this->log_file_mutex.Unlock (the_mutex_is_locked);
+    End_State
+            
+    State(5) // the wake-up message - sweep again, or go idle
+      if (is_woken != true)
+        Terminate_The_Method_Block; // a queued wake-up message, if any, still comes
+      else if (the_num_records == 0)
+      { // idle - the next record staged queues a new wake-up
+        this->is_write_pending.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with Stage_Record
+        
+        { // begin - a record staged before the store saw is_write_pending set
+          std::lock_guard<std::mutex>   the_lock (this->staging_mutex);
+          
+          for (const Log_Staging_Buffer::Pointer &the_buffer : this->staging_buffers)
+            is_staged |= (the_buffer->Is_Empty() != true);
+        } // lock scope
+        
+        is_wake_handled = (is_staged != true) || (this->is_write_pending.exchange(true) == true); // nothing missed, or a producer queued the wake-up
+      } // if then
+      
+      if (is_wake_handled == true)
+        Terminate_The_Method_Block;
+      else the_method_error = A4_Lib::Message_Block::Allocate(the_msg_block);
+    End_State
+            
+    State(6)
+      is_wake_handled = ((the_method_error = this->Enqueue_Message(the_msg_block)) == No_Error);
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_mutex_is_locked == true)
+      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+    
+    if (is_wake_handled != true)
+      this->is_write_pending.store(false); // the next record tries again
+    
+    if (the_msg_block != nullptr)
+      the_msg_block.reset();
+  A4_End_Cleanup
+            
+  return the_method_error.Get_Error_Code();
+} // Write_Staged_Records
+
+/**
+ * @return the number of log lines dropped because the writing thread's staging buffer stayed full for Max_Staging_Wait_MS
+ */
+std::uint64_t   A4_Lib::File_Logger::Get_Num_Dropped_Records (void) const
+{ // begin
+  return this->num_dropped_records.load(std::memory_order_relaxed);
+} // Get_Num_Dropped_Records
+
+/**
+ * \brief Select the binary log file format - each record is written as it was staged, Tools/A4_Log_Decode.py makes
+ *        the text.
+ * @param is_binary - IN
+ * @return No_Error, SBM_Already_Open, SBM_JSON_Mode
+ */
+Error_Code  A4_Lib::File_Logger::Set_Binary_Mode (bool is_binary)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open () == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, SBM_Already_Open, "Invalid state - the File_Logger is already open.");
+      else if ((is_binary == true) && (this->is_json_mode == true))
+        the_method_error = A4_Error (A4_Log_Module_ID, SBM_JSON_Mode, "Invalid state - JSON mode is set, the two are exclusive.");
+      else this->is_binary_mode = is_binary;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Binary_Mode
+
+/**
+ * \brief Select the JSON-lines log file format - each line is one JSON object with level, sequence, timestamp,
+ *        epoch_ns and message fields, and module, error, function & state where the line has them.
+ * @param is_json - IN
+ * @return No_Error, SJM_Already_Open, SJM_Binary_Mode
+ * \note  Lines end in a line feed alone. The opening & closing entries are JSON lines as well.
+ */
+Error_Code  A4_Lib::File_Logger::Set_JSON_Mode (bool is_json)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open () == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, SJM_Already_Open, "Invalid state - the File_Logger is already open.");
+      else if ((is_json == true) && (this->is_binary_mode == true))
+        the_method_error = A4_Error (A4_Log_Module_ID, SJM_Binary_Mode, "Invalid state - binary mode is set, the two are exclusive.");
+      else this->is_json_mode = is_json;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_JSON_Mode
+
+/**
+ * \brief Write the log files through io_uring - Log_File_Writer stays with writev where the ring cannot be set up.
+ * @param is_enabled - IN
+ * @return No_Error, SIU_Already_Open
+ */
+Error_Code  A4_Lib::File_Logger::Set_IO_Uring (bool is_enabled)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open () == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, SIU_Already_Open, "Invalid state - the File_Logger is already open.");
+      else this->log_writer.Set_IO_Uring(is_enabled);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_IO_Uring
+
+/**
+ * \brief gzip compress each log file once it is rolled over - on the low priority Log_Compressor threads, the logging
+ *        threads never wait for it. Retention counts a compressed file from the creation of its log file.
+ * @param is_enabled - IN
+ * @param the_level - IN - Log_Compressor_Constant::Min_Level .. Max_Level
+ * @return No_Error, SC_Already_Open, SC_Not_Supported, Log_Compressor::SL_Invalid_Level
+ * \note  The files an earlier run left uncompressed - the last file of each run among them - are compressed by Open.
+ */
+Error_Code  A4_Lib::File_Logger::Set_Compression (bool  is_enabled,
+                                                  int   the_level)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Open () == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, SC_Already_Open, "Invalid state - the File_Logger is already open.");
+      else if ((is_enabled == true) && (Log_Compressor::Is_Supported() != true))
+        the_method_error = A4_Error (A4_Log_Module_ID, SC_Not_Supported, "Built without zlib - rolled-over log files cannot be compressed.");
+      else if (is_enabled == true)
+        the_method_error = this->log_compressor.Set_Level(the_level);
+    End_State
+          
+    State(2)
+      this->is_compression_enabled = is_enabled;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Compression
+
+/**
+ * \brief Keep a copy of each staged record in a memory mapped ring file - the records a crash kept from the log file are
+ *        appended to it by the next Open. Nothing is synced - the pages belong to the kernel once copied. With io_uring
+ *        each sweep waits for its writes to complete before the ring gives up their records.
+ * @param is_enabled - IN
+ * @param the_size - IN - ring bytes - Log_Crash_Ring_Constant::Min_Size .. Max_Size
+ * @return No_Error, SCR_Already_Open, SCR_Invalid_Size
+ * \note  The ring file is the log file name with Log_Crash_Ring_Constant::Extension, in the log folder.
+ */
+Error_Code  A4_Lib::File_Logger::Set_Crash_Ring (bool         is_enabled,
+                                                 std::size_t  the_size)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Open () == true)
+        the_method_error = A4_Error (A4_Log_Module_ID, SCR_Already_Open, "Invalid state - the File_Logger is already open.");
+      else if ((is_enabled == true) && ((the_size < Log_Crash_Ring_Constant::Min_Size) || (the_size > Log_Crash_Ring_Constant::Max_Size)))
+        the_method_error = A4_Error (A4_Log_Module_ID, SCR_Invalid_Size, "Invalid parameter value - the_size is outside Log_Crash_Ring_Constant::Min_Size .. Max_Size.");
+    End_State
+          
+    State(2)
+      this->crash_ring_size = (is_enabled == true) ? the_size : 0;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Crash_Ring
+
+/**
+ * \brief Queue a closed log file for this->log_compressor - Retain_Compressed_File follows once it is compressed.
+ * @param the_filename - IN - name only, in this->log_folder
+ * @return No_Error upon success.
+ */
+Error_Code  A4_Lib::File_Logger::Compress_Rolled_File (std::string  the_filename)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      the_method_error = this->log_compressor.Enqueue_File(this->log_folder + the_filename, 
+                                                           [this, the_filename] (const std::string &, const std::string &the_compressed_filespec, Error_Code the_error) 
+                                                           { // begin - on a log_compressor thread
+                                                             if (the_error == No_Error)
+                                                               (void) this->Retain_Compressed_File(the_filename, the_compressed_filespec);
+                                                           }); // Enqueue_File
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Compress_Rolled_File
+
+/**
+ * \brief Keep the retention time of a compressed log file - the compressed name takes over the creation time of the_filename.
+ * @param the_filename - IN - name only - deleted by the compression
+ * @param the_compressed_filespec - IN - as written by this->log_compressor - its name is the retention key
+ * @return No_Error upon success.
+ * \note  A file this->log_file_timestamps does not hold - retention is off, or it expired meanwhile - is left to the next Open.
+ */
+Error_Code  A4_Lib::File_Logger::Retain_Compressed_File (std::string  the_filename,
+                                                         std::string  the_compressed_filespec)
+{ // begin
+  std::string   the_compressed_filename = the_compressed_filespec.substr(the_compressed_filespec.find_last_of("/\\") + 1); // npos + 1 - no folder
+  std::time_t   the_creation_time = 0;
+  std::time_t   the_other_time = 0;
+  bool          is_found = false;
+  
+  Method_State_Block_Begin(4)
+    State(1)
+      the_method_error = this->log_file_timestamps.Find(the_filename, the_creation_time, is_found);
+    End_State
+          
+    State(2)
+      if (is_found != true)
+        Terminate_The_Method_Block; // not tracked
+      else the_method_error = this->log_file_timestamps.Erase(the_filename);
+    End_State
+            
+    State(3) // an earlier compression of the same log file may be tracked already
+      the_method_error = this->log_file_timestamps.Find(the_compressed_filename, the_other_time, is_found);
+    End_State
+            
+    State(4)
+      if (is_found != true)
+        the_method_error = this->log_file_timestamps.Insert(the_compressed_filename, the_creation_time);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Retain_Compressed_File
+
+/**
+ * \brief Set when the written log is synced to storage - see Log_Flush_Policy.
+ * @param the_flush_policy - IN
+ * @return No_Error upon success.
+ */
+Error_Code  A4_Lib::File_Logger::Set_Flush_Policy (const Log_Flush_Policy  &the_flush_policy)
+{ // begin
+  bool  the_mutex_is_locked = false;
+  
+  Method_State_Block_Begin(2)
+    State(1)
+      the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
+    End_State
+          
+    State(2)
+      this->flush_policy = the_flush_policy;
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_mutex_is_locked == true)
+      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+  A4_End_Cleanup
+            
+  return the_method_error.Get_Error_Code();
+} // Set_Flush_Policy
+
+/**
+ * @return the current Log_Flush_Policy
+ */
+A4_Lib::Log_Flush_Policy  A4_Lib::File_Logger::Get_Flush_Policy (void)
+{ // begin
+  Log_Flush_Policy  the_flush_policy;
+  bool              the_mutex_is_locked = false;
+  
+  (void) this->log_file_mutex.Lock (the_mutex_is_locked);
+  
+  the_flush_policy = this->flush_policy;
+  
+  if (the_mutex_is_locked == true)
+    (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+  
+  return the_flush_policy;
+} // Get_Flush_Policy
+
+/**
+ * \brief Write every staged record and sync the log file - for a caller that must know its lines are on storage.
+ * @return No_Error, F_Not_Open
+ */
+Error_Code  A4_Lib::File_Logger::Flush (void)
+{ // begin
+  bool  the_mutex_is_locked = false;
+  
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->log_writer.Is_Open() != true)
+        the_method_error = A4_Error (A4_Log_Module_ID, F_Not_Open, "Invalid state - the log file is not open.");
+    End_State
+          
+    State(2)
+      the_method_error = this->Write_Staged_Records();
+    End_State
+          
+    State(3)
+      the_method_error = this->log_file_mutex.Lock (the_mutex_is_locked);
+    End_State
+          
+    State(4)
+      this->last_flush_time = A4_Lib::Now();
+    
+      the_method_error = this->log_writer.Sync();
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_mutex_is_locked == true)
+      (void) this->log_file_mutex.Unlock (the_mutex_is_locked);
+  A4_End_Cleanup
+            
+  return the_method_error.Get_Error_Code();
+} // Flush
+
+/**
+ * \brief Stage an Event_Record - called by Write_Event once the detail level has been checked.
+ * @param the_message_detail_level - IN
+ * @param the_format_id - IN - from Log_Format_Registry::Register
+ * @param the_arguments - IN - from Log_Arguments::Encode
+ * @param the_length - IN - bytes
+ * @return No_Error, SE_Invalid_Format_ID, or a Stage_Record error
+ */
+Error_Code  A4_Lib::File_Logger::Stage_Event (Logging::Detail   the_message_detail_level,
+                                              std::uint32_t     the_format_id,
+                                              const char        *the_arguments,
+                                              std::size_t       the_length)
+{ // begin
+  Log_Record_Header   the_header = {static_cast<std::uint32_t>(the_length), Event_Record, static_cast<std::uint8_t>(the_message_detail_level), 0, the_format_id, 0, 0, 0};
+  
+  Method_State_Block_Begin(2)
+    State(1)
+      if (Log_Format_Registry::Get_Format(the_format_id) == nullptr)
+        the_method_error = A4_Error (A4_Log_Module_ID, SE_Invalid_Format_ID, "Invalid parameter value - the_format_id is not registered.");
+    End_State
+          
+    State(2)
+      the_header.sequence = this->sequence_number.fetch_add(1);
+      the_header.nano_seconds = Epoch_Nano_Seconds();
+    
+      the_method_error = this->Stage_Record (the_header, the_arguments);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Stage_Event
+
+/**
+ * \brief Make the text log line of a Message_Record or Event_Record - the same line Format_and_Enque_Message makes.
+ * @param the_header - IN
+ * @param the_payload - IN
+ * @param the_text - OUT - replaced
+ * @return No_Error upon success.
+ * \note  In JSON mode the message is made first and the_text is then replaced by its JSON line.
+ */
+Error_Code  A4_Lib::File_Logger::Format_Record_Text (const Log_Record_Header  &the_header,
+                                                     const char               *the_payload,
+                                                     std::string              &the_text)
+{ // begin
+  std::string   the_detail_level_string;
+  char          the_prefix [128];
+  char          the_timestamp [Timestamp_Constant::Max_Timestamp_Length];
+  std::size_t   the_timestamp_length = 0;
+  char          the_line [File_Logger_Constants::Max_Record_Length];
+  
+  Method_State_Block_Begin(4)
+    State(1)
+      the_text.clear();
+    
+      if (this->is_json_mode != true)
+        the_method_error = this->Get_Detail_Level_String (static_cast<Logging::Detail>(the_header.detail), the_detail_level_string);
+    End_State
+          
+    State(2)
+      if (this->is_json_mode != true)
+      { // begin
+        if (A4_Lib::Timestamp_String (the_header.nano_seconds, the_timestamp, sizeof(the_timestamp), the_timestamp_length) != No_Error)
+          the_timestamp [0] = '\0'; // the line still goes out
+      
+        if (the_header.detail == A4_Lib::Logging::Content_Dump)
+          (void) std::snprintf (the_prefix, sizeof(the_prefix), "%lld: ", static_cast<long long>(the_header.sequence));
+        else (void) std::snprintf (the_prefix, sizeof(the_prefix), "%s (%06jd) %s - ", 
+                                   the_detail_level_string.c_str(), static_cast<std::intmax_t>(the_header.sequence), the_timestamp);
+      
+        the_text = the_prefix;
+      } // if then
+    End_State
+            
+    State(3)
+      if (the_header.kind == Event_Record)
+        the_method_error = Log_Arguments::Format (Log_Format_Registry::Get_Format(the_header.format_id), the_payload, the_header.length, the_text);
+      else the_text.append(the_payload, the_header.length);
+    End_State
+            
+    State(4)
+      if (this->is_json_mode == true)
+        the_text.assign(the_line, this->Format_JSON_Line (the_header, nullptr, the_text.data(), the_text.length(), the_line, sizeof(the_line)));
+      else if (the_header.detail != A4_Lib::Logging::Content_Dump)
+        the_text += "\r\n";
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Format_Record_Text
+
+/**
+ * \brief Write one log line as a JSON object - level, sequence, timestamp, the_context fields, then the message.
+ * @param the_header - IN - the detail level, sequence & time of the line
+ * @param the_context - IN - may be nullptr
+ * @param the_text - IN - the message
+ * @param the_text_length - IN
+ * @param the_line - OUT - the JSON line, ending in a line feed
+ * @param the_line_size - IN
+ * @return the line length - a message too long for the_line is cut short, the line is still valid JSON
+ */
+std::size_t   A4_Lib::File_Logger::Format_JSON_Line (const Log_Record_Header  &the_header,
+                                                     const Log_Line_Context   *the_context,
+                                                     const char               *the_text,
+                                                     std::size_t              the_text_length,
+                                                     char                     *the_line,
+                                                     std::size_t              the_line_size) noexcept
+{ // begin
+  JSON_Line_Writer  the_writer (the_line, the_line_size);
+  char              the_timestamp [Timestamp_Constant::Max_Timestamp_Length];
+  std::size_t       the_timestamp_length = 0;
+  char              the_error_code [File_Logger_Constants::Max_Error_Code_Length];
+  
+  the_writer.Put_String("level", Get_Detail_Level_Name(static_cast<Logging::Detail>(the_header.detail)));
+  the_writer.Put_Integer("sequence", the_header.sequence);
+  
+  if (A4_Lib::Timestamp_String (the_header.nano_seconds, the_timestamp, sizeof(the_timestamp), the_timestamp_length) == No_Error)
+    the_writer.Put_String("timestamp", the_timestamp, the_timestamp_length);
+  
+  the_writer.Put_Integer("epoch_ns", the_header.nano_seconds);
+  
+  if (the_context != nullptr)
+  { // begin
+    the_writer.Put_Unsigned("module", the_context->module_id);
+    
+    if (the_context->function != nullptr)
+    { // an error report
+      (void) std::snprintf (the_error_code, sizeof(the_error_code), "%1.5f", A4_Error::Get_Dot_Error_Code(the_context->error));
+      
+      the_writer.Put_String("error", the_error_code);
+      the_writer.Put_String("function", the_context->function);
+      the_writer.Put_Integer("state", static_cast<std::int64_t>(the_context->state));
+    } // if then
+  } // if then
+  
+  while ((the_text_length > 0) && ((the_text [the_text_length - 1] == '\n') || (the_text [the_text_length - 1] == '\r')))
+    the_text_length--; // the line ends the message - the opening & closing entries end in line breaks of their own
+  
+  the_writer.Put_String("message", the_text, the_text_length);
+  
+  return the_writer.Finish();
+} // Format_JSON_Line
+
+
+/**
+ * \brief Add one staged record to this->log_writer's batch - as a text line, or as it was staged to a binary log file.
+ * @param the_header - IN - in a staging buffer, its payload follows
+ * @param the_text - IN/OUT - scratch space
+ * \note  Assumes that this->log_file_mutex is held by the calling method.
+ */
+void  A4_Lib::File_Logger::Batch_Record (const Log_Record_Header  &the_header,
+                                         std::string              &the_text)
+{ // begin
+  const char  *the_payload = reinterpret_cast<const char *>(&the_header + 1);
+  const char  *the_format = nullptr;
+  
+  if (this->is_binary_mode == true)
+  { // begin
+    if ((the_header.kind == Event_Record) && (the_header.format_id < this->is_format_written.size()) && (this->is_format_written [the_header.format_id] != true) &&
+        ((the_format = Log_Format_Registry::Get_Format(the_header.format_id)) != nullptr))
+    { // the decoder learns the format ahead of its first event in this file
+      Log_Record_Header   the_format_header = {static_cast<std::uint32_t>(std::strlen(the_format)), Format_Record, 0, 0, the_header.format_id, 0, 0, 0};
+      
+      this->log_writer.Add_Copy(reinterpret_cast<const char *>(&the_format_header), sizeof(the_format_header));
+      this->log_writer.Add(the_format, the_format_header.length); // static
+      this->is_format_written [the_header.format_id] = true;
+    } // if then
+    
+    this->log_writer.Add(reinterpret_cast<const char *>(&the_header), sizeof(the_header) + the_header.length);
+  } // if then
+  else if (the_header.kind == Line_Record)
+    this->log_writer.Add(the_payload, the_header.length);
+  else if (this->Format_Record_Text(the_header, the_payload, the_text) == No_Error)
+    this->log_writer.Add_Copy(the_text.data(), the_text.length());
+} // Batch_Record
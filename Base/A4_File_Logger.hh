@@ -35,10 +35,33 @@
 #include "A4_Active_Object.hh"
 #include "A4_Recursive_Mutex.hh"
 #include "A4_Unordered_Map_T.hh"
+#include "A4_Log_Staging_Buffer.hh"
+#include "A4_Binary_Log.hh"
+#include "A4_Log_File_Writer.hh"
+#include "A4_Log_Compressor.hh"
+#include "A4_Log_Crash_Ring.hh"
 #include <atomic>
+#include <cstdarg>
+#include <mutex>
+#include <vector>
 
 #define A4_File_Log  A4_Lib::File_Logger::Instance()
 
+/**
+ * \brief Log an event without formatting it on the calling thread - see A4_Binary_Log.hh.
+ * \note  the_format must be a string literal - it is registered once per call site.
+ */
+#define A4_Log_Event(the_detail, the_format, ...) \
+  do { \
+    if (((the_detail) <= A4_Log_Max_Compiled_Detail) && (A4_Lib::Logger::Is_Enabled(the_detail) == true)) \
+    { \
+      static const std::uint32_t    the_event_format_id = A4_Lib::Log_Format_Registry::Register(the_format); \
+      A4_Lib::File_Logger::Pointer  the_event_logger = A4_Lib::File_Logger::Instance(); \
+      if (the_event_logger != nullptr) \
+        (void) the_event_logger->Write_Event(the_detail, the_event_format_id, ##__VA_ARGS__); \
+    } \
+  } while (false)
+
 namespace A4_Lib
 { // begin
 
@@ -56,8 +79,11 @@ namespace A4_Lib
     const std::uint64_t   Min_Max_Log_Length = 1048576; /**< why have the maximum size smaller than this value? */
     const std::size_t     Max_Filename_Length = 256; /**< Max length of the file-spec - this could be longer if the use case requires it. */
     const std::size_t     Max_Shutdown_Wait = 30; /**< if it takes longer than this number of seconds to stop, then data will be lost */
-    const std::time_t     Buffer_Flush_Interval = 10; /**< The max. number of seconds a log message can be written, but not flushed to storage. */
+    const std::time_t     Buffer_Flush_Interval = 10; /**< The default Log_Flush_Policy::sync_interval - the max. number of seconds a log message can be written, but not synced to storage. */
     const std::time_t     Rollover_Check_Interval = 15; /**< The number of seconds between testing whether old log files need deleting */
+    const std::size_t     Max_Record_Length = A4_Lib::Max_Error_Message_Length + 128; /**< a formatted log line - longer text is truncated */
+    const std::int64_t    Max_Staging_Wait_MS = 50; /**< a thread that outruns the writer by a whole staging buffer waits this long before its line is dropped */
+    const std::size_t     Max_Staging_Loggers = 4; /**< File_Loggers a thread keeps a staging buffer for at once - a further one replaces the least recently added */
   } // namespace File_Logger_Constants
 
   typedef class File_Logger : public A4_Lib::Logger,
@@ -71,6 +97,17 @@ namespace A4_Lib
       typedef std::shared_ptr<File_Logger>  Pointer; 
       typedef A4_Lib::Unordered_Map_T <std::string, std::time_t, A4_File_Logger_Module_ID, File_Logger_Constants::Timestamp_Map_Error_Offset>  Map_Type;
       
+      /**
+       * @brief Where a log line came from - the JSON-lines fields beyond level, sequence, timestamp & message.
+       */
+      typedef struct Log_Line_Context
+      { // begin
+        Module_ID     module_id;
+        Error_Code    error;
+        const char    *function; /**< nullptr - no error, function & state fields */
+        Method_State  state;
+      } Log_Line_Context;
+      
     public: // required virtual methods
       static Error_Code Allocate_Singleton (void); // allocate a new singleton instance - 
       
@@ -78,13 +115,19 @@ namespace A4_Lib
                                           std::string       the_calling_function_name,
                                           Error_Code        the_error,
                                           Method_State      the_state,
-                                          Logging::Detail   the_message_detail_level) override;
+                                          Logging::Detail   the_message_detail_level,
+                                          std::int64_t      the_nano_seconds = 0) override;
       
       A4_Export virtual Error_Code Write (std::string       the_log_text,
                                           Logging::Detail   the_message_detail_level) override;
       
       A4_Export virtual Error_Code Write (A4_Lib::Logging::Detail    the_message_detail_level,
-                                          std::string                the_log_text,
+                                          const char                 *the_log_text,
+                                          ...) override;
+      
+      A4_Export virtual Error_Code Write (Module_ID                  the_module_id,
+                                          A4_Lib::Logging::Detail    the_message_detail_level,
+                                          const char                 *the_log_text,
                                           ...) override;
       
       virtual Error_Code  Open (std::string        the_log_filespec,
@@ -101,39 +144,124 @@ namespace A4_Lib
     public: // file logging specific methods
       A4_Export Error_Code    Set_Log_Header_Text (std::string the_header_text);
       
+      A4_Export std::uint64_t   Get_Num_Dropped_Records (void) const; // lines lost because their thread's staging buffer stayed full
+      
+      A4_Export Error_Code    Set_Binary_Mode (bool is_binary); // before Open - the log files hold records for Tools/A4_Log_Decode.py
+      
+      bool  Is_Binary_Mode (void) const {return this->is_binary_mode;};
+      
+      A4_Export Error_Code    Set_JSON_Mode (bool is_json); // before Open - one JSON object per log line, for log indexers
+      
+      bool  Is_JSON_Mode (void) const {return this->is_json_mode;};
+      
+      A4_Export Error_Code    Set_IO_Uring (bool is_enabled); // before Open - write the log files through io_uring where the kernel allows
+      
+      bool  Is_IO_Uring_Active (void) const {return this->log_writer.Is_IO_Uring_Active();}; // false when writing with writev
+      
+      A4_Export Error_Code    Set_Compression (bool  is_enabled,
+                                               int   the_level = Log_Compressor_Constant::Default_Level); // before Open - rolled-over log files are gzip compressed in the background
+      
+      bool  Is_Compression_Enabled (void) const {return this->is_compression_enabled;};
+      
+      A4_Export Error_Code    Set_Crash_Ring (bool         is_enabled,
+                                              std::size_t  the_size = Log_Crash_Ring_Constant::Default_Size); // before Open - the staged records survive a crash in the log name + ".ring"
+      
+      bool  Is_Crash_Ring_Open (void) const {return this->crash_ring.Is_Open();};
+      
+      A4_Export Error_Code    Set_Flush_Policy (const Log_Flush_Policy  &the_flush_policy); // when the written log reaches storage
+      A4_Export Log_Flush_Policy  Get_Flush_Policy (void);
+      
+      A4_Export Error_Code    Flush (void); // write every staged record and sync the log file - returns once both are done
+      
+      /**
+       * \brief Stage an A4_Log_Event - the arguments are encoded, the text is made by the worker or the decoder.
+       * @param the_message_detail_level - IN
+       * @param the_format_id - IN - from Log_Format_Registry::Register
+       * @param the_args - IN - numbers, strings or pointers
+       */
+      template <typename... The_Args> Error_Code  Write_Event (Logging::Detail     the_message_detail_level,
+                                                               std::uint32_t       the_format_id,
+                                                               const The_Args &... the_args)
+      { // begin
+        char  the_arguments [Binary_Log_Constant::Max_Argument_Bytes];
+        
+        if ((Is_Enabled(the_message_detail_level) != true) || (this->Is_Closing() == true))
+          return No_Error; // the event doesn't need logging
+        
+        return this->Stage_Event (the_message_detail_level, the_format_id, the_arguments, Log_Arguments::Encode(the_arguments, sizeof(the_arguments), the_args...));
+      } // Write_Event
+      
     protected: // overrides
       virtual   Error_Code  Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block) override;
       virtual   Error_Code  Handle_Timeout (void) override;
       
     private: // methods
-      Error_Code  Format_and_Enque_Message (std::string       &the_log_text, 
-                                            Logging::Detail   the_message_detail_level,
-                                            bool              is_high_prio_prepend = false);
+      Error_Code  Format_and_Enque_Message (std::string             &the_log_text, 
+                                            Logging::Detail         the_message_detail_level,
+                                            bool                    is_high_prio_prepend = false,
+                                            const Log_Line_Context  *the_context = nullptr, // JSON mode only
+                                            std::int64_t            the_nano_seconds = 0); // the timestamp - 0 means now
+      
+      Error_Code  Format_and_Enque_Arguments (Logging::Detail         the_message_detail_level,
+                                              const Log_Line_Context  *the_context, // JSON mode only - may be nullptr
+                                              const char              *the_log_text,
+                                              va_list                 the_va_list); // the variadic Writes - formatted once, straight into the record
+      
+      std::size_t Format_JSON_Line (const Log_Record_Header  &the_header,
+                                    const Log_Line_Context   *the_context,
+                                    const char               *the_text,
+                                    std::size_t              the_text_length,
+                                    char                     *the_line,
+                                    std::size_t              the_line_size) noexcept; // the line length
       
       Error_Code  Init_Log_Filespec (std::string  the_log_filespec);
       Error_Code  Init_Rollover_Sequence(void);
       
       Error_Code  Open_Log_File (void);
+      Error_Code  Open_Crash_Ring (void); // and append the records an earlier run staged but never wrote
       Error_Code  Close_Log_File (void);
       Error_Code  Make_Closing_Entry (void);
       Error_Code  Make_Opening_Entry (void);
       
-      Error_Code  Flush_File_Buffer(std::time_t  the_current_time); // log will be flushed at a regular interval - not after every write
+      Error_Code  Flush_File_Buffer(std::time_t  the_current_time); // log will be synced at the Log_Flush_Policy interval - not after every write
       
       Error_Code  Rollover_Log_File (std::time_t  the_current_time);
       
       Error_Code  Delete_Expired_Log_Files(std::time_t  the_current_time);
       
+      Error_Code  Compress_Rolled_File (std::string  the_filename); // hand a closed log file to this->log_compressor
+      Error_Code  Retain_Compressed_File (std::string  the_filename,
+                                          std::string  the_compressed_filespec); // on a log_compressor thread - the compressed name replaces the_filename in this->log_file_timestamps
+      
       Error_Code  Internal_Write (std::string   &the_log_message);
       
+      Error_Code  Stage_Record (const Log_Record_Header  &the_header,
+                                const char               *the_payload); // append to the calling thread's staging buffer
+      
+      Error_Code  Stage_Event (Logging::Detail   the_message_detail_level,
+                               std::uint32_t     the_format_id,
+                               const char        *the_arguments,
+                               std::size_t       the_length);
+      
+      Error_Code  Format_Record_Text (const Log_Record_Header  &the_header,
+                                      const char               *the_payload,
+                                      std::string              &the_text); // a Message_Record or Event_Record as a text log line
+      
+      void        Batch_Record (const Log_Record_Header  &the_header,
+                                std::string              &the_text); // worker side - add a staged record to this->log_writer's batch - the_text is scratch space
+      
+      Error_Code  Write_Staged_Records (bool  is_woken = false); // sweep every staging buffer into the log file - the worker side, is_woken for the wake-up message
+      
     private: // data
-      std::FILE                 *log_file; /**< The file instance that will be appended with new log entries - deliberately \b not a unique_ptr */
-      A4_Lib::Recursive_Mutex   log_file_mutex; /**< Keeps this->log_file thread safe */
+      A4_Lib::Log_File_Writer   log_writer; /**< The open log file that will be appended with new log entries */
+      A4_Lib::Recursive_Mutex   log_file_mutex; /**< Keeps this->log_writer & this->flush_policy thread safe */
+      Log_Flush_Policy          flush_policy; /**< see Set_Flush_Policy */
       
       A4_Lib::String_Vector	filespec_vector; /**< splits the filespec into folders / filename.ext */
       A4_Lib::String_Vector     filename_vector; /**< splits the filename into filename / .ext */
       
       Map_Type                  log_file_timestamps; /**< map containing the log filename and the creation date */
+      std::string               current_log_filename; /**< the open log file - name only, as in log_file_timestamps */
       
       std::atomic_int_fast64_t  sequence_number; /**< unique number for each log entry */
       std::atomic_uint16_t      rollover_sequence; /**< the sequence number appended to the log filename */
@@ -147,12 +275,28 @@ namespace A4_Lib
       
       std::time_t               log_archive_days; /**< The number of days a log file will be allowed to stay in storage. A value of zero means forever */
       
-      std::time_t               last_flush_time; /**< The last time (in seconds) the log file was flushed */
+      std::time_t               last_flush_time; /**< The last time (in seconds) the log file was synced */
       std::time_t               file_creation_time; /**< The log file creation time */
       std::time_t               last_rollover_time; /**< The last time the logs were tested for rolling over */
       
       bool                      is_closing; /**< if \b true, this File_Logger instance is closing and no new log entries will be accepted. */
       
+      std::vector<Log_Staging_Buffer::Pointer>  staging_buffers; /**< one per thread that has written a log entry */
+      std::mutex                staging_mutex; /**< Keeps this->staging_buffers thread safe - never held while logging */
+      std::atomic<bool>         is_write_pending; /**< a wake-up message is queued for the worker, or the worker is sweeping for it - at most one at a time */
+      std::atomic<std::uint64_t>  num_dropped_records; /**< see Get_Num_Dropped_Records */
+      std::uint64_t             staging_generation; /**< tells this instance's staging buffers from those of an earlier singleton */
+      
+      bool                      is_binary_mode; /**< see Set_Binary_Mode */
+      bool                      is_json_mode; /**< see Set_JSON_Mode */
+      
+      A4_Lib::Log_Compressor    log_compressor; /**< compresses the rolled-over log files - started by Open when is_compression_enabled */
+      bool                      is_compression_enabled; /**< see Set_Compression */
+      A4_Lib::String_Vector     uncompressed_log_files; /**< found by Init_Rollover_Sequence - compressed once Open has started log_compressor */
+      A4_Lib::Log_Crash_Ring    crash_ring; /**< a copy of every staged record - open from Open to Close when crash_ring_size is set */
+      std::size_t               crash_ring_size; /**< see Set_Crash_Ring - 0 for none */
+      std::vector<bool>         is_format_written; /**< by format id - the Format_Record is in the current binary log file */
+      
     public: // errors
       enum File_Logger_Errors /**< Errors unique to File_Logger */
       { // begin
@@ -167,12 +311,28 @@ namespace A4_Lib
         ILF_Invalid_Filespec_Vector_Size  = 8, /**< \b Init_Log_Filespec: Parsing the_log_filespec resulted in a parsed vector that is too short. */
         ILF_Invalid_Filename_Vector_Size  = 9, /**< \b Init_Log_Filespec: Parsing the file name resulted in a parsed vector that is too short. */
         OLF_File_Already_Open             = 10, /**< \b Open_Log_File: Invalid member state - this->log_file is not NULL. */
-        OLF_fopen_Error                   = 11, /**< \b Open_Log_File: Call to std::fopen resulted in error */
-        CLF_fclose_Error                  = 12, /**< \b Close_Log_File: all to std::fclose resulted in error */
+        OLF_fopen_Error                   = 11, /**< \b Open_Log_File: Call to Log_File_Writer::Open resulted in error */
+        CLF_fclose_Error                  = 12, /**< \b Close_Log_File: Call to Log_File_Writer::Close resulted in error */
         IW_Log_File_Not_Open              = 13, /**< \b Internal_Write: Invalid state - the log file is not open. */
-        IW_FWrite_Error                   = 14, /**< \b Internal_Write: Call to std::fwrite failed - enough storage space? */
+        IW_FWrite_Error                   = 14, /**< \b Internal_Write: Call to Log_File_Writer::Write_Batch failed - enough storage space? */
         W2_Invalid_Text_Length            = 15, /**< \b Write (2-parameter): Invalid parameter length - the_log_text is empty. */
         W3_Invalid_Text_Length            = 16, /**< \b Write (variadic): Invalid parameter length - the_log_text is empty. */
+        SR_Allocation_Error               = 17, /**< \b Stage_Record: Memory allocation error - could not allocate the calling thread's Log_Staging_Buffer. */
+        SR_Staging_Buffer_Full            = 18, /**< \b Stage_Record: The calling thread's Log_Staging_Buffer stayed full for Max_Staging_Wait_MS - the log line was dropped. */
+        SBM_Already_Open                  = 19, /**< \b Set_Binary_Mode: Invalid state - the File_Logger is already open. */
+        SE_Invalid_Format_ID              = 20, /**< \b Stage_Event: Invalid parameter value - the_format_id is not registered. */
+        OLF_Magic_Write_Error             = 21, /**< \b Open_Log_File: Call to Log_File_Writer::Write_Batch failed writing the binary log file magic. */
+        F_Not_Open                        = 22, /**< \b Flush: Invalid state - the log file is not open. */
+        SIU_Already_Open                  = 23, /**< \b Set_IO_Uring: Invalid state - the File_Logger is already open. */
+        W4_Invalid_Text_Length            = 24, /**< \b Write (module): Invalid parameter length - the_log_text is NULL or empty. */
+        SJM_Already_Open                  = 25, /**< \b Set_JSON_Mode: Invalid state - the File_Logger is already open. */
+        SJM_Binary_Mode                   = 26, /**< \b Set_JSON_Mode: Invalid state - binary mode is set, the two are exclusive. */
+        SBM_JSON_Mode                     = 27, /**< \b Set_Binary_Mode: Invalid state - JSON mode is set, the two are exclusive. */
+        SC_Already_Open                   = 28, /**< \b Set_Compression: Invalid state - the File_Logger is already open. */
+        SC_Not_Supported                  = 29, /**< \b Set_Compression: Built without zlib - rolled-over log files cannot be compressed. */
+        SCR_Already_Open                  = 30, /**< \b Set_Crash_Ring: Invalid state - the File_Logger is already open. */
+        SCR_Invalid_Size                  = 31, /**< \b Set_Crash_Ring: Invalid parameter value - the_size is outside Log_Crash_Ring_Constant::Min_Size .. Max_Size. */
+        OCR_Write_Error                   = 32, /**< \b Open_Crash_Ring: Call to Log_File_Writer::Write_Batch failed writing the recovered records - enough storage space? */
       }; // File_Logger_Errors
   } File_Logger;
 } // namespace A4_Lib
@@ -197,11 +197,9 @@ Error_Code  A4_Lib::Get_File_Creation_Time(std::string    the_filespec,
   
     struct dirent           *the_dir_entry = NULL; 
     
-    Method_State            the_file_loop = 0;
-    
     bool                    is_a_match = false;
     
-    Method_State_Block_Begin(8)
+    Method_State_Block_Begin(6)
       State(1)  
         the_filename_vector.clear();
     
@@ -232,41 +230,34 @@ Error_Code  A4_Lib::Get_File_Creation_Time(std::string    the_filespec,
       End_State
               
       State(5)
-        Define_Target_State(the_file_loop);
-      End_State
-      
-      State(6)
-        if (the_dir_entry == NULL)
-        { // all done
-          Terminate_The_Method_Block;
-          
-          if (closedir (the_dir) != 0)
-            the_method_error = A4_Error (A4_File_Util_Module_ID, A4_Lib::A4_File_Util_Errors::GLFV_Closedir_Error, "Call to closedir failed with error %d", errno);
-        } // if then
-      End_State
-              
-      State(7)
-        if (the_dir_entry->d_type == DT_REG)
-          the_method_error = A4_Lib::String_Matches_Wildcard (the_search_string_vector.back(), the_dir_entry->d_name, is_a_match);
-        else {
-          the_dir_entry = readdir (the_dir);
+        State_Loop(the_dir_entry != NULL)
+          is_a_match = false;
+
+          if (the_dir_entry->d_type == DT_REG)
+            the_method_error = A4_Lib::String_Matches_Wildcard (the_search_string_vector.back(), the_dir_entry->d_name, is_a_match);
+
+          if (is_a_match == true)
+          { // file found
+            the_filename_vector.push_back (the_dir_entry->d_name);
+          } // if then
         
-          Set_Target_State (the_file_loop);         
-        } // if else
+          the_dir_entry = readdir (the_dir);
+        End_State_Loop
       End_State
-              
-      State(8)
-        if (is_a_match == true)
-        { // file found
-          the_filename_vector.push_back (the_dir_entry->d_name);
-        } // if then
-        
-        the_dir_entry = readdir (the_dir);
-        
-        Set_Target_State (the_file_loop);
+
+      State(6)
+        DIR   *the_closing_dir = the_dir;
+
+        the_dir = NULL;
+
+        if (closedir (the_closing_dir) != 0)
+          the_method_error = A4_Error (A4_File_Util_Module_ID, A4_Lib::A4_File_Util_Errors::GLFV_Closedir_Error, "Call to closedir failed with error %d", errno);
       End_State
     End_Method_State_Block
 
+    if (the_dir != NULL) // a match failed
+      (void) closedir (the_dir);
+
     return the_method_error.Get_Error_Code(); 
   } // Get_Linux_File_Vector
 #endif // Get_File_Vector os-specific implementations
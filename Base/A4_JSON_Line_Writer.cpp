@@ -0,0 +1,355 @@
+/**
+ * @brief   JSON-lines writer implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_JSON_Line_Writer.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_JSON_Line_Writer.hh"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief The escape of each byte - 0 for none, 'u' for \u00XX, '8' for a byte of a UTF-8 sequence, otherwise the
+   *        character after the backslash.
+   */
+  struct Escape_Table
+  { // begin
+    char  escapes [256];
+
+    constexpr Escape_Table (void) : escapes {}
+    { // begin
+      for (int the_byte = 0; the_byte < 0x20; the_byte++)
+        escapes [the_byte] = 'u';
+
+      for (int the_byte = 0x80; the_byte < 0x100; the_byte++)
+        escapes [the_byte] = '8';
+
+      escapes [static_cast<unsigned char>('\b')] = 'b';
+      escapes [static_cast<unsigned char>('\f')] = 'f';
+      escapes [static_cast<unsigned char>('\n')] = 'n';
+      escapes [static_cast<unsigned char>('\r')] = 'r';
+      escapes [static_cast<unsigned char>('\t')] = 't';
+      escapes [static_cast<unsigned char>('"')] = '"';
+      escapes [static_cast<unsigned char>('\\')] = '\\';
+    } // constructor
+  }; // Escape_Table
+
+  constexpr Escape_Table  the_escape_table;
+
+  const char  Hex_Digits [] = "0123456789abcdef";
+  const char  Replacement_Character [] = "\xEF\xBF\xBD"; /**< U+FFFD - written for a byte that is not valid UTF-8 */
+
+  const std::uint64_t   Byte_Ones = 0x0101010101010101ull;
+  const std::uint64_t   Byte_High_Bits = 0x8080808080808080ull;
+
+  /**
+   * @brief Whether any of the 8 bytes of the_word is a control character, a quote, a backslash or not ASCII - the bytes
+   *        a JSON string escapes, and those that must be checked as UTF-8.
+   */
+  inline bool   Has_Escape (std::uint64_t  the_word) noexcept
+  { // begin
+    std::uint64_t   the_quotes = the_word ^ (Byte_Ones * '"');
+    std::uint64_t   the_backslashes = the_word ^ (Byte_Ones * '\\');
+
+    return ((((the_word - Byte_Ones * 0x20) & ~the_word) |
+             ((the_quotes - Byte_Ones) & ~the_quotes) |
+             ((the_backslashes - Byte_Ones) & ~the_backslashes) |
+             the_word) & Byte_High_Bits) != 0;
+  } // Has_Escape
+
+  /**
+   * @brief The length of the UTF-8 sequence at the_bytes - RFC 3629, no overlong forms, surrogates or code points
+   *        above U+10FFFF.
+   * @param the_bytes - IN - the first byte is not ASCII
+   * @param the_length - IN - bytes left
+   * @return 2..4, or 0 when the sequence is not valid
+   */
+  inline std::size_t  UTF8_Sequence_Length (const unsigned char   *the_bytes,
+                                            std::size_t           the_length) noexcept
+  { // begin
+    unsigned char   the_lowest = 0x80; // of the second byte
+    unsigned char   the_highest = 0xBF;
+    std::size_t     the_sequence_length = 0;
+
+    if ((the_bytes [0] >= 0xC2) && (the_bytes [0] <= 0xDF))
+      the_sequence_length = 2;
+    else if ((the_bytes [0] >= 0xE0) && (the_bytes [0] <= 0xEF))
+    { // begin
+      the_sequence_length = 3;
+      the_lowest = (the_bytes [0] == 0xE0) ? 0xA0 : 0x80; // not overlong
+      the_highest = (the_bytes [0] == 0xED) ? 0x9F : 0xBF; // not a surrogate
+    } // else if
+    else if ((the_bytes [0] >= 0xF0) && (the_bytes [0] <= 0xF4))
+    { // begin
+      the_sequence_length = 4;
+      the_lowest = (the_bytes [0] == 0xF0) ? 0x90 : 0x80; // not overlong
+      the_highest = (the_bytes [0] == 0xF4) ? 0x8F : 0xBF; // not above U+10FFFF
+    } // else if
+    else return 0; // a continuation byte, or a lead byte no valid sequence starts with
+
+    if ((the_sequence_length > the_length) || (the_bytes [1] < the_lowest) || (the_bytes [1] > the_highest))
+      return 0;
+
+    for (std::size_t the_byte = 2; the_byte < the_sequence_length; the_byte++)
+      if ((the_bytes [the_byte] & 0xC0) != 0x80)
+        return 0;
+
+    return the_sequence_length;
+  } // UTF8_Sequence_Length
+} // namespace
+
+/**
+ * @brief Start the object - the_buffer holds "{" from here on.
+ * @param the_buffer - OUT - the line, NUL terminated once Finish returns
+ * @param the_size - IN - a smaller buffer gets an empty object, or nothing when even that does not fit
+ */
+JSON_Line_Writer::JSON_Line_Writer (char         *the_buffer,
+                                    std::size_t  the_size) noexcept
+  : buffer (the_buffer), size (the_size)
+{ // begin
+  if ((this->buffer == nullptr) || (this->size < JSON_Line_Constant::Min_Buffer_Size))
+  { // begin
+    this->size = ((this->buffer == nullptr) || (the_size <= JSON_Line_Constant::Reserved_Bytes)) ? 0 : JSON_Line_Constant::Reserved_Bytes + 1;
+    this->is_truncated = true;
+  } // if then
+
+  if (this->size > 0)
+    this->buffer [this->length++] = '{';
+} // constructor
+
+/**
+ * @brief Add "the_name":"the_value" - the_value escaped, cut short when the buffer runs out.
+ * @param the_name - IN
+ * @param the_value - IN - may hold NULs
+ * @param the_length - IN
+ */
+void  JSON_Line_Writer::Put_String (const char    *the_name,
+                                    const char    *the_value,
+                                    std::size_t   the_length) noexcept
+{ // begin
+  if (the_value == nullptr)
+    this->Put_Field(the_name, "null", 4);
+  else if (this->Put_Name(the_name, 2) == true) // the quotes at least
+  { // begin
+    this->buffer [this->length++] = '"';
+    this->Put_Escaped(the_value, the_length);
+    this->buffer [this->length++] = '"'; // Put_Escaped left room for it
+  } // else if
+} // Put_String
+
+/**
+ * @brief Add "the_name":"the_value" for a NUL terminated the_value.
+ */
+void  JSON_Line_Writer::Put_String (const char  *the_name,
+                                    const char  *the_value) noexcept
+{ // begin
+  this->Put_String(the_name, the_value, (the_value != nullptr) ? std::strlen(the_value) : 0);
+} // Put_String
+
+/**
+ * @brief Add "the_name":the_value.
+ */
+void  JSON_Line_Writer::Put_Integer (const char     *the_name,
+                                     std::int64_t   the_value) noexcept
+{ // begin
+  char  the_digits [24];
+
+  this->Put_Field(the_name, the_digits, static_cast<std::size_t>(std::to_chars(the_digits, the_digits + sizeof(the_digits), the_value).ptr - the_digits));
+} // Put_Integer
+
+/**
+ * @brief Add "the_name":the_value.
+ */
+void  JSON_Line_Writer::Put_Unsigned (const char     *the_name,
+                                      std::uint64_t  the_value) noexcept
+{ // begin
+  char  the_digits [24];
+
+  this->Put_Field(the_name, the_digits, static_cast<std::size_t>(std::to_chars(the_digits, the_digits + sizeof(the_digits), the_value).ptr - the_digits));
+} // Put_Unsigned
+
+/**
+ * @brief Add "the_name":the_digits - the whole field or none of it.
+ */
+void  JSON_Line_Writer::Put_Number (const char  *the_name,
+                                    const char  *the_digits) noexcept
+{ // begin
+  this->Put_Field(the_name, the_digits, std::strlen(the_digits));
+} // Put_Number
+
+/**
+ * @brief Close the object and the line.
+ * @return the line length - the NUL that follows it not included
+ */
+std::size_t   JSON_Line_Writer::Finish (void) noexcept
+{ // begin
+  if (this->size == 0)
+    return 0;
+
+  this->buffer [this->length++] = '}';
+  this->buffer [this->length++] = '\n';
+  this->buffer [this->length] = '\0';
+
+  return this->length;
+} // Finish
+
+/**
+ * @brief Write ,"the_name": - or "the_name": for the first field.
+ * @param the_name - IN
+ * @param the_value_room - IN - what the value needs at least
+ * @return false when the name and the_value_room do not fit - nothing is written then
+ */
+bool  JSON_Line_Writer::Put_Name (const char   *the_name,
+                                  std::size_t  the_value_room) noexcept
+{ // begin
+  std::size_t   the_name_length = std::strlen(the_name);
+
+  if ((this->size == 0) || ((the_name_length + the_value_room + ((this->is_first == true) ? 3 : 4)) > this->Get_Room()))
+  { // begin
+    this->is_truncated = true;
+    return false;
+  } // if then
+
+  if (this->is_first != true)
+    this->buffer [this->length++] = ',';
+
+  this->buffer [this->length++] = '"';
+  std::memcpy(this->buffer + this->length, the_name, the_name_length);
+  this->length += the_name_length;
+  this->buffer [this->length++] = '"';
+  this->buffer [this->length++] = ':';
+  this->is_first = false;
+
+  return true;
+} // Put_Name
+
+/**
+ * @brief Write ,"the_name":the_value - the_value as it is.
+ */
+void  JSON_Line_Writer::Put_Field (const char   *the_name,
+                                   const char   *the_value,
+                                   std::size_t  the_length) noexcept
+{ // begin
+  if (this->Put_Name(the_name, the_length) == true)
+  { // begin
+    std::memcpy(this->buffer + this->length, the_value, the_length);
+    this->length += the_length;
+  } // if then
+} // Put_Field
+
+/**
+ * @brief Copy the_bytes with the JSON string escapes - ASCII runs that need none are copied at once, a valid UTF-8
+ *        sequence whole, and a byte that is not valid UTF-8 is replaced by U+FFFD.
+ */
+void  JSON_Line_Writer::Put_Escaped (const char   *the_bytes,
+                                     std::size_t  the_length) noexcept
+{ // begin
+  std::size_t   the_next = 0;
+
+  while (the_next < the_length)
+  { // begin
+    std::size_t   the_run = the_next;
+    std::uint64_t the_word = 0;
+
+    while ((the_run + sizeof(the_word)) <= the_length)
+    { // 8 bytes at a time while none needs an escape
+      std::memcpy(&the_word, the_bytes + the_run, sizeof(the_word));
+
+      if (Has_Escape(the_word) == true)
+        break;
+
+      the_run += sizeof(the_word);
+    } // while
+
+    while ((the_run < the_length) && (the_escape_table.escapes [static_cast<unsigned char>(the_bytes [the_run])] == 0))
+      the_run++;
+
+    if (the_run > the_next)
+    { // copy the run - as much of it as fits - it is ASCII, so any cut is at a character
+      std::size_t   the_copied = std::min(the_run - the_next, this->Get_Room() - 1);
+
+      if (the_copied < (the_run - the_next))
+        the_run = the_next + the_copied + 1; // stops below
+
+      std::memcpy(this->buffer + this->length, the_bytes + the_next, the_copied);
+      this->length += the_copied;
+      the_next += the_copied;
+
+      if (the_next < the_run)
+        break; // full
+    } // if then
+
+    if (the_next < the_length)
+    { // begin
+      unsigned char   the_byte = static_cast<unsigned char>(the_bytes [the_next]);
+      char            the_escape = the_escape_table.escapes [the_byte];
+      std::size_t     the_escape_length = (the_escape == 'u') ? 6 : 2;
+
+      if (the_escape == '8')
+      { // a character that is not ASCII - whole, or U+FFFD in place of one invalid byte
+        std::size_t   the_sequence_length = UTF8_Sequence_Length(reinterpret_cast<const unsigned char *>(the_bytes + the_next), the_length - the_next);
+        std::size_t   the_written_length = (the_sequence_length == 0) ? (sizeof(Replacement_Character) - 1) : the_sequence_length;
+
+        if (the_written_length > this->Get_Room() - 1)
+          break;
+
+        std::memcpy(this->buffer + this->length, (the_sequence_length == 0) ? Replacement_Character : (the_bytes + the_next), the_written_length);
+        this->length += the_written_length;
+        the_next += (the_sequence_length == 0) ? 1 : the_sequence_length;
+
+        continue;
+      } // if then
+
+      if (the_escape_length > this->Get_Room() - 1)
+        break;
+
+      this->buffer [this->length++] = '\\';
+
+      if (the_escape == 'u')
+      { // begin
+        this->buffer [this->length++] = 'u';
+        this->buffer [this->length++] = '0';
+        this->buffer [this->length++] = '0';
+        this->buffer [this->length++] = Hex_Digits [the_byte >> 4];
+        this->buffer [this->length++] = Hex_Digits [the_byte & 0x0F];
+      } // if then
+      else this->buffer [this->length++] = the_escape;
+
+      the_next++;
+    } // if then
+  } // while
+
+  if (the_next < the_length)
+    this->is_truncated = true;
+} // Put_Escaped
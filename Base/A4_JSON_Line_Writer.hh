@@ -0,0 +1,103 @@
+#ifndef __A4_JSON_Line_Writer_Defined__
+#define __A4_JSON_Line_Writer_Defined__
+/**
+ * @brief   One JSON object per line, written straight into a caller buffer - for the File_Logger JSON-lines mode.
+ * @author  a. zippay * 2017..2020
+ * @file A4_JSON_Line_Writer.hh
+ * @note  Names are written as given - they must be plain ASCII identifiers. Values are escaped in runs: ASCII bytes that
+ *        need no escape are found 8 at a time and copied with one memcpy per run, numbers go through std::to_chars.
+ *        Other bytes are checked a character at a time - a valid UTF-8 sequence is copied, any other byte is written as
+ *        U+FFFD, so the line is always valid JSON. Nothing is allocated.
+ *
+ *        A line that does not fit is cut short and still closed - a cut string ends where the buffer did, a field that
+ *        does not fit at all is left out - and Is_Truncated tells.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <cstddef>
+#include <cstdint>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace JSON_Line_Constant
+  { // begin
+    static const std::size_t  Min_Buffer_Size = 64; /**< smaller buffers hold an empty object only */
+    static const std::size_t  Reserved_Bytes = 3; /**< kept back for "}\n" and the NUL */
+  } // namespace JSON_Line_Constant
+
+  /**
+   * @brief Writes {"name":value,...}\n into the_buffer - one object per instance.
+   */
+  typedef class JSON_Line_Writer
+  { // begin
+  public: // construction
+    A4_Export JSON_Line_Writer (char         *the_buffer,
+                                std::size_t  the_size) noexcept; // the_size - at least Min_Buffer_Size
+
+  public: // methods
+    A4_Export void  Put_String (const char    *the_name,
+                                const char    *the_value,
+                                std::size_t   the_length) noexcept; // escaped - a nullptr the_value is written as null
+
+    A4_Export void  Put_String (const char    *the_name,
+                                const char    *the_value) noexcept; // NUL terminated
+
+    A4_Export void  Put_Integer (const char     *the_name,
+                                 std::int64_t   the_value) noexcept;
+
+    A4_Export void  Put_Unsigned (const char     *the_name,
+                                  std::uint64_t  the_value) noexcept;
+
+    A4_Export void  Put_Number (const char  *the_name,
+                                const char  *the_digits) noexcept; // already formatted - written unquoted
+
+    A4_Export std::size_t   Finish (void) noexcept; // "}\n" and a NUL - the line length, the NUL not included
+
+    bool  Is_Truncated (void) const noexcept {return this->is_truncated;};
+
+  private: // methods
+    bool  Put_Name (const char   *the_name,
+                    std::size_t  the_value_room) noexcept; // ,"the_name": - false, and nothing written, unless the_value_room is left after it
+    void  Put_Field (const char   *the_name,
+                     const char   *the_value,
+                     std::size_t  the_length) noexcept; // ,"the_name":the_value - all or nothing
+    void  Put_Escaped (const char   *the_bytes,
+                       std::size_t  the_length) noexcept; // as much as fits - one byte is left for the closing quote
+
+    std::size_t   Get_Room (void) const noexcept {return this->size - JSON_Line_Constant::Reserved_Bytes - this->length;};
+
+  private: // data
+    char          *buffer;
+    std::size_t   size;
+    std::size_t   length = 0;
+    bool          is_first = true; /**< no field written yet */
+    bool          is_truncated = false;
+  } JSON_Line_Writer;
+} // namespace A4_Lib
+
+#endif // __A4_JSON_Line_Writer_Defined__
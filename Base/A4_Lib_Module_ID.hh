@@ -64,5 +64,19 @@ const Module_ID A4_RDBMS_Table_Module_ID              = 45;
 const Module_ID A4_Network_Data_Connection_Module_ID  = 46;
 const Module_ID A4_RDBMS_Common_Base_Module_ID        = 47;
 const Module_ID A4_Trading_Exchange_Info_Module_ID    = 48;
+const Module_ID A4_Method_Request_Module_ID           = 49;
+const Module_ID A4_Executor_Module_ID                 = 50;
+const Module_ID A4_Coroutine_Active_Object_Module_ID  = 51;
+const Module_ID A4_Pipeline_Module_ID                 = 52;
+const Module_ID A4_Method_Profiler_Module_ID          = 53;
+const Module_ID A4_Error_Rate_Limiter_Module_ID       = 54;
+const Module_ID A4_Tracer_Module_ID                   = 55;
+const Module_ID A4_Error_Sink_Module_ID               = 56;
+const Module_ID A4_Log_File_Writer_Module_ID          = 57;
+const Module_ID A4_Log_Uring_Module_ID                = 58;
+const Module_ID A4_Log_Compressor_Module_ID           = 59;
+const Module_ID A4_Log_Crash_Ring_Module_ID           = 60;
+const Module_ID A4_Log_Sink_Module_ID                 = 61;
+const Module_ID A4_Composite_Logger_Module_ID         = 62;
 /** @}*/ // A4_Lib_Module_ID_Group
 #endif // __A4_Lib_Module_Defined__
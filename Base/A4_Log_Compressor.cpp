@@ -0,0 +1,293 @@
+/**
+ * @brief   gzip compression of rolled-over log files implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Compressor.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_Compressor.hh"
+#include "A4_Method_State_Block.hh"
+#include "A4_Logger.hh"
+#include "A4_File_Util.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+
+#if __has_include(<zlib.h>)
+  #define A4_Log_Compressor_Supported
+  #include <zlib.h>
+#endif
+
+#if defined(__linux__)
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  const int   IO_Priority_Class_Idle = 3; /**< IOPRIO_CLASS_IDLE - the disk only when nobody else wants it */
+  const int   IO_Priority_Class_Shift = 13; /**< IOPRIO_CLASS_SHIFT */
+  const int   IO_Priority_Who_Process = 1; /**< IOPRIO_WHO_PROCESS - a thread id on Linux */
+  const int   Idle_Nice_Value = 19;
+
+  thread_local bool   is_thread_lowered = false; /**< Lower_Thread_Priority has run on this thread */
+
+  /**
+   * @brief Run the calling worker thread at idle cpu & I/O priority - once per thread, a failure leaves it as it was.
+   */
+  void  Lower_Thread_Priority (void)
+  { // begin
+    if (is_thread_lowered == true)
+      return;
+
+    is_thread_lowered = true;
+
+#if defined(A4_Lib_Windows)
+    (void) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__linux__)
+    pid_t   the_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+
+    (void) setpriority(PRIO_PROCESS, static_cast<id_t>(the_thread_id), Idle_Nice_Value); // per thread on Linux
+  #ifdef SYS_ioprio_set
+    (void) syscall(SYS_ioprio_set, IO_Priority_Who_Process, the_thread_id, IO_Priority_Class_Idle << IO_Priority_Class_Shift);
+  #endif
+#endif
+  } // Lower_Thread_Priority
+} // namespace
+
+/**
+ * @brief default constructor
+ */
+Log_Compressor::Log_Compressor (void)
+{ // begin
+  this->level = Log_Compressor_Constant::Default_Level;
+  this->num_files = 0;
+  this->bytes_in = 0;
+  this->bytes_out = 0;
+} // constructor
+
+/**
+ * @brief default destructor - a file being compressed is finished first
+ */
+Log_Compressor::~Log_Compressor (void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+} // destructor
+
+/**
+ * @brief Whether files can be compressed - zlib was found at build time.
+ */
+bool  Log_Compressor::Is_Supported (void)
+{ // begin
+#ifdef A4_Log_Compressor_Supported
+  return true;
+#else
+  return false;
+#endif
+} // Is_Supported
+
+/**
+ * @brief Set the zlib compression level.
+ * @param the_level - IN - Min_Level (fastest) .. Max_Level (smallest)
+ * @return No_Error, SL_Invalid_Level
+ */
+Error_Code  Log_Compressor::Set_Level (int  the_level)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if ((the_level < Log_Compressor_Constant::Min_Level) || (the_level > Log_Compressor_Constant::Max_Level))
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, SL_Invalid_Level, "Invalid parameter value - the_level is outside Min_Level .. Max_Level.");
+      else this->level = the_level;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Level
+
+/**
+ * @brief Compress the_filespec on one of the worker threads - the caller goes on at once.
+ * @param the_filespec - IN
+ * @param the_completion - IN - may be nullptr
+ * @return No_Error, EF_Invalid_Filespec or an Active_Object error - not started?
+ */
+Error_Code  Log_Compressor::Enqueue_File (std::string   the_filespec,
+                                          Completion    the_completion)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_filespec.empty() == true)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, EF_Invalid_Filespec, "Invalid parameter length - the_filespec is empty.");
+    End_State
+
+    State(2)
+      the_method_error = this->Post([this, the_filespec, the_completion] () { // begin - on a worker thread
+                                      std::string   the_compressed_filespec;
+                                      Error_Code    the_error = No_Error;
+
+                                      Lower_Thread_Priority();
+
+                                      the_error = this->Compress_File(the_filespec, the_compressed_filespec);
+
+                                      if (the_completion != nullptr)
+                                        the_completion(the_filespec, the_compressed_filespec, the_error);
+
+                                      return the_error;
+                                    }); // Post
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Enqueue_File
+
+/**
+ * @brief Write the_filespec to the_filespec.gz - through the_filespec.gz.part, so a .gz file is always complete.
+ * @param the_filespec - IN - deleted once the .gz file is in place
+ * @param the_compressed_filespec - OUT - the_filespec + Extension
+ * @return No_Error, CF_Not_Supported, CF_Invalid_Filespec, CF_fopen_Error, CF_gzopen_Error, CF_Read_Error,
+ *         CF_gzwrite_Error, CF_gzclose_Error, CF_rename_Error, CF_remove_Error
+ */
+Error_Code  Log_Compressor::Compress_File (std::string   the_filespec,
+                                           std::string   &the_compressed_filespec)
+{ // begin
+  std::string               the_partial_filespec;
+  std::unique_ptr<char []>  the_chunk;
+  std::FILE                 *the_file = nullptr;
+  std::uint64_t             the_bytes_in = 0;
+  std::size_t               the_bytes_out = 0;
+  std::size_t               the_length = 0;
+  bool                      is_partial_written = false;
+
+#ifdef A4_Log_Compressor_Supported
+  char                      the_mode [8];
+  gzFile                    the_gz_file = nullptr;
+#endif
+
+  Method_State_Block_Begin(6)
+    State(1)
+      the_compressed_filespec.clear();
+
+      if (Is_Supported() != true)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_Not_Supported, "Built without zlib - the log file is left as it is.");
+      else if (the_filespec.empty() == true)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_Invalid_Filespec, "Invalid parameter length - the_filespec is empty.");
+      else if ((the_file = std::fopen(the_filespec.c_str(), "rb")) == nullptr)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_fopen_Error, A4_Lib::Logging::Error,
+                                     "Call to fopen resulted in error %d for %s", errno, the_filespec.c_str());
+    End_State
+
+#ifdef A4_Log_Compressor_Supported
+    State(2)
+      the_partial_filespec = the_filespec + Log_Compressor_Constant::Extension + Log_Compressor_Constant::Partial_Extension;
+      the_chunk.reset(new char [Log_Compressor_Constant::Chunk_Size]);
+
+      (void) std::snprintf(the_mode, sizeof(the_mode), "wb%d", this->level.load());
+
+      if ((the_gz_file = gzopen(the_partial_filespec.c_str(), the_mode)) == nullptr)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_gzopen_Error, A4_Lib::Logging::Error,
+                                     "Call to gzopen resulted in error %d for %s", errno, the_partial_filespec.c_str());
+      else { // begin
+        is_partial_written = true;
+        (void) gzbuffer(the_gz_file, static_cast<unsigned int>(Log_Compressor_Constant::Chunk_Size));
+      } // if else
+    End_State
+
+    State(3)
+      while ((the_length = std::fread(the_chunk.get(), 1, Log_Compressor_Constant::Chunk_Size, the_file)) > 0)
+      { // begin
+        if (gzwrite(the_gz_file, the_chunk.get(), static_cast<unsigned int>(the_length)) != static_cast<int>(the_length))
+          break;
+
+        the_bytes_in += the_length;
+      } // while
+
+      if (the_length > 0)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_gzwrite_Error, "Call to gzwrite failed - enough storage space?");
+      else if (std::ferror(the_file) != 0)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_Read_Error, "Call to fread failed reading the log file.");
+    End_State
+
+    State(4)
+      int   the_result = gzclose(the_gz_file);
+
+      the_gz_file = nullptr;
+
+      if (the_result != Z_OK)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_gzclose_Error, "Call to gzclose failed completing the compressed file - enough storage space?");
+      else { // begin
+        (void) std::fclose(the_file);
+        the_file = nullptr;
+      } // if else
+    End_State
+#endif // A4_Log_Compressor_Supported
+
+    State(5)
+      the_compressed_filespec = the_filespec + Log_Compressor_Constant::Extension;
+
+      if (std::rename(the_partial_filespec.c_str(), the_compressed_filespec.c_str()) != 0)
+      { // begin
+        the_compressed_filespec.clear();
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_rename_Error, A4_Lib::Logging::Error,
+                                     "Call to rename resulted in error %d for %s", errno, the_partial_filespec.c_str());
+      } // if then
+      else is_partial_written = false;
+    End_State
+
+    State(6)
+      (void) A4_Lib::Get_File_Size(the_compressed_filespec, the_bytes_out); // statistics only
+
+      this->num_files.fetch_add(1, std::memory_order_relaxed);
+      this->bytes_in.fetch_add(the_bytes_in, std::memory_order_relaxed);
+      this->bytes_out.fetch_add(the_bytes_out, std::memory_order_relaxed);
+
+      if (std::remove(the_filespec.c_str()) != 0)
+        the_method_error = A4_Error (A4_Log_Compressor_Module_ID, CF_remove_Error, A4_Lib::Logging::Warning,
+                                     "Call to remove resulted in error %d for %s - both copies are kept", errno, the_filespec.c_str());
+      else A4_Module_Log(A4_Log_Compressor_Module_ID, A4_Lib::Logging::Info, "Log file %s compressed - %llu to %llu bytes",
+                         the_filespec.c_str(), static_cast<unsigned long long>(the_bytes_in), static_cast<unsigned long long>(the_bytes_out));
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+#ifdef A4_Log_Compressor_Supported
+    if (the_gz_file != nullptr)
+      (void) gzclose(the_gz_file);
+#endif
+
+    if (the_file != nullptr)
+      (void) std::fclose(the_file);
+
+    if (is_partial_written == true)
+      (void) std::remove(the_partial_filespec.c_str()); // the log file is still there
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Compress_File
@@ -0,0 +1,113 @@
+#ifndef __A4_Log_Compressor_Defined__
+#define __A4_Log_Compressor_Defined__
+/**
+ * @brief   gzip compression of rolled-over log files on low priority threads of their own.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Compressor.hh
+ * @note  File_Logger hands each log file it rolls over to Enqueue_File - the logging threads never wait for it. The
+ *        worker threads run at idle cpu & I/O priority where the platform allows. A file is compressed into
+ *        name.gz.part, renamed to name.gz and only then deleted - a name.gz.part left by a crash is a partial copy of a
+ *        file that still exists.
+ *
+ *        Built with zlib where <zlib.h> is found - link with -lz. Without it Is_Supported is false and every file
+ *        is left as it is.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Active_Object.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_Compressor_Constant
+  { // begin
+    static const int          Min_Level = 1; /**< zlib - fastest */
+    static const int          Max_Level = 9; /**< zlib - smallest */
+    static const int          Default_Level = 6; /**< zlib's own default - log text shrinks 8 to 12 times */
+    static const std::size_t  Chunk_Size = 262144; /**< bytes read from the log file at once */
+    static const char         Extension [] = ".gz"; /**< appended to the name of a compressed file */
+    static const char         Partial_Extension [] = ".part"; /**< appended to Extension while the file is written */
+  } // namespace Log_Compressor_Constant
+
+  typedef class Log_Compressor : public A4_Lib::Active_Object
+  { // begin
+  public: // construction
+    Log_Compressor (void);
+    Log_Compressor (Log_Compressor &) = delete;
+    virtual ~Log_Compressor (void);
+
+  public: // types
+    /**
+     * @brief Called on the worker thread once the_filespec is done - the_compressed_filespec is empty unless the_error is No_Error.
+     */
+    typedef std::function<void (const std::string  &the_filespec,
+                                const std::string  &the_compressed_filespec,
+                                Error_Code         the_error)>  Completion;
+
+  public: // methods
+    static bool   Is_Supported (void); // built with zlib
+
+    A4_Export Error_Code  Set_Level (int  the_level); // Min_Level .. Max_Level - the files compressed from then on
+
+    A4_Export Error_Code  Enqueue_File (std::string   the_filespec,
+                                        Completion    the_completion = nullptr); // compressed by a worker thread - must be started
+
+    A4_Export Error_Code  Compress_File (std::string   the_filespec,
+                                         std::string   &the_compressed_filespec); // on the calling thread - the_filespec is deleted once the_compressed_filespec is complete
+
+    std::uint64_t   Get_Num_Files (void) const {return this->num_files.load(std::memory_order_relaxed);}; // compressed so far
+    std::uint64_t   Get_Bytes_In (void) const {return this->bytes_in.load(std::memory_order_relaxed);};
+    std::uint64_t   Get_Bytes_Out (void) const {return this->bytes_out.load(std::memory_order_relaxed);};
+
+  private: // data
+    std::atomic_int             level; /**< see Set_Level */
+    std::atomic<std::uint64_t>  num_files; /**< see Get_Num_Files */
+    std::atomic<std::uint64_t>  bytes_in; /**< log file bytes read */
+    std::atomic<std::uint64_t>  bytes_out; /**< compressed bytes written */
+
+  public: // errors
+    enum Log_Compressor_Errors /**< Errors unique to Log_Compressor */
+    { // begin
+      SL_Invalid_Level          = 0, /**< \b Set_Level: Invalid parameter value - the_level is outside Min_Level .. Max_Level. */
+      EF_Invalid_Filespec       = 1, /**< \b Enqueue_File: Invalid parameter length - the_filespec is empty. */
+      CF_Not_Supported          = 2, /**< \b Compress_File: Built without zlib - the log file is left as it is. */
+      CF_Invalid_Filespec       = 3, /**< \b Compress_File: Invalid parameter length - the_filespec is empty. */
+      CF_fopen_Error            = 4, /**< \b Compress_File: Call to fopen failed for the log file. */
+      CF_gzopen_Error           = 5, /**< \b Compress_File: Call to gzopen failed for the compressed file. */
+      CF_Read_Error             = 6, /**< \b Compress_File: Call to fread failed reading the log file. */
+      CF_gzwrite_Error          = 7, /**< \b Compress_File: Call to gzwrite failed - enough storage space? */
+      CF_gzclose_Error          = 8, /**< \b Compress_File: Call to gzclose failed completing the compressed file - enough storage space? */
+      CF_rename_Error           = 9, /**< \b Compress_File: Call to rename failed for the completed compressed file. */
+      CF_remove_Error           = 10, /**< \b Compress_File: Call to remove failed for the compressed log file - both copies are kept. */
+    }; // Log_Compressor_Errors
+  } Log_Compressor;
+} // namespace A4_Lib
+
+#endif // __A4_Log_Compressor_Defined__
@@ -0,0 +1,458 @@
+/**
+ * @brief   Crash ring file implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Crash_Ring.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_Crash_Ring.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef A4_Lib_Windows
+  #include <io.h>
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  const char            Ring_Magic [8] = {'A', '4', 'R', 'I', 'N', 'G', '0', '1'};
+  const std::uint32_t   Entry_Magic = 0xA4C4A5E1;
+
+  enum Entry_State : std::uint32_t
+  { // begin
+    Staged_State    = 1, /**< copied - not yet written to the log file */
+    Written_State   = 2, /**< in the log file */
+  }; // Entry_State
+
+  /**
+   * @brief The first page of the ring file.
+   */
+  struct Crash_Ring_Header
+  { // begin
+    char                        magic [sizeof(Ring_Magic)];
+    std::uint64_t               capacity; /**< ring bytes - the file size less Header_Size */
+    std::atomic<std::uint64_t>  position; /**< bytes handed out - an entry starts at position % capacity */
+    std::uint32_t               epoch; /**< counts the runs that opened the file */
+    std::uint32_t               reserved;
+  }; // Crash_Ring_Header
+
+  /**
+   * @brief Leads every entry - a Log_Record_Header, its payload & the format string follow, zero padded to Entry_Alignment.
+   */
+  struct Crash_Ring_Entry
+  { // begin
+    std::atomic<std::uint32_t>  magic; /**< Entry_Magic once the entry is complete */
+    std::atomic<std::uint32_t>  state; /**< Entry_State */
+    std::uint32_t               epoch; /**< of the run that wrote it */
+    std::uint32_t               length; /**< bytes that follow - the padding not included */
+    std::uint32_t               format_length;
+    std::uint32_t               checksum; /**< of epoch, length & the padded bytes that follow */
+  }; // Crash_Ring_Entry
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the ring header is shared through the file - its atomics must be lock free");
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the ring entries are shared through the file - their atomics must be lock free");
+  static_assert((sizeof(Crash_Ring_Entry) % Log_Crash_Ring_Constant::Entry_Alignment) == 0, "Crash_Ring_Entry keeps the records aligned");
+
+  inline std::size_t  Entry_Size (std::size_t  the_length) noexcept
+  { // begin
+    return (sizeof(Crash_Ring_Entry) + the_length + Log_Crash_Ring_Constant::Entry_Alignment - 1) & ~(Log_Crash_Ring_Constant::Entry_Alignment - 1);
+  } // Entry_Size
+
+  /**
+   * @brief A multiply-rotate hash of the_words 8 bytes at a time - tells a complete entry from a torn or overwritten one.
+   */
+  std::uint32_t   Checksum (const Crash_Ring_Entry  &the_entry,
+                            const char              *the_bytes,
+                            std::size_t             the_length) noexcept
+  { // begin
+    std::uint64_t   the_hash = (static_cast<std::uint64_t>(the_entry.epoch) << 32) | the_entry.length;
+    std::uint64_t   the_word = 0;
+
+    for (std::size_t the_offset = 0; the_offset < the_length; the_offset += sizeof(the_word))
+    { // begin
+      std::memcpy(&the_word, the_bytes + the_offset, sizeof(the_word));
+
+      the_hash ^= the_word;
+      the_hash = ((the_hash << 29) | (the_hash >> 35)) * 0x9E3779B97F4A7C15ull;
+    } // for
+
+    return static_cast<std::uint32_t>(the_hash ^ (the_hash >> 32));
+  } // Checksum
+
+  inline Crash_Ring_Header  *Get_Header (char  *the_mapping) noexcept
+  { // begin
+    return reinterpret_cast<Crash_Ring_Header *>(the_mapping);
+  } // Get_Header
+
+  void  Unmap (char         *the_mapping,
+               std::size_t  the_size) noexcept
+  { // begin
+#ifdef A4_Lib_Windows
+    (void) the_size;
+    (void) UnmapViewOfFile(the_mapping);
+#else
+    (void) munmap(the_mapping, the_size);
+#endif
+  } // Unmap
+} // namespace
+
+/**
+ * @brief Close the ring file.
+ */
+Log_Crash_Ring::~Log_Crash_Ring (void)
+{ // begin
+  (void) this->Close();
+} // destructor
+
+/**
+ * @brief Open - or create - the ring file and collect what the earlier run staged but never wrote. The ring starts
+ *        empty for this run either way.
+ * @param the_filespec - IN
+ * @param the_size - IN - ring bytes - Min_Size .. Max_Size, a changed size drops the earlier run's records once collected
+ * @param the_records - OUT - by sequence number, empty for a new file
+ * @return No_Error, O_Already_Open, O_Invalid_Size, O_open_Error, O_fstat_Error, O_ftruncate_Error, O_Allocation_Error, M_mmap_Error
+ */
+Error_Code  Log_Crash_Ring::Open (const std::string         &the_filespec,
+                                  std::size_t               the_size,
+                                  Crash_Ring_Record_Vector  &the_records)
+{ // begin
+  struct stat       the_status;
+  std::size_t       the_file_size = 0;
+  bool              is_valid = false; // the file holds an earlier run's ring
+  std::uint32_t     the_last_epoch = 0;
+
+  Method_State_Block_Begin(7)
+    State(1)
+      the_records.clear();
+      the_size &= ~(Log_Crash_Ring_Constant::Entry_Alignment - 1);
+
+      if (this->file_descriptor >= 0)
+        the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_Already_Open, "Invalid state - the ring file is already open.");
+      else if ((the_size < Log_Crash_Ring_Constant::Min_Size) || (the_size > Log_Crash_Ring_Constant::Max_Size))
+        the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_Invalid_Size, "Invalid parameter value - the_size is outside Min_Size .. Max_Size.");
+      else
+      { // begin
+#ifdef A4_Lib_Windows
+        this->file_descriptor = _open(the_filespec.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        this->file_descriptor = open(the_filespec.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+#endif
+
+        if (this->file_descriptor < 0)
+          the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_open_Error, A4_Lib::Logging::Error, "Call to open resulted in error %d for filespec %s", errno, the_filespec.c_str());
+      } // else
+    End_State
+
+    State(2)
+      if (fstat(this->file_descriptor, &the_status) != 0)
+        the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_fstat_Error, A4_Lib::Logging::Error, "Call to fstat resulted in error %d for filespec %s", errno, the_filespec.c_str());
+      else the_file_size = static_cast<std::size_t>(the_status.st_size);
+    End_State
+
+    State(3)
+      if (the_file_size >= (Log_Crash_Ring_Constant::Header_Size + Log_Crash_Ring_Constant::Min_Size))
+        the_method_error = this->Map(the_file_size);
+    End_State
+
+    State(4) // the earlier run's ring
+      if (this->mapping != nullptr)
+      { // begin
+        Crash_Ring_Header   *the_header = Get_Header(this->mapping);
+
+        is_valid = ((std::memcmp(the_header->magic, Ring_Magic, sizeof(Ring_Magic)) == 0) && (the_header->capacity == (the_file_size - Log_Crash_Ring_Constant::Header_Size)));
+
+        if (is_valid == true)
+        { // begin
+          the_last_epoch = the_header->epoch;
+
+          try
+          { // begin
+            this->Find_Unwritten(the_records);
+          } // try
+          catch (...)
+          { // begin
+            the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_Allocation_Error, "Memory allocation error - could not copy the unwritten records.");
+          } // catch
+        } // if then
+      } // if then
+    End_State
+
+    State(5)
+      if (the_file_size != (Log_Crash_Ring_Constant::Header_Size + the_size))
+      { // begin
+        if (this->mapping != nullptr)
+          Unmap(this->mapping, this->mapping_size);
+
+        this->mapping = nullptr;
+        is_valid = false;
+
+#ifdef A4_Lib_Windows
+        if (_chsize_s(this->file_descriptor, static_cast<__int64>(Log_Crash_Ring_Constant::Header_Size + the_size)) != 0)
+#else
+        if (ftruncate(this->file_descriptor, static_cast<off_t>(Log_Crash_Ring_Constant::Header_Size + the_size)) != 0)
+#endif
+          the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, O_ftruncate_Error, A4_Lib::Logging::Error, "Call to ftruncate resulted in error %d for filespec %s", errno, the_filespec.c_str());
+      } // if then
+    End_State
+
+    State(6)
+      if (this->mapping == nullptr)
+        the_method_error = this->Map(Log_Crash_Ring_Constant::Header_Size + the_size);
+    End_State
+
+    State(7) // a new epoch - the earlier run's entries are passed over from here on
+      Crash_Ring_Header   *the_header = Get_Header(this->mapping);
+
+      if (is_valid != true)
+      { // begin
+        std::memset(this->mapping, 0, Log_Crash_Ring_Constant::Header_Size);
+        std::memcpy(the_header->magic, Ring_Magic, sizeof(Ring_Magic));
+        the_header->capacity = the_size;
+      } // if then
+
+      the_header->epoch = the_last_epoch + 1;
+      the_header->position.store(0, std::memory_order_relaxed);
+
+      this->capacity = the_size;
+      this->epoch = the_header->epoch;
+      this->data.store(this->mapping + Log_Crash_Ring_Constant::Header_Size, std::memory_order_release); // open from here on
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if ((the_method_error != No_Error) && (this->file_descriptor >= 0) && (this->Is_Open() != true))
+    { // the records found are kept
+      if (this->mapping != nullptr)
+        Unmap(this->mapping, this->mapping_size);
+
+#ifdef A4_Lib_Windows
+      (void) _close(this->file_descriptor);
+#else
+      (void) close(this->file_descriptor);
+#endif
+      this->mapping = nullptr;
+      this->file_descriptor = -1;
+    } // if then
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Open
+
+/**
+ * @brief Unmap and close the ring file - not synced, the kernel writes the pages back in its own time.
+ * @return No_Error
+ */
+Error_Code  Log_Crash_Ring::Close (void)
+{ // begin
+  this->data.store(nullptr, std::memory_order_release);
+
+  if (this->mapping != nullptr)
+    Unmap(this->mapping, this->mapping_size);
+
+  if (this->file_descriptor >= 0)
+  { // begin
+#ifdef A4_Lib_Windows
+    (void) _close(this->file_descriptor);
+#else
+    (void) close(this->file_descriptor);
+#endif
+  } // if then
+
+  this->mapping = nullptr;
+  this->mapping_size = 0;
+  this->file_descriptor = -1;
+
+  return No_Error;
+} // Close
+
+/**
+ * @brief Copy a record into the ring - the end of the ring is skipped when the entry does not fit before it.
+ * @param the_header - IN
+ * @param the_payload - IN - the_header.length bytes
+ * @param the_format - IN - the format string of an Event_Record, nullptr otherwise
+ * @return the ring_slot for Mark_Written - 0 when the ring is not open or the record is larger than a quarter of it
+ */
+std::uint32_t   Log_Crash_Ring::Append (const Log_Record_Header   &the_header,
+                                        const char                *the_payload,
+                                        const char                *the_format) noexcept
+{ // begin
+  std::size_t   the_format_length = (the_format != nullptr) ? std::strlen(the_format) : 0;
+  std::size_t   the_length = sizeof(Log_Record_Header) + the_header.length + the_format_length;
+  std::size_t   the_size = Entry_Size(the_length);
+  std::size_t   the_offset = 0;
+  char          *the_data = this->data.load(std::memory_order_acquire);
+  char          *the_bytes = nullptr;
+
+  Crash_Ring_Entry  *the_entry = nullptr;
+
+  if ((the_data == nullptr) || (the_size > (this->capacity / 4)))
+    return 0;
+
+  do
+  { // begin
+    the_offset = static_cast<std::size_t>(Get_Header(this->mapping)->position.fetch_add(the_size, std::memory_order_relaxed) % this->capacity);
+  } while ((the_offset + the_size) > this->capacity);
+
+  the_entry = reinterpret_cast<Crash_Ring_Entry *>(the_data + the_offset);
+  the_entry->magic.store(0, std::memory_order_relaxed); // whatever was here is gone
+  the_bytes = reinterpret_cast<char *>(the_entry + 1);
+
+  std::memcpy(the_bytes, &the_header, sizeof(Log_Record_Header));
+  reinterpret_cast<Log_Record_Header *>(the_bytes)->ring_slot = 0;
+  std::memcpy(the_bytes + sizeof(Log_Record_Header), the_payload, the_header.length);
+
+  if (the_format_length > 0)
+    std::memcpy(the_bytes + sizeof(Log_Record_Header) + the_header.length, the_format, the_format_length);
+
+  std::memset(the_bytes + the_length, 0, the_size - sizeof(Crash_Ring_Entry) - the_length);
+
+  the_entry->state.store(Staged_State, std::memory_order_relaxed);
+  the_entry->epoch = this->epoch;
+  the_entry->length = static_cast<std::uint32_t>(the_length);
+  the_entry->format_length = static_cast<std::uint32_t>(the_format_length);
+  the_entry->checksum = Checksum(*the_entry, the_bytes, the_size - sizeof(Crash_Ring_Entry));
+  the_entry->magic.store(Entry_Magic, std::memory_order_release);
+
+  return static_cast<std::uint32_t>(the_offset / Log_Crash_Ring_Constant::Entry_Alignment) + 1;
+} // Append
+
+/**
+ * @brief Mark the entry at the_ring_slot written - the next Open passes it over.
+ * @param the_ring_slot - IN - from Append, 0 is ignored
+ * @param the_sequence - IN - the record's - a different one means the ring has since overwritten it
+ */
+void  Log_Crash_Ring::Mark_Written (std::uint32_t   the_ring_slot,
+                                    std::int64_t    the_sequence) noexcept
+{ // begin
+  std::size_t         the_offset = static_cast<std::size_t>(the_ring_slot - 1) * Log_Crash_Ring_Constant::Entry_Alignment;
+  char                *the_data = this->data.load(std::memory_order_acquire);
+  Crash_Ring_Entry    *the_entry = nullptr;
+  Log_Record_Header   the_header;
+
+  if ((the_data == nullptr) || (the_ring_slot == 0) || ((the_offset + sizeof(Crash_Ring_Entry) + sizeof(Log_Record_Header)) > this->capacity))
+    return;
+
+  the_entry = reinterpret_cast<Crash_Ring_Entry *>(the_data + the_offset);
+  std::memcpy(&the_header, the_entry + 1, sizeof(the_header));
+
+  if ((the_entry->magic.load(std::memory_order_acquire) == Entry_Magic) && (the_header.sequence == the_sequence))
+    the_entry->state.store(Written_State, std::memory_order_relaxed);
+} // Mark_Written
+
+/**
+ * @brief Map this->file_descriptor - the_file_size bytes, shared with the file.
+ * @return No_Error, M_mmap_Error
+ */
+Error_Code  Log_Crash_Ring::Map (std::size_t  the_file_size)
+{ // begin
+  void  *the_address = nullptr;
+
+  Method_State_Block_Begin(1)
+    State(1)
+#ifdef A4_Lib_Windows
+      HANDLE  the_file_mapping = CreateFileMappingA(reinterpret_cast<HANDLE>(_get_osfhandle(this->file_descriptor)), nullptr, PAGE_READWRITE,
+                                                    static_cast<DWORD>(static_cast<std::uint64_t>(the_file_size) >> 32), static_cast<DWORD>(the_file_size), nullptr);
+
+      if (the_file_mapping != nullptr)
+      { // the view keeps the mapping
+        the_address = MapViewOfFile(the_file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, the_file_size);
+        (void) CloseHandle(the_file_mapping);
+      } // if then
+
+      if (the_address == nullptr)
+        the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, M_mmap_Error, A4_Lib::Logging::Error, "Call to MapViewOfFile resulted in error %lu", GetLastError());
+#else
+      the_address = mmap(nullptr, the_file_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file_descriptor, 0);
+
+      if (the_address == MAP_FAILED)
+        the_method_error = A4_Error (A4_Log_Crash_Ring_Module_ID, M_mmap_Error, A4_Lib::Logging::Error, "Call to mmap resulted in error %d", errno);
+#endif
+      else
+      { // begin
+        this->mapping = static_cast<char *>(the_address);
+        this->mapping_size = the_file_size;
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Map
+
+/**
+ * @brief Scan the mapped ring of the earlier run for complete entries that were never marked written.
+ * @param the_records - OUT - by sequence number
+ * \note  Every aligned offset is tried - an entry cut short or overwritten fails its checksum and the scan moves on by
+ *        Entry_Alignment until it finds the next complete one.
+ */
+void  Log_Crash_Ring::Find_Unwritten (Crash_Ring_Record_Vector  &the_records) const
+{ // begin
+  Crash_Ring_Header   *the_header = Get_Header(this->mapping);
+  const char          *the_ring = this->mapping + Log_Crash_Ring_Constant::Header_Size;
+  std::size_t         the_offset = 0;
+  Crash_Ring_Record   the_record;
+
+  while ((the_offset + sizeof(Crash_Ring_Entry) + sizeof(Log_Record_Header)) <= the_header->capacity)
+  { // begin
+    const Crash_Ring_Entry  *the_entry = reinterpret_cast<const Crash_Ring_Entry *>(the_ring + the_offset);
+    const char              *the_bytes = reinterpret_cast<const char *>(the_entry + 1);
+    std::size_t             the_size = Entry_Size(the_entry->length);
+
+    if ((the_entry->magic.load(std::memory_order_relaxed) != Entry_Magic) || (the_entry->epoch != the_header->epoch) ||
+        (the_entry->length < sizeof(Log_Record_Header)) || (the_size > (the_header->capacity - the_offset)) ||
+        (Checksum(*the_entry, the_bytes, the_size - sizeof(Crash_Ring_Entry)) != the_entry->checksum))
+    { // not an entry
+      the_offset += Log_Crash_Ring_Constant::Entry_Alignment;
+      continue;
+    } // if then
+
+    std::memcpy(&the_record.header, the_bytes, sizeof(the_record.header));
+
+    if ((the_entry->state.load(std::memory_order_relaxed) == Staged_State) &&
+        ((sizeof(Log_Record_Header) + the_record.header.length + the_entry->format_length) == the_entry->length))
+    { // begin
+      the_record.payload.assign(the_bytes + sizeof(Log_Record_Header), the_record.header.length);
+      the_record.format.assign(the_bytes + sizeof(Log_Record_Header) + the_record.header.length, the_entry->format_length);
+      the_records.push_back(the_record);
+    } // if then
+
+    the_offset += the_size;
+  } // while
+
+  std::sort(the_records.begin(), the_records.end(), [](const Crash_Ring_Record &the_left, const Crash_Ring_Record &the_right)
+            {return the_left.header.sequence < the_right.header.sequence;});
+} // Find_Unwritten
@@ -0,0 +1,125 @@
+#ifndef __A4_Log_Crash_Ring_Defined__
+#define __A4_Log_Crash_Ring_Defined__
+/**
+ * @brief   A memory mapped ring file holding the last staged log records - what a crash kept from the log file.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Crash_Ring.hh
+ * @note  File_Logger copies every record it stages into the ring, and marks it written once the worker's writev has
+ *        returned. The pages are shared with the file, so a record is in the kernel's hands as soon as it is copied -
+ *        a crashed process loses none of it, and nothing is synced. A crash of the machine itself is not covered.
+ *
+ *        Open finds the records of an earlier run that were staged but never written - the File_Logger appends them
+ *        to the new log file. Each entry carries a checksum, entries a crash cut short or the ring overwrote are
+ *        passed over. The oldest records give way once the ring is full.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+#include "A4_Log_Staging_Buffer.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_Crash_Ring_Constant
+  { // begin
+    static const std::size_t  Min_Size = 65536; /**< ring bytes - the header page not included */
+    static const std::size_t  Max_Size = 1073741824; /**< 1GB - a ring_slot counts 8 byte units */
+    static const std::size_t  Default_Size = 8388608; /**< 8MB - some 50,000 log lines */
+    static const std::size_t  Header_Size = 4096; /**< the file starts with one page of Crash_Ring_Header */
+    static const std::size_t  Entry_Alignment = 8; /**< every entry starts on this boundary */
+    static const char         Extension [] = ".ring"; /**< the ring file is the log file name with this extension */
+  } // namespace Log_Crash_Ring_Constant
+
+  /**
+   * @brief A record found by Open - staged by an earlier run, never written to its log file.
+   */
+  typedef struct Crash_Ring_Record
+  { // begin
+    Log_Record_Header   header;
+    std::string         payload; /**< header.length bytes */
+    std::string         format; /**< the format string of an Event_Record - the format id is the earlier run's */
+  } Crash_Ring_Record;
+
+  typedef std::vector<Crash_Ring_Record>  Crash_Ring_Record_Vector;
+
+  /**
+   * @brief The ring file - Append & Mark_Written from any thread, Open & Close while neither runs.
+   */
+  typedef class Log_Crash_Ring
+  { // begin
+  public: // construction
+    Log_Crash_Ring (void) = default;
+    Log_Crash_Ring (Log_Crash_Ring &) = delete;
+    ~Log_Crash_Ring (void);
+
+  public: // methods
+    A4_Export Error_Code  Open (const std::string         &the_filespec,
+                                std::size_t               the_size,
+                                Crash_Ring_Record_Vector  &the_records); // the_records - the unwritten records of the earlier run, by sequence number
+
+    A4_Export Error_Code  Close (void); // the records not marked written stay for the next Open
+
+    A4_Export std::uint32_t   Append (const Log_Record_Header   &the_header,
+                                      const char                *the_payload,
+                                      const char                *the_format) noexcept; // the ring_slot - 0 when not open
+
+    A4_Export void  Mark_Written (std::uint32_t   the_ring_slot,
+                                  std::int64_t    the_sequence) noexcept; // the record reached the log file - unless the ring has moved on
+
+    bool  Is_Open (void) const {return this->data.load(std::memory_order_acquire) != nullptr;};
+
+  private: // methods
+    void  Find_Unwritten (Crash_Ring_Record_Vector  &the_records) const; // may throw std::bad_alloc
+    Error_Code  Map (std::size_t  the_file_size); // this->file_descriptor into memory
+
+  private: // data
+    int                   file_descriptor = -1;
+    char                  *mapping = nullptr; /**< the whole file */
+    std::size_t           mapping_size = 0;
+    std::atomic<char *>   data {nullptr}; /**< the ring - past the header page, nullptr while closed */
+    std::uint64_t         capacity = 0; /**< ring bytes */
+    std::uint32_t         epoch = 0; /**< this run's - entries of another run are passed over */
+
+  public: // errors
+    enum Log_Crash_Ring_Errors /**< Errors unique to Log_Crash_Ring */
+    { // begin
+      O_Already_Open      = 0, /**< \b Open: Invalid state - the ring file is already open. */
+      O_Invalid_Size      = 1, /**< \b Open: Invalid parameter value - the_size is outside Min_Size .. Max_Size. */
+      O_open_Error        = 2, /**< \b Open: Call to open failed for the ring file. */
+      O_fstat_Error       = 3, /**< \b Open: Call to fstat failed for the ring file. */
+      O_ftruncate_Error   = 4, /**< \b Open: Call to ftruncate failed sizing the ring file - enough storage space? */
+      O_Allocation_Error  = 5, /**< \b Open: Memory allocation error - could not copy the unwritten records. */
+      M_mmap_Error        = 6, /**< \b Map: Call to mmap failed for the ring file. */
+    }; // Log_Crash_Ring_Errors
+  } Log_Crash_Ring;
+} // namespace A4_Lib
+
+#endif // __A4_Log_Crash_Ring_Defined__
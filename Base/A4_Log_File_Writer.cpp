@@ -0,0 +1,367 @@
+/**
+ * @brief   Batched log file writer implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_File_Writer.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_File_Writer.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef A4_Lib_Windows
+  #include <io.h>
+#else
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+using namespace A4_Lib;
+
+/**
+ * @brief Close an open file - a failure is not reported from here.
+ */
+Log_File_Writer::~Log_File_Writer (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Open the_filespec for appending - Get_Size starts at its current length. With Set_IO_Uring(true) the file is
+ *        written through io_uring, or with writev when the ring cannot be set up - Open succeeds either way.
+ * @param the_filespec - IN
+ * @return No_Error, O_Already_Open, O_open_Error, O_fstat_Error
+ */
+Error_Code  Log_File_Writer::Open (const std::string  &the_filespec)
+{ // begin
+  struct stat   the_status;
+  bool          is_opened = false; // by this call
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, O_Already_Open, "Invalid state - a log file is already open.");
+      else
+      { // begin
+#ifdef A4_Lib_Windows
+        this->file_descriptor = _open(the_filespec.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        this->file_descriptor = open(the_filespec.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+
+        if (this->file_descriptor < 0)
+          the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, O_open_Error, A4_Lib::Logging::Error, "Call to open resulted in error %d for filespec %s", errno, the_filespec.c_str());
+        else is_opened = true;
+      } // else
+    End_State
+
+    State(2)
+      if (fstat(this->file_descriptor, &the_status) != 0)
+        the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, O_fstat_Error, A4_Lib::Logging::Error, "Call to fstat resulted in error %d for filespec %s", errno, the_filespec.c_str());
+      else
+      { // begin
+        this->size = static_cast<std::uint64_t>(the_status.st_size);
+        this->unsynced_bytes = 0;
+      } // else
+    End_State
+
+    State(3)
+      if (this->is_io_uring_enabled == true)
+        (void) this->Start_IO_Uring(); // logged there
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if ((the_method_error != No_Error) && (is_opened == true))
+    { // begin
+#ifdef A4_Lib_Windows
+      (void) _close(this->file_descriptor);
+#else
+      (void) close(this->file_descriptor);
+#endif
+      this->file_descriptor = -1;
+    } // if then
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Open
+
+/**
+ * @brief Write the open file through this->uring - each write goes at its own offset, so O_APPEND is cleared first and
+ *        set again when the ring cannot be set up. A failed set up is not tried again for the next file.
+ * @return No_Error, SIU_fcntl_Error, or a Log_Uring::Open error
+ */
+Error_Code  Log_File_Writer::Start_IO_Uring (void)
+{ // begin
+  int   the_flags = 0;
+
+  Method_State_Block_Begin(2)
+    State(1)
+#ifndef A4_Lib_Windows
+      if (((the_flags = fcntl(this->file_descriptor, F_GETFL)) < 0) || (fcntl(this->file_descriptor, F_SETFL, the_flags & ~O_APPEND) != 0))
+        the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, SIU_fcntl_Error, A4_Lib::Logging::Warning, "Call to fcntl resulted in error %d clearing O_APPEND - writing with writev", errno);
+#endif
+    End_State
+
+    State(2)
+      the_method_error = this->uring.Open(this->file_descriptor, this->size);
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+#ifndef A4_Lib_Windows
+    if ((the_method_error != No_Error) && (the_flags >= 0))
+      (void) fcntl(this->file_descriptor, F_SETFL, the_flags);
+#endif
+
+    if (the_method_error != No_Error)
+      this->is_io_uring_enabled = false;
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Start_IO_Uring
+
+/**
+ * @brief Sync and close the file - an unwritten batch is dropped.
+ * @return No_Error, C_close_Error, or a Sync error
+ */
+Error_Code  Log_File_Writer::Close (void)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Open() != true)
+        Terminate_The_Method_Block; // nothing to close
+      else the_method_error = this->Sync();
+    End_State
+
+    State(2)
+      (void) this->uring.Close(); // drained by Sync
+
+#ifdef A4_Lib_Windows
+      if (_close(this->file_descriptor) != 0)
+#else
+      if (close(this->file_descriptor) != 0)
+#endif
+        the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, C_close_Error, A4_Lib::Logging::Error, "Call to close resulted in error %d", errno);
+    End_State
+  End_Method_State_Block
+
+  if (this->uring.Is_Open() == true)
+    (void) this->uring.Close(); // the sync failed
+
+  this->file_descriptor = -1; // even when close or the sync fails
+  this->entries.clear();
+  this->copies.clear();
+
+  return the_method_error.Get_Error_Code();
+} // Close
+
+/**
+ * @brief Add the_bytes to the batch by address - bytes that follow the previous entry extend it.
+ * @param the_bytes - IN - unchanged until Write_Batch
+ * @param the_length - IN
+ */
+void  Log_File_Writer::Add (const char    *the_bytes,
+                            std::size_t   the_length)
+{ // begin
+  if (the_length == 0)
+    return;
+
+  if ((this->entries.empty() == false) && (this->entries.back().bytes != nullptr) && ((this->entries.back().bytes + this->entries.back().length) == the_bytes))
+    this->entries.back().length += the_length;
+  else this->entries.push_back({the_bytes, 0, the_length});
+} // Add
+
+/**
+ * @brief Add a copy of the_bytes to the batch - copies that follow each other share one entry.
+ * @param the_bytes - IN
+ * @param the_length - IN
+ */
+void  Log_File_Writer::Add_Copy (const char    *the_bytes,
+                                 std::size_t   the_length)
+{ // begin
+  if (the_length == 0)
+    return;
+
+  if ((this->entries.empty() == false) && (this->entries.back().bytes == nullptr) && ((this->entries.back().offset + this->entries.back().length) == this->copies.size()))
+    this->entries.back().length += the_length;
+  else this->entries.push_back({nullptr, this->copies.size(), the_length});
+
+  this->copies.insert(this->copies.end(), the_bytes, the_bytes + the_length);
+} // Add_Copy
+
+/**
+ * @brief Append the batch to the file - Max_Batch_Vectors entries per writev, a short write continues where it stopped.
+ *        Through io_uring the batch is copied and submitted, and this returns before it is written.
+ * @return No_Error, WB_Not_Open, WB_writev_Error, or a Log_Uring error - a write that failed earlier is reported here
+ */
+Error_Code  Log_File_Writer::Write_Batch (void)
+{ // begin
+  std::size_t   the_first = 0; // the first entry not completely written
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Open() != true)
+        the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, WB_Not_Open, "Invalid state - no log file is open.");
+    End_State
+
+    State(2)
+      if (this->uring.Is_Open() == true)
+      { // begin
+        std::uint64_t   the_num_copied = 0;
+
+        for (std::size_t the_entry = 0; (the_entry < this->entries.size()) && (the_method_error == No_Error); the_entry++)
+        { // begin
+          const Batch_Entry   &the_batch_entry = this->entries [the_entry];
+
+          the_method_error = this->uring.Append((the_batch_entry.bytes != nullptr) ? the_batch_entry.bytes : (this->copies.data() + the_batch_entry.offset), the_batch_entry.length);
+
+          if (the_method_error == No_Error)
+            the_num_copied += the_batch_entry.length;
+        } // for
+
+        if (the_method_error == No_Error)
+          the_method_error = this->uring.Submit();
+
+        this->size += the_num_copied; // on its way to the file
+        this->unsynced_bytes += the_num_copied;
+      } // if then
+
+      while ((this->uring.Is_Open() != true) && (the_first < this->entries.size()) && (the_method_error == No_Error))
+      { // begin
+        std::size_t   the_num_vectors = std::min(this->entries.size() - the_first, Log_File_Writer_Constant::Max_Batch_Vectors);
+        long long     the_num_written = 0;
+
+#ifdef A4_Lib_Windows
+        const Batch_Entry   &the_entry = this->entries [the_first];
+
+        the_num_vectors = 1;
+        the_num_written = _write(this->file_descriptor, (the_entry.bytes != nullptr) ? the_entry.bytes : (this->copies.data() + the_entry.offset), static_cast<unsigned int>(the_entry.length));
+#else
+        struct iovec  the_vectors [Log_File_Writer_Constant::Max_Batch_Vectors];
+
+        for (std::size_t the_vector = 0; the_vector < the_num_vectors; the_vector++)
+        { // begin
+          const Batch_Entry   &the_entry = this->entries [the_first + the_vector];
+
+          the_vectors [the_vector].iov_base = const_cast<char *>((the_entry.bytes != nullptr) ? the_entry.bytes : (this->copies.data() + the_entry.offset));
+          the_vectors [the_vector].iov_len = the_entry.length;
+        } // for
+
+        the_num_written = writev(this->file_descriptor, the_vectors, static_cast<int>(the_num_vectors));
+#endif
+
+        if ((the_num_written < 0) && (errno == EINTR))
+          continue;
+        else if (the_num_written < 0)
+          the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, WB_writev_Error, A4_Lib::Logging::Error, "Call to writev resulted in error %d - enough storage space?", errno);
+        else
+        { // begin
+          this->size += static_cast<std::uint64_t>(the_num_written);
+          this->unsynced_bytes += static_cast<std::uint64_t>(the_num_written);
+
+          while ((the_num_written > 0) && (the_first < this->entries.size()))
+          { // begin
+            Batch_Entry   &the_entry = this->entries [the_first];
+            std::size_t   the_consumed = std::min(the_entry.length, static_cast<std::size_t>(the_num_written));
+
+            the_num_written -= static_cast<long long>(the_consumed);
+            the_entry.length -= the_consumed;
+
+            if (the_entry.bytes != nullptr)
+              the_entry.bytes += the_consumed;
+            else the_entry.offset += the_consumed;
+
+            if (the_entry.length == 0)
+              the_first++;
+          } // while
+        } // else
+      } // while
+    End_State
+  End_Method_State_Block
+
+  this->entries.clear(); // written or lost - the referenced bytes may be reused once this returns
+  this->copies.clear();
+
+  return the_method_error.Get_Error_Code();
+} // Write_Batch
+
+/**
+ * @brief Wait for the io_uring writes in flight - with writev every batch is in the file once Write_Batch returns.
+ * @return No_Error, or a Log_Uring::Drain error
+ */
+Error_Code  Log_File_Writer::Wait_For_Writes (void)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->uring.Is_Open() == true)
+        the_method_error = this->uring.Drain();
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Wait_For_Writes
+
+/**
+ * @brief Make every written byte durable - waits for the io_uring writes in flight first.
+ * @return No_Error, S_Sync_Error, or a Log_Uring::Drain error
+ */
+Error_Code  Log_File_Writer::Sync (void)
+{ // begin
+  int   the_result = 0;
+
+  Method_State_Block_Begin(1)
+    State(1)
+      if ((this->Is_Open() != true) || (this->unsynced_bytes == 0))
+        Terminate_The_Method_Block; // nothing to sync
+      else if ((this->uring.Is_Open() == true) && ((the_method_error = this->uring.Drain()) != No_Error))
+        Terminate_The_Method_Block; // not everything was written
+      else
+      { // begin
+#if defined(A4_Lib_Windows)
+        the_result = _commit(this->file_descriptor);
+#elif defined(__linux__)
+        the_result = fdatasync(this->file_descriptor);
+#else
+        the_result = fsync(this->file_descriptor);
+#endif
+
+        if (the_result != 0)
+          the_method_error = A4_Error (A4_Log_File_Writer_Module_ID, S_Sync_Error, A4_Lib::Logging::Error, "Call to fdatasync resulted in error %d", errno);
+        else this->unsynced_bytes = 0;
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Sync
@@ -0,0 +1,132 @@
+#ifndef __A4_Log_File_Writer_Defined__
+#define __A4_Log_File_Writer_Defined__
+/**
+ * @brief   Append-only log file written in batches - one writev per batch on an O_APPEND file descriptor, or io_uring.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_File_Writer.hh
+ * @note  The File_Logger worker adds every record of a sweep to the batch - staged bytes by address, formatted lines as a
+ *        copy - and writes the batch with one call. The file size is counted here rather than asked of the file, and
+ *        nothing reaches storage until Sync - the Log_Flush_Policy of the File_Logger decides when.
+ *
+ *        Set_IO_Uring(true) before Open hands the batches to a Log_Uring instead - Write_Batch copies the batch into a
+ *        registered buffer and returns before the disk has it, so a slow disk no longer holds up the worker. Open stays
+ *        with writev when the ring cannot be set up.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+#include "A4_Log_Uring.hh"
+
+#ifndef A4_DotNet
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_File_Writer_Constant
+  { // begin
+    static const std::size_t  Max_Batch_Vectors = 1024; /**< per writev call - IOV_MAX on Linux */
+  } // namespace Log_File_Writer_Constant
+
+  /**
+   * @brief When the File_Logger asks the written log file to be synced to storage - every trigger is off at zero / false.
+   */
+  typedef struct Log_Flush_Policy
+  { // begin
+    std::time_t     sync_interval; /**< seconds - sync at the first idle timeout this long after the last sync */
+    std::uint64_t   sync_bytes; /**< sync once this many bytes were written since the last sync */
+    bool            is_sync_on_error; /**< sync every batch holding an Error line - before the worker goes on */
+  } Log_Flush_Policy;
+
+  /**
+   * @brief One open log file - not thread safe, the File_Logger holds its log_file_mutex around every call.
+   */
+  typedef class Log_File_Writer
+  { // begin
+  public: // construction
+    Log_File_Writer (void) = default;
+    Log_File_Writer (Log_File_Writer &) = delete;
+    ~Log_File_Writer (void);
+
+  public: // methods
+    A4_Export Error_Code  Open (const std::string  &the_filespec); // created when missing, appended otherwise
+    A4_Export Error_Code  Close (void); // syncs first
+
+    void  Add (const char    *the_bytes,
+               std::size_t   the_length); // by address - the_bytes must stay unchanged until Write_Batch - may throw std::bad_alloc
+
+    void  Add_Copy (const char    *the_bytes,
+                    std::size_t   the_length); // copied into the batch - may throw std::bad_alloc
+
+    A4_Export Error_Code  Write_Batch (void); // the batch is empty afterwards, written or not
+    A4_Export Error_Code  Wait_For_Writes (void); // every batch so far is in the file - through io_uring Write_Batch returns before that
+    A4_Export Error_Code  Sync (void); // the written bytes reach storage
+
+    void            Set_IO_Uring (bool  is_enabled) {this->is_io_uring_enabled = is_enabled;}; // from the next Open - until a set up fails
+    bool            Is_IO_Uring_Active (void) const {return this->uring.Is_Open();}; // false after a fallback to writev
+
+    bool            Is_Open (void) const {return this->file_descriptor >= 0;};
+    std::uint64_t   Get_Size (void) const {return this->size;}; // bytes in the file, the batch not included
+    std::uint64_t   Get_Unsynced_Bytes (void) const {return this->unsynced_bytes;};
+
+  private: // methods
+    Error_Code  Start_IO_Uring (void); // on the file just opened - it stays with writev on an error
+
+  private: // types
+    typedef struct Batch_Entry
+    { // begin
+      const char    *bytes; /**< nullptr for a copy - it starts at offset in this->copies */
+      std::size_t   offset;
+      std::size_t   length;
+    } Batch_Entry;
+
+  private: // data
+    int                       file_descriptor = -1;
+    std::uint64_t             size = 0; /**< see Get_Size */
+    std::uint64_t             unsynced_bytes = 0; /**< written since the last Sync */
+    bool                      is_io_uring_enabled = false; /**< see Set_IO_Uring */
+    Log_Uring                 uring; /**< open while the file is written through io_uring */
+    std::vector<Batch_Entry>  entries; /**< in file order */
+    std::vector<char>         copies; /**< the bytes of the Add_Copy entries */
+
+  public: // errors
+    enum Log_File_Writer_Errors /**< Errors unique to Log_File_Writer */
+    { // begin
+      O_Already_Open    = 0, /**< \b Open: Invalid state - a log file is already open. */
+      O_open_Error      = 1, /**< \b Open: Call to open failed for the log file. */
+      O_fstat_Error     = 2, /**< \b Open: Call to fstat failed for the opened log file. */
+      WB_Not_Open       = 3, /**< \b Write_Batch: Invalid state - no log file is open. */
+      WB_writev_Error   = 4, /**< \b Write_Batch: Call to writev failed - enough storage space? */
+      S_Sync_Error      = 5, /**< \b Sync: Call to fdatasync failed. */
+      C_close_Error     = 6, /**< \b Close: Call to close failed. */
+      SIU_fcntl_Error   = 7, /**< \b Start_IO_Uring: Call to fcntl failed clearing O_APPEND - writing with writev. */
+    }; // Log_File_Writer_Errors
+  } Log_File_Writer;
+} // namespace A4_Lib
+
+#endif // __A4_Log_File_Writer_Defined__
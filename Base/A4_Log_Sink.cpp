@@ -0,0 +1,754 @@
+/**
+ * @brief   Log sink implementations - file, memory & UDP
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Sink.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_Sink.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#ifdef A4_Lib_Windows
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #include <process.h>
+#else
+  #include <netdb.h>
+  #include <sys/socket.h>
+  #include <sys/types.h>
+  #include <unistd.h>
+#endif
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  const std::size_t   Drain_Wait_MS = 10; /**< Close polls the queue this often */
+
+  /**
+   * @brief the_nano_seconds as an RFC 3339 UTC timestamp with microseconds - 2020-10-18T12:00:00.123456Z
+   */
+  std::size_t   RFC3339_Timestamp (std::int64_t   the_nano_seconds,
+                                   char           *the_buffer,
+                                   std::size_t    the_size) noexcept
+  { // begin
+    std::time_t   the_seconds = static_cast<std::time_t>(the_nano_seconds / 1000000000);
+    std::tm       the_time;
+    int           the_length = 0;
+
+#ifdef A4_Lib_Windows
+    if (gmtime_s(&the_time, &the_seconds) != 0)
+      return 0;
+#else
+    if (gmtime_r(&the_seconds, &the_time) == nullptr)
+      return 0;
+#endif
+
+    the_length = std::snprintf(the_buffer, the_size, "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ",
+                               the_time.tm_year + 1900, the_time.tm_mon + 1, the_time.tm_mday, the_time.tm_hour, the_time.tm_min, the_time.tm_sec,
+                               static_cast<int>((the_nano_seconds % 1000000000) / 1000));
+
+    return ((the_length < 0) || (static_cast<std::size_t>(the_length) >= the_size)) ? 0 : static_cast<std::size_t>(the_length);
+  } // RFC3339_Timestamp
+
+  inline void   Close_Socket (std::intptr_t   the_socket) noexcept
+  { // begin
+#ifdef A4_Lib_Windows
+    (void) closesocket(static_cast<SOCKET>(the_socket));
+#else
+    (void) close(static_cast<int>(the_socket));
+#endif
+  } // Close_Socket
+} // namespace
+
+/**
+ * @brief default constructor
+ */
+Log_Sink::Log_Sink (void)
+{ // begin
+  this->detail_level = Logging::Debug;
+  this->is_open = false;
+  this->max_queued = Log_Sink_Constant::Default_Max_Queued;
+  this->is_drain_pending = false;
+  this->is_drain_abandoned = false;
+  this->num_delivered = 0;
+  this->num_dropped = 0;
+  this->num_failed = 0;
+} // constructor
+
+/**
+ * @brief default destructor - a subclass must Close the sink in its own destructor, Close_Sink is gone by now
+ */
+Log_Sink::~Log_Sink (void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+} // destructor
+
+/**
+ * @brief Open the destination and start the worker threads - records are taken from now on.
+ * @param the_max_queued - IN - records the sink may fall behind before Submit drops them
+ * @return No_Error, O_Already_Open, O_Invalid_Max_Queued or an Open_Sink / Active_Object error
+ */
+Error_Code  Log_Sink::Open (std::size_t   the_max_queued)
+{ // begin
+  bool  is_sink_open = false; // Open_Sink returned No_Error
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, O_Already_Open, "Invalid state - the sink is already open.");
+      else if (the_max_queued < Log_Sink_Constant::Min_Max_Queued)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, O_Invalid_Max_Queued, "Invalid parameter value - the_max_queued is less than Log_Sink_Constant::Min_Max_Queued.");
+      else the_method_error = this->Open_Sink();
+    End_State
+
+    State(2)
+      is_sink_open = true;
+
+      this->max_queued = the_max_queued;
+      this->is_drain_abandoned = false;
+      this->num_delivered = 0;
+      this->num_dropped = 0;
+      this->num_failed = 0;
+
+      if (this->Is_Initialized() != true) // one drain is posted at a time - the message queue stays short
+        the_method_error = this->Initialize();
+    End_State
+
+    State(3)
+      the_method_error = this->Start();
+    End_State
+
+    State(4)
+      this->is_open.store(true, std::memory_order_release);
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if ((the_method_error != No_Error) && (is_sink_open == true))
+      (void) this->Close_Sink();
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Open
+
+/**
+ * @brief Stop taking records, deliver those queued and close the destination.
+ * @return No_Error, C_Not_Open or an Active_Object / Close_Sink error
+ * \note  A sink that does not catch up within Max_Shutdown_Wait seconds drops the rest of its queue.
+ */
+Error_Code  Log_Sink::Close (void)
+{ // begin
+  std::chrono::steady_clock::time_point   the_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(Log_Sink_Constant::Max_Shutdown_Wait);
+
+  bool  is_draining = true;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->is_open.exchange(false, std::memory_order_acq_rel) != true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, C_Not_Open, "Invalid state - the sink is not open.");
+    End_State
+
+    State(2)
+      while ((is_draining == true) && (std::chrono::steady_clock::now() < the_deadline))
+      { // wait for the posted drain
+        { // begin
+          std::lock_guard<std::mutex>   the_lock (this->queue_mutex);
+
+          is_draining = this->is_drain_pending;
+        } // lock
+
+        if (is_draining == true)
+          std::this_thread::sleep_for(std::chrono::milliseconds(Drain_Wait_MS));
+      } // while
+
+      this->is_drain_abandoned.store(is_draining, std::memory_order_relaxed); // the drain running drops the rest of its records
+
+      the_method_error = this->Stop();
+    End_State
+
+    State(3)
+      { // begin
+        std::lock_guard<std::mutex>   the_lock (this->queue_mutex);
+
+        this->num_dropped.fetch_add(this->queue.size(), std::memory_order_relaxed);
+        this->queue.clear();
+        this->is_drain_pending = false;
+      } // lock
+
+      the_method_error = this->Close_Sink();
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Close
+
+/**
+ * @brief Queue the_record for delivery - the calling thread never waits on the destination.
+ * @param the_record - IN - shared with the other sinks, never changed
+ * @return No_Error, S_Invalid_Record, S_Drain_Post_Error
+ * \note  A full queue - or a closed sink - drops the_record and counts it. Only one drain is posted at a time, the
+ *        records reach the destination in the order they were submitted.
+ */
+Error_Code  Log_Sink::Submit (const Log_Sink_Record::Pointer  &the_record)
+{ // begin
+  bool  is_drain_needed = false;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_record == nullptr)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, S_Invalid_Record, "Invalid parameter address - the_record is nullptr.");
+      else if (this->Is_Open() != true)
+      { // begin
+        this->num_dropped.fetch_add(1, std::memory_order_relaxed);
+        Terminate_The_Method_Block;
+      } // if then
+      else { // begin
+        std::lock_guard<std::mutex>   the_lock (this->queue_mutex);
+
+        if (this->queue.size() >= this->max_queued)
+          this->num_dropped.fetch_add(1, std::memory_order_relaxed);
+        else { // begin
+          this->queue.push_back(the_record);
+
+          is_drain_needed = (this->is_drain_pending != true);
+          this->is_drain_pending = true;
+        } // else
+      } // else
+    End_State
+
+    State(2)
+      if (is_drain_needed == true)
+      { // begin
+        if (this->Post([this] () {this->Drain(); return No_Error;}) != No_Error)
+        { // the next Submit tries again
+          std::lock_guard<std::mutex>   the_lock (this->queue_mutex);
+
+          this->is_drain_pending = false;
+
+          the_method_error = A4_Error (A4_Log_Sink_Module_ID, S_Drain_Post_Error, "Call to Active_Object::Post failed - the queue is delivered by the next Submit.");
+        } // if then
+      } // if then
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Submit
+
+/**
+ * @brief Deliver the queue until it stays empty, then Flush_Sink - the queue is swapped out, Submit is never held up
+ *        by Deliver.
+ * \note  On a worker thread. A failed Deliver is counted, not logged - what logs beneath it, say a Log_File_Writer
+ *        error, is written while draining_sink is set and kept from this sink, or each failure would queue a line that
+ *        fails again.
+ */
+void  Log_Sink::Drain (void)
+{ // begin
+  std::deque<Log_Sink_Record::Pointer>  the_records;
+
+  const Log_Sink  *the_outer_sink = Log_Sink::draining_sink; // nullptr - a worker thread drains one sink at a time
+
+  Error_Trace::Drain(); // a chain the caller left open goes to every sink
+
+  Log_Sink::draining_sink = this;
+
+  for (;;)
+  { // begin
+    { // begin
+      std::lock_guard<std::mutex>   the_lock (this->queue_mutex);
+
+      if (this->queue.empty() == true)
+      { // caught up - the next Submit posts a drain
+        this->is_drain_pending = false;
+        break;
+      } // if then
+
+      the_records.swap(this->queue);
+    } // lock
+
+    for (const Log_Sink_Record::Pointer &the_record : the_records)
+    { // begin
+      if (this->is_drain_abandoned.load(std::memory_order_relaxed) == true)
+        this->num_dropped.fetch_add(1, std::memory_order_relaxed); // Close stopped waiting
+      else if (this->Deliver(the_record) == No_Error)
+        this->num_delivered.fetch_add(1, std::memory_order_relaxed);
+      else this->num_failed.fetch_add(1, std::memory_order_relaxed);
+    } // for
+
+    if (this->Flush_Sink() != No_Error)
+      this->num_failed.fetch_add(1, std::memory_order_relaxed);
+
+    the_records.clear();
+  } // for
+
+  Error_Trace::Drain(); // the chains of this drain's failures are written now, not by the caller's frame once draining_sink is reset
+
+  Log_Sink::draining_sink = the_outer_sink;
+} // Drain
+
+/**
+ * @brief default destructor
+ */
+File_Log_Sink::~File_Log_Sink (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Set the log file and its rotation.
+ * @param the_filespec - IN - the current file - the rotated files are the_filespec.1 .. the_filespec.N, newest first
+ * @param the_max_file_size - IN - bytes - the file is rotated before a line would take it past this
+ * @param the_num_rotated_files - IN - 1 .. Max_Num_Rotated_Files
+ * @return No_Error, SF_Already_Open, SF_Invalid_Filespec, SF_Invalid_Max_Size, SF_Invalid_Num_Files
+ */
+Error_Code  File_Log_Sink::Set_File (const std::string  &the_filespec,
+                                     std::uint64_t      the_max_file_size,
+                                     std::size_t        the_num_rotated_files)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SF_Already_Open, "Invalid state - the sink is already open.");
+      else if (the_filespec.empty() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SF_Invalid_Filespec, "Invalid parameter length - the_filespec is empty.");
+      else if (the_max_file_size < Log_Sink_Constant::Min_Max_File_Size)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SF_Invalid_Max_Size, "Invalid parameter value - the_max_file_size is less than Log_Sink_Constant::Min_Max_File_Size.");
+      else if ((the_num_rotated_files < 1) || (the_num_rotated_files > Log_Sink_Constant::Max_Num_Rotated_Files))
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SF_Invalid_Num_Files, "Invalid parameter value - the_num_rotated_files is outside 1 .. Max_Num_Rotated_Files.");
+      else { // begin
+        this->filespec = the_filespec;
+        this->max_file_size = the_max_file_size;
+        this->num_rotated_files = the_num_rotated_files;
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_File
+
+/**
+ * @brief Open the log file - appended to when it exists.
+ * @return No_Error, OS_No_Filespec or a Log_File_Writer error
+ */
+Error_Code  File_Log_Sink::Open_Sink (void)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      this->batch_bytes = 0;
+
+      if (this->filespec.empty() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, OS_No_Filespec, "Invalid state - Set_File was not called.");
+      else the_method_error = this->log_writer.Open(this->filespec);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Open_Sink
+
+/**
+ * @brief Add the_record's line to the batch - by address, the drain holds the_record until Flush_Sink. The file is
+ *        rotated first when the line would take it past max_file_size.
+ * @param the_record - IN
+ * @return No_Error, D_Write_Error, R_rename_Error
+ */
+Error_Code  File_Log_Sink::Deliver (const Log_Sink_Record::Pointer  &the_record)
+{ // begin
+  Error_Code  the_error = No_Error;
+
+  if ((this->log_writer.Get_Size() + this->batch_bytes > 0) && (this->log_writer.Get_Size() + this->batch_bytes + the_record->line.length() > this->max_file_size))
+  { // the file is full
+    the_error = this->Flush_Sink();
+
+    if (the_error == No_Error)
+      the_error = this->Rotate();
+  } // if then
+
+  if (this->log_writer.Is_Open() == true)
+  { // begin
+    this->log_writer.Add(the_record->line.data(), the_record->line.length());
+    this->batch_bytes += the_record->line.length();
+
+    if (this->batch_bytes >= Log_Sink_Constant::Max_File_Batch_Bytes) // a long drain writes as it goes
+      the_error = this->Flush_Sink();
+  } // if then
+
+  return the_error;
+} // Deliver
+
+/**
+ * @brief Write the batch.
+ * @return No_Error, D_Write_Error
+ */
+Error_Code  File_Log_Sink::Flush_Sink (void)
+{ // begin
+  this->batch_bytes = 0;
+
+  if ((this->log_writer.Is_Open() == true) && (this->log_writer.Write_Batch() != No_Error))
+    return A4_Error::Make_Error_Code(A4_Log_Sink_Module_ID, D_Write_Error);
+
+  return No_Error;
+} // Flush_Sink
+
+/**
+ * @brief Close the log file.
+ * @return No_Error or a Log_File_Writer error
+ */
+Error_Code  File_Log_Sink::Close_Sink (void)
+{ // begin
+  (void) this->Flush_Sink();
+
+  return this->log_writer.Close();
+} // Close_Sink
+
+/**
+ * @brief Move each file up one - the_filespec.N goes - and start the_filespec anew.
+ * @return No_Error, R_rename_Error - the file that could not be renamed is written on
+ * \note  On the worker thread - the batch has been written.
+ */
+Error_Code  File_Log_Sink::Rotate (void)
+{ // begin
+  Error_Code  the_error = No_Error;
+
+  (void) this->log_writer.Close();
+  (void) std::remove((this->filespec + "." + std::to_string(this->num_rotated_files)).c_str());
+
+  for (std::size_t the_number = this->num_rotated_files - 1; the_number > 0; the_number--)
+    (void) std::rename((this->filespec + "." + std::to_string(the_number)).c_str(), (this->filespec + "." + std::to_string(the_number + 1)).c_str()); // the gaps are missing files
+
+  if (std::rename(this->filespec.c_str(), (this->filespec + ".1").c_str()) != 0)
+    the_error = A4_Error::Make_Error_Code(A4_Log_Sink_Module_ID, R_rename_Error);
+
+  if (this->log_writer.Open(this->filespec) != No_Error)
+    the_error = A4_Error::Make_Error_Code(A4_Log_Sink_Module_ID, D_Write_Error);
+
+  return the_error;
+} // Rotate
+
+/**
+ * @brief Set how many records are kept - the oldest give way.
+ * @param the_max_records - IN
+ * @return No_Error, SC_Already_Open, SC_Invalid_Capacity
+ */
+Error_Code  Memory_Log_Sink::Set_Capacity (std::size_t  the_max_records)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SC_Already_Open, "Invalid state - the sink is already open.");
+      else if (the_max_records < 1)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SC_Invalid_Capacity, "Invalid parameter value - the_max_records is zero.");
+      else this->capacity = the_max_records;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Capacity
+
+/**
+ * @brief Copy the kept records from the_min_sequence on - a health endpoint passes the last sequence it saw plus one.
+ * @param the_records - OUT - oldest first, replaced
+ * @param the_min_sequence - IN
+ * @return No_Error upon success.
+ */
+Error_Code  Memory_Log_Sink::Get_Records (Log_Sink_Record_Vector  &the_records,
+                                          std::int64_t            the_min_sequence) const
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      std::lock_guard<std::mutex>   the_lock (this->records_mutex);
+
+      the_records.clear();
+
+      for (const Log_Sink_Record::Pointer &the_record : this->records)
+        if (the_record->sequence >= the_min_sequence)
+          the_records.push_back(the_record);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Get_Records
+
+/**
+ * @brief Copy the text of the newest records.
+ * @param the_lines - OUT - oldest first, replaced - each ends in its line break
+ * @param the_max_lines - IN - 0 for every record kept
+ * @return No_Error upon success.
+ */
+Error_Code  Memory_Log_Sink::Get_Lines (String_Vector  &the_lines,
+                                        std::size_t    the_max_lines) const
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      std::lock_guard<std::mutex>   the_lock (this->records_mutex);
+
+      std::size_t   the_first = ((the_max_lines > 0) && (the_max_lines < this->records.size())) ? this->records.size() - the_max_lines : 0;
+
+      the_lines.clear();
+      the_lines.reserve(this->records.size() - the_first);
+
+      for (std::size_t the_index = the_first; the_index < this->records.size(); the_index++)
+        the_lines.push_back(this->records [the_index]->line);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Get_Lines
+
+/**
+ * @brief The number of records kept.
+ */
+std::size_t   Memory_Log_Sink::Get_Num_Records (void) const
+{ // begin
+  std::lock_guard<std::mutex>   the_lock (this->records_mutex);
+
+  return this->records.size();
+} // Get_Num_Records
+
+/**
+ * @brief Forget the kept records - a test starting over.
+ */
+void  Memory_Log_Sink::Clear (void)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock (this->records_mutex);
+
+  this->records.clear();
+} // Clear
+
+/**
+ * @brief default destructor
+ */
+Memory_Log_Sink::~Memory_Log_Sink (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Keep the_record - the record itself, shared with the other sinks, not a copy of its line.
+ * @param the_record - IN
+ * @return No_Error
+ */
+Error_Code  Memory_Log_Sink::Deliver (const Log_Sink_Record::Pointer  &the_record)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock (this->records_mutex);
+
+  if (this->records.size() >= this->capacity)
+    this->records.pop_front();
+
+  this->records.push_back(the_record);
+
+  return No_Error;
+} // Deliver
+
+/**
+ * @brief default destructor
+ */
+UDP_Log_Sink::~UDP_Log_Sink (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Set the collector the datagrams go to.
+ * @param the_host - IN - a name or an address
+ * @param the_port - IN
+ * @param the_app_name - IN - the APP-NAME field - spaces are replaced by '_'
+ * @return No_Error, SCO_Already_Open, SCO_Invalid_Host
+ */
+Error_Code  UDP_Log_Sink::Set_Collector (const std::string  &the_host,
+                                         std::uint16_t      the_port,
+                                         const std::string  &the_app_name)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SCO_Already_Open, "Invalid state - the sink is already open.");
+      else if (the_host.empty() == true)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, SCO_Invalid_Host, "Invalid parameter length - the_host is empty.");
+      else { // begin
+        this->host = the_host;
+        this->port = the_port;
+        this->app_name = (the_app_name.empty() == true) ? "-" : the_app_name.substr(0, 48); // RFC 5424 - APP-NAME is 1*48 PRINTUSASCII
+
+        for (char &the_character : this->app_name)
+          if ((the_character <= ' ') || (the_character > '~'))
+            the_character = '_';
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Collector
+
+/**
+ * @brief The syslog severity of a log line - Error is err (3), Warning is warning (4), Info is informational (6),
+ *        a Private_Comment is notice (5) and the rest debug (7).
+ * @param the_detail - IN
+ */
+int   UDP_Log_Sink::Get_Severity (Logging::Detail  the_detail) noexcept
+{ // begin
+  switch (the_detail)
+  { // begin
+    case Logging::Error:            return 3;
+    case Logging::Warning:          return 4;
+    case Logging::Private_Comment:  return 5;
+    case Logging::Info:             return 6;
+    default:                        return 7;
+  } // switch
+} // Get_Severity
+
+/**
+ * @brief Resolve the collector and connect a datagram socket to it - send then needs no address, and an unreachable
+ *        collector shows as a failed send.
+ * @return No_Error, OS_getaddrinfo_Error, OS_socket_Error, OS_connect_Error
+ */
+Error_Code  UDP_Log_Sink::Open_Sink (void)
+{ // begin
+  struct addrinfo   the_hints;
+  struct addrinfo   *the_addresses = nullptr;
+  char              the_host_name [256] = "-";
+  int               the_result = 0;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      std::memset(&the_hints, 0, sizeof(the_hints));
+      the_hints.ai_family = AF_UNSPEC;
+      the_hints.ai_socktype = SOCK_DGRAM;
+
+      the_result = getaddrinfo(this->host.c_str(), std::to_string(this->port).c_str(), &the_hints, &the_addresses);
+
+      if ((the_result != 0) || (the_addresses == nullptr))
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, OS_getaddrinfo_Error, A4_Lib::Logging::Error, "Call to getaddrinfo resulted in error %d for host %s", the_result, this->host.c_str());
+    End_State
+
+    State(2)
+      this->socket_handle = static_cast<std::intptr_t>(socket(the_addresses->ai_family, the_addresses->ai_socktype, the_addresses->ai_protocol));
+
+#ifdef A4_Lib_Windows
+      if (static_cast<SOCKET>(this->socket_handle) == INVALID_SOCKET)
+#else
+      if (this->socket_handle < 0)
+#endif
+      { // begin
+        this->socket_handle = -1;
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, OS_socket_Error, A4_Lib::Logging::Error, "Call to socket resulted in error %d", errno);
+      } // if then
+    End_State
+
+    State(3)
+      if (connect(static_cast<int>(this->socket_handle), the_addresses->ai_addr, static_cast<socklen_t>(the_addresses->ai_addrlen)) != 0)
+        the_method_error = A4_Error (A4_Log_Sink_Module_ID, OS_connect_Error, A4_Lib::Logging::Error, "Call to connect resulted in error %d for host %s", errno, this->host.c_str());
+      else { // the header fields that stay the same
+        if (gethostname(the_host_name, sizeof(the_host_name) - 1) != 0)
+          std::strcpy(the_host_name, "-");
+
+        the_host_name [sizeof(the_host_name) - 1] = '\0';
+
+#ifdef A4_Lib_Windows
+        this->header_suffix = std::string(" ") + the_host_name + " " + this->app_name + " " + std::to_string(_getpid()) + " - - ";
+#else
+        this->header_suffix = std::string(" ") + the_host_name + " " + this->app_name + " " + std::to_string(getpid()) + " - - ";
+#endif
+      } // else
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if (the_addresses != nullptr)
+      freeaddrinfo(the_addresses);
+
+    if ((the_method_error != No_Error) && (this->socket_handle != -1))
+    { // begin
+      Close_Socket(this->socket_handle);
+      this->socket_handle = -1;
+    } // if then
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+} // Open_Sink
+
+/**
+ * @brief Send the_record as one datagram - the message is the line less its prefix & line break, cut to fit
+ *        Max_Datagram_Size.
+ * @param the_record - IN
+ * @return No_Error, D_send_Error - a datagram the socket buffer had no room for is counted, not waited on
+ */
+Error_Code  UDP_Log_Sink::Deliver (const Log_Sink_Record::Pointer  &the_record)
+{ // begin
+  char          the_datagram [Log_Sink_Constant::Max_Datagram_Size];
+  int           the_length = 0;
+  std::size_t   the_message_length = the_record->line.length() - std::min(the_record->message_offset, the_record->line.length());
+  char          the_timestamp [40] = "-";
+
+  while ((the_message_length > 0) && ((the_record->line [the_record->message_offset + the_message_length - 1] == '\n') || (the_record->line [the_record->message_offset + the_message_length - 1] == '\r')))
+    the_message_length--;
+
+  if (RFC3339_Timestamp(the_record->nano_seconds, the_timestamp, sizeof(the_timestamp)) == 0)
+    std::strcpy(the_timestamp, "-");
+
+  the_length = std::snprintf(the_datagram, sizeof(the_datagram), "<%d>1 %s%s", (Log_Sink_Constant::Syslog_Facility * 8) + Get_Severity(the_record->detail), the_timestamp, this->header_suffix.c_str());
+
+  if ((the_length < 0) || (static_cast<std::size_t>(the_length) >= sizeof(the_datagram)))
+    return A4_Error::Make_Error_Code(A4_Log_Sink_Module_ID, D_send_Error);
+
+  the_message_length = std::min(the_message_length, sizeof(the_datagram) - static_cast<std::size_t>(the_length));
+  std::memcpy(the_datagram + the_length, the_record->line.data() + the_record->message_offset, the_message_length);
+
+#ifdef A4_Lib_Windows
+  if (send(static_cast<SOCKET>(this->socket_handle), the_datagram, static_cast<int>(the_length + the_message_length), 0) < 0)
+#else
+  if (send(static_cast<int>(this->socket_handle), the_datagram, static_cast<std::size_t>(the_length) + the_message_length, MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+#endif
+    return A4_Error::Make_Error_Code(A4_Log_Sink_Module_ID, D_send_Error);
+
+  return No_Error;
+} // Deliver
+
+/**
+ * @brief Close the socket.
+ * @return No_Error
+ */
+Error_Code  UDP_Log_Sink::Close_Sink (void)
+{ // begin
+  if (this->socket_handle != -1)
+    Close_Socket(this->socket_handle);
+
+  this->socket_handle = -1;
+
+  return No_Error;
+} // Close_Sink
@@ -0,0 +1,272 @@
+#ifndef __A4_Log_Sink_Defined__
+#define __A4_Log_Sink_Defined__
+/**
+ * @brief   Destinations for the Composite_Logger - each with its own detail level, queue & worker threads.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Sink.hh
+ * @note  The Composite_Logger formats a log line once and hands the same Log_Sink_Record to every sink whose detail
+ *        level takes it. Submit only appends the record to the sink's own bounded queue - it never waits, a full queue
+ *        drops the record and counts it - and the sink delivers its queue in order on a worker thread of its own. A
+ *        slow sink falls behind and drops on its own, the others and the logging threads carry on.
+ *
+ *        File_Log_Sink    - a log file, rotated by size: name.ext, name.ext.1 .. name.ext.N
+ *        Memory_Log_Sink  - the last N records in memory, for tests & health endpoints to query
+ *        UDP_Log_Sink     - one RFC 5424 syslog datagram per record to a collector, usually on the local host
+ *
+ *        A sink counts a failed delivery. What fails beneath it may still log - Log_File_Writer does - so a line logged
+ *        on a sink's own drain goes to every other sink but not back into the one that is failing. Two sinks that
+ *        fail alike report to each other at the rate the Error_Rate_Limiter admits.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Active_Object.hh"
+#include "A4_Log_File_Writer.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_Sink_Constant
+  { // begin
+    static const std::size_t      Default_Max_Queued = 10000; /**< records a sink may fall behind before it drops */
+    static const std::size_t      Min_Max_Queued = 16;
+    static const std::size_t      Max_Shutdown_Wait = 30; /**< seconds Close waits for the queue to drain */
+    static const std::uint64_t    Default_Max_File_Size = 10485760; /**< 10MB - as File_Logger_Constants::Default_Max_Log_Length */
+    static const std::uint64_t    Min_Max_File_Size = 65536;
+    static const std::size_t      Default_Num_Rotated_Files = 5; /**< name.ext.1 .. name.ext.5 */
+    static const std::size_t      Max_Num_Rotated_Files = 999;
+    static const std::size_t      Max_File_Batch_Bytes = 262144; /**< a File_Log_Sink writes at least this often while draining */
+    static const std::size_t      Default_Memory_Capacity = 1000; /**< records a Memory_Log_Sink keeps */
+    static const std::uint16_t    Default_Syslog_Port = 514;
+    static const int              Syslog_Facility = 1; /**< user-level messages */
+    static const std::size_t      Max_Datagram_Size = 2048; /**< every RFC 5424 receiver takes this much - longer messages are cut */
+  } // namespace Log_Sink_Constant
+
+  /**
+   * @brief A log line formatted once by the Composite_Logger - shared by every sink it is submitted to, never changed.
+   */
+  typedef struct Log_Sink_Record
+  { // begin
+    typedef std::shared_ptr<const Log_Sink_Record>  Pointer;
+
+    Logging::Detail   detail;
+    Module_ID         module_id; /**< 0 - not from a module */
+    std::int64_t      sequence; /**< the Composite_Logger sequence number */
+    std::int64_t      nano_seconds; /**< since the epoch - the system clock */
+    std::string       line; /**< the text log line - the prefix, the message & "\r\n" */
+    std::size_t       message_offset; /**< where the message starts in line */
+  } Log_Sink_Record;
+
+  typedef std::vector<Log_Sink_Record::Pointer>   Log_Sink_Record_Vector;
+
+  /**
+   * @brief A log destination - subclasses implement Deliver, and optionally Open_Sink, Flush_Sink & Close_Sink, all of
+   *        which run one at a time.
+   */
+  typedef class Log_Sink : protected A4_Lib::Active_Object
+  { // begin
+  public: // construction
+    Log_Sink (void);
+    Log_Sink (Log_Sink &) = delete;
+    virtual ~Log_Sink (void);
+
+  public: // types
+    typedef std::shared_ptr<Log_Sink>   Pointer;
+
+  public: // methods
+    A4_Export Error_Code  Open (std::size_t   the_max_queued = Log_Sink_Constant::Default_Max_Queued); // Open_Sink, then the worker threads start
+    A4_Export Error_Code  Close (void); // the queue is delivered first - for up to Max_Shutdown_Wait seconds
+
+    A4_Export Error_Code  Submit (const Log_Sink_Record::Pointer  &the_record); // never waits - a full queue drops the_record
+
+    void              Set_Detail_Level (Logging::Detail  the_detail_level) {this->detail_level.store(the_detail_level, std::memory_order_relaxed);};
+    Logging::Detail   Get_Detail_Level (void) const {return this->detail_level.load(std::memory_order_relaxed);};
+
+    /**
+     * @brief Does this sink take a line at the_detail? Module_Specific lines always pass - as Logger::Is_Enabled.
+     */
+    bool  Is_Enabled (Logging::Detail  the_detail) const noexcept
+    { // begin
+      return (the_detail <= this->detail_level.load(std::memory_order_relaxed)) || (the_detail == Logging::Module_Specific);
+    } // Is_Enabled
+
+    bool  Is_Open (void) const {return this->is_open.load(std::memory_order_acquire);};
+
+    /**
+     * @brief Is this sink draining on the calling thread? A line logged there reports a failure of this sink - the
+     *        Composite_Logger keeps it from this sink.
+     */
+    bool  Is_Draining_Here (void) const noexcept {return Log_Sink::draining_sink == this;};
+
+    std::uint64_t   Get_Num_Delivered (void) const {return this->num_delivered.load(std::memory_order_relaxed);};
+    std::uint64_t   Get_Num_Dropped (void) const {return this->num_dropped.load(std::memory_order_relaxed);}; // the queue was full
+    std::uint64_t   Get_Num_Failed (void) const {return this->num_failed.load(std::memory_order_relaxed);}; // Deliver returned an error
+
+  protected: // overridables
+    virtual Error_Code  Open_Sink (void) {return No_Error;}; // on Open - before the first Deliver
+    virtual Error_Code  Deliver (const Log_Sink_Record::Pointer  &the_record) = 0; // on a worker thread, in Submit order - held until the Flush_Sink that follows
+    virtual Error_Code  Flush_Sink (void) {return No_Error;}; // the queue has drained - write what Deliver kept back
+    virtual Error_Code  Close_Sink (void) {return No_Error;}; // on Close - after the last Deliver
+
+  private: // methods
+    void  Drain (void); // deliver the queue until it is empty - on a worker thread, one drain at a time
+
+  private: // data
+    std::atomic<Logging::Detail>          detail_level; /**< see Set_Detail_Level - Logging::Debug to start with */
+    std::atomic<bool>                     is_open;
+    inline static thread_local const Log_Sink *draining_sink = nullptr; /**< see Is_Draining_Here */
+    std::mutex                            queue_mutex; /**< keeps queue & is_drain_pending thread safe - held for a push_back or a swap */
+    std::deque<Log_Sink_Record::Pointer>  queue; /**< submitted, not yet delivered */
+    std::size_t                           max_queued; /**< see Open */
+    bool                                  is_drain_pending; /**< a Drain is posted or running - at most one at a time */
+    std::atomic<bool>                     is_drain_abandoned; /**< Close waited Max_Shutdown_Wait seconds - the running Drain drops what is left */
+    std::atomic<std::uint64_t>            num_delivered; /**< see Get_Num_Delivered */
+    std::atomic<std::uint64_t>            num_dropped; /**< see Get_Num_Dropped */
+    std::atomic<std::uint64_t>            num_failed; /**< see Get_Num_Failed */
+
+  public: // errors
+    enum Log_Sink_Errors /**< Errors unique to Log_Sink */
+    { // begin
+      O_Already_Open          = 0, /**< \b Open: Invalid state - the sink is already open. */
+      O_Invalid_Max_Queued    = 1, /**< \b Open: Invalid parameter value - the_max_queued is less than Log_Sink_Constant::Min_Max_Queued. */
+      C_Not_Open              = 2, /**< \b Close: Invalid state - the sink is not open. */
+      S_Invalid_Record        = 3, /**< \b Submit: Invalid parameter address - the_record is nullptr. */
+      S_Drain_Post_Error      = 4, /**< \b Submit: Call to Active_Object::Post failed - the queue is delivered by the next Submit. */
+      SF_Already_Open         = 5, /**< \b File_Log_Sink::Set_File: Invalid state - the sink is already open. */
+      SF_Invalid_Filespec     = 6, /**< \b File_Log_Sink::Set_File: Invalid parameter length - the_filespec is empty. */
+      SF_Invalid_Max_Size     = 7, /**< \b File_Log_Sink::Set_File: Invalid parameter value - the_max_file_size is less than Log_Sink_Constant::Min_Max_File_Size. */
+      SF_Invalid_Num_Files    = 8, /**< \b File_Log_Sink::Set_File: Invalid parameter value - the_num_rotated_files is outside 1 .. Max_Num_Rotated_Files. */
+      OS_No_Filespec          = 9, /**< \b File_Log_Sink::Open_Sink: Invalid state - Set_File was not called. */
+      R_rename_Error          = 10, /**< \b File_Log_Sink::Rotate: Call to rename failed for a rotated log file - writing on in the same file. */
+      SC_Already_Open         = 11, /**< \b Memory_Log_Sink::Set_Capacity: Invalid state - the sink is already open. */
+      SC_Invalid_Capacity     = 12, /**< \b Memory_Log_Sink::Set_Capacity: Invalid parameter value - the_max_records is zero. */
+      SCO_Already_Open        = 13, /**< \b UDP_Log_Sink::Set_Collector: Invalid state - the sink is already open. */
+      SCO_Invalid_Host        = 14, /**< \b UDP_Log_Sink::Set_Collector: Invalid parameter length - the_host is empty. */
+      OS_getaddrinfo_Error    = 15, /**< \b UDP_Log_Sink::Open_Sink: Call to getaddrinfo failed for the collector host. */
+      OS_socket_Error         = 16, /**< \b UDP_Log_Sink::Open_Sink: Call to socket failed. */
+      OS_connect_Error        = 17, /**< \b UDP_Log_Sink::Open_Sink: Call to connect failed for the collector address. */
+      D_send_Error            = 18, /**< \b UDP_Log_Sink::Deliver: Call to send failed - the collector is not listening? Counted, not logged. */
+      D_Write_Error           = 19, /**< \b File_Log_Sink::Flush_Sink: Call to Log_File_Writer::Write_Batch failed - counted, the writer logs the cause to the other sinks. */
+    }; // Log_Sink_Errors
+  } Log_Sink;
+
+  /**
+   * @brief The records in a log file that is rotated once it reaches its maximum size - the current file keeps its name.
+   */
+  typedef class File_Log_Sink : public Log_Sink
+  { // begin
+  public: // construction
+    File_Log_Sink (void) = default;
+    virtual ~File_Log_Sink (void);
+
+  public: // methods
+    A4_Export Error_Code  Set_File (const std::string  &the_filespec,
+                                    std::uint64_t      the_max_file_size = Log_Sink_Constant::Default_Max_File_Size,
+                                    std::size_t        the_num_rotated_files = Log_Sink_Constant::Default_Num_Rotated_Files); // before Open
+
+  protected: // overrides
+    virtual Error_Code  Open_Sink (void) override;
+    virtual Error_Code  Deliver (const Log_Sink_Record::Pointer  &the_record) override;
+    virtual Error_Code  Flush_Sink (void) override;
+    virtual Error_Code  Close_Sink (void) override;
+
+  private: // methods
+    Error_Code  Rotate (void); // name.ext.N is deleted, each other file moves up one, name.ext becomes name.ext.1
+
+  private: // data
+    Log_File_Writer   log_writer;
+    std::string       filespec;
+    std::uint64_t     max_file_size = Log_Sink_Constant::Default_Max_File_Size;
+    std::size_t       num_rotated_files = Log_Sink_Constant::Default_Num_Rotated_Files;
+    std::size_t       batch_bytes = 0; /**< added since the last Write_Batch */
+  } File_Log_Sink;
+
+  /**
+   * @brief The most recent records, in memory - Get_Records & Get_Lines may be called from any thread.
+   */
+  typedef class Memory_Log_Sink : public Log_Sink
+  { // begin
+  public: // construction
+    Memory_Log_Sink (void) = default;
+    virtual ~Memory_Log_Sink (void);
+
+  public: // methods
+    A4_Export Error_Code  Set_Capacity (std::size_t  the_max_records); // before Open - Default_Memory_Capacity otherwise
+
+    A4_Export Error_Code  Get_Records (Log_Sink_Record_Vector  &the_records,
+                                       std::int64_t            the_min_sequence = 0) const; // oldest first - those from the_min_sequence on
+    A4_Export Error_Code  Get_Lines (String_Vector  &the_lines,
+                                     std::size_t    the_max_lines = 0) const; // the newest the_max_lines, oldest first - 0 for all
+
+    A4_Export std::size_t   Get_Num_Records (void) const;
+    A4_Export void          Clear (void);
+
+  protected: // overrides
+    virtual Error_Code  Deliver (const Log_Sink_Record::Pointer  &the_record) override;
+
+  private: // data
+    mutable std::mutex                    records_mutex; /**< keeps records thread safe */
+    std::deque<Log_Sink_Record::Pointer>  records; /**< oldest first */
+    std::size_t                           capacity = Log_Sink_Constant::Default_Memory_Capacity;
+  } Memory_Log_Sink;
+
+  /**
+   * @brief Each record as an RFC 5424 syslog datagram - <PRI>1 TIMESTAMP HOST APP-NAME PROCID - - MESSAGE.
+   */
+  typedef class UDP_Log_Sink : public Log_Sink
+  { // begin
+  public: // construction
+    UDP_Log_Sink (void) = default;
+    virtual ~UDP_Log_Sink (void);
+
+  public: // methods
+    A4_Export Error_Code  Set_Collector (const std::string  &the_host = "127.0.0.1",
+                                         std::uint16_t      the_port = Log_Sink_Constant::Default_Syslog_Port,
+                                         const std::string  &the_app_name = "A4_Lib"); // before Open
+
+    static int  Get_Severity (Logging::Detail  the_detail) noexcept; // the syslog severity of a detail level
+
+  protected: // overrides
+    virtual Error_Code  Open_Sink (void) override;
+    virtual Error_Code  Deliver (const Log_Sink_Record::Pointer  &the_record) override;
+    virtual Error_Code  Close_Sink (void) override;
+
+  private: // data
+    std::string     host = "127.0.0.1";
+    std::uint16_t   port = Log_Sink_Constant::Default_Syslog_Port;
+    std::string     app_name = "A4_Lib";
+    std::string     header_suffix; /**< " HOST APP-NAME PROCID - - " - made by Open_Sink */
+    std::intptr_t   socket_handle = -1; /**< connected to the collector while open */
+  } UDP_Log_Sink;
+} // namespace A4_Lib
+
+#endif // __A4_Log_Sink_Defined__
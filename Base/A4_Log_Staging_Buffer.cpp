@@ -0,0 +1,111 @@
+/**
+ * @brief   Log staging ring implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Staging_Buffer.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_Staging_Buffer.hh"
+
+#include <cstring>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  inline std::size_t  Record_Size (std::size_t  the_payload_length) noexcept
+  { // begin
+    return (sizeof(Log_Record_Header) + the_payload_length + Log_Staging_Constant::Record_Alignment - 1) & ~(Log_Staging_Constant::Record_Alignment - 1);
+  } // Record_Size
+} // namespace
+
+/**
+ * @brief Append a whole record - it becomes visible to the consumer once completely copied.
+ * @param the_header - IN - the_header.length payload bytes follow
+ * @param the_payload - IN
+ * @return \b false when the ring has no room for the record - nothing is appended
+ */
+bool  Log_Staging_Buffer::Push (const Log_Record_Header   &the_header,
+                                const char                *the_payload) noexcept
+{ // begin
+  std::size_t   the_head = this->head.load(std::memory_order_relaxed);
+  std::size_t   the_offset = the_head & (Log_Staging_Constant::Buffer_Size - 1);
+  std::size_t   the_size = Record_Size(the_header.length);
+  std::size_t   the_skip = 0; // the end of the ring, when the record does not fit before it
+
+  if ((the_offset + the_size) > Log_Staging_Constant::Buffer_Size)
+    the_skip = Log_Staging_Constant::Buffer_Size - the_offset;
+
+  if ((the_head + the_skip + the_size - this->tail.load(std::memory_order_acquire)) > Log_Staging_Constant::Buffer_Size)
+    return false;
+
+  if (the_skip >= sizeof(Log_Record_Header))
+  { // begin - a shorter skip is implied by the consumer
+    Log_Record_Header   the_padding = {static_cast<std::uint32_t>(the_skip - sizeof(Log_Record_Header)), Padding_Record, 0, 0, 0, 0, 0, 0};
+
+    std::memcpy(this->bytes + the_offset, &the_padding, sizeof(the_padding));
+  } // if then
+
+  the_offset = (the_head + the_skip) & (Log_Staging_Constant::Buffer_Size - 1);
+
+  std::memcpy(this->bytes + the_offset, &the_header, sizeof(the_header));
+  std::memcpy(this->bytes + the_offset + sizeof(the_header), the_payload, the_header.length);
+
+  this->head.store(the_head + the_skip + the_size, std::memory_order_release);
+
+  return true;
+} // Push
+
+/**
+ * @brief The record at the_cursor - padding is skipped.
+ * @param the_cursor - IN - from Get_Begin or the previous Next / OUT - past the returned record
+ * @param the_end - IN - from Get_End
+ * @return the header, its payload follows - \b nullptr once the_cursor reaches the_end
+ */
+const Log_Record_Header   *Log_Staging_Buffer::Next (std::size_t  &the_cursor,
+                                                     std::size_t  the_end) const noexcept
+{ // begin
+  const Log_Record_Header   *the_header = nullptr;
+
+  while ((the_header == nullptr) && (the_cursor < the_end))
+  { // begin
+    std::size_t   the_offset = the_cursor & (Log_Staging_Constant::Buffer_Size - 1);
+
+    if ((Log_Staging_Constant::Buffer_Size - the_offset) < sizeof(Log_Record_Header))
+      the_cursor += Log_Staging_Constant::Buffer_Size - the_offset; // too short for a padding record
+    else
+    { // begin
+      the_header = reinterpret_cast<const Log_Record_Header *>(this->bytes + the_offset);
+      the_cursor += Record_Size(the_header->length);
+
+      if (the_header->kind == Padding_Record)
+        the_header = nullptr;
+    } // else
+  } // while
+
+  return the_header;
+} // Next
@@ -0,0 +1,119 @@
+#ifndef __A4_Log_Staging_Buffer_Defined__
+#define __A4_Log_Staging_Buffer_Defined__
+/**
+ * @brief   Single producer / single consumer ring holding the log records of one thread.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Staging_Buffer.hh
+ * @note  The File_Logger gives each writing thread its own buffer - the thread appends whole records without a lock and
+ *        the logger's worker reads every buffer's pending records in one sweep. A record is a Log_Record_Header followed by
+ *        its payload, published only once completely copied and never split where the ring wraps - the rest of the ring
+ *        is skipped instead.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_Staging_Constant
+  { // begin
+    static const std::size_t  Buffer_Size = 65536; /**< bytes per thread - a power of two */
+    static const std::size_t  Record_Alignment = 8; /**< every record starts on this boundary */
+  } // namespace Log_Staging_Constant
+
+  /**
+   * @brief What a record carries - the binary log file keeps the same values.
+   */
+  enum Log_Record_Kind : std::uint8_t
+  { // begin
+    Padding_Record    = 0, /**< the ring's unused end - never in a file */
+    Line_Record       = 1, /**< a formatted log line - written as it is */
+    Message_Record    = 2, /**< log text - the line prefix is made from the header when the record is written */
+    Event_Record      = 3, /**< Log_Arguments for the format string format_id - formatted by the worker or the decoder */
+    Format_Record     = 4, /**< the format string format_id - binary log files only, ahead of its first Event_Record */
+  }; // Log_Record_Kind
+
+  /**
+   * @brief Leads every record - the payload follows.
+   */
+  typedef struct Log_Record_Header
+  { // begin
+    std::uint32_t   length; /**< payload bytes */
+    std::uint8_t    kind; /**< Log_Record_Kind */
+    std::uint8_t    detail; /**< Logging::Detail */
+    std::uint16_t   reserved;
+    std::uint32_t   format_id; /**< Event_Record & Format_Record - see Log_Format_Registry */
+    std::uint32_t   ring_slot; /**< the Log_Crash_Ring entry of a staged record - 0 for none, ignored in a log file */
+    std::int64_t    sequence; /**< the File_Logger sequence number */
+    std::int64_t    nano_seconds; /**< since the epoch - the system clock */
+  } Log_Record_Header;
+
+  static_assert(sizeof(Log_Record_Header) == 32, "Log_Record_Header is part of the binary log file format");
+
+  /**
+   * @brief One thread's ring - Push from the owning thread only, Get_End, Next & Release from one consumer at a time.
+   */
+  typedef class Log_Staging_Buffer
+  { // begin
+  public: // construction
+    Log_Staging_Buffer (void) = default;
+    Log_Staging_Buffer (Log_Staging_Buffer &) = delete;
+
+  public: // types
+    typedef std::shared_ptr<Log_Staging_Buffer>   Pointer;
+
+  public: // producer
+    A4_Export bool  Push (const Log_Record_Header   &the_header,
+                          const char                *the_payload) noexcept; // false when the ring has no room for the whole record
+
+    void  Set_Finished (void) noexcept {this->is_finished.store(true, std::memory_order_release);}; // the owning thread has exited
+
+  public: // consumer
+    std::size_t   Get_Begin (void) const noexcept {return this->tail.load(std::memory_order_relaxed);}; // the oldest pending record
+    std::size_t   Get_End (void) const noexcept {return this->head.load(std::memory_order_acquire);}; // past the newest published record
+
+    A4_Export const Log_Record_Header   *Next (std::size_t  &the_cursor,
+                                               std::size_t  the_end) const noexcept; // nullptr at the_end - the payload follows the header
+
+    void  Release (std::size_t  the_cursor) noexcept {this->tail.store(the_cursor, std::memory_order_release);}; // every record before the_cursor has been written
+
+    bool  Is_Empty (void) const noexcept {return this->tail.load(std::memory_order_relaxed) == this->head.load(std::memory_order_acquire);};
+    bool  Is_Finished (void) const noexcept {return this->is_finished.load(std::memory_order_acquire);};
+
+  private: // data
+    alignas(64) std::atomic<std::size_t>  head {0}; /**< written by the producer - bytes ever pushed */
+    alignas(64) std::atomic<std::size_t>  tail {0}; /**< written by the consumer - bytes ever released */
+    std::atomic<bool>                     is_finished {false};
+    alignas(64) char                      bytes [Log_Staging_Constant::Buffer_Size];
+  } Log_Staging_Buffer;
+} // namespace A4_Lib
+
+#endif // __A4_Log_Staging_Buffer_Defined__
@@ -0,0 +1,531 @@
+/**
+ * @brief   io_uring log file writes implementation - Linux only
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Uring.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Log_Uring.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+  #define A4_Log_Uring_Supported
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+using namespace A4_Lib;
+
+#ifdef A4_Log_Uring_Supported
+namespace
+{ // begin
+  int  IO_Uring_Setup (unsigned int           the_num_entries,
+                       struct io_uring_params  &the_params)
+  { // begin
+    return static_cast<int>(syscall(__NR_io_uring_setup, the_num_entries, &the_params));
+  } // IO_Uring_Setup
+
+  int  IO_Uring_Enter (int           the_ring,
+                       unsigned int  the_num_submitted,
+                       unsigned int  the_min_complete)
+  { // begin
+    return static_cast<int>(syscall(__NR_io_uring_enter, the_ring, the_num_submitted, the_min_complete,
+                                    (the_min_complete > 0) ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+  } // IO_Uring_Enter
+
+  int  IO_Uring_Register (int           the_ring,
+                          unsigned int  the_opcode,
+                          const void    *the_argument,
+                          unsigned int  the_num_arguments)
+  { // begin
+    return static_cast<int>(syscall(__NR_io_uring_register, the_ring, the_opcode, the_argument, the_num_arguments));
+  } // IO_Uring_Register
+} // namespace
+#endif // A4_Log_Uring_Supported
+
+/**
+ * @brief Close an open ring - a failure is not reported from here.
+ */
+Log_Uring::~Log_Uring (void)
+{ // begin
+  if (this->Is_Open() == true)
+    (void) this->Close();
+} // destructor
+
+/**
+ * @brief Set up the rings and register the buffers - the caller falls back to writev on any error.
+ * @param the_file_descriptor - IN - opened without O_APPEND, every write goes at its own offset
+ * @param the_file_size - IN
+ * @return No_Error, O_Already_Open, O_Not_Supported, O_Setup_Error, O_mmap_Error, O_Allocation_Error, O_Register_Error
+ */
+Error_Code  Log_Uring::Open (int            the_file_descriptor,
+                             std::uint64_t  the_file_size)
+{ // begin
+#ifdef A4_Log_Uring_Supported
+  struct io_uring_params  the_params;
+  struct iovec            the_vectors [Log_Uring_Constant::Num_Buffers];
+  bool                    is_set_up = false; // by this call
+
+  std::memset(&the_params, 0, sizeof(the_params));
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, O_Already_Open, "Invalid state - the ring is already open.");
+      else if ((this->ring_descriptor = IO_Uring_Setup(Log_Uring_Constant::Queue_Depth, the_params)) < 0)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, O_Setup_Error, A4_Lib::Logging::Warning, "Call to io_uring_setup resulted in error %d - writing with writev", errno);
+      else is_set_up = true;
+    End_State
+
+    State(2)
+      this->ring_memory_size = the_params.sq_off.array + (the_params.sq_entries * sizeof(unsigned int));
+      this->completion_memory_size = the_params.cq_off.cqes + (the_params.cq_entries * sizeof(struct io_uring_cqe));
+
+      if ((the_params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        this->ring_memory_size = std::max(this->ring_memory_size, this->completion_memory_size);
+
+      this->ring_memory = mmap(nullptr, this->ring_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_descriptor, IORING_OFF_SQ_RING);
+
+      if (this->ring_memory == MAP_FAILED)
+        this->ring_memory = nullptr;
+      else if ((the_params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        this->completion_memory = this->ring_memory;
+      else if ((this->completion_memory = mmap(nullptr, this->completion_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_descriptor, IORING_OFF_CQ_RING)) == MAP_FAILED)
+        this->completion_memory = nullptr;
+
+      if (this->completion_memory != nullptr)
+      { // begin
+        this->entry_memory_size = the_params.sq_entries * sizeof(struct io_uring_sqe);
+        this->entry_memory = mmap(nullptr, this->entry_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring_descriptor, IORING_OFF_SQES);
+
+        if (this->entry_memory == MAP_FAILED)
+          this->entry_memory = nullptr;
+      } // if then
+
+      if (this->entry_memory == nullptr)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, O_mmap_Error, A4_Lib::Logging::Warning, "Call to mmap resulted in error %d for the io_uring rings - writing with writev", errno);
+      else
+      { // begin
+        char  *the_rings = static_cast<char *>(this->ring_memory);
+        char  *the_completion_rings = static_cast<char *>(this->completion_memory);
+
+        this->submission_tail = reinterpret_cast<unsigned int *>(the_rings + the_params.sq_off.tail);
+        this->submission_mask = *reinterpret_cast<unsigned int *>(the_rings + the_params.sq_off.ring_mask);
+        this->submission_array = reinterpret_cast<unsigned int *>(the_rings + the_params.sq_off.array);
+        this->completion_head = reinterpret_cast<unsigned int *>(the_completion_rings + the_params.cq_off.head);
+        this->completion_tail = reinterpret_cast<unsigned int *>(the_completion_rings + the_params.cq_off.tail);
+        this->completion_mask = *reinterpret_cast<unsigned int *>(the_completion_rings + the_params.cq_off.ring_mask);
+        this->completions = the_completion_rings + the_params.cq_off.cqes;
+      } // else
+    End_State
+
+    State(3)
+      this->buffer_memory = static_cast<char *>(std::aligned_alloc(4096, Log_Uring_Constant::Num_Buffers * Log_Uring_Constant::Buffer_Size));
+
+      if (this->buffer_memory == nullptr)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, O_Allocation_Error, A4_Lib::Logging::Warning, "Memory allocation error - could not allocate %zu io_uring buffers - writing with writev", Log_Uring_Constant::Num_Buffers);
+    End_State
+
+    State(4)
+      for (std::size_t the_buffer = 0; the_buffer < Log_Uring_Constant::Num_Buffers; the_buffer++)
+      { // begin
+        the_vectors [the_buffer].iov_base = this->buffer_memory + (the_buffer * Log_Uring_Constant::Buffer_Size);
+        the_vectors [the_buffer].iov_len = Log_Uring_Constant::Buffer_Size;
+        this->buffer_lengths [the_buffer] = 0;
+        this->is_in_flight [the_buffer] = false;
+      } // for
+
+      if (IO_Uring_Register(this->ring_descriptor, IORING_REGISTER_BUFFERS, the_vectors, Log_Uring_Constant::Num_Buffers) != 0)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, O_Register_Error, A4_Lib::Logging::Warning, "Call to io_uring_register resulted in error %d for the buffers - writing with writev", errno);
+      else
+      { // begin
+        this->file_descriptor = the_file_descriptor;
+        this->next_offset = the_file_size;
+        this->num_failed_writes = 0;
+        this->current_buffer = Log_Uring_Constant::Num_Buffers;
+        this->num_in_flight = 0;
+      } // else
+    End_State
+  End_Method_State_Block
+
+  A4_Cleanup_Begin
+    if ((the_method_error != No_Error) && (is_set_up == true))
+    { // begin
+      std::free(this->buffer_memory);
+      this->buffer_memory = nullptr;
+
+      if (this->entry_memory != nullptr)
+        (void) munmap(this->entry_memory, this->entry_memory_size);
+
+      if ((this->completion_memory != nullptr) && (this->completion_memory != this->ring_memory))
+        (void) munmap(this->completion_memory, this->completion_memory_size);
+
+      if (this->ring_memory != nullptr)
+        (void) munmap(this->ring_memory, this->ring_memory_size);
+
+      this->entry_memory = this->completion_memory = this->ring_memory = nullptr;
+
+      if (this->ring_descriptor >= 0)
+        (void) close(this->ring_descriptor);
+
+      this->ring_descriptor = -1;
+    } // if then
+  A4_End_Cleanup
+
+  return the_method_error.Get_Error_Code();
+#else
+  (void) the_file_descriptor;
+  (void) the_file_size;
+
+  return A4_Error (A4_Log_Uring_Module_ID, O_Not_Supported, A4_Lib::Logging::Warning, "io_uring is not available on this platform - writing with writev").Get_Error_Code();
+#endif // A4_Log_Uring_Supported
+} // Open
+
+/**
+ * @brief Wait for the writes in flight and release the ring - the file descriptor belongs to the caller.
+ * @return No_Error, or a Drain error - the ring is released either way
+ */
+Error_Code  Log_Uring::Close (void)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (this->Is_Open() == true)
+        the_method_error = this->Drain();
+    End_State
+  End_Method_State_Block
+
+#ifdef A4_Log_Uring_Supported
+  if (this->Is_Open() == true)
+  { // begin
+    (void) munmap(this->entry_memory, this->entry_memory_size);
+
+    if (this->completion_memory != this->ring_memory)
+      (void) munmap(this->completion_memory, this->completion_memory_size);
+
+    (void) munmap(this->ring_memory, this->ring_memory_size);
+    (void) close(this->ring_descriptor); // unregisters the buffers
+
+    std::free(this->buffer_memory);
+  } // if then
+#endif // A4_Log_Uring_Supported
+
+  this->entry_memory = this->completion_memory = this->ring_memory = nullptr;
+  this->buffer_memory = nullptr;
+  this->ring_descriptor = this->file_descriptor = -1;
+  this->current_buffer = Log_Uring_Constant::Num_Buffers;
+  this->num_in_flight = 0;
+
+  return the_method_error.Get_Error_Code();
+} // Close
+
+/**
+ * @brief Copy the_bytes into the current buffer - each buffer that fills up is submitted, the rest waits for Submit.
+ * @param the_bytes - IN
+ * @param the_length - IN
+ * @return No_Error, A_Not_Open, or an Acquire_Buffer or Submit error
+ * \note  An earlier write that completed with an error does not stop this one - every byte is still copied and
+ *        submitted, and R_Write_Error is returned once it has been.
+ */
+Error_Code  Log_Uring::Append (const char   *the_bytes,
+                               std::size_t  the_length)
+{ // begin
+  A4_Error  the_write_error (No_Error); // of an earlier write
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Open() != true)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, A_Not_Open, "Invalid state - the ring is not open.");
+    End_State
+
+    State(2)
+      while ((the_length > 0) && (the_method_error == No_Error))
+      { // begin
+        if (this->current_buffer == Log_Uring_Constant::Num_Buffers)
+          the_method_error = this->Acquire_Buffer();
+        else
+        { // begin
+          std::size_t   &the_buffer_length = this->buffer_lengths [this->current_buffer];
+          std::size_t   the_copied = std::min(the_length, Log_Uring_Constant::Buffer_Size - the_buffer_length);
+
+          std::memcpy(this->buffer_memory + (this->current_buffer * Log_Uring_Constant::Buffer_Size) + the_buffer_length, the_bytes, the_copied);
+          the_buffer_length += the_copied;
+          the_bytes += the_copied;
+          the_length -= the_copied;
+
+          if (the_buffer_length == Log_Uring_Constant::Buffer_Size)
+            the_method_error = this->Submit();
+        } // else
+
+        if (the_method_error == A4_Error::Make_Error_Code(A4_Log_Uring_Module_ID, R_Write_Error))
+        { // an earlier write failed - Acquire_Buffer has a buffer all the same
+          the_write_error = the_method_error;
+          the_method_error = No_Error;
+        } // if then
+      } // while
+
+      if (the_method_error == No_Error)
+        the_method_error = the_write_error;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Append
+
+/**
+ * @brief Submit the current buffer as one fixed-buffer write at its offset - returns without waiting for it.
+ *        When io_uring_enter fails the entry is taken back and the buffer is written here with pwrite instead.
+ * @return No_Error, S_Enter_Error
+ */
+Error_Code  Log_Uring::Submit (void)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if ((this->current_buffer == Log_Uring_Constant::Num_Buffers) || (this->buffer_lengths [this->current_buffer] == 0))
+        Terminate_The_Method_Block; // nothing to write
+      else
+      { // begin
+#ifdef A4_Log_Uring_Supported
+        std::size_t   the_buffer = this->current_buffer;
+        unsigned int  the_tail = *this->submission_tail; // only written here
+        unsigned int  the_index = the_tail & this->submission_mask;
+        io_uring_sqe  *the_entry = static_cast<io_uring_sqe *>(this->entry_memory) + the_index;
+        int           the_result = 0;
+
+        std::memset(the_entry, 0, sizeof(*the_entry));
+        the_entry->opcode = IORING_OP_WRITE_FIXED;
+        the_entry->fd = this->file_descriptor;
+        the_entry->addr = reinterpret_cast<std::uint64_t>(this->buffer_memory + (the_buffer * Log_Uring_Constant::Buffer_Size));
+        the_entry->len = static_cast<std::uint32_t>(this->buffer_lengths [the_buffer]);
+        the_entry->off = this->buffer_offsets [the_buffer];
+        the_entry->buf_index = static_cast<std::uint16_t>(the_buffer);
+        the_entry->user_data = the_buffer;
+
+        this->submission_array [the_index] = the_index;
+        __atomic_store_n(this->submission_tail, the_tail + 1, __ATOMIC_RELEASE);
+
+        this->next_offset += this->buffer_lengths [the_buffer];
+        this->is_in_flight [the_buffer] = true;
+        this->num_in_flight++;
+        this->current_buffer = Log_Uring_Constant::Num_Buffers;
+
+        while (((the_result = IO_Uring_Enter(this->ring_descriptor, 1, 0)) < 0) && (errno == EINTR))
+          ;
+
+        if (the_result < 0)
+        { // nothing was consumed - take the entry back, or Drain would wait for a completion that never comes
+          int   the_enter_error = errno;
+          int   the_write_error = 0;
+
+          __atomic_store_n(this->submission_tail, the_tail, __ATOMIC_RELEASE);
+
+          this->is_in_flight [the_buffer] = false;
+          this->num_in_flight--;
+
+          if ((the_write_error = this->Write_Buffer(the_buffer, 0)) != 0)
+          { // begin
+            this->num_failed_writes++;
+
+            the_method_error = A4_Error (A4_Log_Uring_Module_ID, S_Enter_Error, A4_Lib::Logging::Error,
+                                         "Call to io_uring_enter resulted in error %d submitting a log file write, and pwrite in error %d", the_enter_error, the_write_error);
+          } // if then
+        } // if then
+#endif // A4_Log_Uring_Supported
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Submit
+
+/**
+ * @brief Submit the current buffer and wait until no write is in flight.
+ * @return No_Error, or a Submit or Reap error - a write that completed with an error does not stop the wait
+ */
+Error_Code  Log_Uring::Drain (void)
+{ // begin
+  A4_Error  the_write_error (No_Error);
+
+  Method_State_Block_Begin(2)
+    State(1)
+      the_method_error = this->Submit();
+    End_State
+
+    State(2)
+      while ((this->num_in_flight > 0) && (the_method_error == No_Error))
+      { // begin
+        the_method_error = this->Reap(1);
+
+        if (the_method_error == A4_Error::Make_Error_Code(A4_Log_Uring_Module_ID, R_Write_Error))
+        { // the other writes are still in flight
+          the_write_error = the_method_error;
+          the_method_error = No_Error;
+        } // if then
+      } // while
+
+      if (the_method_error == No_Error)
+        the_method_error = the_write_error;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Drain
+
+/**
+ * @brief Make a free buffer the current one, starting at next_offset - waits for a write to complete when none is free.
+ * @return No_Error, or a Reap error
+ */
+Error_Code  Log_Uring::Acquire_Buffer (void)
+{ // begin
+  std::size_t   the_free = Log_Uring_Constant::Num_Buffers;
+
+  Method_State_Block_Begin(1)
+    State(1)
+      while ((the_free == Log_Uring_Constant::Num_Buffers) && (the_method_error == No_Error))
+      { // begin
+        the_method_error = this->Reap((this->num_in_flight == Log_Uring_Constant::Num_Buffers) ? 1 : 0);
+
+        for (std::size_t the_buffer = 0; (the_buffer < Log_Uring_Constant::Num_Buffers) && (the_free == Log_Uring_Constant::Num_Buffers); the_buffer++)
+        { // begin
+          if (this->is_in_flight [the_buffer] == false)
+            the_free = the_buffer;
+        } // for
+      } // while
+
+      if (the_free != Log_Uring_Constant::Num_Buffers)
+      { // begin
+        this->current_buffer = the_free;
+        this->buffer_lengths [the_free] = 0;
+        this->buffer_offsets [the_free] = this->next_offset;
+      } // if then
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Acquire_Buffer
+
+/**
+ * @brief Handle the completed writes - a short write is finished with pwrite, a failed one is counted and reported.
+ * @param the_min_complete - IN - 0 to take what has completed without waiting
+ * @return No_Error, R_Enter_Error, R_Write_Error
+ */
+Error_Code  Log_Uring::Reap (unsigned int  the_min_complete)
+{ // begin
+#ifdef A4_Log_Uring_Supported
+  int   the_failure = 0; // the last errno of a failed write
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if ((the_min_complete > 0) && (this->num_in_flight > 0))
+      { // begin
+        int   the_result = 0;
+
+        while (((the_result = IO_Uring_Enter(this->ring_descriptor, 0, the_min_complete)) < 0) && (errno == EINTR))
+          ;
+
+        if (the_result < 0)
+          the_method_error = A4_Error (A4_Log_Uring_Module_ID, R_Enter_Error, A4_Lib::Logging::Error, "Call to io_uring_enter resulted in error %d waiting for a log file write", errno);
+      } // if then
+    End_State
+
+    State(2)
+      unsigned int  the_head = *this->completion_head; // only written here
+      unsigned int  the_tail = __atomic_load_n(this->completion_tail, __ATOMIC_ACQUIRE);
+
+      for (; the_head != the_tail; the_head++)
+      { // begin
+        const io_uring_cqe  &the_completion = static_cast<const io_uring_cqe *>(this->completions) [the_head & this->completion_mask];
+        std::size_t         the_buffer = static_cast<std::size_t>(the_completion.user_data);
+        int                 the_written = the_completion.res;
+
+        if (the_written >= 0)
+          the_written = -this->Write_Buffer(the_buffer, static_cast<std::size_t>(the_written)); // the rest of a short write
+
+        if (the_written < 0)
+        { // begin
+          the_failure = -the_written;
+          this->num_failed_writes++;
+        } // if then
+
+        this->is_in_flight [the_buffer] = false;
+        this->num_in_flight--;
+      } // for
+
+      __atomic_store_n(this->completion_head, the_head, __ATOMIC_RELEASE);
+
+      if (the_failure != 0)
+        the_method_error = A4_Error (A4_Log_Uring_Module_ID, R_Write_Error, A4_Lib::Logging::Error, "A log file write completed with error %d - enough storage space?", the_failure);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+#else
+  (void) the_min_complete;
+
+  return No_Error;
+#endif // A4_Log_Uring_Supported
+} // Reap
+
+/**
+ * @brief Write the bytes of the_buffer from the_written on with pwrite - a short io_uring write, or one that was not submitted.
+ * @param the_buffer - IN
+ * @param the_written - IN - bytes of the buffer already in the file
+ * @return 0, or the errno of the failed pwrite
+ */
+int   Log_Uring::Write_Buffer (std::size_t  the_buffer,
+                               std::size_t  the_written)
+{ // begin
+#ifdef A4_Log_Uring_Supported
+  while (the_written < this->buffer_lengths [the_buffer])
+  { // begin
+    ssize_t   the_result = pwrite(this->file_descriptor, this->buffer_memory + (the_buffer * Log_Uring_Constant::Buffer_Size) + the_written,
+                                  this->buffer_lengths [the_buffer] - the_written, static_cast<off_t>(this->buffer_offsets [the_buffer] + the_written));
+
+    if ((the_result < 0) && (errno == EINTR))
+      continue;
+    else if (the_result < 0)
+      return errno;
+    else if (the_result == 0)
+      return EIO;
+    else the_written += static_cast<std::size_t>(the_result);
+  } // while
+
+  return 0;
+#else
+  (void) the_buffer;
+  (void) the_written;
+
+  return 0;
+#endif // A4_Log_Uring_Supported
+} // Write_Buffer
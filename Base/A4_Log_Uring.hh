@@ -0,0 +1,130 @@
+#ifndef __A4_Log_Uring_Defined__
+#define __A4_Log_Uring_Defined__
+/**
+ * @brief   io_uring submission of log file writes from registered buffers - Linux only.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Uring.hh
+ * @note  Log_File_Writer copies each batch into one of Num_Buffers registered buffers and submits it as a fixed-buffer
+ *        write at its own file offset - the worker goes on without waiting for the disk. It only waits when every buffer
+ *        is still in flight, or in Drain before a sync or close. Writes complete in any order, so the file is written
+ *        by offset rather than O_APPEND.
+ *
+ *        Talks to the kernel with the io_uring system calls directly - no liburing. Open fails where io_uring is not
+ *        available (not Linux, an older kernel, a seccomp filter, RLIMIT_MEMLOCK) and Log_File_Writer then stays with
+ *        writev.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <cstddef>
+#include <cstdint>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Log_Uring_Constant
+  { // begin
+    static const unsigned int   Queue_Depth = 32; /**< submission queue entries - more than Num_Buffers */
+    static const std::size_t    Num_Buffers = 16; /**< registered buffers - writes in flight at most */
+    static const std::size_t    Buffer_Size = 262144; /**< bytes per registered buffer */
+  } // namespace Log_Uring_Constant
+
+  /**
+   * @brief One io_uring instance writing one file - not thread safe, used under the File_Logger's log_file_mutex.
+   */
+  typedef class Log_Uring
+  { // begin
+  public: // construction
+    Log_Uring (void) = default;
+    Log_Uring (Log_Uring &) = delete;
+    ~Log_Uring (void);
+
+  public: // methods
+    A4_Export Error_Code  Open (int             the_file_descriptor,
+                                std::uint64_t   the_file_size); // the next write goes at the_file_size
+    A4_Export Error_Code  Close (void); // drains first - the file descriptor is left open
+
+    A4_Export Error_Code  Append (const char    *the_bytes,
+                                  std::size_t   the_length); // copied into the current buffer - full buffers are submitted
+
+    A4_Export Error_Code  Submit (void); // the current buffer, however full
+    A4_Export Error_Code  Drain (void); // returns once every submitted write has completed
+
+    bool            Is_Open (void) const {return this->ring_descriptor >= 0;};
+    std::uint64_t   Get_Num_Failed_Writes (void) const {return this->num_failed_writes;};
+
+  private: // methods
+    Error_Code  Acquire_Buffer (void); // a free buffer becomes the current one - waits for a completion when none is free
+    Error_Code  Reap (unsigned int  the_min_complete); // handle the completions - wait for the_min_complete of them
+    int         Write_Buffer (std::size_t   the_buffer,
+                              std::size_t   the_written); // pwrite what is left of the_buffer - 0 or the errno
+
+  private: // data
+    int             ring_descriptor = -1;
+    int             file_descriptor = -1;
+    std::uint64_t   next_offset = 0; /**< where the next appended byte goes in the file */
+    std::uint64_t   num_failed_writes = 0;
+
+    void            *ring_memory = nullptr; /**< the submission & completion rings */
+    std::size_t     ring_memory_size = 0;
+    void            *completion_memory = nullptr; /**< same as ring_memory unless the kernel maps the rings apart */
+    std::size_t     completion_memory_size = 0;
+    void            *entry_memory = nullptr; /**< the submission queue entries */
+    std::size_t     entry_memory_size = 0;
+
+    unsigned int    *submission_tail = nullptr;
+    unsigned int    submission_mask = 0;
+    unsigned int    *submission_array = nullptr;
+    unsigned int    *completion_head = nullptr;
+    unsigned int    *completion_tail = nullptr;
+    unsigned int    completion_mask = 0;
+    void            *completions = nullptr; /**< io_uring_cqe [] */
+
+    char            *buffer_memory = nullptr; /**< Num_Buffers * Buffer_Size - registered with the kernel */
+    std::size_t     buffer_lengths [Log_Uring_Constant::Num_Buffers] = {}; /**< bytes to write */
+    std::uint64_t   buffer_offsets [Log_Uring_Constant::Num_Buffers] = {}; /**< where they go */
+    bool            is_in_flight [Log_Uring_Constant::Num_Buffers] = {};
+    std::size_t     current_buffer = Log_Uring_Constant::Num_Buffers; /**< filled by Append - Num_Buffers when there is none */
+    std::size_t     num_in_flight = 0;
+
+  public: // errors
+    enum Log_Uring_Errors /**< Errors unique to Log_Uring */
+    { // begin
+      O_Already_Open          = 0, /**< \b Open: Invalid state - the ring is already open. */
+      O_Not_Supported         = 1, /**< \b Open: io_uring is not available on this platform. */
+      O_Setup_Error           = 2, /**< \b Open: Call to io_uring_setup failed. */
+      O_mmap_Error            = 3, /**< \b Open: Call to mmap failed for the io_uring rings. */
+      O_Allocation_Error      = 4, /**< \b Open: Memory allocation error - could not allocate the registered buffers. */
+      O_Register_Error        = 5, /**< \b Open: Call to io_uring_register failed for the buffers - RLIMIT_MEMLOCK? */
+      A_Not_Open              = 6, /**< \b Append: Invalid state - the ring is not open. */
+      S_Enter_Error           = 7, /**< \b Submit: Call to io_uring_enter failed submitting a write, and so did writing the buffer with pwrite. */
+      R_Enter_Error           = 8, /**< \b Reap: Call to io_uring_enter failed waiting for a completion. */
+      R_Write_Error           = 9, /**< \b Reap: A log file write completed with an error - enough storage space? */
+    }; // Log_Uring_Errors
+  } Log_Uring;
+} // namespace A4_Lib
+
+#endif // __A4_Log_Uring_Defined__
@@ -38,13 +38,19 @@ namespace A4_Lib_Logger_Singleton
   A4_Lib::Logger::Pointer       logging_instance_pointer;
 } // A4_Lib_Logger_Singleton
 
+std::atomic<A4_Lib::Logging::Detail>  A4_Lib::Logger::log_detail_level {A4_Lib::Logging::Debug};
+std::atomic<A4_Lib::Logging::Detail>  A4_Lib::Logger::module_detail_levels [A4_Lib::Logger_Constant::Max_Filtered_Modules]; // Unfiltered from the constructor
+
 /**
  * \brief Default constructor
  */
 A4_Lib::Logger::Logger(void)
 { // begin
   this->is_open = false;  
-  this->log_detail_level = A4_Lib::Logging::Debug;
+  log_detail_level = A4_Lib::Logging::Debug;
+  
+  for (std::atomic<Logging::Detail> &the_module_level : module_detail_levels)
+    the_module_level.store(Logger_Constant::Unfiltered, std::memory_order_relaxed);
 } // constructor
 
 /**
@@ -58,7 +64,7 @@ A4_Lib::Logger::~Logger(void)
   if (A4_Lib_Logger_Singleton::logging_instance_pointer != nullptr)
     A4_Lib_Logger_Singleton::logging_instance_pointer.reset();
   
-  this->log_detail_level = A4_Lib::Logging::Off;
+  log_detail_level = A4_Lib::Logging::Off;
 } // destructor
 
 /**
@@ -66,9 +72,50 @@ A4_Lib::Logger::~Logger(void)
  */
 A4_Lib::Logging::Detail  A4_Lib::Logger::Get_Detail_Level (void) const
 { // begin
-  return this->log_detail_level;
+  return log_detail_level.load(std::memory_order_relaxed);
 } // Get_Detail_Level
 
+/**
+ * \brief Set the maximum detail level written - takes effect for the next line of every thread.
+ * @param the_detail_level - IN
+ */
+void  A4_Lib::Logger::Set_Detail_Level (Logging::Detail  the_detail_level)
+{ // begin
+  log_detail_level.store(the_detail_level, std::memory_order_relaxed);
+} // Set_Detail_Level
+
+/**
+ * \brief Give the_module_id a detail level of its own - one module at Debug does not flood the log with the others.
+ * @param the_module_id - IN - below Logger_Constant::Max_Filtered_Modules
+ * @param the_detail_level - IN - Logger_Constant::Unfiltered to follow Set_Detail_Level again
+ * @return No_Error, SMDL_Invalid_Module_ID
+ */
+Error_Code  A4_Lib::Logger::Set_Module_Detail_Level (Module_ID        the_module_id,
+                                                     Logging::Detail  the_detail_level)
+{ // begin
+  Method_State_Block_Begin(1)
+    State(1)
+      if (the_module_id >= Logger_Constant::Max_Filtered_Modules)
+        the_method_error = A4_Error (A4_Logger_Base_Module_ID, SMDL_Invalid_Module_ID, "Invalid parameter value - the_module_id is not below Max_Filtered_Modules");
+      else module_detail_levels [the_module_id].store(the_detail_level, std::memory_order_relaxed);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Set_Module_Detail_Level
+
+/**
+ * @param the_module_id - IN
+ * @return the detail level of the_module_id - Logger_Constant::Unfiltered when it follows Set_Detail_Level
+ */
+A4_Lib::Logging::Detail  A4_Lib::Logger::Get_Module_Detail_Level (Module_ID  the_module_id) const
+{ // begin
+  if (the_module_id >= Logger_Constant::Max_Filtered_Modules)
+    return Logger_Constant::Unfiltered;
+
+  return module_detail_levels [the_module_id].load(std::memory_order_relaxed);
+} // Get_Module_Detail_Level
+
 /**
  * \brief Retrieve this instance address - allocated by the subclass
  * \returns a shared pointer for this instance
@@ -111,13 +158,15 @@ bool  A4_Lib::Logger::Is_Open()
  * @param the_error - IN
  * @param the_state - IN
  * @param the_message_detail_level - IN
+ * @param the_nano_seconds - IN - the entry's timestamp, nano-seconds since the system clock epoch - 0 means now
  * @return 
  */
 Error_Code    A4_Lib::Logger::Write(std::string        the_log_text,
                                     std::string        the_calling_function_name,  
                                     Error_Code         the_error,
                                     Method_State       the_state,
-                                    A4_Lib::Logging::Detail    the_message_detail_level)
+                                    A4_Lib::Logging::Detail    the_message_detail_level,
+                                    std::int64_t       the_nano_seconds)
 { // begin
   return A4_Error_Code (A4_Logger_Base_Module_ID, W_Not_Implemented); 
 } // Write        
@@ -130,17 +179,33 @@ Error_Code A4_Lib::Logger::Write (std::string       the_log_text,
 /**
  * \brief This method must be overridden in the subclass as it cannot be implemented here.
  * @param the_message_detail_level - IN
- * @param the_log_text - IN - 
+ * @param the_log_text - IN - printf style format
  * @param ... - variables to include into the formatted log text
  * @return 
  */
 Error_Code    A4_Lib::Logger::Write (A4_Lib::Logging::Detail    the_message_detail_level,
-                                     std::string                the_log_text,
+                                     const char                 *the_log_text,
                                      ...)
 { // begin
   return A4_Error_Code (A4_Logger_Base_Module_ID, W_Not_Implemented2); 
 } // Write 
 
+/**
+ * \brief This method must be overridden in the subclass as it cannot be implemented here.
+ * @param the_module_id - IN
+ * @param the_message_detail_level - IN
+ * @param the_log_text - IN - printf style format
+ * @param ... - variables to include into the formatted log text
+ * @return 
+ */
+Error_Code    A4_Lib::Logger::Write (Module_ID                  the_module_id,
+                                     A4_Lib::Logging::Detail    the_message_detail_level,
+                                     const char                 *the_log_text,
+                                     ...)
+{ // begin
+  return A4_Error_Code (A4_Logger_Base_Module_ID, W_Not_Implemented4); 
+} // Write (module)
+
 /**
  * \brief Open the instance by setting the is_open member to true. Must be called from the subclass from the overridden Open method.
  * @return No_Error upon success.
@@ -174,6 +239,29 @@ Error_Code    A4_Lib::Logger::Close(void)
   return the_method_error.Get_Error_Code();           
 } // Close      
 
+/**
+ * \brief The name of the_detail_level as it appears in the log - static text, nothing is allocated.
+ * @param the_detail_level - IN
+ * @return "Undefined Level" when the_detail_level is not defined
+ */
+const char *  A4_Lib::Logger::Get_Detail_Level_Name (A4_Lib::Logging::Detail  the_detail_level) noexcept
+{ // begin
+  switch (the_detail_level)
+  { // begin
+    case A4_Lib::Logging::Private_Comment:  return "Comment";
+    case A4_Lib::Logging::Off:              return "Off";
+    case A4_Lib::Logging::Error:            return "ERROR";
+    case A4_Lib::Logging::Warning:          return "WARNING";
+    case A4_Lib::Logging::Info:             return "INFO";
+    case A4_Lib::Logging::Module_Specific:  return "Module-Specific Info";
+    case A4_Lib::Logging::Debug:            return "DEBUG";
+    case A4_Lib::Logging::Dump_Start:       return "CONTENT DUMP BEGIN";
+    case A4_Lib::Logging::Dump_End:         return "CONTENT DUMP END";
+    case A4_Lib::Logging::Content_Dump:     return "CONTENT DUMP";
+    default:                                return "Undefined Level";
+  } // switch
+} // Get_Detail_Level_Name
+
 /**
  * \brief Retrieve the string description matching the_detail_level
  * @param the_detail_level - IN - if it's not defined, then "Undefined Level" is 
@@ -185,54 +273,7 @@ Error_Code  A4_Lib::Logger::Get_Detail_Level_String (A4_Lib::Logging::Detail  th
 { // begin
   Method_State_Block_Begin(1)
     State(1)  
-      the_string.clear();
-  
-      switch (the_detail_level)
-      { // begin
-        case A4_Lib::Logging::Private_Comment:
-          the_string = "Comment";
-        break;
-        
-        case A4_Lib::Logging::Off:
-          the_string = "Off";
-        break;
-
-        case A4_Lib::Logging::Error:
-          the_string = "ERROR";
-        break;
-
-        case A4_Lib::Logging::Warning:
-          the_string = "WARNING";
-        break;
-
-        case A4_Lib::Logging::Info:
-          the_string = "INFO";
-        break;
-
-        case A4_Lib::Logging::Module_Specific:
-          the_string = "Module-Specific Info";
-        break;
-
-        case A4_Lib::Logging::Debug:
-          the_string = "DEBUG";
-        break;
-
-        case A4_Lib::Logging::Dump_Start:
-          the_string = "CONTENT DUMP BEGIN";
-        break;
-
-        case A4_Lib::Logging::Dump_End:
-          the_string = "CONTENT DUMP END";
-        break;
-
-        case A4_Lib::Logging::Content_Dump:
-         the_string = "CONTENT DUMP";
-        break;
-
-        default:
-          the_string = "Undefined Level";
-        break;        
-      } // switch
+      the_string = Get_Detail_Level_Name (the_detail_level);
     End_State
   End_Method_State_Block
 
@@ -32,13 +32,46 @@
  */
 
 #include "A4_Lib_Base.hh"
+#include <atomic>
 #include <memory>
 
 
 #define App_Log A4_Lib::Logger::Instance() /**< App_Log->Write versus A4_Lib::Logger::Instance()->Write */
 
+/**
+ * \brief The most detailed level compiled in - A4_Log and A4_Module_Log calls above it compile to nothing.
+ *        e.g. -DA4_Log_Max_Compiled_Detail=4 leaves Info, Warning and Error in a release build.
+ */
+#ifndef A4_Log_Max_Compiled_Detail
+#define A4_Log_Max_Compiled_Detail  A4_Lib::Logging::Content_Dump
+#endif
+
+/**
+ * \brief App_Log->Write (variadic) - the arguments are not evaluated unless the_detail is being logged.
+ */
+#define A4_Log(the_detail, ...) \
+  do { \
+    if (((the_detail) <= A4_Log_Max_Compiled_Detail) && (A4_Lib::Logger::Is_Enabled(the_detail) == true)) \
+      (void) App_Log->Write((the_detail), __VA_ARGS__); \
+  } while (false)
+
+/**
+ * \brief A4_Log at the detail level set for the_module_id - see Logger::Set_Module_Detail_Level.
+ */
+#define A4_Module_Log(the_module_id, the_detail, ...) \
+  do { \
+    if (((the_detail) <= A4_Log_Max_Compiled_Detail) && (A4_Lib::Logger::Is_Enabled((the_detail), (the_module_id)) == true)) \
+      (void) App_Log->Write((the_module_id), (the_detail), __VA_ARGS__); \
+  } while (false)
+
 namespace A4_Lib
 { // begin
+  namespace Logger_Constant
+  { // begin
+    static const std::size_t      Max_Filtered_Modules = 256; /**< Module_IDs below this can have a detail level of their own */
+    static const Logging::Detail  Unfiltered = 0xFF; /**< the module logs at the Logger's detail level */
+  } // namespace Logger_Constant
+
   typedef class Logger
   { // begin
     protected: // construction
@@ -58,16 +91,50 @@ namespace A4_Lib
                                             std::string        the_calling_function_name,  
                                             Error_Code         the_error,
                                             Method_State       the_state,
-                                            Logging::Detail    the_message_detail_level);  
+                                            Logging::Detail    the_message_detail_level,
+                                            std::int64_t       the_nano_seconds = 0); // when the error happened, system clock - 0 means now
 
      A4_Export virtual Error_Code    Write (Logging::Detail    the_message_detail_level,
-                                            std::string        the_log_text,
+                                            const char         *the_log_text, // printf style format
                                             ...);
      
      A4_Export virtual Error_Code Write (std::string       the_log_text,
                                          Logging::Detail   the_message_detail_level);
      
+     A4_Export virtual Error_Code    Write (Module_ID          the_module_id, // filtered by the module's detail level
+                                            Logging::Detail    the_message_detail_level,
+                                            const char         *the_log_text,
+                                            ...);
+     
      A4_Export Logging::Detail  Get_Detail_Level (void) const;
+     A4_Export void             Set_Detail_Level (Logging::Detail  the_detail_level);
+     
+     A4_Export Error_Code       Set_Module_Detail_Level (Module_ID        the_module_id,
+                                                         Logging::Detail  the_detail_level); // Unfiltered to follow Set_Detail_Level again
+     A4_Export Logging::Detail  Get_Module_Detail_Level (Module_ID  the_module_id) const; // Unfiltered when not set
+     
+     /**
+      * \brief Would a line at the_detail be written? Module_Specific lines always are.
+      */
+     static bool  Is_Enabled (Logging::Detail  the_detail) noexcept
+     { // begin
+       return (the_detail <= log_detail_level.load(std::memory_order_relaxed)) || (the_detail == Logging::Module_Specific);
+     } // Is_Enabled
+     
+     /**
+      * \brief Would a line at the_detail from the_module_id be written?
+      */
+     static bool  Is_Enabled (Logging::Detail  the_detail,
+                              Module_ID        the_module_id) noexcept
+     { // begin
+       Logging::Detail  the_module_level = (the_module_id < Logger_Constant::Max_Filtered_Modules) ? module_detail_levels [the_module_id].load(std::memory_order_relaxed)
+                                                                                                     : Logger_Constant::Unfiltered;
+       
+       if (the_module_level == Logger_Constant::Unfiltered)
+         return Is_Enabled(the_detail);
+       
+       return (the_detail <= the_module_level) || (the_detail == Logging::Module_Specific);
+     } // Is_Enabled
      
       virtual Error_Code  Open (void);
       virtual Error_Code  Close(void);
@@ -77,8 +144,11 @@ namespace A4_Lib
       Error_Code  Get_Detail_Level_String (Logging::Detail  the_detail_level, // in
                                            std::string      &the_string); // out
       
+      static const char *   Get_Detail_Level_Name (Logging::Detail  the_detail_level) noexcept; // static text - as Get_Detail_Level_String
+      
     private: // data
-      Logging::Detail   log_detail_level; /**< The maximum logging detail level that will be written. */
+      static std::atomic<Logging::Detail>   log_detail_level; /**< The maximum logging detail level that will be written - one Logger singleton */
+      static std::atomic<Logging::Detail>   module_detail_levels [Logger_Constant::Max_Filtered_Modules]; /**< per Module_ID - Unfiltered or its own maximum */
 
       bool              is_open; /**< if \b true, the log is open for business */
 
@@ -91,6 +161,8 @@ namespace A4_Lib
         C_Already_Closed                        = 3, /**< Instance is already closed or was never open. */
         W_Not_Implemented2                      = 4, /**< method Write must be overridden in the subclass, not called here. */
         W_Not_Implemented3                      = 5, /**< method Write must be overridden in the subclass, not called here. */
+        W_Not_Implemented4                      = 6, /**< method Write (module) must be overridden in the subclass, not called here. */
+        SMDL_Invalid_Module_ID                  = 7, /**< \b Set_Module_Detail_Level: Invalid parameter value - the_module_id is not below Max_Filtered_Modules. */
       }; // Logger_Errors
   } Logger;
 } // namespace A4_Lib
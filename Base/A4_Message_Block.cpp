@@ -216,7 +216,7 @@ Error_Code Message_Block::Set_Data (std::uint8_t   the_data,
 Error_Code Message_Block::Get_Data (std::uint16_t  &the_data,
                                     Vector_Offset  the_vector_offset)
 { // begin
-  Method_State_Block_Begin(2)
+  Method_State_Block_Begin(1)
     State(1) 
       the_method_error = Get_Data_T<std::uint16_t, Message_Block_Constants::Get_Uint16_Error_Offset>(the_data, the_vector_offset, this->data_vector, this->data_length_vector, *this);
     End_State
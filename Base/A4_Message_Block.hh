@@ -28,6 +28,7 @@
  */
 
 #include "A4_Lib_Module_ID.hh"
+#include "A4_Tracer.hh"
 #include <memory>
 #include <deque>
 
@@ -132,6 +133,12 @@ namespace A4_Lib
 
     std::size_t    Data_Length(Vector_Offset  the_vector_offset) const;
 
+    void            Set_Enqueue_Time (std::int64_t   the_nano_seconds) {this->enqueue_time = the_nano_seconds;}; // set by Message_Queue::Enqueue
+    std::int64_t    Get_Enqueue_Time (void) const {return this->enqueue_time;};
+
+    void                    Set_Trace_Context (const Trace_Context   &the_context) {this->trace_context = the_context;}; // set by Message_Queue::Enqueue while tracing
+    const Trace_Context &   Get_Trace_Context (void) const {return this->trace_context;};
+
   private: // data
     Message_Block::Data_Vector          data_vector; /**< container of shared data pointers */
     
@@ -139,6 +146,10 @@ namespace A4_Lib
 
     Message_Block::Pointer              child; /**< nested message block - for use cases involving aggregated classes */
 
+    std::int64_t                        enqueue_time = 0; /**< monotonic nano-seconds - the queue wait statistics of the Active_Object */
+
+    Trace_Context                       trace_context; /**< the producer's trace - continued by Active_Object::Dispatch */
+
   public: // errors
     enum Message_Block_Errors
     { // begin
@@ -31,6 +31,8 @@
 #endif
 
 #include "A4_Method_State_Block.hh"
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Error_Catalogue.hh"
 #include "A4_Message_Queue.hh"
 #include "A4_Utils.hh"
 
@@ -66,9 +68,43 @@ Message_Queue::~Message_Queue(void)
  */
 bool  Message_Queue::Is_Empty(void)
 { // begin
-  return this->msg_queue.empty();
+  return ((this->msg_queue.empty() == true) && (this->request_queue.empty() == true));
 } // Is_Empty
 
+/**
+ * \brief Retrieve the number of queued message blocks
+ */
+std::size_t   Message_Queue::Size(void)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock(this->condition_mutex);
+
+  return this->msg_queue.size();
+} // Size
+
+/**
+ * \brief Retrieve the message block limit set by Initialize
+ */
+std::size_t   Message_Queue::Max_Size(void) const
+{ // begin
+  return this->max_queued_items;
+} // Max_Size
+
+/**
+ * \brief Wait until the queue has room for another message block.
+ * @param the_max_milli_seconds_to_wait - IN
+ * @return \b true if there is room, \b false on a timeout or when the queue is not activated.
+ * @note  Another producer may take the room first - Enqueue still applies the limit.
+ */
+bool  Message_Queue::Wait_For_Space(std::int64_t    the_max_milli_seconds_to_wait)
+{ // begin
+  std::unique_lock<std::mutex>  the_lock(this->condition_mutex);
+
+  (void) this->space_condition.wait_for(the_lock, std::chrono::duration<std::int64_t, std::milli>(the_max_milli_seconds_to_wait), 
+                                        [this] () {return ((this->msg_queue.size() < this->max_queued_items) || (this->is_activated != true));});
+
+  return ((this->is_activated == true) && (this->msg_queue.size() < this->max_queued_items));
+} // Wait_For_Space
+
 
 /// @brief  Allocate a new Message_Queue::Pointer
 /// \param the_new_queue - IN - nullptr - OUT - the new instance
@@ -78,14 +114,14 @@ Error_Code   Message_Queue::Allocate (Message_Queue::Pointer    &the_new_queue)
    Method_State_Block_Begin(2)
     State(1)  
       if (the_new_queue != nullptr)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, A_Invalid_Initial_State, "Invalid parameter state - the_new_queue must equal nullptr - memory leak?");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, A_Invalid_Initial_State);
     End_State
      
     State(2)
       the_new_queue = std::make_shared<Message_Queue>();
     
       if (the_new_queue == nullptr)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, A_Allocation_Error, "Memory allocation error - could not allocate a new Message_Queue instance.");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, A_Allocation_Error);
     End_State
   End_Method_State_Block
     
@@ -102,12 +138,12 @@ Error_Code    Message_Queue::Initialize (std::size_t    the_maximum_queued_items
   Method_State_Block_Begin(3)
     State(1)  
       if (this->Is_Initialized() == true)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, I_Already_Initialized, "Instance is already initialized.");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, I_Already_Initialized);
     End_State
     
     State(2)
       if (the_maximum_queued_items < 1)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, I_Invalid_Max_Value, "Invalid parameter value - the_maximum_queued_items should be set to a non-zero value.");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, I_Invalid_Max_Value);
       else this->max_queued_items = the_maximum_queued_items;
     End_State
       
@@ -140,6 +176,14 @@ Error_Code    Message_Queue::Set_Activation_State(bool    the_new_state)
   if (the_new_state == true) // <-- why test? don't want un-initialized values being used.
     this->is_activated = true;
   else this->is_activated = false;
+
+  { // begin - release blocked producers & consumers so they can see the new state
+    std::lock_guard<std::mutex>   the_lock(this->condition_mutex);
+
+    this->space_condition.notify_all();
+    this->request_space_condition.notify_all();
+    this->access_condition.notify_all();
+  } // end
   
   return No_Error; // perhaps we should return an error is an un-initialized value is detected...
 } // Set_Activation_State
@@ -168,43 +212,56 @@ Error_Code    Message_Queue::Enqueue (A4_Lib::Message_Block::Pointer    the_mess
   std::chrono::time_point<std::chrono::system_clock> the_stop_time = the_current_time + std::chrono::duration<std::int64_t, std::milli>(the_max_milli_seconds_to_wait);
   
   bool	  the_mutex_is_locked = false;
+  bool    is_full = false; /**< never for a high priority message */
 
   Method_State_Block_Begin(5)
     State(1)
       if (this->is_activated != true)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated, "Message queue is not in an Activated state - could not enqueue the message block.");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated);
     End_State
     
     State(2) 
       if ((the_message_block == nullptr) || (the_message_block.use_count() < 1))
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, EQ_Invalid_Address, "Invalid parameter address - the_message_block is nullptr");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Invalid_Address);
     End_State
     
     State(3)
       if (the_max_milli_seconds_to_wait < 0)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, EQ_Negative_Time, "Invalid parameter value - the_max_milli_seconds_to_wait < 0");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Negative_Time);
     End_State
       
     State(4)
       the_current_time = std::chrono::system_clock::now();
     
     // it's possible that the message queue is full. We can wait for a until the timeout for room to appear.
-      while ((this->msg_queue.size() >= this->max_queued_items) && (the_current_time < the_stop_time) && (this->is_activated == true) && (is_high_prio_prepend == false))
-      { // wait until the number of items drops below the max or the timeout is exceeded
-        A4_Lib::Sleep_MS(50); // perhaps this is too long?
-        the_current_time = std::chrono::system_clock::now();
-      } // while
+      if (is_high_prio_prepend == false)
+      { // wait until the number of items drops below the max or the timeout is exceeded - Dequeue signals the space_condition
+        std::unique_lock<std::mutex>  the_lock(this->condition_mutex);
+
+        while ((this->msg_queue.size() >= this->max_queued_items) && (the_current_time < the_stop_time) && (this->is_activated == true))
+        { // begin
+          (void) this->space_condition.wait_until(the_lock, the_stop_time);
+          the_current_time = std::chrono::system_clock::now();
+        } // while
+
+        is_full = (this->msg_queue.size() >= this->max_queued_items); // under the lock - another producer may fill the space once it is released
+      } // if then
     
-      if ((msg_queue.size() >= this->max_queued_items) && (is_high_prio_prepend == false))
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, EQ_Timeout2, "Could not Enqueue the message block within the allotted time.");
+      if (is_full == true)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Timeout2);
       else the_method_error = this->deque_mutex.Lock(the_mutex_is_locked);
     End_State
       
     State(5)
       if (this->is_activated == true)
       { // insert the message
-        std::lock_guard<std::mutex>(this->condition_mutex);
+        std::lock_guard<std::mutex>   the_lock(this->condition_mutex); // named - an unnamed temporary unlocks immediately and the notify can be lost
         
+        the_message_block->Set_Enqueue_Time(A4_Lib::Monotonic_Nano_Seconds());
+
+        if (A4_Lib::Tracer::Is_Active() == true)
+          the_message_block->Set_Trace_Context(A4_Lib::Tracer::Send());
+
         if (is_high_prio_prepend == false)
           this->msg_queue.push_back(the_message_block); // will throw on failure      
         else this->msg_queue.push_front(the_message_block); // high priority message
@@ -215,7 +272,7 @@ Error_Code    Message_Queue::Enqueue (A4_Lib::Message_Block::Pointer    the_mess
 
 	the_method_error = this->deque_mutex.Unlock(the_mutex_is_locked);
       } // if then
-      else the_method_error = A4_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated2, "The message queue is no longer activated - message not inserted into the queue.");
+      else the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated2);
     End_State
   End_Method_State_Block
 
@@ -240,17 +297,17 @@ Error_Code    Message_Queue::Dequeue (A4_Lib::Message_Block::Pointer  &the_messa
   Method_State_Block_Begin(6)
     State(1)
       if (this->is_activated != true)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, DQ_Not_Activated, "Message queue is not in an Activated state - could not dequeue the message block.");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQ_Not_Activated);
     End_State
     
     State(2) 
       if (the_message_block != nullptr)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, DQ_Invalid_Input_Address, "Invalid parameter address - the_message_block is not nullptr, indicating a memory leak?");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQ_Invalid_Input_Address);
     End_State
       
     State(3)
       if (the_max_milli_seconds_to_wait < 0)
-        the_method_error = A4_Error (A4_Message_Queue_Module_ID, DQ_Negative_Time, "Invalid parameter value - the_max_milli_seconds_to_wait < 0");
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQ_Negative_Time);
     End_State     
       
     State(4)
@@ -275,6 +332,13 @@ Error_Code    Message_Queue::Dequeue (A4_Lib::Message_Block::Pointer  &the_messa
       // else another thread grabbed the message 
     
       the_method_error = this->deque_mutex.Unlock(the_mutex_is_locked);
+
+      if (the_message_block != nullptr)
+      { // room for a blocked producer
+        std::lock_guard<std::mutex>   the_lock(this->condition_mutex);
+
+        this->space_condition.notify_one();
+      } // if then
     End_State
   End_Method_State_Block
     
@@ -283,3 +347,136 @@ Error_Code    Message_Queue::Dequeue (A4_Lib::Message_Block::Pointer  &the_messa
 
   return the_method_error.Get_Error_Code(); 
 } // Dequeue
+
+
+/**
+ * \brief Insert a method request into the request lane
+ * @param the_request - IN - message queue becomes owner
+ * @param the_max_milli_seconds_to_wait - IN - how long to wait for room when the request lane is full - zero means don't wait, as in Enqueue
+ * @param is_high_prio_prepend - IN - if true, the request is pushed to the front of the lane without checking the limit.
+ */
+Error_Code    Message_Queue::Enqueue_Request (A4_Lib::Method_Request::Pointer   the_request,
+                                              std::int64_t                      the_max_milli_seconds_to_wait,
+                                              bool                              is_high_prio_prepend) 
+{ // begin
+  std::chrono::time_point<std::chrono::steady_clock> the_stop_time = std::chrono::steady_clock::now() + std::chrono::duration<std::int64_t, std::milli>(the_max_milli_seconds_to_wait);
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->is_activated != true)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQR_Not_Activated);
+    End_State
+    
+    State(2) 
+      if (the_request == nullptr)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQR_Invalid_Address);
+    End_State
+    
+    State(3)
+      if (the_max_milli_seconds_to_wait < 0)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQR_Negative_Time);
+    End_State
+      
+    State(4)
+      std::unique_lock<std::mutex>  the_lock(this->condition_mutex);
+
+      // a full lane is drained by the worker threads, which signal the request_space_condition as they dequeue
+      while ((this->request_queue.size() >= this->max_queued_items) && (this->is_activated == true) && (is_high_prio_prepend == false))
+        if (this->request_space_condition.wait_until(the_lock, the_stop_time) == std::cv_status::timeout)
+          break; // zero - no wait, as in Enqueue
+
+      if (this->is_activated != true)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQR_Not_Activated);
+      else if ((this->request_queue.size() >= this->max_queued_items) && (is_high_prio_prepend == false))
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQR_Timeout);
+      else
+      { // insert the request
+        the_request->Set_Enqueue_Time(A4_Lib::Monotonic_Nano_Seconds());
+
+        if (A4_Lib::Tracer::Is_Active() == true)
+          the_request->Set_Trace_Context(A4_Lib::Tracer::Send());
+
+        if (is_high_prio_prepend == false)
+          this->request_queue.push_back(std::move(the_request)); // will throw on failure      
+        else this->request_queue.push_front(std::move(the_request));
+
+        this->access_condition.notify_one(); // only consumers wait on the access_condition
+      } // else
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();    
+} // Enqueue_Request
+
+
+/**
+ * \brief   Remove either a method request or a message block from the queue - method requests are served first
+ * @param the_message_block - IN - must be nullptr, OUT - the address of a Message_Block or nullptr
+ * @param the_request - IN - must be nullptr, OUT - the address of a Method_Request or nullptr
+ * @param the_max_milli_seconds_to_wait - IN - the longest time to wait for either to arrive
+ * @note  at most one of the OUT parameters is set; both remain nullptr on a timeout.
+ */
+Error_Code    Message_Queue::Dequeue (A4_Lib::Message_Block::Pointer  &the_message_block,
+                                      A4_Lib::Method_Request::Pointer &the_request,
+                                      std::int64_t                    the_max_milli_seconds_to_wait)
+{ // begin
+  bool	the_mutex_is_locked = false;
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->is_activated != true)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQR_Not_Activated);
+    End_State
+    
+    State(2) 
+      if ((the_message_block != nullptr) || (the_request != nullptr))
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQR_Invalid_Input_Address);
+    End_State
+      
+    State(3)
+      if (the_max_milli_seconds_to_wait < 0)
+        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, DQR_Negative_Time);
+    End_State     
+      
+    State(4)
+      std::unique_lock<std::mutex>  the_lock(this->condition_mutex);
+
+      if ((this->request_queue.empty() == true) && (this->msg_queue.empty() == true))
+        (void) this->access_condition.wait_for(the_lock, std::chrono::duration<std::int64_t, std::milli>(the_max_milli_seconds_to_wait));
+
+      if (this->request_queue.empty() != true)
+      { // requests never touch the deque_mutex - they are guarded by the condition_mutex alone
+        the_request = std::move(this->request_queue.front());
+        this->request_queue.pop_front();
+
+        this->request_space_condition.notify_one(); // room for a waiting Enqueue_Request
+      } // if then
+      else if (this->msg_queue.empty() != true)
+      { // get the available message
+        the_lock.unlock(); // Enqueue takes the deque_mutex before the condition_mutex - keep the same order
+
+        the_method_error = this->deque_mutex.Lock(the_mutex_is_locked);
+
+        if ((the_method_error.Get_Error_Code() == No_Error) && (this->msg_queue.size() > 0) && (this->msg_queue.front() != nullptr))
+        { // else another thread grabbed the message
+          the_message_block = this->msg_queue.front();  
+          this->msg_queue.pop_front();
+        } // if then
+
+        if (the_mutex_is_locked == true)
+          the_method_error = this->deque_mutex.Unlock(the_mutex_is_locked);
+
+        if (the_message_block != nullptr)
+        { // room for a blocked producer
+          the_lock.lock();
+          this->space_condition.notify_one();
+        } // if then
+      } // else if
+    End_State
+  End_Method_State_Block
+    
+  if (the_mutex_is_locked == true)
+    (void) this->deque_mutex.Unlock(the_mutex_is_locked);
+
+  return the_method_error.Get_Error_Code(); 
+} // Dequeue (request)
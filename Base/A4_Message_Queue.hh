@@ -2,6 +2,7 @@
 #define __A4_Message_Queue_Defined__
 
 #include "A4_Message_Block.hh"
+#include "A4_Method_Request.hh"
 
 #ifndef A4_DotNet
 #include "A4_Recursive_Mutex.hh"
@@ -58,23 +59,39 @@ namespace A4_Lib
     Error_Code    Initialize (size_t    the_maximum_queued_items);
 
     Error_Code    Enqueue (A4_Lib::Message_Block::Pointer   the_message_block,// by value
-                           std::int64_t                     the_max_milli_seconds_to_wait = 0, // zero means wait forever
+                           std::int64_t                     the_max_milli_seconds_to_wait = 0, // zero means don't wait
                            bool                             is_high_prio_prepend = false); // true means: 1) the limit is bypassed, 2) the message is pushed front
 
     Error_Code    Dequeue (A4_Lib::Message_Block::Pointer   &the_message_block, // caller becomes owner
-                           std::int64_t                     the_max_milli_seconds_to_wait = 0);// zero means wait forever
+                           std::int64_t                     the_max_milli_seconds_to_wait = 0); // zero means don't wait
+
+    Error_Code    Enqueue_Request (A4_Lib::Method_Request::Pointer  the_request, // by value
+                                   std::int64_t                     the_max_milli_seconds_to_wait = 0, // zero means don't wait
+                                   bool                             is_high_prio_prepend = false);
+
+    Error_Code    Dequeue (A4_Lib::Message_Block::Pointer   &the_message_block, // caller becomes owner of either, 
+                           A4_Lib::Method_Request::Pointer  &the_request, // method requests are served first
+                           std::int64_t                     the_max_milli_seconds_to_wait = 0);
 
     Error_Code    Set_Activation_State(bool    the_new_state);
 
     bool          Is_Empty(void);
     bool          Is_Activated(void) const;
+
+    std::size_t   Size(void); // queued message blocks - method requests are not counted
+    std::size_t   Max_Size(void) const;
+
+    bool          Wait_For_Space(std::int64_t   the_max_milli_seconds_to_wait); // true once a message block could be enqueued without waiting
     bool          Is_Initialized(void) const;
 
 #ifndef A4_DotNet
   private: //data
     std::deque<A4_Lib::Message_Block::Pointer>  msg_queue; /**< queue used as a FIFO - with high priority messages enqueued to the front */
+    std::deque<A4_Lib::Method_Request::Pointer> request_queue; /**< method requests - a separate lane so no Message_Block is needed per call */
 
     std::condition_variable                     access_condition; /**< allows for a time-limited blocking of the Deque_Message method.*/
+    std::condition_variable                     space_condition; /**< signalled when a message block is dequeued - wakes producers blocked on a full queue */
+    std::condition_variable                     request_space_condition; /**< signalled when a method request is dequeued - wakes producers blocked on a full request lane */
     std::mutex                                  condition_mutex; /**< used in conjunction with the access_condition */
     A4_Lib::Recursive_Mutex		        deque_mutex; /**< allows thread-safe en/dequing of Message_Blocks */
 
@@ -94,11 +111,18 @@ namespace A4_Lib
       EQ_Timeout2                     = 4, /**< \b Enqueue: Could not Enqueue the message block within the allotted time. */
       EQ_Not_Activated                = 5, /**< \b Enqueue: Message queue is not in an Activated state - could not enqueue the message block. */
       DQ_Not_Activated                = 6, /**< \b Dequeue: Message queue is not in an Activated state - could not dequeue the message block. */
-      DQ_Invalid_Input_Address        = 7, /**< \b Dequeue: Message queue is not in an Activated state - could not dequeue the message block. */
+      DQ_Invalid_Input_Address        = 7, /**< \b Dequeue: Invalid parameter address - the_message_block is not nullptr, indicating a memory leak? */
       DQ_Negative_Time                = 8, /**< \b Dequeue: Invalid parameter value - the_max_milli_seconds_to_wait < 0 */
       I_Already_Initialized           = 9, /**< \b Initialize: Instance is already initialized. */
       I_Invalid_Max_Value             = 10, /**< \b Initialize: Invalid parameter value - the_maximum_queued_items should be set to a non-zero value. */
       A_Invalid_Initial_State         = 11, /**< \b Allocate: Invalid parameter state - the_new_queue must equal nullptr - memory leak? */
+      EQR_Invalid_Address             = 12, /**< \b Enqueue_Request: Invalid parameter address - the_request is nullptr */
+      EQR_Not_Activated               = 13, /**< \b Enqueue_Request: Message queue is not in an Activated state - could not enqueue the method request. */
+      EQR_Negative_Time               = 14, /**< \b Enqueue_Request: Invalid parameter value - the_max_milli_seconds_to_wait < 0 */
+      EQR_Timeout                     = 15, /**< \b Enqueue_Request: Could not Enqueue the method request within the allotted time. */
+      DQR_Not_Activated               = 16, /**< \b Dequeue (request): Message queue is not in an Activated state - could not dequeue. */
+      DQR_Invalid_Input_Address       = 17, /**< \b Dequeue (request): Invalid parameter address - the_message_block or the_request is not nullptr, indicating a memory leak? */
+      DQR_Negative_Time               = 18, /**< \b Dequeue (request): Invalid parameter value - the_max_milli_seconds_to_wait < 0 */
     }; // Message_Queue_Errors
   }Message_Queue;
 }// namespace A4_Lib
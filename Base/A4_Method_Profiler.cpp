@@ -0,0 +1,277 @@
+/**
+ * @brief   Method State Block profiler implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Method_Profiler.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Method_Profiler.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <new>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief Plain counters - the totals of exited threads, and the merge buffer of Get_Profile.
+   */
+  typedef struct Profile_Totals
+  { // begin
+    std::uint64_t   calls = 0;
+    std::uint64_t   ticks = 0;
+    std::uint64_t   errors = 0;
+  } Profile_Totals;
+
+  typedef std::vector<Profile_Totals>   Profile_Totals_Vector;
+
+  /**
+   * @brief One thread's counters - written only by that thread, freed (after merging) when it exits.
+   */
+  typedef class Method_Profile_Table
+  { // begin
+  public: // construction
+    Method_Profile_Table (void);
+    ~Method_Profile_Table (void);
+
+  public: // data
+    std::array<std::atomic<Method_State_Profile *>, Method_Profiler_Constant::Max_Profiled_Methods>   sites = {}; /**< by site_id - [0] method + [1..num_states] */
+  } Method_Profile_Table;
+
+  /**
+   * @brief The sites, the live tables and the totals of exited threads - guarded by mutex.
+   */
+  typedef struct Method_Profile_Registry
+  { // begin
+    std::mutex                            mutex;
+    std::vector<Method_Profile_Site *>    sites; /**< by site_id */
+    std::vector<Method_Profile_Table *>   tables; /**< live threads */
+    std::vector<Profile_Totals_Vector>    retired; /**< by site_id - exited threads */
+  } Method_Profile_Registry;
+
+  /**
+   * @brief Retrieve the registry - never destroyed, so threads exiting during shutdown can still retire their tables.
+   */
+  Method_Profile_Registry &   Registry (void)
+  { // begin
+    static Method_Profile_Registry  *the_registry = new Method_Profile_Registry();
+
+    return *the_registry;
+  } // Registry
+
+  thread_local Method_Profile_Table   the_thread_table; /**< constructed on the first profiled block of each thread */
+
+  /**
+   * @brief Register this thread's table.
+   */
+  Method_Profile_Table::Method_Profile_Table (void)
+  { // begin
+    Method_Profile_Registry   &the_registry = Registry();
+    std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+    the_registry.tables.push_back(this);
+  } // constructor
+
+  /**
+   * @brief Move this thread's counters into the retired totals and unregister.
+   */
+  Method_Profile_Table::~Method_Profile_Table (void)
+  { // begin
+    Method_Profile_Registry   &the_registry = Registry();
+    std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+    for (std::size_t the_site = 0; the_site < the_registry.sites.size(); the_site++)
+    { // begin
+      Method_State_Profile  *the_profile = this->sites [the_site].load(std::memory_order_relaxed);
+
+      if (the_profile == nullptr)
+        continue;
+
+      for (std::size_t the_index = 0; the_index < the_registry.retired [the_site].size(); the_index++)
+      { // begin
+        the_registry.retired [the_site][the_index].calls += the_profile [the_index].calls.Get();
+        the_registry.retired [the_site][the_index].ticks += the_profile [the_index].ticks.Get();
+        the_registry.retired [the_site][the_index].errors += the_profile [the_index].errors.Get();
+      } // for
+
+      delete [] the_profile;
+    } // for
+
+    the_registry.tables.erase(std::remove(the_registry.tables.begin(), the_registry.tables.end(), this), the_registry.tables.end());
+  } // destructor
+} // namespace
+
+/**
+ * @brief Register a profiled method.
+ * @param the_function_name - IN - static - This_Function_Name
+ * @param the_max_states - IN - the Method State Block max_states
+ */
+Method_Profile_Site::Method_Profile_Site (const char    *the_function_name,
+                                          Method_State  the_max_states) noexcept
+: function_name(the_function_name), num_states(std::min<std::size_t>(the_max_states, Method_Profiler_Constant::Max_Profiled_States)),
+  site_id(Method_Profiler_Constant::Max_Profiled_Methods)
+{ // begin
+  Method_Profile_Registry   &the_registry = Registry();
+  std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+  if (the_registry.sites.size() >= Method_Profiler_Constant::Max_Profiled_Methods)
+    return;
+
+  try
+  { // begin
+    the_registry.retired.emplace_back(this->num_states + 1);
+    the_registry.sites.push_back(this);
+
+    this->site_id = the_registry.sites.size() - 1;
+  } // try
+  catch (...)
+  { // begin
+    the_registry.retired.resize(the_registry.sites.size()); // not profiled
+  } // catch
+} // constructor
+
+/**
+ * @brief Retrieve this thread's counters for the site - allocated on its first call on the thread.
+ */
+Method_State_Profile *  Method_Profile_Site::Thread_Profile (void) noexcept
+{ // begin
+  Method_State_Profile  *the_profile = nullptr;
+
+  if (this->site_id >= Method_Profiler_Constant::Max_Profiled_Methods)
+    return nullptr;
+
+  if ((the_profile = the_thread_table.sites [this->site_id].load(std::memory_order_relaxed)) == nullptr)
+  { // begin
+    if ((the_profile = new (std::nothrow) Method_State_Profile [this->num_states + 1]) != nullptr)
+      the_thread_table.sites [this->site_id].store(the_profile, std::memory_order_release);
+  } // if then
+
+  return the_profile;
+} // Thread_Profile
+
+/**
+ * @brief Merge the counters of every thread - one row per profiled method and one per state that was entered.
+ * @param the_profile - OUT - must be empty - sorted by ticks, highest first
+ */
+Error_Code  Method_Profiler::Get_Profile (Method_Profile_Vector  &the_profile)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_profile.empty() == false)
+        the_method_error = A4_Error (A4_Method_Profiler_Module_ID, GP_Invalid_Output_State, "Invalid parameter state - the_profile must be empty.");
+    End_State
+
+    State(2)
+      Method_Profile_Registry   &the_registry = Registry();
+      std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+      for (std::size_t the_site = 0; the_site < the_registry.sites.size(); the_site++)
+      { // begin
+        Profile_Totals_Vector   the_totals = the_registry.retired [the_site];
+
+        for (Method_Profile_Table *the_table : the_registry.tables)
+        { // begin
+          Method_State_Profile  *the_counters = the_table->sites [the_site].load(std::memory_order_acquire);
+
+          if (the_counters == nullptr)
+            continue;
+
+          for (std::size_t the_index = 0; the_index < the_totals.size(); the_index++)
+          { // begin
+            the_totals [the_index].calls += the_counters [the_index].calls.Get();
+            the_totals [the_index].ticks += the_counters [the_index].ticks.Get();
+            the_totals [the_index].errors += the_counters [the_index].errors.Get();
+          } // for
+        } // for
+
+        for (std::size_t the_index = 0; the_index < the_totals.size(); the_index++)
+        { // begin
+          Method_Profile_Entry  the_entry;
+
+          if ((the_totals [the_index].calls == 0) && (the_totals [the_index].errors == 0))
+            continue;
+
+          the_entry.function_name = the_registry.sites [the_site]->Get_Function_Name();
+          the_entry.state = static_cast<Method_State>(the_index);
+          the_entry.calls = the_totals [the_index].calls;
+          the_entry.ticks = the_totals [the_index].ticks;
+          the_entry.errors = the_totals [the_index].errors;
+
+          the_profile.push_back(the_entry);
+        } // for
+      } // for
+
+      std::sort(the_profile.begin(), the_profile.end(), [](const Method_Profile_Entry &the_left, const Method_Profile_Entry &the_right) {return the_left.ticks > the_right.ticks;});
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Get_Profile
+
+/**
+ * @brief Write the hottest rows of Get_Profile to the application log.
+ * @param the_max_entries - IN - rows to write
+ * @param the_detail_level - IN
+ */
+Error_Code  Method_Profiler::Log_Profile (std::size_t       the_max_entries,
+                                          Logging::Detail   the_detail_level)
+{ // begin
+  Method_Profile_Vector   the_profile;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (App_Log->Is_Open() == false)
+        the_method_error = A4_Error (A4_Method_Profiler_Module_ID, LP_Log_Not_Open, "The application log is not open.");
+    End_State
+
+    State(2)
+      the_method_error = Method_Profiler::Get_Profile(the_profile);
+    End_State
+
+    State(3)
+      (void) App_Log->Write(the_detail_level, "Method profile - %zu rows, ticks are %s", the_profile.size(),
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+                            "CPU cycles");
+#else
+                            "nano-seconds");
+#endif
+
+      for (std::size_t the_row = 0; (the_row < the_profile.size()) && (the_row < the_max_entries); the_row++)
+        (void) App_Log->Write(the_detail_level, "  %s state=%d calls=%llu ticks=%llu (%llu per call) errors=%llu", the_profile [the_row].function_name.c_str(),
+                              static_cast<int>(the_profile [the_row].state), static_cast<unsigned long long>(the_profile [the_row].calls),
+                              static_cast<unsigned long long>(the_profile [the_row].ticks),
+                              static_cast<unsigned long long>(the_profile [the_row].ticks / std::max<std::uint64_t>(the_profile [the_row].calls, 1)),
+                              static_cast<unsigned long long>(the_profile [the_row].errors));
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Log_Profile
@@ -0,0 +1,225 @@
+#ifndef __A4_Method_Profiler_Defined__
+#define __A4_Method_Profiler_Defined__
+/**
+ * @brief   Per-method, per-state profiler built into the Method State Block macros.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Method_Profiler.hh
+ * @note  Opt-in - compile with \b A4_Method_State_Profiling defined and every Method_State_Block / Fast_State_Block records
+ *        the calls, ticks and errors of the method and of each of its states. Ticks are read with rdtsc on x86 (CPU cycles)
+ *        and from std::chrono::steady_clock (nano-seconds) elsewhere.
+ *
+ *        Every thread owns its table and is its only writer (a relaxed load and store per counter). Method_Profiler::Get_Profile
+ *        merges the tables of the live threads with the totals of the threads that have exited.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Error.hh"
+
+#ifndef A4_DotNet
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Method_Profiler_Constant
+  { // begin
+    static const std::size_t  Max_Profiled_Methods = 4096; /**< methods beyond this are not profiled */
+    static const std::size_t  Max_Profiled_States = 256; /**< states above this are counted in the method total only */
+  } // namespace Method_Profiler_Constant
+
+  /**
+   * @brief Retrieve the profiler clock - CPU cycles on x86, otherwise steady_clock nano-seconds.
+   */
+  inline std::uint64_t  Profile_Ticks (void) noexcept
+  { // begin
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(Monotonic_Nano_Seconds());
+#endif
+  } // Profile_Ticks
+
+  /**
+   * @brief One aggregated row of Method_Profiler::Get_Profile.
+   */
+  typedef struct Method_Profile_Entry
+  { // begin
+    std::string     function_name;
+    Method_State    state = 0; /**< zero for the method as a whole */
+    std::uint64_t   calls = 0; /**< times the method was called, or the state entered */
+    std::uint64_t   ticks = 0; /**< see Profile_Ticks */
+    std::uint64_t   errors = 0; /**< blocks that ended with an error - in this state, for a state row */
+  } Method_Profile_Entry;
+
+  typedef std::vector<Method_Profile_Entry>   Method_Profile_Vector;
+
+#ifndef A4_DotNet
+  /**
+   * @brief The counters of one method, or of one of its states, on one thread.
+   */
+  typedef struct Method_State_Profile
+  { // begin
+    Worker_Counter  calls;
+    Worker_Counter  ticks;
+    Worker_Counter  errors;
+  } Method_State_Profile;
+
+  /**
+   * @brief A profiled method - a function-local static created by the first call of its Method State Block.
+   */
+  typedef class Method_Profile_Site
+  { // begin
+  public: // construction
+    A4_Export Method_Profile_Site (const char    *the_function_name,
+                                   Method_State  the_max_states) noexcept;
+
+  public: // methods
+    A4_Export Method_State_Profile *  Thread_Profile (void) noexcept; // this thread's [0] method + [1..num_states] state counters - nullptr when not profiled
+
+    const char *  Get_Function_Name (void) const noexcept {return this->function_name;};
+    std::size_t   Get_Num_States (void) const noexcept {return this->num_states;};
+
+  private: // data
+    const char      *function_name; /**< static - This_Function_Name */
+    std::size_t     num_states; /**< clamped to Max_Profiled_States */
+    std::size_t     site_id; /**< Max_Profiled_Methods when the registry is full */
+  } Method_Profile_Site;
+
+  /**
+   * @brief Times one run of a Method State Block - declared by Method_State_Block_Begin when profiling.
+   */
+  typedef class Method_Profile_Scope
+  { // begin
+  public: // construction
+    explicit Method_Profile_Scope (Method_Profile_Site  &the_site) noexcept
+    : profile(the_site.Thread_Profile()), num_states(the_site.Get_Num_States()), state(0), start_ticks(Profile_Ticks()), state_ticks(start_ticks) {};
+
+    ~Method_Profile_Scope (void) {this->End(this->state, A4_Error());}; // a return from inside a State - counted without an error
+
+  public: // methods
+    void  Enter_State (Method_State  the_state) noexcept;
+
+    void  End (Method_State     the_method_state,
+               const A4_Error   &the_method_error) noexcept;
+
+  private: // methods
+    std::size_t   Index_Of (Method_State  the_state) const noexcept;
+
+  private: // data
+    Method_State_Profile  *profile;
+    std::size_t           num_states;
+    Method_State          state; /**< the state being timed - zero before the first */
+    std::uint64_t         start_ticks;
+    std::uint64_t         state_ticks; /**< when state was entered */
+  } Method_Profile_Scope;
+
+  /**
+   * @brief Close the running state and start timing the_state.
+   */
+  inline void  Method_Profile_Scope::Enter_State (Method_State  the_state) noexcept
+  { // begin
+    std::uint64_t   the_now = Profile_Ticks();
+    std::size_t     the_index = 0;
+
+    if (this->profile == nullptr)
+      return;
+
+    if ((the_index = this->Index_Of(this->state)) != 0)
+      this->profile [the_index].ticks.Add(the_now - this->state_ticks);
+
+    if ((the_index = this->Index_Of(the_state)) != 0)
+      this->profile [the_index].calls.Increment();
+
+    this->state = the_state;
+    this->state_ticks = the_now;
+  } // Enter_State
+
+  /**
+   * @brief Close the running state and record the method - the error is charged to the state the block stopped in.
+   * @param the_method_state - IN - without the Terminate_The_Method_Block offset
+   */
+  inline void  Method_Profile_Scope::End (Method_State     the_method_state,
+                                          const A4_Error   &the_method_error) noexcept
+  { // begin
+    std::uint64_t   the_now = Profile_Ticks();
+    std::size_t     the_index = 0;
+
+    if (this->profile == nullptr)
+      return;
+
+    if ((the_index = this->Index_Of(this->state)) != 0)
+      this->profile [the_index].ticks.Add(the_now - this->state_ticks);
+
+    this->profile [0].calls.Increment();
+    this->profile [0].ticks.Add(the_now - this->start_ticks);
+
+    if (the_method_error != No_Error)
+    { // begin
+      this->profile [0].errors.Increment();
+
+      if ((the_index = this->Index_Of(the_method_state)) != 0)
+        this->profile [the_index].errors.Increment();
+    } // if then
+
+    this->profile = nullptr;
+  } // End
+
+  /**
+   * @brief Retrieve the counter index of the_state - zero when the state is not tracked.
+   */
+  inline std::size_t  Method_Profile_Scope::Index_Of (Method_State  the_state) const noexcept
+  { // begin
+    return ((the_state > 0) && (static_cast<std::size_t>(the_state) <= this->num_states)) ? static_cast<std::size_t>(the_state) : 0;
+  } // Index_Of
+#endif // A4_DotNet
+
+  /**
+   * @brief Aggregation of the per-thread tables.
+   */
+  typedef class Method_Profiler
+  { // begin
+  public: // methods
+    A4_Export static Error_Code   Get_Profile (Method_Profile_Vector  &the_profile); // sorted by ticks, highest first
+
+    A4_Export static Error_Code   Log_Profile (std::size_t              the_max_entries = 50,
+                                               Logging::Detail          the_detail_level = Logging::Info);
+
+  public: // errors
+    enum Method_Profiler_Errors
+    { // begin
+      GP_Invalid_Output_State       = 0, /**< \b Get_Profile: Invalid parameter state - the_profile must be empty. */
+      LP_Log_Not_Open               = 1, /**< \b Log_Profile: The application log is not open. */
+    }; // Method_Profiler_Errors
+  } Method_Profiler;
+} // namespace A4_Lib
+
+#endif // __A4_Method_Profiler_Defined__
@@ -0,0 +1,143 @@
+/**
+ * @brief   Method Request pool implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Method_Request.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Method_Request.hh"
+
+using namespace A4_Lib;
+
+/**
+ * @brief Default constructor
+ */
+Request_Pool::Request_Pool(void)
+{ // begin
+} // constructor
+
+/**
+ * @brief Default destructor - returns every pooled block to the heap
+ */
+Request_Pool::~Request_Pool(void)
+{ // begin
+  A4_Cleanup_Begin
+    for (std::size_t the_offset = 0; the_offset < this->free_blocks.size(); the_offset++)
+      ::operator delete (this->free_blocks[the_offset]);
+
+    this->free_blocks.clear();
+  A4_End_Cleanup
+} // destructor
+
+/// @brief  Allocate a new Request_Pool::Pointer
+/// @param the_new_pool - IN - nullptr - OUT - the new instance
+//
+Error_Code   Request_Pool::Allocate (Request_Pool::Pointer    &the_new_pool)
+{ // begin
+  Method_State_Block_Begin(2)
+    State(1)
+      if (the_new_pool != nullptr)
+        the_method_error = A4_Error (A4_Method_Request_Module_ID, A_Invalid_Initial_State, "Invalid parameter state - the_new_pool must equal nullptr - memory leak?");
+    End_State
+
+    State(2)
+      the_new_pool = std::make_shared<Request_Pool>();
+
+      if (the_new_pool == nullptr)
+        the_method_error = A4_Error (A4_Method_Request_Module_ID, A_Allocation_Error, "Memory allocation error - could not allocate a new Request_Pool instance.");
+      else the_new_pool->free_blocks.reserve(Method_Request_Constant::Max_Pooled_Blocks);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Allocate
+
+/**
+ * @brief Retrieve a block of at least the_number_of_bytes - pooled when it fits, from the heap otherwise.
+ * @param the_number_of_bytes - IN
+ * @return the block address - throws std::bad_alloc on failure (this is called by the standard library allocators).
+ */
+void *  Request_Pool::Get_Block (std::size_t  the_number_of_bytes)
+{ // begin
+  void  *the_block = nullptr;
+
+  if (the_number_of_bytes > Method_Request_Constant::Pool_Block_Size)
+    return ::operator new (the_number_of_bytes);
+
+  { // begin - pop a free block
+    std::lock_guard<std::mutex>   the_lock(this->pool_mutex);
+
+    if (this->free_blocks.empty() != true)
+    { // re-use
+      the_block = this->free_blocks.back();
+      this->free_blocks.pop_back();
+    } // if then
+  } // end - pop a free block
+
+  if (the_block == nullptr)
+    the_block = ::operator new (Method_Request_Constant::Pool_Block_Size);
+
+  return the_block;
+} // Get_Block
+
+/**
+ * @brief Return a block previously retrieved with Get_Block.
+ * @param the_block - IN
+ * @param the_number_of_bytes - IN - must match the Get_Block request
+ */
+void  Request_Pool::Release_Block (void         *the_block,
+                                   std::size_t  the_number_of_bytes) noexcept
+{ // begin
+  bool  is_pooled = false;
+
+  if (the_block == nullptr)
+    return;
+
+  if (the_number_of_bytes <= Method_Request_Constant::Pool_Block_Size)
+  { // begin - push the free block
+    std::lock_guard<std::mutex>   the_lock(this->pool_mutex);
+
+    if (this->free_blocks.size() < this->free_blocks.capacity()) // capacity is reserved by Allocate - push_back will not throw
+    { // keep it for the next request
+      this->free_blocks.push_back(the_block);
+      is_pooled = true;
+    } // if then
+  } // end - push the free block
+
+  if (is_pooled != true)
+    ::operator delete (the_block);
+} // Release_Block
+
+/**
+ * @brief Retrieve the number of blocks currently waiting for re-use.
+ */
+std::size_t   Request_Pool::Num_Free_Blocks (void)
+{ // begin
+  std::lock_guard<std::mutex>   the_lock(this->pool_mutex);
+
+  return this->free_blocks.size();
+} // Num_Free_Blocks
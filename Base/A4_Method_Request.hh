@@ -0,0 +1,258 @@
+#ifndef __A4_Method_Request_Defined__
+#define __A4_Method_Request_Defined__
+/**
+ * @brief   Method Request - a callable submitted to an Active_Object whose result is delivered through a std::future.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Method_Request.hh
+ * @note  The request and the promise shared state are both carved from a Request_Pool owned by the Active_Object,
+ *        so a round-trip does not touch the general purpose heap once the pool is warm.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Method_State_Block.hh"
+#include "A4_Tracer.hh"
+
+#ifndef A4_DotNet
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Method_Request_Constant
+  { // begin
+    static const std::size_t  Pool_Block_Size = 256; /**< bytes - requests (and promise states) larger than this bypass the pool */
+    static const std::size_t  Max_Pooled_Blocks = 1024; /**< released blocks beyond this count are returned to the heap */
+  } // namespace Method_Request_Constant
+
+#ifndef A4_DotNet
+  /**
+   * @brief Thread safe free-list of fixed size blocks - used to allocate Method_Requests and their promise shared state.
+   */
+  typedef class Request_Pool
+  { // begin
+  public: // construction
+    Request_Pool(void);
+    Request_Pool(Request_Pool &) = delete;
+    virtual ~Request_Pool(void);
+
+    Request_Pool & operator = (Request_Pool &) = delete;
+
+  public: // types
+    typedef std::shared_ptr<Request_Pool>  Pointer;
+
+  public: // methods
+    static Error_Code   Allocate (Request_Pool::Pointer   &the_new_pool);
+
+    void *  Get_Block (std::size_t  the_number_of_bytes); // throws std::bad_alloc - allocator semantics
+    void    Release_Block (void         *the_block,
+                           std::size_t  the_number_of_bytes) noexcept;
+
+    std::size_t   Num_Free_Blocks (void);
+
+  private: // data
+    std::vector<void *>   free_blocks; /**< blocks of Method_Request_Constant::Pool_Block_Size bytes ready for re-use */
+    std::mutex            pool_mutex; /**< guards free_blocks - held only for a push or pop */
+
+  public: // errors
+    enum Request_Pool_Errors
+    { // begin
+      A_Invalid_Initial_State   = 0, /**< \b Allocate: Invalid parameter state - the_new_pool must equal nullptr - memory leak? */
+      A_Allocation_Error        = 1, /**< \b Allocate: Memory allocation error - could not allocate a new Request_Pool instance. */
+    }; // Request_Pool_Errors
+  } Request_Pool;
+
+  /**
+   * @brief Standard allocator adapter over a Request_Pool - suitable for std::allocate_shared and std::promise.
+   * @note  The allocator shares ownership of the pool, so a future may safely outlive the Active_Object that fulfilled it.
+   */
+  template <typename The_Value_Type> class Request_Pool_Allocator
+  { // begin
+  public: // types
+    typedef The_Value_Type  value_type;
+
+  public: // construction
+    explicit Request_Pool_Allocator (Request_Pool::Pointer  the_pool) noexcept : pool(the_pool) {};
+
+    template <typename The_Other_Type>
+      Request_Pool_Allocator (const Request_Pool_Allocator<The_Other_Type>  &the_other) noexcept : pool(the_other.pool) {};
+
+  public: // methods
+    The_Value_Type *  allocate (std::size_t  the_count)
+    { // begin
+      return static_cast<The_Value_Type *>(this->pool->Get_Block(the_count * sizeof (The_Value_Type)));
+    } // allocate
+
+    void  deallocate (The_Value_Type  *the_block,
+                      std::size_t     the_count) noexcept
+    { // begin
+      this->pool->Release_Block(the_block, the_count * sizeof (The_Value_Type));
+    } // deallocate
+
+    template <typename The_Other_Type>
+      bool operator == (const Request_Pool_Allocator<The_Other_Type>  &the_other) const noexcept {return this->pool == the_other.pool;};
+
+    template <typename The_Other_Type>
+      bool operator != (const Request_Pool_Allocator<The_Other_Type>  &the_other) const noexcept {return this->pool != the_other.pool;};
+
+  public: // data - public for the converting constructor
+    Request_Pool::Pointer   pool; /**< the owning pool */
+  }; // Request_Pool_Allocator
+#endif // A4_DotNet
+
+  /**
+   * @brief  Type erased unit of work placed in a Message_Queue request lane and executed by an Active_Object worker thread.
+   */
+  typedef class Method_Request
+  { // begin
+  public: // construction
+    Method_Request(void) = default;
+    virtual ~Method_Request(void) = default;
+
+  public: // types
+    typedef std::shared_ptr<Method_Request>   Pointer;
+
+  public: // methods
+    virtual Error_Code  Call (void) = 0; /**< invoke the callable and fulfil the promise - called exactly once */
+
+    void            Set_Enqueue_Time (std::int64_t   the_nano_seconds) {this->enqueue_time = the_nano_seconds;}; // set by Message_Queue::Enqueue_Request
+    std::int64_t    Get_Enqueue_Time (void) const {return this->enqueue_time;};
+
+    void                    Set_Trace_Context (const Trace_Context   &the_context) {this->trace_context = the_context;}; // set by Message_Queue::Enqueue_Request while tracing
+    const Trace_Context &   Get_Trace_Context (void) const {return this->trace_context;};
+
+  private: // data
+    std::int64_t    enqueue_time = 0; /**< monotonic nano-seconds - the queue wait statistics of the Active_Object */
+    Trace_Context   trace_context; /**< the producer's trace - continued by Active_Object::Dispatch */
+
+  public: // errors
+    enum Method_Request_Errors
+    { // begin
+      C_Callable_Exception    = 2, /**< \b Call: The submitted callable threw an exception - it has been passed on to the future (or discarded when posted). */
+    }; // Method_Request_Errors
+  } Method_Request;
+
+#ifndef A4_DotNet
+  namespace Method_Request_Private
+  { // begin
+    template <typename The_Result_Type, typename The_Callable>
+      void Fulfil (std::promise<The_Result_Type>  &the_promise,
+                   The_Callable                   &the_callable)
+    { // begin
+      the_promise.set_value(the_callable());
+    } // Fulfil
+
+    template <typename The_Callable>
+      void Fulfil (std::promise<void>  &the_promise,
+                   The_Callable        &the_callable)
+    { // begin
+      the_callable();
+      the_promise.set_value();
+    } // Fulfil (void)
+  } // namespace Method_Request_Private
+
+  /**
+   * @brief Binds a callable to the promise that will carry its result back to the submitting thread.
+   * @param The_Result_Type - the return type of the callable
+   * @param The_Callable - any copy/move constructible callable taking no arguments
+   */
+  template <typename The_Result_Type,
+            typename The_Callable> class Method_Request_T : public Method_Request
+  { // begin
+  public: // construction
+    Method_Request_T (The_Callable                    &&the_callable,
+                      std::promise<The_Result_Type>   &&the_promise) : callable(std::move(the_callable)), promise(std::move(the_promise)) {};
+
+    virtual ~Method_Request_T(void) = default;
+
+  public: // methods
+/**
+ * @brief Run the callable on the calling (worker) thread and deliver the result - exceptions are delivered to the future.
+ * @return No_Error, C_Callable_Exception
+ */
+    virtual Error_Code  Call (void) override
+    { // begin
+      Method_State_Block_Begin(1)
+        State(1)
+          try { // the callable belongs to the caller - its exceptions belong to the future
+            Method_Request_Private::Fulfil(this->promise, this->callable);
+          } // try
+          catch (...) { // begin
+            this->promise.set_exception(std::current_exception());
+
+            the_method_error = A4_Error (A4_Method_Request_Module_ID, C_Callable_Exception, "The submitted callable threw an exception - it has been passed on to the future.");
+          } // catch
+        End_State
+      End_Method_State_Block
+
+      return the_method_error.Get_Error_Code();
+    } // Call
+
+  private: // data
+    The_Callable                    callable; /**< the work to be done */
+    std::promise<The_Result_Type>   promise; /**< delivers the result of the callable */
+  }; // Method_Request_T
+
+  /**
+   * @brief Fire-and-forget variant of Method_Request_T - there is no promise, the result of the callable is discarded.
+   * @param The_Callable - any copy/move constructible callable taking no arguments
+   */
+  template <typename The_Callable> class Post_Request_T : public Method_Request
+  { // begin
+  public: // construction
+    explicit Post_Request_T (The_Callable   &&the_callable) : callable(std::move(the_callable)) {};
+
+    virtual ~Post_Request_T(void) = default;
+
+  public: // methods
+/**
+ * @brief Run the callable on the calling (worker) thread - exceptions are logged and discarded.
+ * @return No_Error, C_Callable_Exception
+ */
+    virtual Error_Code  Call (void) override
+    { // begin
+      Method_State_Block_Begin(1)
+        State(1)
+          try { // nobody is waiting for the outcome
+            (void) this->callable();
+          } // try
+          catch (...) { // begin
+            the_method_error = A4_Error (A4_Method_Request_Module_ID, C_Callable_Exception, "The posted callable threw an exception - it has been discarded.");
+          } // catch
+        End_State
+      End_Method_State_Block
+
+      return the_method_error.Get_Error_Code();
+    } // Call
+
+  private: // data
+    The_Callable    callable; /**< the work to be done */
+  }; // Post_Request_T
+#endif // A4_DotNet
+} // namespace A4_Lib
+
+#endif // __A4_Method_Request_Defined__
@@ -38,6 +38,9 @@
 #include "A4_Lib_Module_ID.hh"
 #include "A4_Error.hh"
 #include "A4_Logger.hh"
+#include "A4_Error_Trace.hh"
+#include "A4_Error_Sink.hh"
+#include "A4_Error_Rate_Limiter.hh"
 
 #include <memory.h>
 
@@ -55,8 +58,58 @@ enum A4_Process_Block_Errors
 
 
 static const int A4_Max_Target_States = 5; // an arbitrary number - perhaps this should be a macro parameter? perhaps array should be replaced by a vector?
+static_assert(A4_Max_Target_States <= 8, "A4_Max_Target_States must fit the bits of the_defined_target_states");
 static const int A4_Max_Method_States = 0x7530; // 30000 states is probably enough for humans...but machine generated code?  
 
+/**
+ * \brief Opt-in profiling - define A4_Method_State_Profiling to count the calls, ticks and errors of every block and State.
+ * \see A4_Method_Profiler.hh
+ */
+#ifdef A4_Method_State_Profiling
+#include "A4_Method_Profiler.hh"
+
+#define A4_Profile_Block_Begin(max_states)\
+  static A4_Lib::Method_Profile_Site  the_profile_site(This_Function_Name, (max_states));\
+  A4_Lib::Method_Profile_Scope  the_profile_scope(the_profile_site);
+#define A4_Profile_State(x) the_profile_scope.Enter_State(x);
+#define A4_Profile_Block_End  the_profile_scope.End(the_method_state % A4_Max_Method_States, the_method_error);
+#else
+#define A4_Profile_Block_Begin(max_states)
+#define A4_Profile_State(x)
+#define A4_Profile_Block_End
+#endif // A4_Method_State_Profiling
+
+/**
+ * \brief Opt-in tracing - define A4_Method_State_Tracing to record every block as a span while the Tracer is started.
+ * \see A4_Tracer.hh
+ */
+#ifdef A4_Method_State_Tracing
+#include "A4_Tracer.hh"
+
+#define A4_Span_Block_Begin  A4_Lib::Trace_Span  the_trace_span(This_Function_Name);
+#else
+#define A4_Span_Block_Begin
+#endif // A4_Method_State_Tracing
+
+/**
+ * \brief Error logging - by default a failed block is recorded in its thread's Error_Trace and each call chain is logged once.
+ *        Define A4_Synchronous_Error_Logging to write every failed block to App_Log as it ends. Either way the registered
+ *        Error_Sinks receive every failure.
+ * \see A4_Error_Trace.hh, A4_Error_Sink.hh
+ */
+#ifdef A4_Synchronous_Error_Logging
+#define A4_Trace_Block_Begin
+#define A4_Log_Block_Error \
+if (the_method_error != No_Error){\
+  if (A4_Lib::Error_Sink::Is_Any_Registered() == true)\
+    A4_Lib::Error_Sink::Dispatch(the_method_error, This_Function_Name, the_method_state);\
+  if ((A4_Lib::Error_Sink::Is_Text_Log_Enabled() == true) && (App_Log->Is_Open() == true) && (A4_Lib::Error_Rate_Limiter::Admit(This_Function_Name, the_method_state, the_method_error.Get_Error_Code()) == true))\
+    (void) App_Log->Write(the_method_error.Get_Error_Message(), This_Function_Name, the_method_error.Get_Error_Code(), the_method_state, A4_Lib::Logging::Error);};
+#else
+#define A4_Trace_Block_Begin  A4_Lib::Error_Trace_Frame  the_error_frame;
+#define A4_Log_Block_Error  A4_Lib::Error_Trace::End_Frame(the_method_error, This_Function_Name, the_method_state);
+#endif // A4_Synchronous_Error_Logging
+
 /**
  * \brief The head of the Method State Block - must be closed with End_Method_State_Block
  */
@@ -64,7 +117,11 @@ static const int A4_Max_Method_States = 0x7530; // 30000 states is probably enou
   Method_State		the_method_state = 0;\
   A4_Error  		the_method_error(No_Error);\
   Method_State		the_target_state[A4_Max_Target_States];\
-  memset(the_target_state, 0, sizeof(the_target_state));\
+  std::uint8_t		the_defined_target_states = 0;\
+  (void) the_target_state; (void) the_defined_target_states;\
+  A4_Trace_Block_Begin\
+  A4_Span_Block_Begin\
+  A4_Profile_Block_Begin(max_states)\
 while((the_method_state < max_states) && (the_method_error == No_Error)){ the_method_state += 1;\
   switch(the_method_state){ 
 // Method_State_Block_Begin
@@ -77,9 +134,8 @@ if (the_method_state < A4_Max_Method_States){\
   the_method_error = A4_Error(A4_Method_State_Block_Module_ID, EMSB_Undefined_State, A4_Lib::Logging::Error, "Undefined method state was encountered in %s at line=%d in the_method_state=%d",\
 This_Function_Name, __LINE__, the_method_state);\
 };}}\
-/* log errors */\
-if (the_method_error != No_Error){\
-  if (App_Log->Is_Open() == true) (void) App_Log->Write(the_method_error.Get_Error_Message(), This_Function_Name, the_method_error.Get_Error_Code(), the_method_state, A4_Lib::Logging::Error);};
+A4_Profile_Block_End \
+A4_Log_Block_Error
 // End_Method_State_Block 
 
 /**
@@ -88,9 +144,9 @@ if (the_method_error != No_Error){\
  * 
  * \note  Since C++ implements a zero-work try, there's no performance hit for trying...only for catching
  */
-#define State(x)case x: try { 
+#define State(x)case x: A4_Profile_State(x) try { 
 
-#define State_NoTry(x)case x: /**< When there's no need to try or (more likely) when a compiler complains about Unreachable Code */
+#define State_NoTry(x)case x: A4_Profile_State(x) /**< When there's no need to try or (more likely) when a compiler complains about Unreachable Code */
 #define End_State_NoTry break; /**< must be used together with State_NoTry */
 
 /**
@@ -112,9 +168,11 @@ break; // End_State
 /**
  * \brief Define a State where control may be directed to - this can be seen as the start of a Loop - the advantage being that control remains in the Method State Block
  * \param x - IN - defines the offset within the_target_state array which holds the_method_state 
+ * \note  A loop that stays within one State is cheaper written with State_Loop.
  */					
-#define Define_Target_State(x)if((x < A4_Max_Target_States)&&(x >= 0))\
+#define Define_Target_State(x)if((x < A4_Max_Target_States)&&(x >= 0)){\
 				the_target_state[x]= the_method_state;\
+				the_defined_target_states |= static_cast<std::uint8_t>(1u << (x));}\
 			      else the_method_error = A4_Error(A4_Method_State_Block_Module_ID, DTS_Invalid_Target_State, "Invalid Target State - The max state number must be less than A4_Max_Target_States")
 
 /**
@@ -122,10 +180,59 @@ break; // End_State
  * \param x - IN - defines the offset within the_target_state array which holds the_method_state 
  */
 #define Set_Target_State(x)if((x < A4_Max_Target_States)&&(x >= 0)){\
-			     if(the_target_state[x]==0) the_method_error = A4_Error(A4_Method_State_Block_Module_ID, STS_Undefined_Target_State1, "Invalid Target State value which must be between 0..A4_Max_Target_States-1");\
+			     if((the_defined_target_states & (1u << (x))) == 0) the_method_error = A4_Error(A4_Method_State_Block_Module_ID, STS_Undefined_Target_State1, "Invalid Target State value which must be between 0..A4_Max_Target_States-1");\
 			     else the_method_state = the_target_state[x];}\
 			   else the_method_error = A4_Error(A4_Method_State_Block_Module_ID, STS_Undefined_Target_State2, "Invalid Target State - Set_Target_State must point to a defined target state")
 
+/**
+ * \brief A loop within a single State - the body repeats while (condition) holds, no error has been set and the block has
+ *        not been terminated. A plain break leaves the loop, Terminate_The_Method_Block leaves the block.
+ * \param condition - IN - tested before each pass
+ *
+ * \note  Each pass is a native loop iteration - Define_Target_State / Set_Target_State send every pass back through the
+ *        while/switch dispatcher. The State's try/catch covers the whole loop. Must be closed with End_State_Loop.
+ */
+#define State_Loop(condition)while((the_method_error == No_Error) && (the_method_state < A4_Max_Method_States) && (condition)){
+
+#define End_State_Loop } /**< must be used together with State_Loop */
+
+/**
+ * \brief The head of a Fast State Block - the noexcept fast-path variant of Method_State_Block_Begin. Must be closed with End_Fast_State_Block.
+ * \param max_states - IN - the highest state number
+ *
+ * \note  The states run in the order written, each guarded by a plain test of the_method_error - there is no while/switch
+ *        dispatcher and no try/catch, so a block of non-throwing states compiles to straight-line code and can be inlined.
+ *        Errors are logged exactly as End_Method_State_Block does. Terminate_The_Method_Block and State_Loop work, the
+ *        target state (loop) macros do not. An exception is \b not caught here - it propagates to the caller, so use this only where
+ *        the states cannot throw.
+ */
+#define Fast_State_Block_Begin(max_states)\
+  Method_State		the_method_state = 0;\
+  A4_Error  		the_method_error(No_Error);\
+  constexpr Method_State the_max_fast_state = (max_states);\
+  static_assert((the_max_fast_state > 0) && (the_max_fast_state < A4_Max_Method_States), "Fast_State_Block_Begin: max_states is out of range");\
+  A4_Trace_Block_Begin\
+  A4_Span_Block_Begin\
+  A4_Profile_Block_Begin(the_max_fast_state)
+// Fast_State_Block_Begin
+
+/**
+ * \brief Start of a single fast state - runs only while no error has been set and the block has not been terminated.
+ * \param x - IN - the state number - ascending, 1..max_states - must be closed with End_Fast_State
+ */
+#define Fast_State(x)static_assert(((x) > 0) && ((x) <= the_max_fast_state), "Fast_State: the state number exceeds max_states");\
+if ((the_method_error == No_Error) && (the_method_state < A4_Max_Method_States)){ the_method_state = (x); A4_Profile_State(x)
+
+#define End_Fast_State } /**< must be used together with Fast_State */
+
+/**
+ * \brief The Fast State Block termination - will log any errors, as End_Method_State_Block does
+ */
+#define End_Fast_State_Block \
+A4_Profile_Block_End \
+A4_Log_Block_Error
+// End_Fast_State_Block
+
 #define A4_Cleanup_Begin  try{
 
 #define A4_End_Cleanup }\
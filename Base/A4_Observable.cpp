@@ -373,12 +373,10 @@ namespace A4_Lib
   { // begin
     Map_Type::Iterator    the_iterator;
   
-    int     the_observer_loop = 0;
-  
     bool    the_mutex_is_acquired = false;
   
   
-    Method_State_Block_Begin(7)
+    Method_State_Block_Begin(4)
       State(1)
         the_method_error = this->observer_map.Lock(the_mutex_is_acquired);
         //the_method_error = this->observer_map.Lock(the_mutex_is_acquired); 
@@ -389,32 +387,19 @@ namespace A4_Lib
       End_State
       
       State(3)
-        Define_Target_State(the_observer_loop);
-      End_State
-    
-      State(4)
-        if (the_iterator == this->observer_map.End())
-        { // finish up
-          Terminate_The_Method_Block; // all done
-          the_method_error = this->observer_map.Unlock(the_mutex_is_acquired);
-        } // if then
-      End_State
-      
-      State(5)
-        if (the_iterator->second == NULL)
-          the_method_error = A4_Error (A4_Observable_Module_ID, NCO_Invalid_Observer_Address, "Invalid Observer address retrieved from the observer map iterator.");
-      End_State
+        State_Loop(the_iterator != this->observer_map.End())
+          if (the_iterator->second == NULL)
+            the_method_error = A4_Error (A4_Observable_Module_ID, NCO_Invalid_Observer_Address, "Invalid Observer address retrieved from the observer map iterator.");
+          else if (the_iterator->second->Address() == NULL)
+            the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Observer_Address, "An invalid Observer address was encountered.");
+          else the_method_error = reinterpret_cast<A4_Lib::Observer *>(the_iterator->second->Address())->Notify (the_data, the_hint); // it's the responsibility of the Observer to handle this asynchronously...or not.
 
-      State(6)
-        if (the_iterator->second->Address() == NULL)
-          the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Observer_Address, "An invalid Observer address was encountered.");
-        else the_method_error = reinterpret_cast<A4_Lib::Observer *>(the_iterator->second->Address())->Notify (the_data, the_hint); // it's the responsibility of the Observer to handle this asynchronously...or not.
+          the_iterator++;
+        End_State_Loop
       End_State
 
-      State(7)
-        the_iterator++;
-    
-        Set_Target_State(the_observer_loop);
+      State(4)
+        the_method_error = this->observer_map.Unlock(the_mutex_is_acquired);
       End_State
     End_Method_State_Block
 
@@ -435,48 +420,33 @@ namespace A4_Lib
   { // begin
     Map_Type::Iterator    the_iterator;
 
-    int     the_observer_loop = 0;
-   
     bool    the_mutex_is_acquired = false;
   
-    Method_State_Block_Begin(8)
+    Method_State_Block_Begin(4)
       State(1)
         if (the_msg_block == nullptr)
           the_method_error = A4_Error (A4_Observable_Module_ID, NCO_Invalid_Msg_Block, "Invalid parameter - the_msg_block == nullptr");
         else the_method_error = this->observer_map.Lock(the_mutex_is_acquired); 
       End_State
 
-      State(3)
+      State(2)
         the_method_error = this->observer_map.Begin (the_iterator);
       End_State
       
-      State(4)
-        Define_Target_State(the_observer_loop);
-      End_State
-    
-      State(5)
-        if (the_iterator == this->observer_map.End())
-        { // finish up
-          Terminate_The_Method_Block; // all done
-          the_method_error = this->observer_map.Unlock(the_mutex_is_acquired);
-        } // if then
-      End_State
-
-      State(6)
-        if (the_iterator->second == NULL)
-          the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Entry_Address2, "Invalid Observer address retrieved from the observer map iterator.");
-      End_State
+      State(3)
+        State_Loop(the_iterator != this->observer_map.End())
+          if (the_iterator->second == NULL)
+            the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Entry_Address2, "Invalid Observer address retrieved from the observer map iterator.");
+          else if (the_iterator->second->Address() == NULL)
+            the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Observer_Address2, "An invalid Observer address was encountered.");
+          else the_method_error = reinterpret_cast<A4_Lib::Observer *>(the_iterator->second->Address())->Notify (the_msg_block, the_hint); // it's the responsibility of the Observer to handle this asynchronously...or not.
 
-      State(7)
-        if (the_iterator->second->Address() == NULL)
-          the_method_error = A4_Error (A4_Observable_Module_ID, NO_Invalid_Observer_Address2, "An invalid Observer address was encountered.");
-        else the_method_error = reinterpret_cast<A4_Lib::Observer *>(the_iterator->second->Address())->Notify (the_msg_block, the_hint); // it's the responsibility of the Observer to handle this asynchronously...or not.
+          the_iterator++;
+        End_State_Loop
       End_State
 
-      State(8)
-        the_iterator++;
-    
-        Set_Target_State(the_observer_loop);
+      State(4)
+        the_method_error = this->observer_map.Unlock(the_mutex_is_acquired);
       End_State
     End_Method_State_Block
 
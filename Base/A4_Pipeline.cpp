@@ -0,0 +1,433 @@
+/**
+ * @brief   Pipeline implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Pipeline.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Pipeline.hh"
+#include "A4_Method_State_Block.hh"
+#include "A4_Utils.hh"
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  const Error_Code  Queue_Full_Error = A4_Error::Make_Error_Code(A4_Message_Queue_Module_ID, Message_Queue::EQ_Timeout2); /**< Enqueue_Message gave up waiting for room - retried while the stage is started */
+} // namespace - end
+
+/**
+ * @brief Default constructor
+ */
+Pipeline_Stage::Pipeline_Stage(void)
+{ // begin
+  this->next_stage = nullptr;
+  this->pipeline = nullptr;
+  this->parallelism = 0;
+  this->queue_depth = 0;
+  this->num_processed = 0;
+  this->num_forwarded = 0;
+  this->busy_nano_seconds = 0;
+  this->blocked_nano_seconds = 0;
+} // constructor
+
+/**
+ * @brief Default destructor
+ */
+Pipeline_Stage::~Pipeline_Stage(void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+
+  this->next_stage = nullptr;
+  this->pipeline = nullptr;
+} // destructor
+
+/**
+ * @brief Call Process_Stage and pass whatever it leaves in the_message_block to the next stage.
+ * @param the_message_block - IN - OUT - nullptr
+ */
+Error_Code  Pipeline_Stage::Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block)
+{ // begin
+  std::chrono::steady_clock::time_point   the_start_time;
+
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->pipeline == nullptr)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, PM_Not_In_Pipeline, "The stage has not been added to a Pipeline.");
+    End_State
+
+    State(2)
+      the_start_time = std::chrono::steady_clock::now();
+
+      the_method_error = this->Process_Stage(the_message_block);
+
+      this->busy_nano_seconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - the_start_time).count(), std::memory_order_relaxed);
+      this->num_processed.fetch_add(1, std::memory_order_relaxed);
+    End_State
+
+    State(3)
+      if ((the_message_block != nullptr) && (this->next_stage != nullptr))
+        the_method_error = this->Forward(the_message_block);
+    End_State
+  End_Method_State_Block
+
+  the_message_block.reset(); // the last stage - or a failure - drops it
+
+  return the_method_error.Get_Error_Code();
+} // Process_Message
+
+/**
+ * @brief Enqueue the_message_block on the next stage, waiting for as long as that stage is full - this is the backpressure.
+ * @param the_message_block - IN - OUT - nullptr on success
+ */
+Error_Code  Pipeline_Stage::Forward (A4_Lib::Message_Block::Pointer   &the_message_block)
+{ // begin
+  std::chrono::steady_clock::time_point   the_start_time = std::chrono::steady_clock::now();
+
+  Error_Code    the_error = Queue_Full_Error;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      while ((the_error == Queue_Full_Error) && (this->next_stage->Is_Started() == true))
+        if (this->next_stage->Wait_For_Message_Queue_Space(Pipeline_Constant::Backpressure_Wait_MS) == true)
+          the_error = this->next_stage->Enqueue_Message(the_message_block); // a parallel worker may take the room first - then it is still full
+
+      this->blocked_nano_seconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - the_start_time).count(), std::memory_order_relaxed);
+
+      if (the_error == Queue_Full_Error)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, FW_Next_Stage_Stopped, "The next stage was stopped while waiting for room in its queue - the message was dropped.");
+    End_State
+
+    State(2)
+      the_method_error = the_error;
+
+      if (the_method_error == No_Error)
+        this->num_forwarded.fetch_add(1, std::memory_order_relaxed);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Forward
+
+/**
+ * @brief Default constructor
+ */
+Pipeline::Pipeline(void)
+{ // begin
+  this->is_started = false;
+} // constructor
+
+/**
+ * @brief Default destructor
+ */
+Pipeline::~Pipeline(void)
+{ // begin
+  if (this->Is_Started() == true)
+    (void) this->Stop();
+
+  for (std::size_t the_offset = 0; the_offset < this->stages.size(); the_offset++)
+    this->stages [the_offset]->pipeline = nullptr;
+} // destructor
+
+/**
+ * @brief   Retrieve the current started state.
+ */
+bool  Pipeline::Is_Started (void) const
+{ // begin
+  return this->is_started;
+} // Is_Started
+
+/**
+ * @brief Append a stage - it receives whatever the previously added stage forwards.
+ * @param the_stage - IN - must not be initialized by the caller - the pipeline initializes and starts it
+ * @param the_stage_name - IN - used by the statistics
+ * @param the_parallelism - IN - the number of messages the stage may process at once - 1 keeps it serial
+ * @param the_queue_depth - IN - the bound of the stage's queue - must be >= Active_Object_Constant::Min_Queued_Messages
+ */
+Error_Code  Pipeline::Add_Stage (Pipeline_Stage     &the_stage,
+                                 const std::string  &the_stage_name,
+                                 std::size_t        the_parallelism,
+                                 std::size_t        the_queue_depth)
+{ // begin
+  Method_State_Block_Begin(3)
+    State(1)
+      if (this->Is_Started() == true)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, AS_Already_Started, "The pipeline is started - stages must be added before Start.");
+      else if (the_stage.pipeline != nullptr)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, AS_Already_Added, "The stage already belongs to a pipeline.");
+    End_State
+
+    State(2)
+      if (the_parallelism < 1)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, AS_Invalid_Parallelism, "Invalid parameter value - the_parallelism must be non-zero.");
+      else if (the_queue_depth < Active_Object_Constant::Min_Queued_Messages)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, AS_Invalid_Queue_Depth, "Invalid parameter value - the_queue_depth is less than Active_Object_Constant::Min_Queued_Messages.");
+    End_State
+
+    State(3)
+      the_stage.pipeline = this;
+      the_stage.stage_name = the_stage_name;
+      the_stage.parallelism = the_parallelism;
+      the_stage.queue_depth = the_queue_depth;
+      the_stage.next_stage = nullptr;
+
+      if (this->stages.empty() != true)
+        this->stages.back()->next_stage = &the_stage;
+
+      this->stages.push_back(&the_stage);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Add_Stage
+
+/**
+ * @brief Initialize and start every stage on a shared executor - the last stage first, so nothing is forwarded to a stopped stage.
+ */
+Error_Code  Pipeline::Start (void)
+{ // begin
+  std::size_t   the_total_parallelism = 0;
+  std::size_t   the_offset = 0;
+
+  Method_State_Block_Begin(5)
+    State(1)
+      if (this->Is_Started() == true)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, S_Already_Started, "The pipeline is already started.");
+      else if (this->stages.empty() == true)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, S_No_Stages, "The pipeline has no stages.");
+    End_State
+
+    State(2)
+      for (the_offset = 0; the_offset < this->stages.size(); the_offset++)
+        the_total_parallelism += this->stages [the_offset]->parallelism;
+
+      this->executor.reset();
+
+      the_method_error = A4_Lib::Executor::Allocate(this->executor);
+    End_State
+
+    State(3) // one pool thread per unit of parallelism - a stage blocked on its successor never starves the successor
+      the_method_error = this->executor->Initialize(the_total_parallelism);
+    End_State
+
+    State(4)
+      the_method_error = this->executor->Start();
+    End_State
+
+    State(5)
+      for (the_offset = this->stages.size(); (the_offset > 0) && (the_method_error == No_Error); the_offset--)
+      { // begin
+        Pipeline_Stage  *the_stage = this->stages [the_offset - 1];
+
+        the_stage->num_processed = 0;
+        the_stage->num_forwarded = 0;
+        the_stage->busy_nano_seconds = 0;
+        the_stage->blocked_nano_seconds = 0;
+
+        if (the_stage->Is_Initialized() != true)
+          the_method_error = the_stage->Initialize(Active_Object_Constant::Min_Num_Threads, Active_Object_Constant::Default_Message_Queue_Wait_MS, the_stage->queue_depth);
+
+        if (the_method_error == No_Error)
+          the_method_error = the_stage->Attach_Executor(this->executor, the_stage->parallelism);
+
+        if (the_method_error == No_Error)
+          the_method_error = the_stage->Start();
+      } // for
+
+      if (the_method_error == No_Error)
+      { // begin
+        this->start_time = std::chrono::steady_clock::now();
+        this->is_started = true;
+      } // if then
+      else for (the_offset = 0; the_offset < this->stages.size(); the_offset++)
+             if (this->stages [the_offset]->Is_Started() == true)
+               (void) this->stages [the_offset]->Stop();
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Start
+
+/**
+ * @brief Stop the pipeline - each stage is drained before it is stopped, starting at the source.
+ * @note  A stage is given up to Pipeline_Constant::Max_Stop_Drain_Wait_MS - then it is stopped anyway and ST_Drain_Timeout is returned.
+ */
+Error_Code  Pipeline::Stop (void)
+{ // begin
+  std::size_t   the_num_undrained = 0;
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (this->Is_Started() != true)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, ST_Not_Started, "The pipeline is already stopped.");
+      else this->is_started = false; // no more Enqueue
+    End_State
+
+    State(2)
+      for (std::size_t the_offset = 0; the_offset < this->stages.size(); the_offset++)
+      { // begin
+        std::chrono::steady_clock::time_point   the_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Pipeline_Constant::Max_Stop_Drain_Wait_MS);
+
+        while ((this->stages [the_offset]->Message_Queue_Is_Empty() != true) && (std::chrono::steady_clock::now() < the_deadline))
+          A4_Lib::Sleep_MS(10);
+
+        if (this->stages [the_offset]->Message_Queue_Is_Empty() != true)
+        { // a stuck Process_Stage - or a downstream stage that no longer drains
+          (void) App_Log->Write (A4_Lib::Logging::Error, "Pipeline stage %s did not drain within %lld ms - %zu queued messages are dropped", this->stages [the_offset]->stage_name.c_str(),
+                                 static_cast<long long>(Pipeline_Constant::Max_Stop_Drain_Wait_MS), this->stages [the_offset]->Message_Queue_Size());
+
+          the_num_undrained += 1;
+        } // if then
+
+        the_method_error = this->stages [the_offset]->Stop(); // waits for the running slices, which may still forward downstream
+
+        if (the_method_error != No_Error)
+          (void) App_Log->Write (A4_Lib::Logging::Error, "Pipeline stage %s failed to stop - error %1.5f", this->stages [the_offset]->stage_name.c_str(), the_method_error.Get_Dot_Error_Code());
+      } // for
+
+      the_method_error = No_Error; // logged above
+    End_State
+
+    State(3)
+      the_method_error = this->executor->Stop();
+    End_State
+
+    State(4)
+      if (the_num_undrained > 0)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, ST_Drain_Timeout, A4_Lib::Logging::Error, "%zu stage(s) did not drain before they were stopped - queued messages were dropped.", the_num_undrained);
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Stop
+
+/**
+ * @brief Enqueue into the first stage, waiting for as long as it is full - this is where the backpressure reaches the source.
+ * @param the_message_block - IN - OUT - nullptr on success
+ */
+Error_Code  Pipeline::Enqueue (A4_Lib::Message_Block::Pointer   &the_message_block)
+{ // begin
+  Error_Code    the_error = Queue_Full_Error;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      if (this->Is_Started() != true)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, EQ_Not_Started, "The pipeline is not started.");
+    End_State
+
+    State(2)
+      while ((the_error == Queue_Full_Error) && (this->Is_Started() == true))
+        if (this->stages.front()->Wait_For_Message_Queue_Space(Pipeline_Constant::Backpressure_Wait_MS) == true)
+          the_error = this->stages.front()->Enqueue_Message(the_message_block); // another source may take the room first - then it is still full
+
+      if (the_error == Queue_Full_Error)
+        the_method_error = A4_Error (A4_Pipeline_Module_ID, EQ_Not_Started, "The pipeline is not started.");
+      else the_method_error = the_error;
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Enqueue
+
+/**
+ * @brief Take a snapshot of every stage.
+ * @param the_statistics - OUT - one entry per stage, in processing order
+ */
+Error_Code  Pipeline::Get_Statistics (std::vector<Pipeline_Stage_Statistics>  &the_statistics)
+{ // begin
+  double    the_elapsed_seconds = 0.0;
+
+  Method_State_Block_Begin(1)
+    State(1)
+      the_statistics.clear();
+
+      if (this->Is_Started() == true)
+        the_elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->start_time).count();
+
+      for (std::size_t the_offset = 0; the_offset < this->stages.size(); the_offset++)
+      { // begin
+        Pipeline_Stage              *the_stage = this->stages [the_offset];
+        Pipeline_Stage_Statistics   the_entry;
+
+        the_entry.stage_name = the_stage->stage_name;
+        the_entry.parallelism = the_stage->parallelism;
+        the_entry.queue_depth = the_stage->queue_depth;
+        the_entry.queue_size = (the_stage->Is_Initialized() == true) ? the_stage->Message_Queue_Size() : 0;
+        the_entry.num_processed = the_stage->num_processed.load(std::memory_order_relaxed);
+        the_entry.num_forwarded = the_stage->num_forwarded.load(std::memory_order_relaxed);
+
+        if (the_elapsed_seconds > 0.0)
+        { // rates
+          the_entry.messages_per_second = static_cast<double>(the_entry.num_processed) / the_elapsed_seconds;
+          the_entry.busy_ratio = (static_cast<double>(the_stage->busy_nano_seconds.load(std::memory_order_relaxed)) / 1.0e9) / (the_elapsed_seconds * the_entry.parallelism);
+          the_entry.blocked_ratio = (static_cast<double>(the_stage->blocked_nano_seconds.load(std::memory_order_relaxed)) / 1.0e9) / (the_elapsed_seconds * the_entry.parallelism);
+        } // if then
+
+        the_statistics.push_back(the_entry);
+      } // for
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Get_Statistics
+
+/**
+ * @brief Write one line per stage and name the bottleneck - the busiest stage relative to its parallelism.
+ * @param the_detail_level - IN
+ */
+Error_Code  Pipeline::Log_Statistics (A4_Lib::Logging::Detail   the_detail_level)
+{ // begin
+  std::vector<Pipeline_Stage_Statistics>  the_statistics;
+
+  std::size_t   the_bottleneck = 0;
+
+  Method_State_Block_Begin(2)
+    State(1)
+      the_method_error = this->Get_Statistics(the_statistics);
+    End_State
+
+    State(2)
+      for (std::size_t the_offset = 0; the_offset < the_statistics.size(); the_offset++)
+      { // begin
+        const Pipeline_Stage_Statistics   &the_entry = the_statistics [the_offset];
+
+        (void) App_Log->Write (the_detail_level, "Pipeline stage %s: %.1f msg/s, queue %zu/%zu, busy %.0f%%, blocked downstream %.0f%%, parallelism %zu",
+                               the_entry.stage_name.c_str(), the_entry.messages_per_second, the_entry.queue_size, the_entry.queue_depth,
+                               the_entry.busy_ratio * 100.0, the_entry.blocked_ratio * 100.0, the_entry.parallelism);
+
+        if (the_entry.busy_ratio > the_statistics [the_bottleneck].busy_ratio)
+          the_bottleneck = the_offset;
+      } // for
+
+      if (the_statistics.empty() != true)
+        (void) App_Log->Write (the_detail_level, "Pipeline bottleneck: stage %s", the_statistics [the_bottleneck].stage_name.c_str());
+    End_State
+  End_Method_State_Block
+
+  return the_method_error.Get_Error_Code();
+} // Log_Statistics
@@ -0,0 +1,170 @@
+#ifndef __A4_Pipeline_Defined__
+#define __A4_Pipeline_Defined__
+/**
+ * @brief   Pipeline - chains Pipeline_Stages (Active_Objects) into a staged processing graph with end-to-end backpressure.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Pipeline.hh
+ * @note  Each stage has a bounded message queue (its depth) and a parallelism - the number of messages it may process at
+ *        once. A stage forwarding to a full downstream queue waits for room, so a slow stage fills the queues upstream of it
+ *        until Pipeline::Enqueue blocks the source. All stages share one Executor sized to the sum of the parallelisms.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Active_Object.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  class Pipeline;
+
+  namespace Pipeline_Constant
+  { // begin
+    static const std::size_t    Default_Queue_Depth = 100; /**< per stage - must be >= Active_Object_Constant::Min_Queued_Messages */
+    static const std::size_t    Default_Parallelism = 1; /**< serial stage */
+    static const std::int64_t   Backpressure_Wait_MS = 250; /**< a blocked forward (or Enqueue) re-checks the state of the stage it waits on this often */
+    static const std::int64_t   Max_Stop_Drain_Wait_MS = 5000; /**< Stop waits this long for each stage to empty its queue */
+  } // namespace Pipeline_Constant
+
+  /**
+   * @brief A snapshot of one stage - see Pipeline::Get_Statistics.
+   */
+  typedef struct Pipeline_Stage_Statistics
+  { // begin
+    std::string     stage_name; /**< as passed to Add_Stage */
+    std::size_t     parallelism = 0; /**< messages processed at once */
+    std::size_t     queue_depth = 0; /**< the queue limit */
+    std::size_t     queue_size = 0; /**< messages waiting right now */
+    std::uint64_t   num_processed = 0; /**< calls to Process_Stage since Start */
+    std::uint64_t   num_forwarded = 0; /**< messages passed to the next stage */
+    double          messages_per_second = 0.0; /**< num_processed over the time since Start */
+    double          busy_ratio = 0.0; /**< time inside Process_Stage / (elapsed time * parallelism) - near 1.0 is the bottleneck */
+    double          blocked_ratio = 0.0; /**< time waiting on a full downstream queue / (elapsed time * parallelism) */
+  } Pipeline_Stage_Statistics;
+
+  /**
+   * @brief One stage of a Pipeline - subclasses implement Process_Stage instead of Process_Message.
+   */
+  typedef class Pipeline_Stage : public Active_Object
+  { // begin definition
+  public: // construction
+    Pipeline_Stage(void);
+    virtual ~Pipeline_Stage(void);
+
+  protected: // overridables
+    /**
+     * @brief \b Must be overridden - process one message.
+     * @param the_message_block - IN - OUT - left as is (or replaced) to pass it to the next stage, reset to drop it
+     */
+    virtual Error_Code  Process_Stage (A4_Lib::Message_Block::Pointer   &the_message_block) = 0;
+
+    virtual Error_Code  Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block) override; // Process_Stage & forward
+
+  private: // methods
+    friend class Pipeline;
+
+    Error_Code  Forward (A4_Lib::Message_Block::Pointer   &the_message_block); // blocks while the next stage is full
+
+  #ifndef A4_DotNet
+  private: // data
+    Pipeline_Stage            *next_stage; /**< nullptr for the last stage */
+    Pipeline                  *pipeline; /**< the owner - nullptr until added */
+
+    std::string               stage_name; /**< for the statistics */
+    std::size_t               parallelism; /**< the executor concurrency of this stage */
+    std::size_t               queue_depth; /**< the message queue limit of this stage */
+
+    std::atomic<std::uint64_t>  num_processed; /**< calls to Process_Stage */
+    std::atomic<std::uint64_t>  num_forwarded; /**< successful forwards */
+    std::atomic<std::uint64_t>  busy_nano_seconds; /**< inside Process_Stage */
+    std::atomic<std::uint64_t>  blocked_nano_seconds; /**< waiting on the next stage */
+  #endif // A4_DotNet
+
+  public: // errors
+    enum Pipeline_Stage_Errors
+    { // begin
+      PM_Not_In_Pipeline          = 8, /**< \b Process_Message: The stage has not been added to a Pipeline. */
+      FW_Next_Stage_Stopped       = 9, /**< \b Forward: The next stage was stopped while waiting for room in its queue - the message was dropped. */
+    }; // Pipeline_Stage_Errors
+  } Pipeline_Stage;
+
+  typedef class Pipeline
+  { // begin
+  public: // construction
+    Pipeline(void);
+    Pipeline(Pipeline &) = delete;
+    virtual ~Pipeline(void);
+
+    Pipeline & operator = (Pipeline &) = delete;
+
+  public: // methods
+    Error_Code  Add_Stage (Pipeline_Stage     &the_stage, // must outlive the pipeline - stages are connected in the order added
+                           const std::string  &the_stage_name,
+                           std::size_t        the_parallelism = Pipeline_Constant::Default_Parallelism,
+                           std::size_t        the_queue_depth = Pipeline_Constant::Default_Queue_Depth);
+
+    Error_Code  Start (void);
+    Error_Code  Stop (void); // drains each stage in turn, starting at the source
+
+    bool  Is_Started (void) const;
+
+    Error_Code  Enqueue (A4_Lib::Message_Block::Pointer   &the_message_block); // into the first stage - blocks while it is full
+
+    Error_Code  Get_Statistics (std::vector<Pipeline_Stage_Statistics>  &the_statistics); // OUT - one entry per stage, in order
+
+    Error_Code  Log_Statistics (A4_Lib::Logging::Detail   the_detail_level = A4_Lib::Logging::Info); // one line per stage, then the bottleneck
+
+  #ifndef A4_DotNet
+  private: // data
+    std::vector<Pipeline_Stage *>   stages; /**< in processing order */
+
+    A4_Lib::Executor::Pointer       executor; /**< shared by every stage */
+
+    std::chrono::steady_clock::time_point   start_time; /**< for the rates */
+
+    bool                            is_started; /**< stages may only be added while stopped */
+  #endif // A4_DotNet
+
+  public: // errors
+    enum Pipeline_Errors
+    { // begin
+      AS_Already_Started          = 0, /**< \b Add_Stage: The pipeline is started - stages must be added before Start. */
+      AS_Invalid_Parallelism      = 1, /**< \b Add_Stage: Invalid parameter value - the_parallelism must be non-zero. */
+      AS_Invalid_Queue_Depth      = 2, /**< \b Add_Stage: Invalid parameter value - the_queue_depth is less than Active_Object_Constant::Min_Queued_Messages. */
+      AS_Already_Added            = 3, /**< \b Add_Stage: The stage already belongs to a pipeline. */
+      S_Already_Started           = 4, /**< \b Start: The pipeline is already started. */
+      S_No_Stages                 = 5, /**< \b Start: The pipeline has no stages. */
+      ST_Not_Started              = 6, /**< \b Stop: The pipeline is already stopped. */
+      EQ_Not_Started              = 7, /**< \b Enqueue: The pipeline is not started. */
+      ST_Drain_Timeout            = 10, /**< \b Stop: A stage did not drain before it was stopped - queued messages were dropped. */
+    }; // Pipeline_Errors
+  } Pipeline;
+} // namespace A4_Lib
+
+#endif // __A4_Pipeline_Defined__
@@ -0,0 +1,349 @@
+/**
+ * @brief   Span tracer implementation
+ * @author  a. zippay * 2017..2020
+ * @file A4_Tracer.cpp
+ * @note  * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef A4_Lib_Windows
+#include "Stdafx.h"
+#endif
+
+#include "A4_Tracer.hh"
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_Method_State_Block.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace A4_Lib;
+
+namespace
+{ // begin
+  /**
+   * @brief The events of one thread - single producer (the thread), single consumer (Write_Chrome_Trace).
+   */
+  typedef class Trace_Buffer
+  { // begin
+  public: // construction
+    explicit Trace_Buffer (std::uint32_t  the_thread_index) : events(new Trace_Event [Trace_Constant::Events_Per_Thread]), thread_index(the_thread_index) {};
+
+  public: // methods
+    bool  Push (const Trace_Event   &the_event) noexcept
+    { // begin
+      std::size_t   the_head = this->head.load(std::memory_order_relaxed);
+
+      if ((the_head - this->tail.load(std::memory_order_acquire)) >= Trace_Constant::Events_Per_Thread)
+        return false; // full
+
+      this->events [the_head & (Trace_Constant::Events_Per_Thread - 1)] = the_event;
+      this->head.store(the_head + 1, std::memory_order_release);
+
+      return true;
+    } // Push
+
+  public: // data
+    std::unique_ptr<Trace_Event []>   events;
+    std::atomic<std::size_t>          head {0}; /**< written by the owner */
+    std::atomic<std::size_t>          tail {0}; /**< written by Write_Chrome_Trace */
+    std::atomic<bool>                 is_finished {false}; /**< the owner has exited - freed once drained */
+    std::uint32_t                     thread_index; /**< the Chrome tid */
+  } Trace_Buffer;
+
+  /**
+   * @brief Every buffer - guarded by mutex. Never destroyed, so threads exiting during shutdown can still use it.
+   */
+  typedef struct Trace_Registry
+  { // begin
+    std::mutex                                  mutex;
+    std::vector<std::shared_ptr<Trace_Buffer>>  buffers;
+    std::uint32_t                               next_thread_index = 1;
+  } Trace_Registry;
+
+  Trace_Registry &  Registry (void)
+  { // begin
+    static Trace_Registry   *the_registry = new Trace_Registry();
+
+    return *the_registry;
+  } // Registry
+
+  /**
+   * @brief The tracing state of one thread.
+   */
+  typedef struct Thread_Trace
+  { // begin
+    ~Thread_Trace (void) {if (this->buffer != nullptr) this->buffer->is_finished.store(true, std::memory_order_release);};
+
+    std::shared_ptr<Trace_Buffer>   buffer; /**< created by the first event */
+    std::uint32_t                   depth = 0; /**< open spans */
+    std::uint64_t                   trace_id = 0; /**< the trace the open spans belong to */
+  } Thread_Trace;
+
+  thread_local Thread_Trace     the_thread_trace;
+
+  std::atomic<std::uint64_t>    the_next_id {1}; /**< trace and flow ids */
+  std::atomic<std::uint64_t>    the_dropped_events {0};
+
+  /**
+   * @brief Append an event to the calling thread's buffer.
+   */
+  void  Record (const char      *the_name,
+                char            the_phase,
+                std::uint64_t   the_trace_id,
+                std::uint64_t   the_flow_id) noexcept
+  { // begin
+    Trace_Event   the_event = {the_name, Monotonic_Nano_Seconds(), the_trace_id, the_flow_id, the_phase};
+
+    if (the_thread_trace.buffer == nullptr)
+    { // begin
+      try
+      { // begin
+        Trace_Registry  &the_registry = Registry();
+        std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+        the_thread_trace.buffer = std::make_shared<Trace_Buffer>(the_registry.next_thread_index++);
+        the_registry.buffers.push_back(the_thread_trace.buffer);
+      } // try
+      catch (...)
+      { // begin
+        the_thread_trace.buffer.reset();
+        the_dropped_events.fetch_add(1, std::memory_order_relaxed);
+
+        return;
+      } // catch
+    } // if then
+
+    if (the_thread_trace.buffer->Push(the_event) == false)
+      the_dropped_events.fetch_add(1, std::memory_order_relaxed);
+  } // Record
+
+  /**
+   * @brief Write the_text as a JSON string body.
+   */
+  bool  Put_JSON_Text (const char   *the_text,
+                       std::FILE    *the_file)
+  { // begin
+    for (; (the_text != nullptr) && (*the_text != '\0'); the_text++)
+    { // begin
+      if ((*the_text == '"') || (*the_text == '\\'))
+      { // begin
+        if ((std::fputc('\\', the_file) == EOF) || (std::fputc(*the_text, the_file) == EOF))
+          return false;
+      } // if then
+      else if (std::fputc((static_cast<unsigned char>(*the_text) < 0x20) ? ' ' : *the_text, the_file) == EOF)
+        return false;
+    } // for
+
+    return true;
+  } // Put_JSON_Text
+
+  /**
+   * @brief Write one event as a Chrome trace-event object.
+   */
+  bool  Put_Event (const Trace_Event  &the_event,
+                   std::uint32_t      the_thread_index,
+                   bool               is_first,
+                   std::FILE          *the_file)
+  { // begin
+    bool  is_flow = ((the_event.phase == 's') || (the_event.phase == 'f'));
+
+    if (std::fprintf(the_file, "%s{\"name\":\"", (is_first == true) ? "" : ",\n") < 0)
+      return false;
+
+    if (Put_JSON_Text(the_event.name, the_file) == false)
+      return false;
+
+    if (is_flow == true)
+      return (std::fprintf(the_file, "\",\"cat\":\"a4.hand-off\",\"ph\":\"%c\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%u}", the_event.phase,
+                           static_cast<unsigned long long>(the_event.flow_id), static_cast<double>(the_event.nano_seconds) / 1000.0, the_thread_index) >= 0); // an 'f' binds to the next slice - the receiving span
+
+    return (std::fprintf(the_file, "\",\"cat\":\"a4\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"trace\":%llu}}", the_event.phase,
+                         static_cast<double>(the_event.nano_seconds) / 1000.0, the_thread_index, static_cast<unsigned long long>(the_event.trace_id)) >= 0);
+  } // Put_Event
+} // namespace
+
+/**
+ * @brief Start recording.
+ */
+void  Tracer::Start (void) noexcept
+{ // begin
+  Tracer::is_active.store(true, std::memory_order_relaxed);
+} // Start
+
+/**
+ * @brief Stop recording - spans already open still record their end.
+ */
+void  Tracer::Stop (void) noexcept
+{ // begin
+  Tracer::is_active.store(false, std::memory_order_relaxed);
+} // Stop
+
+/**
+ * @brief Open a span on the calling thread - the outermost span starts a new trace unless Receive continued one.
+ * @param the_name - IN - static
+ */
+void  Tracer::Begin_Span (const char  *the_name) noexcept
+{ // begin
+  if (the_thread_trace.trace_id == 0)
+    the_thread_trace.trace_id = the_next_id.fetch_add(1, std::memory_order_relaxed);
+
+  the_thread_trace.depth += 1;
+
+  Record(the_name, 'B', the_thread_trace.trace_id, 0);
+} // Begin_Span
+
+/**
+ * @brief Close the innermost span on the calling thread.
+ * @param the_name - IN - static - as passed to Begin_Span
+ */
+void  Tracer::End_Span (const char  *the_name) noexcept
+{ // begin
+  Record(the_name, 'E', the_thread_trace.trace_id, 0);
+
+  if ((the_thread_trace.depth > 0) && ((the_thread_trace.depth -= 1) == 0))
+    the_thread_trace.trace_id = 0;
+} // End_Span
+
+/**
+ * @brief Start a hand-off from the calling thread - the returned context goes with the message.
+ */
+Trace_Context   Tracer::Send (void) noexcept
+{ // begin
+  Trace_Context   the_context;
+
+  if (Tracer::Is_Active() == false)
+    return the_context;
+
+  if (the_thread_trace.trace_id == 0)
+    the_thread_trace.trace_id = the_next_id.fetch_add(1, std::memory_order_relaxed);
+
+  the_context.trace_id = the_thread_trace.trace_id;
+  the_context.flow_id = the_next_id.fetch_add(1, std::memory_order_relaxed);
+
+  Record("Message_Queue", 's', the_context.trace_id, the_context.flow_id);
+
+  return the_context;
+} // Send
+
+/**
+ * @brief Finish a hand-off on the calling thread - the spans it opens next belong to the sender's trace.
+ * @param the_context - IN - from Send - a context without a trace starts a new one with the next span
+ * @return the trace id replaced - pass it to Restore once the received message has been handled
+ */
+std::uint64_t   Tracer::Receive (const Trace_Context  &the_context) noexcept
+{ // begin
+  std::uint64_t   the_previous_trace_id = the_thread_trace.trace_id;
+
+  if (Tracer::Is_Active() == false)
+    return the_previous_trace_id;
+
+  the_thread_trace.trace_id = the_context.trace_id; // never the previous message's
+
+  if (the_context.trace_id != 0)
+    Record("Message_Queue", 'f', the_context.trace_id, the_context.flow_id);
+
+  return the_previous_trace_id;
+} // Receive
+
+/**
+ * @brief End a hand-off on the calling thread - the spans still open there continue their own trace.
+ * @param the_trace_id - IN - as returned by Receive
+ */
+void  Tracer::Restore (std::uint64_t  the_trace_id) noexcept
+{ // begin
+  the_thread_trace.trace_id = (the_thread_trace.depth > 0) ? the_trace_id : 0;
+} // Restore
+
+/**
+ * @brief Retrieve the number of events lost to full buffers.
+ */
+std::uint64_t   Tracer::Get_Dropped_Events (void) noexcept
+{ // begin
+  return the_dropped_events.load(std::memory_order_relaxed);
+} // Get_Dropped_Events
+
+/**
+ * @brief Drain the recorded events into a Chrome trace-event JSON file.
+ * @param the_filespec - IN - overwritten
+ */
+Error_Code  Tracer::Write_Chrome_Trace (const std::string   &the_filespec)
+{ // begin
+  std::FILE   *the_file = nullptr;
+  bool        is_first = true;
+
+  Method_State_Block_Begin(4)
+    State(1)
+      if (the_filespec.empty() == true)
+        the_method_error = A4_Error (A4_Tracer_Module_ID, WCT_Empty_Filespec, "Invalid parameter length - the_filespec is empty.");
+    End_State
+
+    State(2)
+      if ((the_file = std::fopen(the_filespec.c_str(), "w")) == nullptr)
+        the_method_error = A4_Error (A4_Tracer_Module_ID, WCT_FOpen_Error, A4_Lib::Logging::Error, "Call to std::fopen failed for %s", the_filespec.c_str());
+    End_State
+
+    State(3)
+      Trace_Registry  &the_registry = Registry();
+      std::lock_guard<std::mutex>   the_lock(the_registry.mutex);
+
+      bool  is_written = (std::fputs("{\"traceEvents\":[\n", the_file) >= 0);
+
+      for (std::shared_ptr<Trace_Buffer> &the_buffer : the_registry.buffers)
+      { // begin
+        std::size_t   the_head = the_buffer->head.load(std::memory_order_acquire);
+        std::size_t   the_tail = the_buffer->tail.load(std::memory_order_relaxed);
+
+        for (; (the_tail < the_head) && (is_written == true); the_tail++, is_first = false)
+          is_written = Put_Event(the_buffer->events [the_tail & (Trace_Constant::Events_Per_Thread - 1)], the_buffer->thread_index, is_first, the_file);
+
+        the_buffer->tail.store(the_tail, std::memory_order_release);
+      } // for
+
+      // exited threads are gone once drained
+      the_registry.buffers.erase(std::remove_if(the_registry.buffers.begin(), the_registry.buffers.end(), [](const std::shared_ptr<Trace_Buffer> &the_buffer)
+                                 {return (the_buffer->is_finished.load(std::memory_order_acquire) == true) &&
+                                         (the_buffer->tail.load(std::memory_order_relaxed) == the_buffer->head.load(std::memory_order_acquire));}),
+                                 the_registry.buffers.end());
+
+      if ((is_written == false) || (std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", the_file) < 0))
+        the_method_error = A4_Error (A4_Tracer_Module_ID, WCT_Write_Error, "Call to std::fputs or std::fclose failed - enough storage space?");
+    End_State
+
+    State(4)
+      std::FILE   *the_closing_file = the_file;
+
+      the_file = nullptr;
+
+      if (std::fclose(the_closing_file) != 0)
+        the_method_error = A4_Error (A4_Tracer_Module_ID, WCT_Write_Error, "Call to std::fputs or std::fclose failed - enough storage space?");
+    End_State
+  End_Method_State_Block
+
+  if (the_file != nullptr)
+    (void) std::fclose(the_file);
+
+  return the_method_error.Get_Error_Code();
+} // Write_Chrome_Trace
@@ -0,0 +1,138 @@
+#ifndef __A4_Tracer_Defined__
+#define __A4_Tracer_Defined__
+/**
+ * @brief   Span tracing of the Method State Block call hierarchy and of Message_Queue hand-offs - Chrome trace-event output.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Tracer.hh
+ * @note  Compile with \b A4_Method_State_Tracing defined and every Method State Block is a span (begin & end events).
+ *        Independently of that define, Message_Queue stamps a Trace_Context into each enqueued Message_Block (and
+ *        Method_Request) and Active_Object::Dispatch continues the trace on the worker thread - a flow arrow from the
+ *        producer's span to the consumer's in the viewer.
+ *
+ *        Nothing is recorded until Tracer::Start. Each thread appends to its own single-producer ring - events are
+ *        dropped (and counted) when it is full - and Tracer::Write_Chrome_Trace drains every ring into a JSON file that
+ *        chrome://tracing and the Perfetto UI load.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Lib_Base.hh"
+
+#ifndef A4_DotNet
+#include <atomic>
+#include <string>
+#endif // A4_DotNet
+
+namespace A4_Lib
+{ // begin
+  namespace Trace_Constant
+  { // begin
+    static const std::size_t  Events_Per_Thread = 65536; /**< ring capacity - a power of two */
+  } // namespace Trace_Constant
+
+  /**
+   * @brief Carried by a Message_Block (or Method_Request) from the producer to the consumer.
+   */
+  typedef struct Trace_Context
+  { // begin
+    std::uint64_t   trace_id = 0; /**< zero when the producer was not tracing */
+    std::uint64_t   flow_id = 0; /**< links the hand-off */
+  } Trace_Context;
+
+  /**
+   * @brief One recorded event.
+   */
+  typedef struct Trace_Event
+  { // begin
+    const char      *name; /**< static */
+    std::int64_t    nano_seconds; /**< Monotonic_Nano_Seconds */
+    std::uint64_t   trace_id;
+    std::uint64_t   flow_id; /**< flow events only */
+    char            phase; /**< Chrome phase - 'B', 'E', 's' (flow start) or 'f' (flow end) */
+  } Trace_Event;
+
+  /**
+   * @brief Span recording and export.
+   */
+  typedef class Tracer
+  { // begin
+  public: // methods
+    static bool   Is_Active (void) noexcept {return Tracer::is_active.load(std::memory_order_relaxed);};
+
+    A4_Export static void   Start (void) noexcept;
+    A4_Export static void   Stop (void) noexcept;
+
+    A4_Export static void   Begin_Span (const char  *the_name) noexcept;
+    A4_Export static void   End_Span (const char  *the_name) noexcept;
+
+    A4_Export static Trace_Context  Send (void) noexcept; // producer side of a hand-off
+    A4_Export static std::uint64_t  Receive (const Trace_Context  &the_context) noexcept; // consumer side - continues the trace, returns the one it replaced
+    A4_Export static void           Restore (std::uint64_t  the_trace_id) noexcept; // the consumer is done - back to the trace Receive replaced
+
+    A4_Export static Error_Code   Write_Chrome_Trace (const std::string   &the_filespec); // drains the recorded events
+
+    A4_Export static std::uint64_t  Get_Dropped_Events (void) noexcept;
+
+  private: // data
+    inline static std::atomic<bool>   is_active {false};
+
+  public: // errors
+    enum Tracer_Errors
+    { // begin
+      WCT_Empty_Filespec            = 0, /**< \b Write_Chrome_Trace: Invalid parameter length - the_filespec is empty. */
+      WCT_FOpen_Error               = 1, /**< \b Write_Chrome_Trace: Call to std::fopen failed. */
+      WCT_Write_Error               = 2, /**< \b Write_Chrome_Trace: Call to std::fputs or std::fclose failed - enough storage space? */
+    }; // Tracer_Errors
+  } Tracer;
+
+  /**
+   * @brief Continues the sender's trace for the lifetime of the instance - declare it before the span of the receiving call.
+   */
+  typedef class Trace_Receive
+  { // begin
+  public: // construction
+    explicit Trace_Receive (const Trace_Context   &the_context) noexcept : is_received(Tracer::Is_Active()) {if (this->is_received == true) this->previous_trace_id = Tracer::Receive(the_context);};
+    Trace_Receive (Trace_Receive &) = delete;
+    ~Trace_Receive (void) {if (this->is_received == true) Tracer::Restore(this->previous_trace_id);};
+
+  private: // data
+    std::uint64_t   previous_trace_id = 0; /**< the calling thread's trace before Receive */
+    bool            is_received; /**< false when the tracer was stopped at construction */
+  } Trace_Receive;
+
+  /**
+   * @brief A span for the lifetime of the instance - declared by Method_State_Block_Begin when A4_Method_State_Tracing is defined.
+   */
+  typedef class Trace_Span
+  { // begin
+  public: // construction
+    explicit Trace_Span (const char   *the_name) noexcept : name((Tracer::Is_Active() == true) ? the_name : nullptr) {if (this->name != nullptr) Tracer::Begin_Span(this->name);};
+    Trace_Span (Trace_Span &) = delete;
+    ~Trace_Span (void) {if (this->name != nullptr) Tracer::End_Span(this->name);};
+
+  private: // data
+    const char  *name; /**< nullptr when the tracer was stopped at construction */
+  } Trace_Span;
+} // namespace A4_Lib
+
+#endif // __A4_Tracer_Defined__
@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <sys/stat.h>
 #include <cstdio>
+#include <cstdint>
 #include <regex>
 #include <limits.h>
 
@@ -131,45 +132,125 @@ namespace A4_Lib
     return the_method_error.Get_Error_Code();      
   } // Struct_TM_To_Time_T
   
+  namespace
+  { // begin
+    /**
+     * @brief The date and time of one second, rendered once for every line of that second on this thread.
+     */
+    typedef struct Timestamp_Cache
+    { // begin
+      std::int64_t  second; /**< since the epoch - INT64_MIN until the first render */
+      std::size_t   length; /**< of text */
+      char          text [Timestamp_Constant::Max_Timestamp_Length]; /**< dd-mm-yyyy hh:mm:ss. - the milliseconds follow */
+    } Timestamp_Cache;
+
+    thread_local Timestamp_Cache  the_timestamp_cache = {INT64_MIN, 0, {0}};
+  } // namespace
+
   /**
    * \brief Translate the current high-resolution clock into a human readable string.
    * @param the_time_string - OUT - the human readable timestamp.
-   * @return No_Error, HRTS_localtime_Error
+   * @return No_Error, or a Timestamp_String error
    */
   Error_Code  High_Res_Timestamp_String (std::string &the_time_string)
   { // begin
-    std::chrono::high_resolution_clock::time_point  the_time_point = std::chrono::high_resolution_clock::now();
-    std::chrono::milliseconds  num_ms = std::chrono::duration_cast<std::chrono::milliseconds>(the_time_point.time_since_epoch());
-    std::chrono::seconds       num_seconds = std::chrono::duration_cast<std::chrono::seconds>(num_ms);
+    std::int64_t  the_nano_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    char          the_buffer [Timestamp_Constant::Max_Timestamp_Length];
+    std::size_t   the_length = 0;
 
-    std::time_t                the_time_t = num_seconds.count ();
+    Method_State_Block_Begin(2)
+      State(1)  
+        the_time_string.clear();
+        the_method_error = Timestamp_String (the_nano_seconds, the_buffer, sizeof(the_buffer), the_length);
+      End_State
 
-    struct tm the_time_info;
-    int    the_error = 0;
+      State(2)
+        the_time_string.assign(the_buffer, the_length);
+      End_State
+    End_Method_State_Block
 
+    return the_method_error.Get_Error_Code();  
+  } // High_Res_Timestamp_String
 
-    Method_State_Block_Begin(1)
-      State(1)  
-        the_time_string.clear();
-        memset(&the_time_info, 0, sizeof (the_time_info));
+  /**
+   * \brief Render the_nano_seconds as dd-mm-yyyy hh:mm:ss.ms, the High_Res_Timestamp_String format. The date and time
+   *        come from a per-thread cache that is rendered again only when the second changes - the milliseconds are
+   *        written in by hand.
+   * @param the_nano_seconds - IN - since the epoch
+   * @param the_buffer - OUT - NUL terminated
+   * @param the_size - IN - at least Max_Timestamp_Length
+   * @param the_length - OUT - without the NUL
+   * @return No_Error, TS_Invalid_Buffer, TS_localtime_Error
+   */
+  Error_Code  Timestamp_String (std::int64_t  the_nano_seconds,
+                                char          *the_buffer,
+                                std::size_t   the_size,
+                                std::size_t   &the_length)
+  { // begin
+    std::int64_t  the_milli_seconds = the_nano_seconds / 1000000;
+    std::int64_t  the_second = the_milli_seconds / 1000;
+    int           the_milli_second = static_cast<int>(the_milli_seconds % 1000);
+
+    if (the_milli_second < 0)
+    { // before the epoch - floor, not truncate
+      the_milli_second += 1000;
+      the_second -= 1;
+    } // if then
+
+    Method_State_Block_Begin(2)
+      State(1)
+        the_length = 0;
+
+        if ((the_buffer == nullptr) || (the_size < Timestamp_Constant::Max_Timestamp_Length))
+          the_method_error = A4_Error (A4_Utils_Module_ID, TS_Invalid_Buffer, "Invalid parameter value - the_buffer is NULL or shorter than Max_Timestamp_Length");
+        else if (the_timestamp_cache.second != the_second)
+        { // a new second - render the date and time
+          std::time_t   the_time_t = static_cast<std::time_t>(the_second);
+          struct tm     the_time_info;
+          int           the_error = 0;
+
+          memset(&the_time_info, 0, sizeof (the_time_info));
 
   #ifdef A4_Lib_Windows      
-        the_error = localtime_s (&the_time_info, &the_time_t);
+          the_error = localtime_s (&the_time_info, &the_time_t);
   #else
-
-        if (localtime_r(&the_time_t, &the_time_info) == NULL)
-         the_error = 1; // 
+          if (localtime_r(&the_time_t, &the_time_info) == NULL)
+            the_error = 1;
   #endif
-        if (the_error != 0)
-          the_method_error = A4_Error (A4_Utils_Module_ID, HRTS_localtime_Error, Logging::Error,
-                                        "Call to localtime failed with error %d", the_error);          
-        else the_method_error = SNPrintf(the_time_string, "%02d-%02d-%d %02d:%02d:%02d.%lld", Max_Error_Message_Length, the_time_info.tm_mday, the_time_info.tm_mon + 1, the_time_info.tm_year + 1900,
-                                                 the_time_info.tm_hour, the_time_info.tm_min, the_time_info.tm_sec, num_ms.count() % 1000);
+          int   the_rendered = (the_error != 0) ? -1 : std::snprintf(the_timestamp_cache.text, sizeof(the_timestamp_cache.text), "%02d-%02d-%d %02d:%02d:%02d.",
+                                                                     the_time_info.tm_mday, the_time_info.tm_mon + 1, the_time_info.tm_year + 1900,
+                                                                     the_time_info.tm_hour, the_time_info.tm_min, the_time_info.tm_sec);
+
+          if ((the_rendered < 0) || (static_cast<std::size_t>(the_rendered) > (sizeof(the_timestamp_cache.text) - 4)))
+          { // begin
+            the_timestamp_cache.second = INT64_MIN;
+            the_method_error = A4_Error (A4_Utils_Module_ID, TS_localtime_Error, Logging::Error, "Call to localtime failed with error %d", the_error);
+          } // if then
+          else
+          { // begin
+            the_timestamp_cache.second = the_second;
+            the_timestamp_cache.length = static_cast<std::size_t>(the_rendered);
+          } // else
+        } // if then
+      End_State
+
+      State(2)
+        std::memcpy(the_buffer, the_timestamp_cache.text, the_timestamp_cache.length);
+        the_length = the_timestamp_cache.length;
+
+        if (the_milli_second >= 100) // not zero padded - as it always was
+          the_buffer [the_length++] = static_cast<char>('0' + (the_milli_second / 100));
+
+        if (the_milli_second >= 10)
+          the_buffer [the_length++] = static_cast<char>('0' + ((the_milli_second / 10) % 10));
+
+        the_buffer [the_length++] = static_cast<char>('0' + (the_milli_second % 10));
+        the_buffer [the_length] = '\0';
       End_State
     End_Method_State_Block
 
-    return the_method_error.Get_Error_Code();  
-  } // High_Res_Timestamp_String
+    return the_method_error.Get_Error_Code();
+  } // Timestamp_String
 
 
   /**
@@ -812,15 +893,14 @@ namespace A4_Lib
                                 String_Vector &the_value_vector,
                                 const char    the_delimiting_character)
   { // begin
-    Method_State         the_value_loop = 0;
-
     std::size_t the_input_offset = 0;
 
     std::string the_parse_string;
 
     bool        in_quote = false;
+    bool        is_end_of_line = false;
 
-    Method_State_Block_Begin(6)
+    Method_State_Block_Begin(4)
       State(1) 
         the_value_vector.clear();
 
@@ -834,61 +914,46 @@ namespace A4_Lib
       End_State
 
       State(3)
-        Define_Target_State(the_value_loop);
-      End_State
-
-      State_NoTry(4)
-        if (the_input_offset >= the_input_string.length())
-        { // all done
-          if (the_parse_string.length() > 0)
-            the_value_vector.push_back(the_parse_string);
-
-          Terminate_The_Method_Block; 
-        } // if then
-      End_State_NoTry
-
-      State(5)
-        switch (the_input_string[the_input_offset])
-        { // begin
-          case '\n': // end of the line
-          case '\r':
-            if (the_parse_string.length() > 0)
-              the_value_vector.push_back(the_parse_string);
-
-            Terminate_The_Method_Block; //all done
-          break;
-
-          case '\"': // double quotes are not included in the value vector...is there a use case to include them?
-            in_quote = !in_quote; // toggle the state
-            the_input_offset += 1;
-          break;
-
-          default: // handle the rest
-            if (the_input_string[the_input_offset] == the_delimiting_character)
-            { // handle the delimiter
-              if (in_quote == true)
-              { // include the delimiter in the value string
-                the_parse_string += the_input_string[the_input_offset];
-              } // if then
-              else { // hit the delimiter
-                if (the_parse_string.length() > 0)
-                { // append the string to the value vector
-                  the_value_vector.push_back(the_parse_string);
-
-                  the_parse_string.clear(); 
+        State_Loop((the_input_offset < the_input_string.length()) && (is_end_of_line == false))
+          switch (the_input_string[the_input_offset])
+          { // begin
+            case '\n': // end of the line
+            case '\r':
+              is_end_of_line = true; //all done
+            break;
+
+            case '\"': // double quotes are not included in the value vector...is there a use case to include them?
+              in_quote = !in_quote; // toggle the state
+            break;
+
+            default: // handle the rest
+              if (the_input_string[the_input_offset] == the_delimiting_character)
+              { // handle the delimiter
+                if (in_quote == true)
+                { // include the delimiter in the value string
+                  the_parse_string += the_input_string[the_input_offset];
                 } // if then
-              } // if else            
-            } // if then
-            else if ((A4_isspace (the_input_string[the_input_offset]) == 0) || (in_quote == true)) // <-- white space is only copied when inside of double-quotes
-                    the_parse_string += the_input_string[the_input_offset];
+                else { // hit the delimiter
+                  if (the_parse_string.length() > 0)
+                  { // append the string to the value vector
+                    the_value_vector.push_back(the_parse_string);
+
+                    the_parse_string.clear(); 
+                  } // if then
+                } // if else            
+              } // if then
+              else if ((A4_isspace (the_input_string[the_input_offset]) == 0) || (in_quote == true)) // <-- white space is only copied when inside of double-quotes
+                      the_parse_string += the_input_string[the_input_offset];
+            break;
+          } // switch      
 
-            the_input_offset += 1;
-          break;
-        } // switch      
+          the_input_offset += 1;
+        End_State_Loop
       End_State
 
-      State(6)
-        Set_Target_State(the_value_loop);
+      State(4)
+        if (the_parse_string.length() > 0) // the last value
+          the_value_vector.push_back(the_parse_string);
       End_State
     End_Method_State_Block
 
@@ -904,15 +969,14 @@ namespace A4_Lib
                                 WString_Vector &the_value_vector,
                                 wchar_t        the_delimiting_character)
   { // begin
-    Method_State    the_value_loop = 0;
-
     std::size_t     the_input_offset = 0;
 
     std::wstring    the_parse_string;
 
     bool            in_quote = false;
+    bool            is_end_of_line = false;
 
-    Method_State_Block_Begin(6)
+    Method_State_Block_Begin(4)
       State(1) 
         the_value_vector.clear();
 
@@ -926,61 +990,46 @@ namespace A4_Lib
       End_State
 
       State(3)
-        Define_Target_State(the_value_loop);
-      End_State
-
-      State_NoTry(4)
-        if (the_input_offset >= the_input_string.length())
-        { // all done
-          if (the_parse_string.length() > 0)
-            the_value_vector.push_back(the_parse_string);
-
-          Terminate_The_Method_Block; 
-        } // if then
-      End_State_NoTry
-
-      State(5)
-        switch (the_input_string[the_input_offset])
-        { // begin
-          case '\n': // end of the line
-          case '\r':
-            if (the_parse_string.length() > 0)
-              the_value_vector.push_back(the_parse_string);
-
-            Terminate_The_Method_Block; //all done
-          break;
-
-          case '\"': // double quotes are not included in the value vector...is there a use case to include them?
-            in_quote = !in_quote; // toggle the state
-            the_input_offset += 1;
-          break;
-
-          default: // handle the rest
-            if (the_input_string[the_input_offset] == the_delimiting_character)
-            { // handle the delimiter
-              if (in_quote == true)
-              { // include the delimiter in the value string
-                the_parse_string += the_input_string[the_input_offset];
-              } // if then
-              else { // hit the delimiter
-                if (the_parse_string.length() > 0)
-                { // append the string to the value vector
-                  the_value_vector.push_back(the_parse_string);
-
-                  the_parse_string.clear(); 
+        State_Loop((the_input_offset < the_input_string.length()) && (is_end_of_line == false))
+          switch (the_input_string[the_input_offset])
+          { // begin
+            case '\n': // end of the line
+            case '\r':
+              is_end_of_line = true; //all done
+            break;
+
+            case '\"': // double quotes are not included in the value vector...is there a use case to include them?
+              in_quote = !in_quote; // toggle the state
+            break;
+
+            default: // handle the rest
+              if (the_input_string[the_input_offset] == the_delimiting_character)
+              { // handle the delimiter
+                if (in_quote == true)
+                { // include the delimiter in the value string
+                  the_parse_string += the_input_string[the_input_offset];
                 } // if then
-              } // if else            
-            } // if then
-            else if ((A4_isspace (the_input_string[the_input_offset]) == 0) || (in_quote == true)) // <-- white space is only copied when inside of double-quotes
-                    the_parse_string += the_input_string[the_input_offset];
+                else { // hit the delimiter
+                  if (the_parse_string.length() > 0)
+                  { // append the string to the value vector
+                    the_value_vector.push_back(the_parse_string);
+
+                    the_parse_string.clear(); 
+                  } // if then
+                } // if else            
+              } // if then
+              else if ((A4_isspace (the_input_string[the_input_offset]) == 0) || (in_quote == true)) // <-- white space is only copied when inside of double-quotes
+                      the_parse_string += the_input_string[the_input_offset];
+            break;
+          } // switch      
 
-            the_input_offset += 1;
-          break;
-        } // switch      
+          the_input_offset += 1;
+        End_State_Loop
       End_State
 
-      State(6)
-        Set_Target_State(the_value_loop);
+      State(4)
+        if (the_parse_string.length() > 0) // the last value
+          the_value_vector.push_back(the_parse_string);
       End_State
     End_Method_State_Block
 
@@ -38,6 +38,11 @@ typedef double DATE;
 
 namespace A4_Lib
 { // begin
+  namespace Timestamp_Constant
+  { // begin
+    static const std::size_t  Max_Timestamp_Length = 32; /**< dd-mm-yyyy hh:mm:ss.mmm and the NUL, with room to spare */
+  } // namespace Timestamp_Constant
+
   A4_Export Error_Code  SNPrintf (char *buf, std::size_t maxlen, const char *format, ...);
   A4_Export Error_Code  SNPrintf (wchar_t *buf, std::size_t maxlen, const wchar_t *format, ...);
 
@@ -67,6 +72,11 @@ namespace A4_Lib
 
   Error_Code  High_Res_Timestamp_String (std::string &the_time_string);
   
+  A4_Export Error_Code  Timestamp_String (std::int64_t  the_nano_seconds, // in - since the epoch, system clock
+                                          char          *the_buffer,      // out - NUL terminated
+                                          std::size_t   the_size,         // in - Max_Timestamp_Length will do
+                                          std::size_t   &the_length);     // out - without the NUL
+  
   Error_Code  DATE_To_Time_T (DATE          the_date,	    // in
 			      std::time_t   &the_time_t); // out
 
@@ -217,6 +227,8 @@ namespace A4_Lib
     SMWWA_Invalid_Wildcard_String_Len   = 52, /**< \b String_Matches_Wildcard(wstring): Invalid parameter length - the_wildcard_string is empty.*/
     TTTST_localtime_s_Error             = 53, /**< \b Time_T_To_Struct_TM: Call to localtime failed with error X */
     STTT_Invalid_Day                    = 54, /**< \b Struct_TM_To_Time_T: Invalid parameter state - the_time_info.tm_mday == X */
+    TS_Invalid_Buffer                   = 55, /**< \b Timestamp_String: Invalid parameter value - the_buffer is NULL or shorter than Max_Timestamp_Length */
+    TS_localtime_Error                  = 56, /**< \b Timestamp_String: Call to localtime failed */
   }; // A4_Lib_Errors
 } // namespace A4_Lib
 
@@ -0,0 +1,384 @@
+#!/usr/bin/env python3
+"""
+@brief   Generate Base/A4_Error_Catalogue.hh from the *_Errors enums - and resolve error codes in a log file offline.
+@author  a. zippay * 2017..2020
+@file A4_Error_Catalogue.py
+@note  The doc comment of every enum value is the catalogue message. The Module_ID of an enum is taken from the sites that
+       raise its errors - A4_Error (X_Module_ID, NAME, ...) or A4_Catalogue_Error (X_Module_ID, NAME, ...) - and the detail
+       level and printf format from the first site that passes them. An undocumented value takes its message from its site. Enums that are never raised are reported and left out.
+
+         python3 Tools/A4_Error_Catalogue.py generate               rewrites Base/A4_Error_Catalogue.hh
+         python3 Tools/A4_Error_Catalogue.py check                  exit status 1 when the checked-in catalogue is stale
+         python3 Tools/A4_Error_Catalogue.py resolve <log file>     appends the catalogue entry to every "Error Code m.ooooo"
+
+The MIT License
+
+Copyright 1995..2020 albert zippay
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+"""
+
+import collections
+import os
+import re
+import sys
+
+Root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+Source_Directories = ['Base', 'Threading', 'Templates'] # Templates/Threading is a copy of Threading
+Excluded_Directories = [os.path.join('Templates', 'Threading')]
+Catalogue_File = os.path.join(Root, 'Base', 'A4_Error_Catalogue.hh')
+
+Enum_Pattern = re.compile(r'enum\s+(\w+_Errors)\b[^{;]*\{(.*?)\}', re.S)
+Value_Pattern = re.compile(r'^\s*(\w+)\s*=\s*(\d+)\s*,?\s*(?:/\*\*<(.*?)\*/)?', re.M)
+Module_Pattern = re.compile(r'const\s+Module_ID\s+(\w+_Module_ID)\s*=\s*(\d+)\s*;')
+Site_Pattern = re.compile(r'\bA4_(?:Catalogue_)?Error\s*\(')
+Detail_Pattern = re.compile(r'^(?:A4_Lib::)?Logging::(\w+)$')
+Literal_Pattern = re.compile(r'^(?:"(?:[^"\\]|\\.)*"\s*)+$')
+Log_Code_Pattern = re.compile(r'Error Code (\d+)\.(\d{5})')
+
+Entry = collections.namedtuple('Entry', 'module_name module_id enum_name value_name offset message format detail')
+
+
+def Read (the_path):
+  with open(the_path, encoding='utf-8', errors='replace') as the_file:
+    return the_file.read().replace('\r\n', '\n')
+
+
+def Source_Files ():
+  for the_directory in Source_Directories:
+    for the_base, the_subdirectories, the_files in os.walk(os.path.join(Root, the_directory)):
+      if any(os.path.relpath(the_base, Root).startswith(the_excluded) for the_excluded in Excluded_Directories):
+        continue
+
+      for the_file in sorted(the_files):
+        if the_file.endswith(('.hh', '.cpp', '.h')) and the_file != os.path.basename(Catalogue_File):
+          yield os.path.join(the_base, the_file)
+
+
+def Strip_Comments (the_text):
+  """ blank out comments but keep the string literals (and the offsets) intact """
+  return re.sub(r'//[^\n]*|/\*.*?\*/|"(?:[^"\\\n]|\\.)*"',
+                lambda the_match: the_match.group(0) if the_match.group(0).startswith('"') else ' ' * len(the_match.group(0)),
+                the_text, flags=re.S)
+
+
+def Split_Arguments (the_text, the_start):
+  """ the top level, comma separated arguments of the call whose '(' precedes the_start """
+  the_arguments = []
+  the_depth = 0
+  the_current = ''
+  the_offset = the_start
+
+  while the_offset < len(the_text):
+    the_char = the_text [the_offset]
+
+    if the_char == '"':
+      the_match = re.compile(r'"(?:[^"\\\n]|\\.)*"').match(the_text, the_offset)
+      if the_match is None:
+        return None
+      the_current += the_match.group(0)
+      the_offset = the_match.end()
+      continue
+
+    if the_char in '([{':
+      the_depth += 1
+    elif the_char in ')]}':
+      if the_depth == 0:
+        the_arguments.append(the_current.strip())
+        return the_arguments
+      the_depth -= 1
+    elif the_char == ',' and the_depth == 0:
+      the_arguments.append(the_current.strip())
+      the_current = ''
+      the_offset += 1
+      continue
+    elif the_char == ';':
+      return None
+
+    the_current += the_char
+    the_offset += 1
+
+  return None
+
+
+def Join_Literal (the_argument):
+  """ "a" "b" -> a b, still escaped for C++ """
+  return ''.join(re.findall(r'"((?:[^"\\]|\\.)*)"', the_argument))
+
+
+def Clean_Message (the_doc):
+  the_doc = ' '.join((the_doc or '').split())
+  the_doc = re.sub(r'^\\b\s+[\w ]*?\w\s*(?:\([^)]*\))?\s*:\s*', '', the_doc) # "\b Method (variant): text" -> "text"
+  the_doc = re.sub(r'\\b\s+', '', the_doc) # remaining doxygen bold markers
+  return the_doc.replace('\\', '\\\\').replace('"', '\\"')
+
+
+def Parse_Modules ():
+  return {the_name: int(the_id) for the_name, the_id in Module_Pattern.findall(Read(os.path.join(Root, 'Base', 'A4_Lib_Module_ID.hh')))}
+
+
+def Parse_Enums ():
+  """ enum name -> (header, [(value name, offset, message)]) """
+  the_enums = {}
+
+  for the_path in Source_Files():
+    for the_enum in Enum_Pattern.finditer(Read(the_path)):
+      the_values = [(the_name, int(the_offset), Clean_Message(the_doc)) for the_name, the_offset, the_doc in Value_Pattern.findall(the_enum.group(2))]
+
+      if the_values and the_enum.group(1) not in the_enums:
+        the_enums [the_enum.group(1)] = (the_path, the_values)
+
+  return the_enums
+
+
+def Parse_Sites (the_modules):
+  """ every A4_Error / A4_Catalogue_Error call whose first two arguments are a Module_ID and a plain enum value """
+  the_sites = []
+
+  for the_path in Source_Files():
+    the_text = Strip_Comments(Read(the_path))
+
+    for the_site in Site_Pattern.finditer(the_text):
+      the_arguments = Split_Arguments(the_text, the_site.end())
+
+      if not the_arguments or len(the_arguments) < 2 or the_arguments [0] not in the_modules:
+        continue
+
+      if not re.match(r'^(?:\w+::)*\w+$', the_arguments [1]):
+        continue # a computed offset - e.g. The_Error_Offset + X
+
+      the_detail = None
+      the_format = None
+      the_message = None
+      the_rest = the_arguments [2:]
+
+      if the_rest and Detail_Pattern.match(the_rest [0]):
+        the_detail = Detail_Pattern.match(the_rest [0]).group(1)
+        if len(the_rest) > 2 and Literal_Pattern.match(the_rest [1]):
+          the_format = Join_Literal(the_rest [1])
+      elif the_rest and Literal_Pattern.match(the_rest [0]):
+        the_message = Join_Literal(the_rest [0])
+        if len(the_rest) > 1 and Detail_Pattern.match(the_rest [1]):
+          the_detail = Detail_Pattern.match(the_rest [1]).group(1)
+
+      the_qualifier, _, the_value = the_arguments [1].rpartition('::')
+      the_sites.append((the_path, the_arguments [0], the_qualifier, the_value, the_detail, the_format, the_message))
+
+  return the_sites
+
+
+def Owning_Enum (the_site, the_enums):
+  """ the enum holding the value raised at the_site - value names repeat across classes so prefer the qualifier, then the file pair """
+  the_path, _, the_qualifier, the_value = the_site [:4]
+  the_candidates = [the_name for the_name, (_, the_values) in the_enums.items() if any(the_value == the_entry [0] for the_entry in the_values)]
+
+  if the_qualifier:
+    the_qualifier = the_qualifier.split('::') [-1]
+    the_matches = [the_name for the_name in the_candidates if the_name in (the_qualifier, the_qualifier + '_Errors')]
+    if the_matches:
+      return the_matches [0]
+
+  the_stem = os.path.splitext(os.path.basename(the_path)) [0]
+  the_matches = [the_name for the_name in the_candidates if os.path.splitext(os.path.basename(the_enums [the_name][0])) [0] == the_stem]
+
+  if the_matches:
+    return the_matches [0]
+
+  return the_candidates [0] if len(the_candidates) == 1 else None
+
+
+def Build_Catalogue ():
+  the_modules = Parse_Modules()
+  the_enums = Parse_Enums()
+  the_enum_modules = collections.defaultdict(collections.Counter)
+  the_site_details = {}
+  the_entries = []
+  the_unraised = []
+
+  for the_site in Parse_Sites(the_modules):
+    the_enum = Owning_Enum(the_site, the_enums)
+
+    if the_enum is None:
+      continue
+
+    the_enum_modules [the_enum][the_site [1]] += 1
+
+    the_key = (the_site [1], the_enum, the_site [3])
+    the_site_details [the_key] = tuple(the_old or the_new for the_old, the_new in zip(the_site_details.get(the_key, (None, None, None)), the_site [4:]))
+
+  for the_enum, (the_path, the_values) in sorted(the_enums.items()):
+    if the_enum not in the_enum_modules:
+      the_unraised.append(the_enum)
+      continue
+
+    the_module = the_enum_modules [the_enum].most_common(1) [0][0]
+
+    for the_value, the_offset, the_message in the_values:
+      the_detail, the_format, the_site_message = the_site_details.get((the_module, the_enum, the_value), (None, None, None))
+      the_message = the_message or the_site_message or the_value.replace('_', ' ') # undocumented values fall back to the raising site
+      the_entries.append(Entry(the_module, the_modules [the_module], the_enum, the_value, the_offset, the_message,
+                               the_format or the_message, the_detail or 'Error'))
+
+  the_entries.sort(key = lambda the_entry: (the_entry.module_id, the_entry.offset))
+
+  for the_previous, the_entry in zip(the_entries, the_entries [1:]):
+    if (the_previous.module_id, the_previous.offset) == (the_entry.module_id, the_entry.offset):
+      sys.exit('A4_Error_Catalogue: %s::%s and %s::%s share %s.%05d' % (the_previous.enum_name, the_previous.value_name, the_entry.enum_name,
+                                                                       the_entry.value_name, the_entry.module_name, the_entry.offset))
+
+  return the_entries, the_unraised
+
+
+def Render (the_entries):
+  the_lines = []
+  the_lines.append('#ifndef __A4_Error_Catalogue_Defined__')
+  the_lines.append('#define __A4_Error_Catalogue_Defined__')
+  the_lines.append('/**')
+  the_lines.append(' * @brief   Static error catalogue - (Module_ID, Error_Offset) to message, detail level and format.')
+  the_lines.append(' * @author  a. zippay * 2017..2020')
+  the_lines.append(' * @file A4_Error_Catalogue.hh')
+  the_lines.append(' * @note  GENERATED by Tools/A4_Error_Catalogue.py from the *_Errors enums - do not edit, edit the enum doc comments and')
+  the_lines.append(' *        run "python3 Tools/A4_Error_Catalogue.py generate".')
+  the_lines.append(' *')
+  the_lines.append(' *        the_method_error = A4_Catalogue_Error (A4_Message_Queue_Module_ID, EQ_Not_Activated);')
+  the_lines.append(' *')
+  the_lines.append(' *        resolves the entry at compile time - an unknown code does not compile - and the error holds only the entry\'s')
+  the_lines.append(' *        address, so no text is built unless a sink formats it.')
+  the_lines.append(' */')
+  the_lines.append('')
+  the_lines.append('#include "A4_Error.hh"')
+  the_lines.append('#include "A4_Lib_Module_ID.hh"')
+  the_lines.append('')
+  the_lines.append('namespace A4_Lib')
+  the_lines.append('{ // begin')
+  the_lines.append('  namespace Error_Catalogue')
+  the_lines.append('  { // begin')
+  the_lines.append('    inline constexpr A4_Error_Descriptor  Entries [] = /**< sorted by error_code */')
+  the_lines.append('    { // begin')
+
+  the_module = None
+  for the_entry in the_entries:
+    if the_entry.module_name != the_module:
+      the_module = the_entry.module_name
+      the_lines.append('      // %s - %s' % (the_module, the_entry.enum_name))
+
+    the_format = 'nullptr' if the_entry.format == the_entry.message else '"%s"' % the_entry.format
+    the_lines.append('      {(Error_Code(%d) << 16) + %d, "%s", %s, Logging::%s}, // %s' % (the_entry.module_id, the_entry.offset, the_entry.message,
+                                                                                 the_format, the_entry.detail, the_entry.value_name))
+
+  the_lines.append('    }; // Entries')
+  the_lines.append('')
+  the_lines.append('    inline constexpr std::size_t  Num_Entries = sizeof(Entries) / sizeof(Entries [0]);')
+  the_lines.append('')
+  the_lines.append('    /**')
+  the_lines.append('     * @brief Retrieve the entry of the_error_code - nullptr when the code is not catalogued.')
+  the_lines.append('     */')
+  the_lines.append('    constexpr const A4_Error_Descriptor *  Find (Error_Code  the_error_code) noexcept')
+  the_lines.append('    { // begin')
+  the_lines.append('      std::size_t   the_low = 0;')
+  the_lines.append('      std::size_t   the_high = Num_Entries;')
+  the_lines.append('')
+  the_lines.append('      while (the_low < the_high)')
+  the_lines.append('      { // begin')
+  the_lines.append('        std::size_t   the_middle = the_low + ((the_high - the_low) / 2);')
+  the_lines.append('')
+  the_lines.append('        if (Entries [the_middle].error_code == the_error_code)')
+  the_lines.append('          return &Entries [the_middle];')
+  the_lines.append('')
+  the_lines.append('        if (Entries [the_middle].error_code < the_error_code)')
+  the_lines.append('          the_low = the_middle + 1;')
+  the_lines.append('        else the_high = the_middle;')
+  the_lines.append('      } // while')
+  the_lines.append('')
+  the_lines.append('      return nullptr;')
+  the_lines.append('    } // Find')
+  the_lines.append('')
+  the_lines.append('    /**')
+  the_lines.append('     * @brief Retrieve the entry of the_error_code - resolved, and checked, at compile time.')
+  the_lines.append('     */')
+  the_lines.append('    template <Error_Code  the_error_code>')
+  the_lines.append('      constexpr const A4_Error_Descriptor &  Entry (void) noexcept')
+  the_lines.append('    { // begin')
+  the_lines.append('      constexpr const A4_Error_Descriptor   *the_entry = Find(the_error_code);')
+  the_lines.append('')
+  the_lines.append('      static_assert(the_entry != nullptr, "the error code is not in the catalogue - run Tools/A4_Error_Catalogue.py generate");')
+  the_lines.append('')
+  the_lines.append('      return *the_entry;')
+  the_lines.append('    } // Entry')
+  the_lines.append('  } // namespace Error_Catalogue')
+  the_lines.append('} // namespace A4_Lib')
+  the_lines.append('')
+  the_lines.append('/**')
+  the_lines.append(' * @brief Build an A4_Error from its catalogue entry - any arguments are captured for the entry\'s format.')
+  the_lines.append(' */')
+  the_lines.append('#define A4_Catalogue_Error(the_module_id, the_error_offset, ...) \\')
+  the_lines.append('  A4_Error (A4_Lib::Error_Catalogue::Entry<A4_Error::Make_Error_Code(the_module_id, the_error_offset)>(), ##__VA_ARGS__)')
+  the_lines.append('')
+  the_lines.append('#endif // __A4_Error_Catalogue_Defined__')
+
+  return '\n'.join(the_lines) + '\n'
+
+
+def Generate (the_check_only):
+  the_entries, the_unraised = Build_Catalogue()
+  the_text = Render(the_entries)
+
+  for the_enum in the_unraised:
+    sys.stderr.write('A4_Error_Catalogue: %s is never raised with a Module_ID - not catalogued\n' % the_enum)
+
+  if the_check_only:
+    if not os.path.exists(Catalogue_File) or Read(Catalogue_File) != the_text:
+      sys.stderr.write('A4_Error_Catalogue: %s is stale\n' % os.path.relpath(Catalogue_File, Root))
+      return 1
+    return 0
+
+  with open(Catalogue_File, 'w', encoding='utf-8', newline='\n') as the_file:
+    the_file.write(the_text)
+
+  sys.stdout.write('%d entries written to %s\n' % (len(the_entries), os.path.relpath(Catalogue_File, Root)))
+  return 0
+
+
+def Resolve (the_log_path):
+  the_entries, _ = Build_Catalogue()
+  the_lookup = {(the_entry.module_id, the_entry.offset): the_entry for the_entry in the_entries}
+
+  def Annotate (the_match):
+    the_entry = the_lookup.get((int(the_match.group(1)), int(the_match.group(2))))
+
+    if the_entry is None:
+      return the_match.group(0)
+
+    return '%s [%s::%s - %s]' % (the_match.group(0), the_entry.enum_name, the_entry.value_name, the_entry.message.replace('\\"', '"'))
+
+  with open(the_log_path, encoding='utf-8', errors='replace') as the_log:
+    for the_line in the_log:
+      sys.stdout.write(Log_Code_Pattern.sub(Annotate, the_line))
+
+  return 0
+
+
+if __name__ == '__main__':
+  if len(sys.argv) == 2 and sys.argv [1] in ('generate', 'check'):
+    sys.exit(Generate(sys.argv [1] == 'check'))
+
+  if len(sys.argv) == 3 and sys.argv [1] == 'resolve':
+    sys.exit(Resolve(sys.argv [2]))
+
+  sys.exit(__doc__)
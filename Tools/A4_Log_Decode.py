@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""
+@brief   Print a binary File_Logger log file as the text log it stands for.
+@author  a. zippay * 2017..2020
+@file A4_Log_Decode.py
+@note  A binary log file - File_Logger::Set_Binary_Mode(true) - starts with File_Magic and holds Log_Record_Header records
+       (Base/A4_Log_Staging_Buffer.hh), each followed by its payload. A Format_Record carries the format string of the
+       Event_Records with its format_id that follow it, Log_Arguments (Base/A4_Binary_Log.hh) carry their arguments.
+
+         python3 Tools/A4_Log_Decode.py <binary log file>     the text lines, the same as the text log would have
+         python3 Tools/A4_Log_Decode.py check                 exit status 1 when Format_Event disagrees with Format_Cases
+
+The MIT License
+
+Copyright 1995..2020 albert zippay
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+"""
+
+import re
+import struct
+import sys
+import time
+
+File_Magic = b'A4BLOG01'
+Header = struct.Struct('<IBBHIIqq') # Log_Record_Header
+
+Line_Record = 1
+Message_Record = 2
+Event_Record = 3
+Format_Record = 4
+
+Content_Dump = 9
+Detail_Strings = ['Comment', 'Off', 'ERROR', 'WARNING', 'INFO', 'Module-Specific Info', 'DEBUG', 'CONTENT DUMP BEGIN', 'CONTENT DUMP END', 'CONTENT DUMP'] # Logger::Get_Detail_Level_String
+
+Specification_Pattern = re.compile(r'%([-+ #0]*)(\*?[0-9]*)(?:\.(\*?[0-9]*))?[hlLqjzt]*(.?)', re.S)
+Conversions = 'diuoxXceEfFgGaAsp' # anything else is not a conversion - it takes no argument and is printed as it is
+Max_Star_Value = 256 # a '*' width or precision is clamped to +/- this
+Max_Field_Length = 10 # flags, width and precision each keep at most this many characters
+
+# the format, the arguments and the text Log_Arguments::Format gives - benchmarks/A4_Binary_Log_Benchmark.cpp checks the same
+Format_Cases = [('[%*d|%-*d]', [('i', 4), ('i', 7), ('i', 3), ('i', 8)], '[   7|8  ]'),
+                ('[%.*f|%.*s]', [('i', 2), ('d', 3.14159), ('i', 3), ('s', 'abcdef')], '[3.14|abc]'),
+                ('[%*d]', [('i', -4), ('i', 7)], '[7   ]'),
+                ('[%.*d]', [('i', -1), ('i', 7)], '[7]'),
+                ('[%*.*f]', [('i', 8), ('i', 3), ('d', 2.5)], '[   2.500]'),
+                ('[%*d]', [('i', 4)], '[(missing)]'),
+                ('[%y|%d]', [('i', 7)], '[%y|7]'),
+                ('[%5k|%s]', [('s', 'x')], '[%5k|x]'),
+                ('[%**d|%d]', [('i', 7)], '[%**d|7]'),
+                ('[%d%]', [('i', 7)], '[7%]'),
+                ('[%d|%]', [('i', 7)], '[7|%]'),
+                ('[%d]%', [('i', 7)], '[7]%')]
+
+
+def Read_Arguments (the_payload):
+  the_arguments = []
+  the_offset = 0
+
+  while the_offset < len(the_payload):
+    the_tag = chr(the_payload [the_offset])
+    the_offset += 1
+
+    if the_tag == 's':
+      if the_offset + 2 > len(the_payload):
+        break
+
+      (the_length,) = struct.unpack_from('<H', the_payload, the_offset)
+      the_arguments.append(('s', the_payload [the_offset + 2:the_offset + 2 + the_length].decode('utf-8', errors='replace')))
+      the_offset += 2 + the_length
+    elif the_offset + 8 > len(the_payload):
+      break
+    elif the_tag == 'i':
+      the_arguments.append(('i', struct.unpack_from('<q', the_payload, the_offset) [0]))
+      the_offset += 8
+    elif the_tag == 'd':
+      the_arguments.append(('d', struct.unpack_from('<d', the_payload, the_offset) [0]))
+      the_offset += 8
+    else: # u & p
+      the_arguments.append((the_tag, struct.unpack_from('<Q', the_payload, the_offset) [0]))
+      the_offset += 8
+
+  return the_arguments
+
+
+def As_Signed (the_argument):
+  """ Log_Arguments::Format As_Signed - a string is zero """
+  the_tag, the_value = the_argument
+
+  if the_tag == 's':
+    return 0
+  elif the_tag == 'd':
+    return int(the_value)
+
+  the_value = int(the_value) & 0xFFFFFFFFFFFFFFFF
+
+  return the_value - (1 << 64) if the_value & (1 << 63) else the_value
+
+
+def Put_Field (the_field, is_precision, the_arguments):
+  """ Log_Arguments::Format Put_Field - a '*' takes its value from the next argument, None when it is missing """
+  if the_field != '*':
+    return ('.' if is_precision else '') + the_field [:Max_Field_Length]
+
+  the_argument = next(the_arguments, None)
+
+  if the_argument is None:
+    return None
+
+  the_value = max(-Max_Star_Value, min(Max_Star_Value, As_Signed(the_argument)))
+
+  if is_precision:
+    return '' if the_value < 0 else '.%d' % the_value
+
+  return '%d' % the_value
+
+
+def Format_Event (the_format, the_payload):
+  """ Log_Arguments::Format - each conversion takes the next argument, whatever its length modifier """
+  return Format_Arguments(the_format, Read_Arguments(the_payload))
+
+
+def Format_Arguments (the_format, the_argument_list):
+  """ a '*' width or precision takes an argument first, an unknown conversion takes none and is printed as it is """
+  the_arguments = iter(the_argument_list)
+
+  def Convert (the_match):
+    the_flags, the_width, the_precision, the_conversion = the_match.group(1, 2, 3, 4)
+
+    if the_conversion == '%' and the_match.end() - the_match.start() == 2:
+      return '%'
+
+    if the_conversion == '' or the_conversion not in Conversions or len(the_width) > 1 and '*' in the_width or \
+       the_precision is not None and len(the_precision) > 1 and '*' in the_precision:
+      return the_match.group(0)
+
+    the_width = Put_Field(the_width, False, the_arguments)
+    the_precision = Put_Field(the_precision, True, the_arguments) if the_width is not None and the_precision is not None else ''
+
+    if the_width is None or the_precision is None:
+      return '(missing)'
+
+    the_flags = the_flags [:Max_Field_Length] + the_width + the_precision
+    the_argument = next(the_arguments, None)
+
+    if the_argument is None:
+      return '(missing)'
+
+    the_tag, the_value = the_argument
+
+    try:
+      if the_conversion in 'di':
+        return ('%' + the_flags + 'd') % As_Signed(the_argument)
+      elif the_conversion in 'uoxX':
+        return ('%' + the_flags + ('d' if the_conversion == 'u' else the_conversion)) % (As_Signed(the_argument) & 0xFFFFFFFFFFFFFFFF)
+      elif the_conversion == 'c':
+        return ('%' + the_flags + 'c') % chr(As_Signed(the_argument) & 0xFF)
+      elif the_conversion in 'eEfFgG':
+        return ('%' + the_flags + the_conversion) % (0.0 if the_tag == 's' else float(the_value))
+      elif the_conversion in 'aA':
+        return float(the_value).hex()
+      elif the_conversion == 's':
+        return ('%' + the_flags + 's') % the_value if the_tag == 's' else '(not a string)'
+      elif the_conversion == 'p':
+        return '0x%x' % the_value
+    except (TypeError, ValueError):
+      pass
+
+    return the_match.group(0)
+
+  return Specification_Pattern.sub(Convert, the_format)
+
+
+def Check ():
+  the_failures = 0
+
+  for the_format, the_arguments, the_expected in Format_Cases:
+    the_text = Format_Arguments(the_format, the_arguments)
+
+    if the_text != the_expected:
+      sys.stderr.write('A4_Log_Decode: %r gives %r, not %r\n' % (the_format, the_text, the_expected))
+      the_failures += 1
+
+  return 1 if the_failures else 0
+
+
+def Timestamp (the_nano_seconds):
+  """ High_Res_Timestamp_String """
+  the_time = time.localtime(the_nano_seconds // 1000000000)
+
+  return '%02d-%02d-%d %02d:%02d:%02d.%d' % (the_time.tm_mday, the_time.tm_mon, the_time.tm_year, the_time.tm_hour, the_time.tm_min, the_time.tm_sec,
+                                             (the_nano_seconds // 1000000) % 1000)
+
+
+def Decode (the_log_path):
+  the_formats = {}
+
+  with open(the_log_path, 'rb') as the_log:
+    if the_log.read(len(File_Magic)) != File_Magic:
+      sys.stderr.write('%s is not a binary A4 log file\n' % the_log_path)
+      return 1
+
+    the_output = sys.stdout.buffer
+
+    while True:
+      the_bytes = the_log.read(Header.size)
+
+      if len(the_bytes) < Header.size:
+        break
+
+      the_length, the_kind, the_detail, _, the_format_id, _, the_sequence, the_nano_seconds = Header.unpack(the_bytes)
+      the_payload = the_log.read(the_length)
+
+      if len(the_payload) < the_length:
+        sys.stderr.write('%s ends inside a record\n' % the_log_path)
+        return 1
+
+      if the_kind == Format_Record:
+        the_formats [the_format_id] = the_payload.decode('utf-8', errors='replace')
+        continue
+      elif the_kind == Line_Record:
+        the_output.write(the_payload)
+        continue
+      elif the_kind == Event_Record:
+        the_text = Format_Event(the_formats.get(the_format_id, '(unknown format %d)' % the_format_id), the_payload)
+      else:
+        the_text = the_payload.decode('utf-8', errors='replace')
+
+      if the_detail == Content_Dump:
+        the_line = '%d: %s' % (the_sequence, the_text)
+      else:
+        the_line = '%s (%06d) %s - %s\r\n' % (Detail_Strings [the_detail] if the_detail < len(Detail_Strings) else 'Undefined Level', the_sequence,
+                                              Timestamp(the_nano_seconds), the_text)
+
+      the_output.write(the_line.encode('utf-8', errors='replace'))
+
+  return 0
+
+
+if __name__ == '__main__':
+  if len(sys.argv) == 2 and sys.argv [1] == 'check':
+    sys.exit(Check())
+
+  if len(sys.argv) == 2:
+    sys.exit(Decode(sys.argv [1]))
+
+  sys.exit(__doc__)
@@ -0,0 +1,143 @@
+#ifndef __A4_Benchmark_Report_Defined__
+#define __A4_Benchmark_Report_Defined__
+/**
+ * @brief   Timing helper and JSON results file shared by the benchmarks.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Benchmark_Report.hh
+ * @note  Each benchmark collects its cases in a Benchmark_Report and writes them to the file named by its first argument
+ *        (default <benchmark>.json):
+ *
+ *          {"benchmark":"A4_Primitive_Benchmark","time":1600000000,"compiler":"9.3.0","results":[
+ *            {"name":"mutex/lock_unlock","unit":"ns/op","value":21.34,"iterations":10000000}, ...]}
+ *
+ *        "make run" in this directory leaves one file per benchmark in results/ - compare two runs by name and unit.
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace A4_Benchmark
+{ // begin
+  /**
+   * @brief One measured case.
+   */
+  typedef struct Benchmark_Result
+  { // begin
+    std::string     name; /**< group/case - stable across runs */
+    std::string     unit; /**< ns/op, msg/s, lines/s ... */
+    double          value;
+    std::uint64_t   iterations;
+  } Benchmark_Result;
+
+  /**
+   * @brief The results of one benchmark program.
+   */
+  typedef class Benchmark_Report
+  { // begin
+  public: // construction
+    Benchmark_Report (const char  *the_benchmark_name,
+                      int         argc,
+                      char        *argv []) : benchmark_name(the_benchmark_name),
+                                              filespec((argc > 1) ? std::string(argv [1]) : std::string(the_benchmark_name) + ".json") {};
+
+  public: // methods
+    /**
+     * @brief Record a case and print it.
+     */
+    void  Add (const std::string  &the_name,
+               const char         *the_unit,
+               double             the_value,
+               std::uint64_t      the_iterations)
+    { // begin
+      this->results.push_back(Benchmark_Result {the_name, the_unit, the_value, the_iterations});
+
+      std::printf("  %-44s : %14.2f %s\n", the_name.c_str(), the_value, the_unit);
+    } // Add
+
+    /**
+     * @brief Write every case to the JSON file.
+     * @return \b true on success
+     */
+    bool  Write (void) const
+    { // begin
+      std::FILE   *the_file = std::fopen(this->filespec.c_str(), "w");
+      bool        is_written = (the_file != nullptr);
+
+      if (is_written == true)
+      { // begin
+        is_written = (std::fprintf(the_file, "{\"benchmark\":\"%s\",\"time\":%lld,\"compiler\":\"%s\",\"results\":[", this->benchmark_name.c_str(),
+                                   static_cast<long long>(std::time(nullptr)), __VERSION__) >= 0);
+
+        for (std::size_t the_offset = 0; (the_offset < this->results.size()) && (is_written == true); the_offset++)
+          is_written = (std::fprintf(the_file, "%s\n  {\"name\":\"%s\",\"unit\":\"%s\",\"value\":%.3f,\"iterations\":%llu}", (the_offset == 0) ? "" : ",",
+                                     this->results [the_offset].name.c_str(), this->results [the_offset].unit.c_str(), this->results [the_offset].value,
+                                     static_cast<unsigned long long>(this->results [the_offset].iterations)) >= 0);
+
+        is_written = (is_written == true) && (std::fprintf(the_file, "\n]}\n") >= 0);
+        is_written = (std::fclose(the_file) == 0) && (is_written == true);
+      } // if then
+
+      if (is_written == false)
+        std::printf("failed to write %s\n", this->filespec.c_str());
+      else std::printf("results written to %s\n", this->filespec.c_str());
+
+      return is_written;
+    } // Write
+
+  private: // data
+    std::string                     benchmark_name;
+    std::string                     filespec; /**< the JSON output */
+    std::vector<Benchmark_Result>   results;
+  } Benchmark_Report;
+
+  /**
+   * @brief Make the_value appear used - keeps the compiler from eliding the object under test (gcc & clang).
+   */
+  template <typename The_Value> inline void   Keep (The_Value   &the_value)
+  { // begin
+    asm volatile ("" : : "r" (&the_value) : "memory");
+  } // Keep
+
+  /**
+   * @brief Call the_operation the_num_calls times.
+   * @return nano-seconds per call
+   */
+  template <typename The_Operation> double  Nano_Seconds_Per_Call (std::size_t     the_num_calls,
+                                                                  The_Operation   the_operation)
+  { // begin
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_call = 0; the_call < the_num_calls; the_call++)
+      the_operation(the_call);
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(the_num_calls);
+  } // Nano_Seconds_Per_Call
+} // namespace A4_Benchmark
+
+#endif // __A4_Benchmark_Report_Defined__
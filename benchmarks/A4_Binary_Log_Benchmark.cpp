@@ -0,0 +1,166 @@
+/**
+ * @brief   Cost of the deferred-format log path - A4_Log_Event into a binary log file.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Binary_Log_Benchmark.cpp
+ * @note  Writes the same lines as the file_logger cases of A4_Primitive_Benchmark, but with A4_Log_Event into a binary log
+ *        file, and times the argument encoding and the formatting left to the worker or the decoder.
+ *
+ *        make A4_Binary_Log_Benchmark && ./build/A4_Binary_Log_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+
+#include "A4_Binary_Log.hh"
+#include "A4_File_Logger.hh"
+
+#include <cstdio>
+#include <cstdlib>
+
+
+namespace
+{ // begin
+  const std::size_t   Num_Calls = 1000000; /**< per case */
+  const std::size_t   Num_Log_Lines = 200000; /**< as A4_Primitive_Benchmark */
+
+  volatile std::uint64_t  the_sink = 0; /**< keeps the results from being optimized away */
+
+  /**
+   * @brief Stop on a failed call - a benchmark of a failing primitive measures the wrong thing.
+   */
+  void  Check (Error_Code   the_error,
+               const char   *the_case)
+  { // begin
+    if (the_error != No_Error)
+    { // begin
+      std::printf("%s failed with error %1.5f\n", the_case, A4_Error::Get_Dot_Error_Code(the_error));
+      std::exit(1);
+    } // if then
+  } // Check
+
+  /**
+   * @brief Stop on a wrong result - the timings of a broken primitive are not worth reporting.
+   */
+  void  Verify (bool         is_correct,
+                const char   *the_case)
+  { // begin
+    if (is_correct != true)
+    { // begin
+      std::printf("%s - verification failed\n", the_case);
+      std::exit(1);
+    } // if then
+  } // Verify
+
+  /**
+   * @brief Format the_args with the_format as the File_Logger worker would.
+   */
+  template <typename... The_Args> std::string   Format_Event (const char          *the_format,
+                                                              const The_Args &... the_args)
+  { // begin
+    char          the_arguments [A4_Lib::Binary_Log_Constant::Max_Argument_Bytes];
+    std::size_t   the_length = A4_Lib::Log_Arguments::Encode(the_arguments, sizeof(the_arguments), the_args...);
+    std::string   the_text;
+
+    Check(A4_Lib::Log_Arguments::Format(the_format, the_arguments, the_length, the_text), the_format);
+
+    return the_text;
+  } // Format_Event
+
+  /**
+   * @brief A '*' width or precision takes an argument first and an unknown conversion takes none, or every later argument
+   *        is off by one - the Format_Cases of Tools/A4_Log_Decode.py check the same.
+   */
+  void  Verify_Format (void)
+  { // begin
+    Verify(Format_Event("[%*d|%-*d]", 4, 7, 3, 8) == "[   7|8  ]", "Log_Arguments::Format * width");
+    Verify(Format_Event("[%.*f|%.*s]", 2, 3.14159, 3, "abcdef") == "[3.14|abc]", "Log_Arguments::Format * precision");
+    Verify(Format_Event("[%*d]", -4, 7) == "[7   ]", "Log_Arguments::Format negative * width");
+    Verify(Format_Event("[%.*d]", -1, 7) == "[7]", "Log_Arguments::Format negative * precision");
+    Verify(Format_Event("[%*.*f]", 8, 3, 2.5) == "[   2.500]", "Log_Arguments::Format * width and precision");
+    Verify(Format_Event("[%*d]", 4) == "[(missing)]", "Log_Arguments::Format missing argument");
+    Verify(Format_Event("[%y|%d]", 7) == "[%y|7]", "Log_Arguments::Format unknown conversion");
+    Verify(Format_Event("[%5k|%s]", "x") == "[%5k|x]", "Log_Arguments::Format unknown conversion with width");
+    Verify(Format_Event("[%**d|%d]", 7) == "[%**d|7]", "Log_Arguments::Format malformed *");
+    Verify(Format_Event("[%d%]", 7) == "[7%]", "Log_Arguments::Format stray %");
+    Verify(Format_Event("[%d|%]", 7) == "[7|%]", "Log_Arguments::Format stray % before text");
+    Verify(Format_Event("[%d]%", 7) == "[7]%", "Log_Arguments::Format trailing %");
+  } // Verify_Format
+
+  /**
+   * @brief Log_Arguments on their own.
+   */
+  void  Argument_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    char          the_arguments [A4_Lib::Binary_Log_Constant::Max_Argument_Bytes];
+    std::size_t   the_length = A4_Lib::Log_Arguments::Encode(the_arguments, sizeof(the_arguments), 12345ull, 200000ull, 3.00004, "a string argument");
+
+    the_report.Add("binary_log/encode_arguments", "ns/op", A4_Benchmark::Nano_Seconds_Per_Call(Num_Calls, [&the_arguments] (std::size_t the_call)
+                   {the_sink = A4_Lib::Log_Arguments::Encode(the_arguments, sizeof(the_arguments), static_cast<unsigned long long>(the_call), 200000ull, 3.00004, "a string argument");
+                    A4_Benchmark::Keep(the_arguments);}), Num_Calls);
+
+    the_report.Add("binary_log/format_arguments", "ns/op", A4_Benchmark::Nano_Seconds_Per_Call(Num_Calls, [&the_arguments, the_length] (std::size_t)
+                   {std::string the_text; Check(A4_Lib::Log_Arguments::Format("benchmark line %llu of %llu - %1.5f %s", the_arguments, the_length, the_text), "Log_Arguments::Format");
+                    the_sink = the_text.size();}), Num_Calls);
+  } // Argument_Cases
+
+  /**
+   * @brief Write Num_Log_Lines events and close the log - Close returns once every record is in the file.
+   */
+  void  Binary_Log_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string   the_filespec = "./A4_Binary_Log_Benchmark.log";
+
+    (void) std::remove(the_filespec.c_str());
+
+    Check(A4_File_Log->Set_Binary_Mode(true), "File_Logger::Set_Binary_Mode");
+    Check(A4_File_Log->Open(the_filespec, A4_Lib::Logging::Info), "File_Logger::Open");
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_line = 0; the_line < Num_Log_Lines; the_line++)
+      A4_Log_Event(A4_Lib::Logging::Info, "benchmark line %llu of %llu", static_cast<unsigned long long>(the_line), static_cast<unsigned long long>(Num_Log_Lines));
+
+    the_report.Add("binary_log/event_call", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Log_Lines), Num_Log_Lines);
+
+    A4_File_Log->Close();
+
+    the_report.Add("binary_log/event_lines", "lines/s",
+                   static_cast<double>(Num_Log_Lines) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count(), Num_Log_Lines);
+  } // Binary_Log_Cases
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Binary_Log_Benchmark", argc, argv);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton();
+
+  Verify_Format();
+  Argument_Cases(the_report);
+  Binary_Log_Cases(the_report);
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
@@ -0,0 +1,188 @@
+/**
+ * @brief   Throughput of a thread-blocking Active_Object against a Coroutine_Active_Object with many requests in flight.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Coroutine_Benchmark.cpp
+ * @note  Every request waits for a simulated 1ms of I/O and then for a reply from a second (server) active object.
+ *        The blocking client holds a worker thread for both waits; the coroutine client releases it.
+ *
+ *        make A4_Coroutine_Benchmark && ./build/A4_Coroutine_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+
+#include "A4_Coroutine_Active_Object.hh"
+#include "A4_File_Logger.hh"
+#include "A4_Utils.hh"
+
+#include <atomic>
+#include <cstdlib>
+
+#ifndef A4_Lib_Coroutines
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Coroutine_Benchmark", argc, argv);
+
+  std::printf("coroutines are not supported by this compiler - build with -std=c++20\n");
+
+  return (the_report.Write() == true) ? 0 : 1; // no results
+} // main
+#else
+
+namespace
+{ // begin
+  const std::size_t     Num_In_Flight = 10000; /**< requests enqueued up front */
+  const std::size_t     Num_Client_Threads = 8; /**< worker threads of each client */
+  const std::uint64_t   Simulated_IO_MS = 1; /**< per request */
+
+  std::atomic<std::size_t>  num_completed(0);
+
+  /**
+   * @brief Replies to both clients.
+   */
+  class Server : public A4_Lib::Active_Object
+  { // begin
+  public:
+    static int  Reply (int  the_value) {return the_value + 1;};
+  }; // Server
+
+  /**
+   * @brief Holds its worker thread while it waits.
+   */
+  class Blocking_Client : public A4_Lib::Active_Object
+  { // begin
+  public:
+    explicit Blocking_Client (Server  &the_server) : server(the_server) {};
+
+  protected:
+    virtual Error_Code  Process_Message (A4_Lib::Message_Block::Pointer   &the_message_block) override
+    { // begin
+      std::future<int>  the_reply;
+
+      A4_Lib::Sleep_MS(Simulated_IO_MS);
+
+      if (this->server.Submit([] () {return Server::Reply(1);}, the_reply) == No_Error)
+        (void) the_reply.get();
+
+      the_message_block.reset();
+      num_completed.fetch_add(1, std::memory_order_relaxed);
+
+      return No_Error;
+    } // Process_Message
+
+  private:
+    Server  &server;
+  }; // Blocking_Client
+
+  /**
+   * @brief Releases its worker thread while it waits.
+   */
+  class Coroutine_Client : public A4_Lib::Coroutine_Active_Object
+  { // begin
+  public:
+    explicit Coroutine_Client (Server  &the_server) : server(the_server) {};
+
+  protected:
+    virtual A4_Lib::Coroutine_Task  Process_Message_Async (A4_Lib::Message_Block::Pointer   the_message_block) override
+    { // begin
+      int   the_reply = 0;
+
+      (void) co_await this->Await_Timer(Simulated_IO_MS);
+      (void) co_await this->Await_Reply(this->server, [] () {return Server::Reply(1);}, the_reply);
+
+      the_message_block.reset();
+      num_completed.fetch_add(1, std::memory_order_relaxed);
+
+      co_return No_Error;
+    } // Process_Message_Async
+
+  private:
+    Server  &server;
+  }; // Coroutine_Client
+
+  /**
+   * @brief Enqueue Num_In_Flight messages and time until every one has completed.
+   * @return messages per second
+   */
+  double  Run (A4_Lib::Active_Object   &the_client)
+  { // begin
+    A4_Lib::Message_Block::Pointer  the_message_block;
+
+    num_completed = 0;
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_offset = 0; the_offset < Num_In_Flight; the_offset++)
+    { // begin
+      the_message_block.reset();
+
+      if ((A4_Lib::Message_Block::Allocate(the_message_block) != No_Error) || (the_client.Enqueue_Message(the_message_block) != No_Error))
+      { // begin
+        std::printf("enqueue failed\n");
+        std::exit(1);
+      } // if then
+    } // for
+
+    while (num_completed.load(std::memory_order_relaxed) < Num_In_Flight)
+      A4_Lib::Sleep_MS(1);
+
+    return static_cast<double>(Num_In_Flight) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count();
+  } // Run
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Coroutine_Benchmark", argc, argv);
+
+  Server            the_server;
+  Blocking_Client   the_blocking_client(the_server);
+  Coroutine_Client  the_coroutine_client(the_server);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton();
+  (void) A4_File_Log->Open("./A4_Coroutine_Benchmark.log", A4_Lib::Logging::Error);
+
+  if ((the_server.Initialize(Num_Client_Threads) != No_Error) || (the_server.Start() != No_Error) ||
+      (the_blocking_client.Initialize(Num_Client_Threads, A4_Lib::Active_Object_Constant::Default_Message_Queue_Wait_MS, Num_In_Flight) != No_Error) || (the_blocking_client.Start() != No_Error) ||
+      (the_coroutine_client.Initialize(Num_Client_Threads, A4_Lib::Active_Object_Constant::Default_Message_Queue_Wait_MS, Num_In_Flight) != No_Error) || (the_coroutine_client.Start() != No_Error))
+  { // begin
+    std::printf("start up failed\n");
+    return 1;
+  } // if then
+
+  std::printf("%zu requests in flight, %zu worker threads per client, %llu ms simulated i/o\n", Num_In_Flight, Num_Client_Threads, static_cast<unsigned long long>(Simulated_IO_MS));
+
+  the_report.Add("active_object/blocking_client", "msg/s", Run(the_blocking_client), Num_In_Flight);
+  the_report.Add("coroutine_active_object/client", "msg/s", Run(the_coroutine_client), Num_In_Flight);
+
+  (void) the_coroutine_client.Stop();
+  (void) the_blocking_client.Stop();
+  (void) the_server.Stop();
+
+  A4_File_Log->Close();
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
+#endif // A4_Lib_Coroutines
@@ -0,0 +1,129 @@
+/**
+ * @brief   Cost of the crash ring - a record copied into the mapped ring file, and the File_Logger writing with it.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Crash_Ring_Benchmark.cpp
+ * @note  Times Log_Crash_Ring::Append & Mark_Written on their own - what Stage_Record and the worker sweep add per record -
+ *        then writes the same lines as the file_logger cases of A4_Primitive_Benchmark with the crash ring open.
+ *
+ *        make A4_Log_Crash_Ring_Benchmark && ./build/A4_Log_Crash_Ring_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+#include "A4_File_Logger.hh"
+#include "A4_Log_Crash_Ring.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+
+namespace
+{ // begin
+  const std::size_t   Num_Calls = 1000000; /**< per case */
+  const std::size_t   Num_Log_Lines = 200000; /**< as A4_Primitive_Benchmark */
+
+  volatile std::uint64_t  the_sink = 0; /**< keeps the results from being optimized away */
+
+  /**
+   * @brief Stop on a failed call - a benchmark of a failing primitive measures the wrong thing.
+   */
+  void  Check (Error_Code   the_error,
+               const char   *the_case)
+  { // begin
+    if (the_error != No_Error)
+    { // begin
+      std::printf("%s failed with error %1.5f\n", the_case, A4_Error::Get_Dot_Error_Code(the_error));
+      std::exit(1);
+    } // if then
+  } // Check
+
+  /**
+   * @brief Log_Crash_Ring on its own - a log line sized record, appended and then marked written.
+   */
+  void  Crash_Ring_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string   the_filespec = "./A4_Log_Crash_Ring_Benchmark.ring";
+    const std::string   the_line = "INFO (000042) 18-10-2020 12:00:00.123 - benchmark line of a log file write batch - 0123456789\r\n";
+
+    A4_Lib::Log_Crash_Ring            the_ring;
+    A4_Lib::Crash_Ring_Record_Vector  the_records;
+    A4_Lib::Log_Record_Header         the_header = {static_cast<std::uint32_t>(the_line.length()), A4_Lib::Line_Record, A4_Lib::Logging::Info, 0, 0, 0, 0, 0};
+
+    (void) std::remove(the_filespec.c_str());
+
+    Check(the_ring.Open(the_filespec, A4_Lib::Log_Crash_Ring_Constant::Default_Size, the_records), "Log_Crash_Ring::Open");
+
+    the_report.Add("crash_ring/append", "ns/op", A4_Benchmark::Nano_Seconds_Per_Call(Num_Calls, [&the_ring, &the_header, &the_line] (std::size_t the_call)
+                   {the_header.sequence = static_cast<std::int64_t>(the_call);
+                    the_sink = the_ring.Append(the_header, the_line.c_str(), nullptr);}), Num_Calls);
+
+    the_report.Add("crash_ring/append_mark_written", "ns/op", A4_Benchmark::Nano_Seconds_Per_Call(Num_Calls, [&the_ring, &the_header, &the_line] (std::size_t the_call)
+                   {the_header.sequence = static_cast<std::int64_t>(the_call);
+                    the_ring.Mark_Written(the_ring.Append(the_header, the_line.c_str(), nullptr), the_header.sequence);}), Num_Calls);
+
+    Check(the_ring.Close(), "Log_Crash_Ring::Close");
+
+    (void) std::remove(the_filespec.c_str());
+  } // Crash_Ring_Cases
+
+  /**
+   * @brief Write Num_Log_Lines lines with the crash ring open and close the log - Close returns once every line is in the file.
+   */
+  void  File_Logger_Case (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string   the_filespec = "./A4_Log_Crash_Ring_Benchmark.log";
+
+    (void) std::remove(the_filespec.c_str());
+
+    Check(A4_File_Log->Set_Crash_Ring(true), "File_Logger::Set_Crash_Ring");
+    Check(A4_File_Log->Open(the_filespec, A4_Lib::Logging::Info), "File_Logger::Open");
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_line = 0; the_line < Num_Log_Lines; the_line++)
+      (void) App_Log->Write(A4_Lib::Logging::Info, "benchmark line %llu of %llu", static_cast<unsigned long long>(the_line), static_cast<unsigned long long>(Num_Log_Lines));
+
+    the_report.Add("crash_ring/write_call", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Log_Lines), Num_Log_Lines);
+
+    A4_File_Log->Close();
+
+    the_report.Add("crash_ring/write_lines", "lines/s",
+                   static_cast<double>(Num_Log_Lines) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count(), Num_Log_Lines);
+  } // File_Logger_Case
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Log_Crash_Ring_Benchmark", argc, argv);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton(); // opened by File_Logger_Case only
+
+  Crash_Ring_Cases(the_report);
+  File_Logger_Case(the_report);
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
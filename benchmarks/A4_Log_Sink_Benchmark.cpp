@@ -0,0 +1,130 @@
+/**
+ * @brief   Cost of the Composite_Logger fan-out - one formatted line submitted to several sinks.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Sink_Benchmark.cpp
+ * @note  Writes the lines of the file_logger cases of A4_Primitive_Benchmark through a Composite_Logger with a file and
+ *        a memory sink, then again with a sink added that never keeps up - the writing thread and the other sinks
+ *        should not notice it.
+ *
+ *        make A4_Log_Sink_Benchmark && ./build/A4_Log_Sink_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+#include "A4_Composite_Logger.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+
+namespace
+{ // begin
+  const std::size_t   Num_Log_Lines = 200000; /**< per case - as A4_Primitive_Benchmark */
+
+  /**
+   * @brief A sink that takes a millisecond per record - a collector that has stopped reading.
+   */
+  typedef class Stalled_Sink : public A4_Lib::Log_Sink
+  { // begin
+  public:
+    virtual ~Stalled_Sink (void) {if (this->Is_Open() == true) (void) this->Close();};
+
+  protected:
+    virtual Error_Code  Deliver (const A4_Lib::Log_Sink_Record::Pointer  &) override
+    { // begin
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      return No_Error;
+    } // Deliver
+  } Stalled_Sink;
+
+  /**
+   * @brief Stop on a failed call - a benchmark of a failing primitive measures the wrong thing.
+   */
+  void  Check (Error_Code   the_error,
+               const char   *the_case)
+  { // begin
+    if (the_error != No_Error)
+    { // begin
+      std::printf("%s failed with error %1.5f\n", the_case, A4_Error::Get_Dot_Error_Code(the_error));
+      std::exit(1);
+    } // if then
+  } // Check
+
+  /**
+   * @brief Time Num_Log_Lines writes - the sinks deliver on their own threads, the time is the writing thread's.
+   */
+  void  Write_Case (A4_Benchmark::Benchmark_Report  &the_report,
+                    const std::string               &the_case)
+  { // begin
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_line = 0; the_line < Num_Log_Lines; the_line++)
+      (void) App_Log->Write(A4_Lib::Logging::Info, "benchmark line %llu of %llu", static_cast<unsigned long long>(the_line), static_cast<unsigned long long>(Num_Log_Lines));
+
+    the_report.Add(the_case + "/write_call", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Log_Lines), Num_Log_Lines);
+  } // Write_Case
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Log_Sink_Benchmark", argc, argv);
+
+  const std::string   the_filespec = "./A4_Log_Sink_Benchmark.log";
+
+  std::shared_ptr<A4_Lib::File_Log_Sink>    the_file_sink = std::make_shared<A4_Lib::File_Log_Sink>();
+  std::shared_ptr<A4_Lib::Memory_Log_Sink>  the_memory_sink = std::make_shared<A4_Lib::Memory_Log_Sink>();
+  std::shared_ptr<Stalled_Sink>             the_stalled_sink = std::make_shared<Stalled_Sink>();
+
+  (void) std::remove(the_filespec.c_str());
+
+  Check(A4_Lib::Composite_Logger::Allocate_Singleton(), "Composite_Logger::Allocate_Singleton");
+  Check(the_file_sink->Set_File(the_filespec, A4_Lib::Log_Sink_Constant::Default_Max_File_Size * 10, 1), "File_Log_Sink::Set_File");
+
+  Check(A4_Composite_Log->Add_Sink(the_file_sink), "Composite_Logger::Add_Sink");
+  Check(A4_Composite_Log->Add_Sink(the_memory_sink), "Composite_Logger::Add_Sink");
+  Check(A4_Composite_Log->Add_Sink(the_stalled_sink), "Composite_Logger::Add_Sink");
+
+  the_stalled_sink->Set_Detail_Level(A4_Lib::Logging::Off); // takes no lines until the second case
+
+  Check(A4_Composite_Log->Open(A4_Lib::Logging::Info), "Composite_Logger::Open");
+
+  Write_Case(the_report, "composite"); // file & memory
+
+  the_stalled_sink->Set_Detail_Level(A4_Lib::Logging::Info);
+
+  Write_Case(the_report, "composite_stalled"); // file, memory & a sink that drops nearly every line
+
+  the_report.Add("composite_stalled/dropped", "lines", static_cast<double>(the_stalled_sink->Get_Num_Dropped()), Num_Log_Lines);
+
+  (void) A4_Composite_Log->Close();
+
+  (void) std::remove(the_filespec.c_str());
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
@@ -0,0 +1,146 @@
+/**
+ * @brief   Cost of a log file write batch with writev and with io_uring - and of the File_Logger writing through io_uring.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Log_Uring_Benchmark.cpp
+ * @note  Times Log_File_Writer::Write_Batch on its own - the time the File_Logger worker spends per sweep - then writes the
+ *        same lines as the file_logger cases of A4_Primitive_Benchmark through io_uring. Where the ring cannot be set up
+ *        the io_uring cases measure the writev fallback, and the report says so.
+ *
+ *        make A4_Log_Uring_Benchmark && ./build/A4_Log_Uring_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+
+#include "A4_File_Logger.hh"
+#include "A4_Log_File_Writer.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+
+namespace
+{ // begin
+  const std::size_t   Num_Batches = 4000; /**< per Write_Batch case */
+  const std::size_t   Lines_Per_Batch = 256; /**< a busy worker sweep */
+  const std::size_t   Num_Log_Lines = 200000; /**< as A4_Primitive_Benchmark */
+
+  /**
+   * @brief Stop on a failed call - a benchmark of a failing primitive measures the wrong thing.
+   */
+  void  Check (Error_Code   the_error,
+               const char   *the_case)
+  { // begin
+    if (the_error != No_Error)
+    { // begin
+      std::printf("%s failed with error %1.5f\n", the_case, A4_Error::Get_Dot_Error_Code(the_error));
+      std::exit(1);
+    } // if then
+  } // Check
+
+  /**
+   * @brief Num_Batches batches of Lines_Per_Batch log lines, then the Close that waits for the last of them.
+   */
+  void  Write_Batch_Case (A4_Benchmark::Benchmark_Report  &the_report,
+                          const std::string               &the_name,
+                          bool                            is_io_uring)
+  { // begin
+    const std::string   the_filespec = "./A4_Log_Uring_Benchmark.log";
+    const std::string   the_line = "INFO (000042) 18-10-2020 12:00:00.123 - benchmark line of a log file write batch - 0123456789\r\n";
+    A4_Lib::Log_File_Writer   the_writer;
+
+    (void) std::remove(the_filespec.c_str());
+
+    the_writer.Set_IO_Uring(is_io_uring);
+    Check(the_writer.Open(the_filespec), "Log_File_Writer::Open");
+
+    if (the_writer.Is_IO_Uring_Active() != is_io_uring)
+      std::printf("%s: io_uring could not be set up - measuring writev\n", the_name.c_str());
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_batch = 0; the_batch < Num_Batches; the_batch++)
+    { // begin
+      for (std::size_t the_line_number = 0; the_line_number < Lines_Per_Batch; the_line_number++)
+        the_writer.Add_Copy(the_line.c_str(), the_line.length());
+
+      Check(the_writer.Write_Batch(), "Log_File_Writer::Write_Batch");
+    } // for
+
+    the_report.Add(the_name + "/write_batch", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Batches), Num_Batches);
+
+    Check(the_writer.Close(), "Log_File_Writer::Close");
+
+    the_report.Add(the_name + "/write_bytes", "MB/s",
+                   static_cast<double>(Num_Batches * Lines_Per_Batch * the_line.length()) / 1.0e6 / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count(),
+                   Num_Batches);
+
+    (void) std::remove(the_filespec.c_str());
+  } // Write_Batch_Case
+
+  /**
+   * @brief Write Num_Log_Lines lines through io_uring and close the log - Close returns once every line is in the file.
+   */
+  void  File_Logger_Case (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string   the_filespec = "./A4_Log_Uring_Benchmark.log";
+
+    (void) std::remove(the_filespec.c_str());
+
+    Check(A4_File_Log->Set_IO_Uring(true), "File_Logger::Set_IO_Uring");
+    Check(A4_File_Log->Open(the_filespec, A4_Lib::Logging::Info), "File_Logger::Open");
+
+    if (A4_File_Log->Is_IO_Uring_Active() != true)
+      std::printf("log_uring/file_logger: io_uring could not be set up - measuring writev\n");
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_line = 0; the_line < Num_Log_Lines; the_line++)
+      (void) App_Log->Write(A4_Lib::Logging::Info, "benchmark line %llu of %llu", static_cast<unsigned long long>(the_line), static_cast<unsigned long long>(Num_Log_Lines));
+
+    the_report.Add("log_uring/write_call", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Log_Lines), Num_Log_Lines);
+
+    A4_File_Log->Close();
+
+    the_report.Add("log_uring/write_lines", "lines/s",
+                   static_cast<double>(Num_Log_Lines) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count(), Num_Log_Lines);
+  } // File_Logger_Case
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Log_Uring_Benchmark", argc, argv);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton(); // opened by File_Logger_Case only
+
+  Write_Batch_Case(the_report, "log_file_writer/writev", false);
+  Write_Batch_Case(the_report, "log_file_writer/io_uring", true);
+  File_Logger_Case(the_report);
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
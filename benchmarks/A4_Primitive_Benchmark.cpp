@@ -0,0 +1,474 @@
+/**
+ * @brief   Per-operation cost of the A4_Lib primitives.
+ * @author  a. zippay * 2017..2020
+ * @file A4_Primitive_Benchmark.cpp
+ * @note  Times A4_Error construction and formatting, uncontended Mutex / Recursive_Mutex / Shared_Timed_Mutex lock and
+ *        unlock, Message_Block set and get for each data type, Message_Queue throughput with 1..4 producers and consumers,
+ *        App_Configuration::Get_String, Unordered_Map_T and the Utils string functions, then the File_Logger Write call
+ *        and lines per second (written and flushed by Close). The Method State Block itself is measured by A4_State_Block_Benchmark.
+ *        A few results are verified before anything is timed - the run stops on a wrong one.
+ *
+ *        make A4_Primitive_Benchmark && ./build/A4_Primitive_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+
+#include "A4_Active_Object_Statistics.hh"
+#include "A4_App_Config.hh"
+#include "A4_File_Logger.hh"
+#include "A4_JSON_Line_Writer.hh"
+#include "A4_Lib_Module_ID.hh"
+#include "A4_Message_Block.hh"
+#include "A4_Message_Queue.hh"
+#include "A4_Mutex.hh"
+#include "A4_Recursive_Mutex.hh"
+#include "A4_Shared_Timed_Mutex.hh"
+#include "A4_Unordered_Map_T.hh"
+#include "A4_Utils.hh"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using A4_Benchmark::Nano_Seconds_Per_Call;
+
+namespace
+{ // begin
+  const std::size_t   Num_Calls = 1000000; /**< per case */
+  const std::size_t   Num_Queued_Messages = 1000000; /**< per producer / consumer combination */
+  const std::size_t   Queue_Depth = 1024;
+  const std::int64_t  Enqueue_Wait_MS = 10000; /**< for space in a full queue */
+  const std::size_t   Num_Log_Lines = 200000;
+  const std::size_t   Num_Map_Keys = 100000;
+  const std::size_t   Num_Large_Parses = 20; /**< of a 1 MB line */
+
+  volatile std::uint64_t  the_sink = 0; /**< keeps the results from being optimized away */
+
+  /**
+   * @brief Stop on a failed call - a benchmark of a failing primitive measures the wrong thing.
+   */
+  void  Check (Error_Code   the_error,
+               const char   *the_case)
+  { // begin
+    if (the_error != No_Error)
+    { // begin
+      std::printf("%s failed with error %1.5f\n", the_case, A4_Error::Get_Dot_Error_Code(the_error));
+      std::exit(1);
+    } // if then
+  } // Check
+
+  /**
+   * @brief Stop on a wrong result - the timings of a broken primitive are not worth reporting.
+   */
+  void  Verify (bool         is_correct,
+                const char   *the_case)
+  { // begin
+    if (is_correct != true)
+    { // begin
+      std::printf("%s - verification failed\n", the_case);
+      std::exit(1);
+    } // if then
+  } // Verify
+
+  /**
+   * @brief Every Latency_Histogram bucket holds the values from the previous bucket's upper bound + 1 to its own -
+   *        Bucket_Of & Bucket_Upper_Bound must agree, or the percentiles of Get_Statistics are off.
+   */
+  void  Histogram_Checks (void)
+  { // begin
+    std::uint64_t   the_lower_bound = 0;
+
+    for (std::size_t the_bucket = 0; the_bucket < A4_Lib::Statistics_Constant::Num_Buckets; the_bucket++)
+    { // begin
+      std::uint64_t   the_upper_bound = A4_Lib::Latency_Histogram::Bucket_Upper_Bound(the_bucket);
+
+      Verify(the_upper_bound >= the_lower_bound, "Latency_Histogram::Bucket_Upper_Bound is below the bucket's lower bound");
+      Verify(A4_Lib::Latency_Histogram::Bucket_Of(the_lower_bound) == the_bucket, "Latency_Histogram::Bucket_Of the lower bound");
+      Verify(A4_Lib::Latency_Histogram::Bucket_Of(the_upper_bound) == the_bucket, "Latency_Histogram::Bucket_Of the upper bound");
+
+      if (the_bucket + 1 < A4_Lib::Statistics_Constant::Num_Buckets)
+        Verify(A4_Lib::Latency_Histogram::Bucket_Upper_Bound(the_bucket + 1) > the_upper_bound, "Latency_Histogram::Bucket_Upper_Bound is not monotonic");
+      else Verify(the_upper_bound == UINT64_MAX, "Latency_Histogram - the last bucket ends at the std::uint64_t maximum");
+
+      the_lower_bound = the_upper_bound + 1;
+    } // for
+  } // Histogram_Checks
+
+  /**
+   * @brief A4_Error construction, formatting and copying.
+   */
+  void  Error_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    A4_Error  the_formatted_error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "Invalid parameter value - the_value (%d) must not be negative.", -1);
+    char      the_buffer [256];
+
+    (void) A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "[%s]", "").Format_Message(the_buffer, sizeof(the_buffer));
+    Verify(std::strcmp(the_buffer, "[]") == 0, "A4_Error::Format_Message - an empty %s is a match");
+
+    (void) A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "[%*d|%-*d|%.*f]", 4, 7, 3, 8).Format_Message(the_buffer, sizeof(the_buffer));
+    Verify(std::strcmp(the_buffer, "[   7|8  |<missing>]") == 0, "A4_Error::Format_Message - a * width takes its argument");
+
+    (void) A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "[%.*f|%.*s|%.*d]", 2, 3.14159, 3, "abcdef", -1, 42).Format_Message(the_buffer, sizeof(the_buffer));
+    Verify(std::strcmp(the_buffer, "[3.14|abc|42]") == 0, "A4_Error::Format_Message - a * precision takes its argument");
+
+    (void) A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "[%*d|%d]", "wide", 5, 6).Format_Message(the_buffer, sizeof(the_buffer));
+    Verify(std::strcmp(the_buffer, "[<?>|6]") == 0, "A4_Error::Format_Message - a * that is not an integer is a mismatch");
+
+    the_report.Add("error/construct_plain", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {A4_Error the_error (A4_Utils_Module_ID, 0, "Invalid parameter value."); A4_Benchmark::Keep(the_error);}), Num_Calls);
+
+    the_report.Add("error/construct_formatted", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t the_call)
+                   {A4_Error the_error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "Invalid parameter value - the_value (%d) must not be negative.", static_cast<int>(the_call));
+                    A4_Benchmark::Keep(the_error);}), Num_Calls);
+
+    the_report.Add("error/copy", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_formatted_error] (std::size_t)
+                   {A4_Error the_copy (the_formatted_error); A4_Benchmark::Keep(the_copy);}), Num_Calls);
+
+    the_report.Add("error/format_message", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_formatted_error, &the_buffer] (std::size_t the_call)
+                   {the_formatted_error.Format_Message(the_buffer, sizeof(the_buffer)); the_sink = static_cast<std::uint64_t>(the_buffer [0]) + the_call;}), Num_Calls);
+  } // Error_Cases
+
+  /**
+   * @brief Uncontended lock and unlock.
+   */
+  void  Mutex_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    A4_Lib::Mutex               the_mutex;
+    A4_Lib::Recursive_Mutex     the_recursive_mutex;
+    A4_Lib::Shared_Timed_Mutex  the_shared_timed_mutex;
+
+    the_report.Add("mutex/lock_unlock", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_mutex] (std::size_t)
+                   {bool is_locked = false; Check(the_mutex.Lock(is_locked), "Mutex::Lock"); Check(the_mutex.Unlock(is_locked), "Mutex::Unlock");}), Num_Calls);
+
+    the_report.Add("recursive_mutex/lock_unlock", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_recursive_mutex] (std::size_t)
+                   {bool is_locked = false; Check(the_recursive_mutex.Lock(is_locked), "Recursive_Mutex::Lock"); Check(the_recursive_mutex.Unlock(is_locked), "Recursive_Mutex::Unlock");}), Num_Calls);
+
+    the_report.Add("shared_timed_mutex/lock_unlock_exclusive", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_shared_timed_mutex] (std::size_t)
+                   {bool is_locked = false; Check(the_shared_timed_mutex.Lock(is_locked), "Shared_Timed_Mutex::Lock");
+                    Check(the_shared_timed_mutex.Unlock(is_locked), "Shared_Timed_Mutex::Unlock");}), Num_Calls);
+
+    the_report.Add("shared_timed_mutex/lock_unlock_shared", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_shared_timed_mutex] (std::size_t)
+                   {bool is_locked = false;
+                    Check(the_shared_timed_mutex.Lock(is_locked, A4_Lib::Shared_Timed_Mutex::Block_Until_Locked, 0, A4_Lib::Shared_Timed_Mutex::Lock_Shared), "Shared_Timed_Mutex::Lock");
+                    Check(the_shared_timed_mutex.Unlock(is_locked), "Shared_Timed_Mutex::Unlock");}), Num_Calls);
+  } // Mutex_Cases
+
+  /**
+   * @brief Set_Data followed by Get_Data of the_value at offset zero.
+   */
+  template <typename The_Data_Type> void  Message_Block_Case (A4_Benchmark::Benchmark_Report   &the_report,
+                                                              const char                       *the_name,
+                                                              The_Data_Type                    the_value)
+  { // begin
+    A4_Lib::Message_Block::Pointer  the_message_block;
+
+    Check(A4_Lib::Message_Block::Allocate(the_message_block), "Message_Block::Allocate");
+
+    the_report.Add(the_name, "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_message_block, &the_value] (std::size_t)
+                   {The_Data_Type the_data; Check(the_message_block->Set_Data(the_value, 0), "Message_Block::Set_Data");
+                    Check(the_message_block->Get_Data(the_data, 0), "Message_Block::Get_Data"); the_sink = sizeof(the_data);}), Num_Calls);
+  } // Message_Block_Case
+
+  /**
+   * @brief Set_Data and Get_Data for each data type.
+   */
+  void  Message_Block_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    A4_Lib::Message_Block::Pointer  the_message_block;
+    char                            the_bytes [64] = {0};
+
+    Message_Block_Case<std::uint8_t>(the_report, "message_block/set_get_uint8", 8);
+    Message_Block_Case<std::uint16_t>(the_report, "message_block/set_get_uint16", 16);
+    Message_Block_Case<std::uint32_t>(the_report, "message_block/set_get_uint32", 32);
+    Message_Block_Case<std::uint64_t>(the_report, "message_block/set_get_uint64", 64);
+    Message_Block_Case<double>(the_report, "message_block/set_get_double", 1.5);
+    Message_Block_Case<long double>(the_report, "message_block/set_get_long_double", 2.5L);
+    Message_Block_Case<std::time_t>(the_report, "message_block/set_get_time_t", std::time(nullptr));
+    Message_Block_Case<std::string>(the_report, "message_block/set_get_string", std::string("a short message block string"));
+    Message_Block_Case<std::wstring>(the_report, "message_block/set_get_wstring", std::wstring(L"a short message block string"));
+    Message_Block_Case<std::shared_ptr<void>>(the_report, "message_block/set_get_shared_ptr", std::make_shared<std::uint64_t>(1));
+
+    Check(A4_Lib::Message_Block::Allocate(the_message_block), "Message_Block::Allocate");
+
+    the_report.Add("message_block/set_get_64_bytes", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_message_block, &the_bytes] (std::size_t)
+                   {std::size_t the_num_bytes = 0; Check(the_message_block->Set_Data(the_bytes, 0, sizeof(the_bytes)), "Message_Block::Set_Data");
+                    Check(the_message_block->Get_Data(the_bytes, 0, sizeof(the_bytes), the_num_bytes), "Message_Block::Get_Data"); the_sink = the_num_bytes;}), Num_Calls);
+  } // Message_Block_Cases
+
+  /**
+   * @brief Pass Num_Queued_Messages through a queue.
+   * @return messages per second
+   */
+  double  Queue_Rate (std::size_t   the_num_producers,
+                      std::size_t   the_num_consumers)
+  { // begin
+    A4_Lib::Message_Queue::Pointer  the_queue;
+    std::atomic<std::size_t>        the_num_remaining (Num_Queued_Messages);
+    std::vector<std::thread>        the_threads;
+
+    Check(A4_Lib::Message_Queue::Allocate(the_queue), "Message_Queue::Allocate");
+    Check(the_queue->Initialize(Queue_Depth), "Message_Queue::Initialize");
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_producer = 0; the_producer < the_num_producers; the_producer++)
+      the_threads.emplace_back([&the_queue, the_producer, the_num_producers] ()
+      { // begin
+        A4_Lib::Message_Block::Pointer  the_message_block;
+        std::size_t                     the_num_messages = Num_Queued_Messages / the_num_producers + ((the_producer < (Num_Queued_Messages % the_num_producers)) ? 1 : 0);
+
+        Check(A4_Lib::Message_Block::Allocate(the_message_block), "Message_Block::Allocate");
+
+        for (std::size_t the_message = 0; the_message < the_num_messages; the_message++)
+          Check(the_queue->Enqueue(the_message_block, Enqueue_Wait_MS), "Message_Queue::Enqueue"); // the same block - the queue holds pointers
+      }); // producer
+
+    for (std::size_t the_consumer = 0; the_consumer < the_num_consumers; the_consumer++)
+      the_threads.emplace_back([&the_queue, &the_num_remaining] ()
+      { // begin
+        A4_Lib::Message_Block::Pointer  the_message_block;
+
+        while (the_num_remaining.load(std::memory_order_relaxed) > 0)
+        { // begin
+          the_message_block.reset();
+
+          if ((the_queue->Dequeue(the_message_block, 10) == No_Error) && (the_message_block != nullptr))
+            the_num_remaining.fetch_sub(1, std::memory_order_relaxed);
+        } // while
+      }); // consumer
+
+    for (std::thread &the_thread : the_threads)
+      the_thread.join();
+
+    return static_cast<double>(Num_Queued_Messages) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count();
+  } // Queue_Rate
+
+  /**
+   * @brief Message_Queue throughput with 1, 2 and 4 producers and consumers.
+   */
+  void  Message_Queue_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::size_t   the_thread_counts [] = {1, 2, 4};
+
+    for (std::size_t the_num_producers : the_thread_counts)
+      for (std::size_t the_num_consumers : the_thread_counts)
+        the_report.Add("message_queue/enqueue_dequeue_" + std::to_string(the_num_producers) + "p_" + std::to_string(the_num_consumers) + "c", "msg/s",
+                       Queue_Rate(the_num_producers, the_num_consumers), Num_Queued_Messages);
+  } // Message_Queue_Cases
+
+  /**
+   * @brief Get_String of a present and of a missing key in a 20 section, 20 key file.
+   */
+  void  App_Configuration_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string           the_filespec = "./A4_Primitive_Benchmark.cfg";
+    A4_Lib::App_Configuration   the_configuration;
+    std::ofstream               the_stream (the_filespec);
+
+    for (int the_section = 0; the_section < 20; the_section++)
+    { // begin
+      the_stream << "[Section_" << the_section << "]\n";
+
+      for (int the_key = 0; the_key < 20; the_key++)
+        the_stream << "Key_" << the_key << "=Value_" << the_section << "_" << the_key << "\n";
+    } // for
+
+    the_stream.close();
+
+    Check(the_configuration.Open(the_filespec), "App_Configuration::Open");
+
+    the_report.Add("app_configuration/get_string_found", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_configuration] (std::size_t)
+                   {std::string the_value; bool is_found = false; Check(the_configuration.Get_String("Section_10", "Key_10", the_value, is_found), "App_Configuration::Get_String");
+                    the_sink = the_value.size();}), Num_Calls);
+
+    the_report.Add("app_configuration/get_string_missing", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_configuration] (std::size_t)
+                   {std::string the_value; bool is_found = false; (void) the_configuration.Get_String("Section_10", "Key_99", the_value, is_found);
+                    the_sink = is_found;}), Num_Calls);
+
+    (void) the_configuration.Close();
+    (void) std::remove(the_filespec.c_str());
+  } // App_Configuration_Cases
+
+  /**
+   * @brief Insert, Find, Exists and Erase of Num_Map_Keys keys.
+   */
+  void  Unordered_Map_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    A4_Lib::Unordered_Map_T<std::uint64_t, std::uint64_t, A4_Utils_Module_ID, 0>  the_map;
+
+    the_report.Add("unordered_map/insert", "ns/op", Nano_Seconds_Per_Call(Num_Map_Keys, [&the_map] (std::size_t the_key)
+                   {Check(the_map.Insert(the_key, the_key), "Unordered_Map_T::Insert");}), Num_Map_Keys);
+
+    the_report.Add("unordered_map/find", "ns/op", Nano_Seconds_Per_Call(Num_Map_Keys, [&the_map] (std::size_t the_key)
+                   {std::uint64_t the_data = 0; bool is_found = false; Check(the_map.Find(the_key, the_data, is_found), "Unordered_Map_T::Find"); the_sink = the_data;}), Num_Map_Keys);
+
+    the_report.Add("unordered_map/exists", "ns/op", Nano_Seconds_Per_Call(Num_Map_Keys, [&the_map] (std::size_t the_key)
+                   {the_sink = the_map.Exists(the_key);}), Num_Map_Keys);
+
+    the_report.Add("unordered_map/erase", "ns/op", Nano_Seconds_Per_Call(Num_Map_Keys, [&the_map] (std::size_t the_key)
+                   {Check(the_map.Erase(the_key), "Unordered_Map_T::Erase");}), Num_Map_Keys);
+  } // Unordered_Map_Cases
+
+  /**
+   * @brief The Utils string functions.
+   */
+  void  Utils_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    std::string   the_wildcard = "A4_*_Benchmark.??p";
+    std::string   the_large_line;
+
+    while (the_large_line.size() < 1024 * 1024)
+      the_large_line += "value_" + std::to_string(the_large_line.size()) + ",\"quoted, value\",  ";
+
+    the_report.Add("utils/snprintf_string", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t the_call)
+                   {std::string the_output; Check(A4_Lib::SNPrintf(the_output, "%s %d %1.5f", 128, "Error", static_cast<int>(the_call), 3.00004), "SNPrintf");
+                    the_sink = the_output.size();}), Num_Calls);
+
+    the_report.Add("utils/short_string_hash", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {the_sink = A4_Lib::Short_String_Hash(std::string("Short_String"));}), Num_Calls);
+
+    the_report.Add("utils/parse_csv_values", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {A4_Lib::String_Vector the_values; Check(A4_Lib::Parse_CSV_Values("alpha,beta,gamma,delta,epsilon,zeta", the_values), "Parse_CSV_Values");
+                    the_sink = the_values.size();}), Num_Calls);
+
+    the_report.Add("utils/parse_csv_values_1mb_line", "ns/op", Nano_Seconds_Per_Call(Num_Large_Parses, [&the_large_line] (std::size_t)
+                   {A4_Lib::String_Vector the_values; Check(A4_Lib::Parse_CSV_Values(the_large_line, the_values), "Parse_CSV_Values");
+                    the_sink = the_values.size();}), Num_Large_Parses);
+
+    the_report.Add("utils/left_right_trim", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {std::string the_string = "   a value surrounded by white space   "; the_sink = A4_Lib::Right_Trim(A4_Lib::Left_Trim(the_string)).size();}), Num_Calls);
+
+    the_report.Add("utils/make_upper_case", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {std::string the_string = "a mixed Case String"; Check(A4_Lib::Make_Upper_Case(the_string), "Make_Upper_Case"); the_sink = the_string.size();}), Num_Calls);
+
+    the_report.Add("utils/astring_to_wstring", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {std::wstring the_output; Check(A4_Lib::AString_To_WString("a narrow string to widen", the_output), "AString_To_WString"); the_sink = the_output.size();}), Num_Calls);
+
+    the_report.Add("utils/wildcard_to_regex", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_wildcard] (std::size_t)
+                   {std::string the_regex; Check(A4_Lib::Wildcard_To_Regex(the_wildcard, the_regex), "Wildcard_To_Regex"); the_sink = the_regex.size();}), Num_Calls);
+
+    the_report.Add("utils/high_res_timestamp_string", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t)
+                   {std::string the_time; Check(A4_Lib::High_Res_Timestamp_String(the_time), "High_Res_Timestamp_String"); the_sink = the_time.size();}), Num_Calls);
+
+    the_report.Add("utils/timestamp_string", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t the_call)
+                   {char the_time [A4_Lib::Timestamp_Constant::Max_Timestamp_Length]; std::size_t the_length = 0;
+                    Check(A4_Lib::Timestamp_String(1600000000000000000ll + static_cast<std::int64_t>(the_call) * 1000, the_time, sizeof(the_time), the_length), "Timestamp_String");
+                    the_sink = the_length;}), Num_Calls);
+  } // Utils_Cases
+
+  /**
+   * @brief One log line as File_Logger formats it - the text line, then the JSON-lines object with the same fields.
+   */
+  void  Log_Line_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const char  the_message [] = "order 42 rejected - \"price\" 410.50 is outside the band\tretry later";
+    const char  the_timestamp [] = "18-10-2020 12:00:00.123";
+
+    { // begin - valid UTF-8 is kept, every byte of anything else becomes U+FFFD
+      const char  the_mixed [] = "caf\xC3\xA9 \xFF x\xE2\x82 \xED\xA0\x80 \xF0\x9F\x98\x80";
+      char        the_line [256];
+
+      A4_Lib::JSON_Line_Writer  the_writer (the_line, sizeof(the_line));
+
+      the_writer.Put_String("message", the_mixed, sizeof(the_mixed) - 1);
+      (void) the_writer.Finish();
+
+      Verify(std::strcmp(the_line, "{\"message\":\"caf\xC3\xA9 \xEF\xBF\xBD x\xEF\xBF\xBD\xEF\xBF\xBD \xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD \xF0\x9F\x98\x80\"}\n") == 0,
+             "JSON_Line_Writer - invalid UTF-8 is replaced by U+FFFD");
+    } // end
+
+    the_report.Add("log_line/text_snprintf", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_message, &the_timestamp] (std::size_t the_call)
+                   {char the_line [A4_Lib::File_Logger_Constants::Max_Record_Length];
+                    the_sink = static_cast<std::uint64_t>(std::snprintf(the_line, sizeof(the_line), "%s (%06jd) %s - %s\r\n", "INFO", static_cast<std::intmax_t>(the_call), the_timestamp, the_message));}), Num_Calls);
+
+    the_report.Add("log_line/json_writer", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [&the_message, &the_timestamp] (std::size_t the_call)
+                   {char the_line [A4_Lib::File_Logger_Constants::Max_Record_Length];
+                    A4_Lib::JSON_Line_Writer  the_writer (the_line, sizeof(the_line));
+                    the_writer.Put_String("level", "INFO");
+                    the_writer.Put_Integer("sequence", static_cast<std::int64_t>(the_call));
+                    the_writer.Put_String("timestamp", the_timestamp, sizeof(the_timestamp) - 1);
+                    the_writer.Put_Integer("epoch_ns", 1600000000000000000ll + static_cast<std::int64_t>(the_call));
+                    the_writer.Put_Unsigned("module", 55);
+                    the_writer.Put_String("message", the_message, sizeof(the_message) - 1);
+                    the_sink = the_writer.Finish();}), Num_Calls);
+  } // Log_Line_Cases
+
+  /**
+   * @brief Write Num_Log_Lines lines and close the log - Close returns once every line is in the file.
+   */
+  void  File_Logger_Cases (A4_Benchmark::Benchmark_Report  &the_report)
+  { // begin
+    const std::string   the_filespec = "./A4_Primitive_Benchmark.log";
+
+    (void) std::remove(the_filespec.c_str());
+
+    Check(A4_File_Log->Open(the_filespec, A4_Lib::Logging::Info), "File_Logger::Open");
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_line = 0; the_line < Num_Log_Lines; the_line++)
+      (void) App_Log->Write(A4_Lib::Logging::Info, "benchmark line %llu of %llu", static_cast<unsigned long long>(the_line), static_cast<unsigned long long>(Num_Log_Lines));
+
+    the_report.Add("file_logger/write_call", "ns/op",
+                   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Log_Lines), Num_Log_Lines);
+
+    A4_File_Log->Close();
+
+    the_report.Add("file_logger/write_lines", "lines/s",
+                   static_cast<double>(Num_Log_Lines) / std::chrono::duration<double>(std::chrono::steady_clock::now() - the_start).count(), Num_Log_Lines);
+
+    // below the Info level of the log - the level check is all either call should cost
+    the_report.Add("file_logger/filtered_write_call", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t the_call)
+                   {(void) App_Log->Write(A4_Lib::Logging::Debug, "filtered line %llu of %s", static_cast<unsigned long long>(the_call), std::to_string(the_call).c_str());}), Num_Calls);
+
+    the_report.Add("file_logger/filtered_macro_call", "ns/op", Nano_Seconds_Per_Call(Num_Calls, [] (std::size_t the_call)
+                   {A4_Log(A4_Lib::Logging::Debug, "filtered line %llu of %s", static_cast<unsigned long long>(the_call), std::to_string(the_call).c_str());}), Num_Calls);
+  } // File_Logger_Cases
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_Primitive_Benchmark", argc, argv);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton(); // opened by File_Logger_Cases only
+
+  Histogram_Checks();
+
+  Error_Cases(the_report);
+  Mutex_Cases(the_report);
+  Message_Block_Cases(the_report);
+  Message_Queue_Cases(the_report);
+  App_Configuration_Cases(the_report);
+  Unordered_Map_Cases(the_report);
+  Utils_Cases(the_report);
+  Log_Line_Cases(the_report);
+  File_Logger_Cases(the_report);
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main
@@ -0,0 +1,247 @@
+/**
+ * @brief   Per-call cost of the Method_State_Block idiom.
+ * @author  a. zippay * 2017..2020
+ * @file A4_State_Block_Benchmark.cpp
+ * @note  Times an empty single-state block, a three-state block, three states that each call an opaque method and a block
+ *        that fails in its first state - each with the
+ *        Method_State_Block macros and with the Fast_State_Block macros. The log is allocated but not opened, so the failing
+ *        cases measure building the A4_Error rather than writing it.
+ *
+ *        make A4_State_Block_Benchmark && ./build/A4_State_Block_Benchmark [results.json]
+ *
+ * The MIT License
+ *
+ * Copyright 1995..2020 albert zippay
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "A4_Benchmark_Report.hh"
+
+#include "A4_File_Logger.hh"
+#include "A4_Lib_Module_ID.hh"
+#include "A4_Method_State_Block.hh"
+
+
+namespace
+{ // begin
+  const std::size_t   Num_Calls = 10000000; /**< per case */
+
+  volatile int  the_sink = 0; /**< keeps the states from being optimized away */
+
+  /**
+   * @brief One state, no error.
+   */
+  __attribute__((noinline)) Error_Code  Empty_Block (int  the_value)
+  { // begin
+    Method_State_Block_Begin(1)
+      State(1)
+        the_sink = the_value;
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Empty_Block
+
+  /**
+   * @brief Three states, no error.
+   */
+  __attribute__((noinline)) Error_Code  Three_State_Block (int  the_value)
+  { // begin
+    Method_State_Block_Begin(3)
+      State(1)
+        the_sink = the_value;
+      End_State
+
+      State(2)
+        the_sink = the_value + 1;
+      End_State
+
+      State(3)
+        the_sink = the_value + 2;
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Three_State_Block
+
+  /**
+   * @brief Fails in its first state with a formatted error.
+   */
+  __attribute__((noinline)) Error_Code  Failing_Block (int  the_value)
+  { // begin
+    Method_State_Block_Begin(2)
+      State(1)
+        the_method_error = A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "Invalid parameter value - the_value (%d) must not be negative.", the_value);
+      End_State
+
+      State(2)
+        the_sink = the_value;
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Failing_Block
+
+  /**
+   * @brief An opaque callee - the compiler cannot see that it never fails (or throws).
+   */
+  __attribute__((noinline)) Error_Code  Callee (int  the_value)
+  { // begin
+    the_sink = the_value;
+
+    return (the_value < 0) ? 1 : No_Error;
+  } // Callee
+
+  /**
+   * @brief Three states, each calling another method - the usual shape of an A4 method.
+   */
+  __attribute__((noinline)) Error_Code  Calling_Block (int  the_value)
+  { // begin
+    Method_State_Block_Begin(3)
+      State(1)
+        the_method_error = Callee(the_value);
+      End_State
+
+      State(2)
+        the_method_error = Callee(the_value + 1);
+      End_State
+
+      State(3)
+        the_method_error = Callee(the_value + 2);
+      End_State
+    End_Method_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Calling_Block
+
+  /**
+   * @brief Three fast states, each calling another method.
+   */
+  __attribute__((noinline)) Error_Code  Fast_Calling_Block (int  the_value)
+  { // begin
+    Fast_State_Block_Begin(3)
+      Fast_State(1)
+        the_method_error = Callee(the_value);
+      End_Fast_State
+
+      Fast_State(2)
+        the_method_error = Callee(the_value + 1);
+      End_Fast_State
+
+      Fast_State(3)
+        the_method_error = Callee(the_value + 2);
+      End_Fast_State
+    End_Fast_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Fast_Calling_Block
+
+  /**
+   * @brief One fast state, no error.
+   */
+  __attribute__((noinline)) Error_Code  Fast_Empty_Block (int  the_value)
+  { // begin
+    Fast_State_Block_Begin(1)
+      Fast_State(1)
+        the_sink = the_value;
+      End_Fast_State
+    End_Fast_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Fast_Empty_Block
+
+  /**
+   * @brief Three fast states, no error.
+   */
+  __attribute__((noinline)) Error_Code  Fast_Three_State_Block (int  the_value)
+  { // begin
+    Fast_State_Block_Begin(3)
+      Fast_State(1)
+        the_sink = the_value;
+      End_Fast_State
+
+      Fast_State(2)
+        the_sink = the_value + 1;
+      End_Fast_State
+
+      Fast_State(3)
+        the_sink = the_value + 2;
+      End_Fast_State
+    End_Fast_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Fast_Three_State_Block
+
+  /**
+   * @brief Fails in its first fast state with a formatted error.
+   */
+  __attribute__((noinline)) Error_Code  Fast_Failing_Block (int  the_value)
+  { // begin
+    Fast_State_Block_Begin(2)
+      Fast_State(1)
+        the_method_error = A4_Error (A4_Utils_Module_ID, 0, A4_Lib::Logging::Error, "Invalid parameter value - the_value (%d) must not be negative.", the_value);
+      End_Fast_State
+
+      Fast_State(2)
+        the_sink = the_value;
+      End_Fast_State
+    End_Fast_State_Block
+
+    return the_method_error.Get_Error_Code();
+  } // Fast_Failing_Block
+
+  /**
+   * @brief Call the_method Num_Calls times.
+   * @return nano-seconds per call
+   */
+  double  Time (Error_Code  (*the_method)(int))
+  { // begin
+    Error_Code  the_errors = No_Error;
+
+    std::chrono::steady_clock::time_point   the_start = std::chrono::steady_clock::now();
+
+    for (std::size_t the_call = 0; the_call < Num_Calls; the_call++)
+      the_errors |= the_method(static_cast<int>(the_call));
+
+    the_sink = static_cast<int>(the_errors);
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - the_start).count() / static_cast<double>(Num_Calls);
+  } // Time
+} // namespace
+
+int main (int   argc,
+          char  *argv [])
+{ // begin
+  A4_Benchmark::Benchmark_Report  the_report ("A4_State_Block_Benchmark", argc, argv);
+
+  (void) A4_Lib::File_Logger::Allocate_Singleton(); // not opened - errors are built, not written
+
+  the_report.Add("state_block/empty", "ns/op", Time(Empty_Block), Num_Calls);
+  the_report.Add("state_block/three_states", "ns/op", Time(Three_State_Block), Num_Calls);
+  the_report.Add("state_block/calling", "ns/op", Time(Calling_Block), Num_Calls);
+  the_report.Add("state_block/failing", "ns/op", Time(Failing_Block), Num_Calls);
+
+  the_report.Add("fast_state_block/empty", "ns/op", Time(Fast_Empty_Block), Num_Calls);
+  the_report.Add("fast_state_block/three_states", "ns/op", Time(Fast_Three_State_Block), Num_Calls);
+  the_report.Add("fast_state_block/calling", "ns/op", Time(Fast_Calling_Block), Num_Calls);
+  the_report.Add("fast_state_block/failing", "ns/op", Time(Fast_Failing_Block), Num_Calls);
+
+  return (the_report.Write() == true) ? 0 : 1;
+} // main